@@ -112,7 +112,7 @@ class PPSTxnManager : public TxnManager
 public:
 	void init(uint64_t thd_id, Workload * h_wl);
   void reset();
-  RC acquire_locks(); 
+  RC acquire_locks(uint64_t lock_part); 
 	RC run_txn();
 	RC run_txn_post_wait();
 	RC run_calvin_txn(); 
@@ -126,6 +126,10 @@ private:
   row_t * row;
 
   uint64_t parts_processed_count;
+  // SUPPLIES or USES entries of the current key, read once per transaction
+  itemid_t ** part_items;
+  uint64_t part_item_cnt;
+  row_t * get_part_row(INDEX * index, uint64_t key, uint64_t part_id);
 
   void next_pps_state();
   RC run_txn_state();
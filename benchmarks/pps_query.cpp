@@ -56,12 +56,12 @@ BaseQuery * PPSQueryGenerator::create_query(Workload * h_wl,uint64_t home_partit
 
 void PPSQuery::init(uint64_t thd_id, Workload * h_wl) {
   BaseQuery::init();
-  part_keys.init(MAX_PPS_PART_PER_PRODUCT);
+  recon_keys.init(MAX_PPS_PART_PER_PRODUCT);
 }
 
 void PPSQuery::init() {
   BaseQuery::init();
-  part_keys.init(MAX_PPS_PART_PER_PRODUCT);
+  recon_keys.init(MAX_PPS_PART_PER_PRODUCT);
 }
 
 void PPSQuery::print() {
@@ -93,8 +93,8 @@ std::set<uint64_t> PPSQuery::participants(Message * msg, Workload * wl) {
     case PPS_GETPARTBYSUPPLIER:
       id = GET_NODE_ID(suppliers_to_partition(pps_msg->supplier_key));
       participant_set.insert(id);
-      for (uint64_t key = 0; key < pps_msg->part_keys.size(); key++) {
-          uint64_t tmp = pps_msg->part_keys[key];
+      for (uint64_t key = 0; key < pps_msg->recon_keys.size(); key++) {
+          uint64_t tmp = pps_msg->recon_keys[key];
           id = GET_NODE_ID(parts_to_partition(tmp));
           participant_set.insert(id);
       }
@@ -102,8 +102,8 @@ std::set<uint64_t> PPSQuery::participants(Message * msg, Workload * wl) {
     case PPS_GETPARTBYPRODUCT:
       id = GET_NODE_ID(products_to_partition(pps_msg->product_key));
       participant_set.insert(id);
-      for (uint64_t key = 0; key < pps_msg->part_keys.size(); key++) {
-          uint64_t tmp = pps_msg->part_keys[key];
+      for (uint64_t key = 0; key < pps_msg->recon_keys.size(); key++) {
+          uint64_t tmp = pps_msg->recon_keys[key];
           id = GET_NODE_ID(parts_to_partition(tmp));
           participant_set.insert(id);
       }
@@ -111,8 +111,8 @@ std::set<uint64_t> PPSQuery::participants(Message * msg, Workload * wl) {
     case PPS_ORDERPRODUCT:
       id = GET_NODE_ID(products_to_partition(pps_msg->product_key));
       participant_set.insert(id);
-      for (uint64_t key = 0; key < pps_msg->part_keys.size(); key++) {
-          uint64_t tmp = pps_msg->part_keys[key];
+      for (uint64_t key = 0; key < pps_msg->recon_keys.size(); key++) {
+          uint64_t tmp = pps_msg->recon_keys[key];
           id = GET_NODE_ID(parts_to_partition(tmp));
           participant_set.insert(id);
       }
@@ -433,8 +433,8 @@ uint64_t PPSQuery::get_participants(Workload * wl) {
       id = GET_NODE_ID(products_to_partition(product_key));
       participant_nodes.set(id,1);
       participant_cnt++;
-      for (uint64_t key = 0; key < part_keys.size(); key++) {
-          id = GET_NODE_ID(parts_to_partition(part_keys[key]));
+      for (uint64_t key = 0; key < recon_keys.size(); key++) {
+          id = GET_NODE_ID(parts_to_partition(recon_keys[key]));
           if (participant_nodes[id] == 0) {
               participant_nodes.set(id,1);
               participant_cnt++;
@@ -445,8 +445,8 @@ uint64_t PPSQuery::get_participants(Workload * wl) {
       id = GET_NODE_ID(suppliers_to_partition(supplier_key));
       participant_nodes.set(id,1);
       participant_cnt++;
-      for (uint64_t key = 0; key < part_keys.size(); key++) {
-          id = GET_NODE_ID(parts_to_partition(part_keys[key]));
+      for (uint64_t key = 0; key < recon_keys.size(); key++) {
+          id = GET_NODE_ID(parts_to_partition(recon_keys[key]));
           if (participant_nodes[id] == 0) {
               participant_nodes.set(id,1);
               participant_cnt++;
@@ -457,8 +457,8 @@ uint64_t PPSQuery::get_participants(Workload * wl) {
       id = GET_NODE_ID(products_to_partition(product_key));
       participant_nodes.set(id,1);
       participant_cnt++;
-      for (uint64_t key = 0; key < part_keys.size(); key++) {
-          id = GET_NODE_ID(parts_to_partition(part_keys[key]));
+      for (uint64_t key = 0; key < recon_keys.size(); key++) {
+          id = GET_NODE_ID(parts_to_partition(recon_keys[key]));
           if (participant_nodes[id] == 0) {
               participant_nodes.set(id,1);
               participant_cnt++;
@@ -489,12 +489,10 @@ uint64_t PPSQuery::get_participants(Workload * wl) {
 
 void PPSQuery::reset() {
   BaseQuery::clear();
-  part_keys.clear();
 }
 
 void PPSQuery::release() {
   BaseQuery::release();
-  part_keys.release();
   DEBUG_M("PPSQuery::release() free\n");
 }
 
@@ -68,8 +68,7 @@ public:
     uint64_t supplier_key;
     uint64_t product_key;
 
-    // part keys from secondary lookup
-    Array<uint64_t> part_keys;
+    // recon_keys: the part keys of the secondary lookup
 
     // track number of parts we've read
     // in a getpartsbyX query
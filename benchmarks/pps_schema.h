@@ -0,0 +1,139 @@
+// Generated by scripts/gen_schema.py. Do not edit.
+#ifndef _PPS_SCHEMA_H_
+#define _PPS_SCHEMA_H_
+
+#include "global.h"
+#include "catalog.h"
+
+// PPS_schema.txt
+namespace pps_schema {
+namespace PARTS {
+	struct PART_KEY { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 116 }; };
+	struct PART_AMOUNT { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 116 }; };
+	struct FIELD1 { typedef char type; static const bool pax = false;
+		enum { id = 2, size = 10, index = 16, group = 0, group_index = 16, group_size = 116 }; };
+	struct FIELD2 { typedef char type; static const bool pax = false;
+		enum { id = 3, size = 10, index = 26, group = 0, group_index = 26, group_size = 116 }; };
+	struct FIELD3 { typedef char type; static const bool pax = false;
+		enum { id = 4, size = 10, index = 36, group = 0, group_index = 36, group_size = 116 }; };
+	struct FIELD4 { typedef char type; static const bool pax = false;
+		enum { id = 5, size = 10, index = 46, group = 0, group_index = 46, group_size = 116 }; };
+	struct FIELD5 { typedef char type; static const bool pax = false;
+		enum { id = 6, size = 10, index = 56, group = 0, group_index = 56, group_size = 116 }; };
+	struct FIELD6 { typedef char type; static const bool pax = false;
+		enum { id = 7, size = 10, index = 66, group = 0, group_index = 66, group_size = 116 }; };
+	struct FIELD7 { typedef char type; static const bool pax = false;
+		enum { id = 8, size = 10, index = 76, group = 0, group_index = 76, group_size = 116 }; };
+	struct FIELD8 { typedef char type; static const bool pax = false;
+		enum { id = 9, size = 10, index = 86, group = 0, group_index = 86, group_size = 116 }; };
+	struct FIELD9 { typedef char type; static const bool pax = false;
+		enum { id = 10, size = 10, index = 96, group = 0, group_index = 96, group_size = 116 }; };
+	struct FIELD10 { typedef char type; static const bool pax = false;
+		enum { id = 11, size = 10, index = 106, group = 0, group_index = 106, group_size = 116 }; };
+}
+namespace PRODUCTS {
+	struct PRODUCT_KEY { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 108 }; };
+	struct FIELD1 { typedef char type; static const bool pax = false;
+		enum { id = 1, size = 10, index = 8, group = 0, group_index = 8, group_size = 108 }; };
+	struct FIELD2 { typedef char type; static const bool pax = false;
+		enum { id = 2, size = 10, index = 18, group = 0, group_index = 18, group_size = 108 }; };
+	struct FIELD3 { typedef char type; static const bool pax = false;
+		enum { id = 3, size = 10, index = 28, group = 0, group_index = 28, group_size = 108 }; };
+	struct FIELD4 { typedef char type; static const bool pax = false;
+		enum { id = 4, size = 10, index = 38, group = 0, group_index = 38, group_size = 108 }; };
+	struct FIELD5 { typedef char type; static const bool pax = false;
+		enum { id = 5, size = 10, index = 48, group = 0, group_index = 48, group_size = 108 }; };
+	struct FIELD6 { typedef char type; static const bool pax = false;
+		enum { id = 6, size = 10, index = 58, group = 0, group_index = 58, group_size = 108 }; };
+	struct FIELD7 { typedef char type; static const bool pax = false;
+		enum { id = 7, size = 10, index = 68, group = 0, group_index = 68, group_size = 108 }; };
+	struct FIELD8 { typedef char type; static const bool pax = false;
+		enum { id = 8, size = 10, index = 78, group = 0, group_index = 78, group_size = 108 }; };
+	struct FIELD9 { typedef char type; static const bool pax = false;
+		enum { id = 9, size = 10, index = 88, group = 0, group_index = 88, group_size = 108 }; };
+	struct FIELD10 { typedef char type; static const bool pax = false;
+		enum { id = 10, size = 10, index = 98, group = 0, group_index = 98, group_size = 108 }; };
+}
+namespace SUPPLIERS {
+	struct SUPPLIER_KEY { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 108 }; };
+	struct FIELD1 { typedef char type; static const bool pax = false;
+		enum { id = 1, size = 10, index = 8, group = 0, group_index = 8, group_size = 108 }; };
+	struct FIELD2 { typedef char type; static const bool pax = false;
+		enum { id = 2, size = 10, index = 18, group = 0, group_index = 18, group_size = 108 }; };
+	struct FIELD3 { typedef char type; static const bool pax = false;
+		enum { id = 3, size = 10, index = 28, group = 0, group_index = 28, group_size = 108 }; };
+	struct FIELD4 { typedef char type; static const bool pax = false;
+		enum { id = 4, size = 10, index = 38, group = 0, group_index = 38, group_size = 108 }; };
+	struct FIELD5 { typedef char type; static const bool pax = false;
+		enum { id = 5, size = 10, index = 48, group = 0, group_index = 48, group_size = 108 }; };
+	struct FIELD6 { typedef char type; static const bool pax = false;
+		enum { id = 6, size = 10, index = 58, group = 0, group_index = 58, group_size = 108 }; };
+	struct FIELD7 { typedef char type; static const bool pax = false;
+		enum { id = 7, size = 10, index = 68, group = 0, group_index = 68, group_size = 108 }; };
+	struct FIELD8 { typedef char type; static const bool pax = false;
+		enum { id = 8, size = 10, index = 78, group = 0, group_index = 78, group_size = 108 }; };
+	struct FIELD9 { typedef char type; static const bool pax = false;
+		enum { id = 9, size = 10, index = 88, group = 0, group_index = 88, group_size = 108 }; };
+	struct FIELD10 { typedef char type; static const bool pax = false;
+		enum { id = 10, size = 10, index = 98, group = 0, group_index = 98, group_size = 108 }; };
+}
+namespace USES {
+	struct PRODUCT_KEY { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 16 }; };
+	struct PART_KEY { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 16 }; };
+}
+namespace SUPPLIES {
+	struct SUPPLIER_KEY { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 16 }; };
+	struct PART_KEY { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 16 }; };
+}
+// checked against the parsed schema by Workload::check_schema
+static const static_column columns[] = {
+	{"PARTS", 0, 8, 0, 0, 0, 116, false},
+	{"PARTS", 1, 8, 8, 0, 8, 116, false},
+	{"PARTS", 2, 10, 16, 0, 16, 116, false},
+	{"PARTS", 3, 10, 26, 0, 26, 116, false},
+	{"PARTS", 4, 10, 36, 0, 36, 116, false},
+	{"PARTS", 5, 10, 46, 0, 46, 116, false},
+	{"PARTS", 6, 10, 56, 0, 56, 116, false},
+	{"PARTS", 7, 10, 66, 0, 66, 116, false},
+	{"PARTS", 8, 10, 76, 0, 76, 116, false},
+	{"PARTS", 9, 10, 86, 0, 86, 116, false},
+	{"PARTS", 10, 10, 96, 0, 96, 116, false},
+	{"PARTS", 11, 10, 106, 0, 106, 116, false},
+	{"PRODUCTS", 0, 8, 0, 0, 0, 108, false},
+	{"PRODUCTS", 1, 10, 8, 0, 8, 108, false},
+	{"PRODUCTS", 2, 10, 18, 0, 18, 108, false},
+	{"PRODUCTS", 3, 10, 28, 0, 28, 108, false},
+	{"PRODUCTS", 4, 10, 38, 0, 38, 108, false},
+	{"PRODUCTS", 5, 10, 48, 0, 48, 108, false},
+	{"PRODUCTS", 6, 10, 58, 0, 58, 108, false},
+	{"PRODUCTS", 7, 10, 68, 0, 68, 108, false},
+	{"PRODUCTS", 8, 10, 78, 0, 78, 108, false},
+	{"PRODUCTS", 9, 10, 88, 0, 88, 108, false},
+	{"PRODUCTS", 10, 10, 98, 0, 98, 108, false},
+	{"SUPPLIERS", 0, 8, 0, 0, 0, 108, false},
+	{"SUPPLIERS", 1, 10, 8, 0, 8, 108, false},
+	{"SUPPLIERS", 2, 10, 18, 0, 18, 108, false},
+	{"SUPPLIERS", 3, 10, 28, 0, 28, 108, false},
+	{"SUPPLIERS", 4, 10, 38, 0, 38, 108, false},
+	{"SUPPLIERS", 5, 10, 48, 0, 48, 108, false},
+	{"SUPPLIERS", 6, 10, 58, 0, 58, 108, false},
+	{"SUPPLIERS", 7, 10, 68, 0, 68, 108, false},
+	{"SUPPLIERS", 8, 10, 78, 0, 78, 108, false},
+	{"SUPPLIERS", 9, 10, 88, 0, 88, 108, false},
+	{"SUPPLIERS", 10, 10, 98, 0, 98, 108, false},
+	{"USES", 0, 8, 0, 0, 0, 16, false},
+	{"USES", 1, 8, 8, 0, 8, 16, false},
+	{"SUPPLIES", 0, 8, 0, 0, 0, 16, false},
+	{"SUPPLIES", 1, 8, 8, 0, 8, 16, false},
+};
+}
+
+#endif
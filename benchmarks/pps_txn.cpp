@@ -24,13 +24,17 @@
 #include "row.h"
 #include "index_hash.h"
 #include "index_btree.h"
+#include "index_art.h"
 #include "transport.h"
 #include "msg_queue.h"
 #include "message.h"
+#include "pps_schema.h"
+#include "mem_alloc.h"
 
 void PPSTxnManager::init(uint64_t thd_id, Workload * h_wl) {
     TxnManager::init(thd_id, h_wl);
     _wl = (PPSWorkload *) h_wl;
+    part_items = (itemid_t **) mem_allocator.alloc(sizeof(itemid_t *) * g_max_parts_per);
     reset();
 	TxnManager::reset();
 }
@@ -67,7 +71,8 @@ void PPSTxnManager::reset() {
     }
 
     parts_processed_count = 0;
-    pps_query->part_keys.clear();
+    part_item_cnt = 0;
+    pps_query->recon_keys.clear();
     TxnManager::reset();
 }
 
@@ -133,14 +138,18 @@ bool PPSTxnManager::is_done() {
   return done;
 }
 
-RC PPSTxnManager::acquire_locks() {
+RC PPSTxnManager::acquire_locks(uint64_t lock_part) {
   uint64_t starttime = get_sys_clock();
-  assert(CC_ALG == CALVIN);
+  assert(CC_ALG == CALVIN || CC_ALG == VLL);
   locking_done = false;
   RC rc = RCOK;
   RC rc2 = RCOK;
   INDEX * index;
   itemid_t * item;
+  // every lock thread reads the secondary index, so the matches are its own
+  itemid_t * lock_items[MAX_PPS_PARTS_PER];
+  uint64_t lock_item_cnt;
+  assert(g_max_parts_per <= MAX_PPS_PARTS_PER);
   incr_lr();
   PPSQuery* pps_query = (PPSQuery*) query;
   uint64_t part_key = pps_query->part_key;
@@ -150,66 +159,66 @@ RC PPSTxnManager::acquire_locks() {
   uint64_t partition_id_product = products_to_partition(pps_query->product_key);
   uint64_t partition_id_supplier = suppliers_to_partition(pps_query->supplier_key);
 
+  // a row's primary key is its index key, and the SUPPLIES and USES rows of
+  // a supplier or product share its key. The index is only read for rows
+  // this lock thread owns
   switch(pps_query->txn_type) {
     case PPS_GETPART:
-      if(GET_NODE_ID(partition_id_part) == g_node_id) {
+      if(GET_NODE_ID(partition_id_part) == g_node_id && calvin_owns_row(part_key,lock_part)) {
         index = _wl->i_parts;
         item = index_read(index, part_key, partition_id_part);
         row_t * row = ((row_t *)item->location);
-        rc2 = get_lock(row,RD);
+        rc2 = get_lock(row,RD,lock_part);
         if(rc2 != RCOK)
           rc = rc2;
       }
       break;
     case PPS_GETPRODUCT:
-      if(GET_NODE_ID(partition_id_product) == g_node_id) {
+      if(GET_NODE_ID(partition_id_product) == g_node_id && calvin_owns_row(product_key,lock_part)) {
         index = _wl->i_products;
         item = index_read(index, product_key, partition_id_product);
         row_t * row = ((row_t *)item->location);
-        rc2 = get_lock(row,RD);
+        rc2 = get_lock(row,RD,lock_part);
         if(rc2 != RCOK)
           rc = rc2;
       }
       break;
     case PPS_GETSUPPLIER:
-      if(GET_NODE_ID(partition_id_supplier) == g_node_id) {
+      if(GET_NODE_ID(partition_id_supplier) == g_node_id && calvin_owns_row(supplier_key,lock_part)) {
         index = _wl->i_suppliers;
         item = index_read(index, supplier_key, partition_id_supplier);
         row_t * row = ((row_t *)item->location);
-        rc2 = get_lock(row,RD);
+        rc2 = get_lock(row,RD,lock_part);
         if(rc2 != RCOK)
           rc = rc2;
       }
       break;
     case PPS_GETPARTBYSUPPLIER:
-      if(GET_NODE_ID(partition_id_supplier) == g_node_id) {
+      if(GET_NODE_ID(partition_id_supplier) == g_node_id && calvin_owns_row(supplier_key,lock_part)) {
         index = _wl->i_suppliers;
         item = index_read(index, supplier_key, partition_id_supplier);
         row_t * row = ((row_t *)item->location);
-        rc2 = get_lock(row,RD);
+        rc2 = get_lock(row,RD,lock_part);
         if(rc2 != RCOK)
           rc = rc2;
 
         index = _wl->i_supplies;
-        int count = 0;
-        item = index_read(index, supplier_key, partition_id_product,count);
-        while (item != NULL) {
-            count++;
-            row_t * row = ((row_t *)item->location);
-            rc2 = get_lock(row,RD);
+        lock_item_cnt = index_read_multiple(index, supplier_key, partition_id_supplier, lock_items, g_max_parts_per);
+        for (uint64_t i = 0; i < lock_item_cnt && i < g_max_parts_per; i++) {
+            row_t * row = ((row_t *)lock_items[i]->location);
+            rc2 = get_lock(row,RD,lock_part);
             if(rc2 != RCOK)
               rc = rc2;
-            item = index_read(index, supplier_key, partition_id_product,count);
         }
       }
-      for (uint64_t i = 0; i < pps_query->part_keys.size(); i++) {
-          uint64_t key = pps_query->part_keys[i];
+      for (uint64_t i = 0; i < pps_query->recon_keys.size(); i++) {
+          uint64_t key = pps_query->recon_keys[i];
           uint64_t pid = parts_to_partition(key);
-          if(GET_NODE_ID(pid) == g_node_id) {
+          if(GET_NODE_ID(pid) == g_node_id && calvin_owns_row(key,lock_part)) {
             index = _wl->i_parts;
             item = index_read(index, key, pid);
             row_t * row = ((row_t *)item->location);
-            rc2 = get_lock(row,RD);
+            rc2 = get_lock(row,RD,lock_part);
             if(rc2 != RCOK)
               rc = rc2;
           }
@@ -217,34 +226,31 @@ RC PPSTxnManager::acquire_locks() {
 
       break;
     case PPS_GETPARTBYPRODUCT:
-        if(GET_NODE_ID(partition_id_product) == g_node_id) {
+        if(GET_NODE_ID(partition_id_product) == g_node_id && calvin_owns_row(product_key,lock_part)) {
           index = _wl->i_products;
           item = index_read(index, product_key, partition_id_product);
           row_t * row = ((row_t *)item->location);
-          rc2 = get_lock(row,RD);
+          rc2 = get_lock(row,RD,lock_part);
           if(rc2 != RCOK)
             rc = rc2;
 
           index = _wl->i_uses;
-          int count = 0;
-          item = index_read(index, product_key, partition_id_product,count);
-          while (item != NULL) {
-              count++;
-              row_t * row = ((row_t *)item->location);
-              rc2 = get_lock(row,RD);
+          lock_item_cnt = index_read_multiple(index, product_key, partition_id_product, lock_items, g_max_parts_per);
+          for (uint64_t i = 0; i < lock_item_cnt && i < g_max_parts_per; i++) {
+              row_t * row = ((row_t *)lock_items[i]->location);
+              rc2 = get_lock(row,RD,lock_part);
               if(rc2 != RCOK)
                 rc = rc2;
-              item = index_read(index, product_key, partition_id_product,count);
           }
         }
-        for (uint64_t i = 0; i < pps_query->part_keys.size(); i++) {
-            uint64_t key = pps_query->part_keys[i];
+        for (uint64_t i = 0; i < pps_query->recon_keys.size(); i++) {
+            uint64_t key = pps_query->recon_keys[i];
             uint64_t pid = parts_to_partition(key);
-            if(GET_NODE_ID(pid) == g_node_id) {
+            if(GET_NODE_ID(pid) == g_node_id && calvin_owns_row(key,lock_part)) {
               index = _wl->i_parts;
               item = index_read(index, key, pid);
               row_t * row = ((row_t *)item->location);
-              rc2 = get_lock(row,RD);
+              rc2 = get_lock(row,RD,lock_part);
               if(rc2 != RCOK)
                 rc = rc2;
             }
@@ -252,34 +258,31 @@ RC PPSTxnManager::acquire_locks() {
 
       break;
     case PPS_ORDERPRODUCT:
-      if(GET_NODE_ID(partition_id_product) == g_node_id) {
+      if(GET_NODE_ID(partition_id_product) == g_node_id && calvin_owns_row(product_key,lock_part)) {
         index = _wl->i_products;
         item = index_read(index, product_key, partition_id_product);
         row_t * row = ((row_t *)item->location);
-        rc2 = get_lock(row,RD);
+        rc2 = get_lock(row,RD,lock_part);
         if(rc2 != RCOK)
           rc = rc2;
 
         index = _wl->i_uses;
-        int count = 0;
-        item = index_read(index, product_key, partition_id_product,count);
-        while (item != NULL) {
-            count++;
-            row_t * row = ((row_t *)item->location);
-            rc2 = get_lock(row,RD);
+        lock_item_cnt = index_read_multiple(index, product_key, partition_id_product, lock_items, g_max_parts_per);
+        for (uint64_t i = 0; i < lock_item_cnt && i < g_max_parts_per; i++) {
+            row_t * row = ((row_t *)lock_items[i]->location);
+            rc2 = get_lock(row,RD,lock_part);
             if(rc2 != RCOK)
               rc = rc2;
-            item = index_read(index, product_key, partition_id_product,count);
         }
       }
-      for (uint64_t i = 0; i < pps_query->part_keys.size(); i++) {
-          uint64_t key = pps_query->part_keys[i];
+      for (uint64_t i = 0; i < pps_query->recon_keys.size(); i++) {
+          uint64_t key = pps_query->recon_keys[i];
           uint64_t pid = parts_to_partition(key);
-          if(GET_NODE_ID(pid) == g_node_id) {
+          if(GET_NODE_ID(pid) == g_node_id && calvin_owns_row(key,lock_part)) {
             index = _wl->i_parts;
             item = index_read(index, key, pid);
             row_t * row = ((row_t *)item->location);
-            rc2 = get_lock(row,WR);
+            rc2 = get_lock(row,WR,lock_part);
             if(rc2 != RCOK)
               rc = rc2;
           }
@@ -287,21 +290,21 @@ RC PPSTxnManager::acquire_locks() {
 
       break;
     case PPS_UPDATEPRODUCTPART:
-      if(GET_NODE_ID(partition_id_product) == g_node_id) {
+      if(GET_NODE_ID(partition_id_product) == g_node_id && calvin_owns_row(product_key,lock_part)) {
         index = _wl->i_products;
         item = index_read(index, product_key, partition_id_product);
         row_t * row = ((row_t *)item->location);
-        rc2 = get_lock(row,WR);
+        rc2 = get_lock(row,WR,lock_part);
         if(rc2 != RCOK)
           rc = rc2;
       }
       break;
     case PPS_UPDATEPART:
-      if(GET_NODE_ID(partition_id_part) == g_node_id) {
+      if(GET_NODE_ID(partition_id_part) == g_node_id && calvin_owns_row(part_key,lock_part)) {
         index = _wl->i_parts;
         item = index_read(index, part_key, partition_id_part);
         row_t * row = ((row_t *)item->location);
-        rc2 = get_lock(row,WR);
+        rc2 = get_lock(row,WR,lock_part);
         if(rc2 != RCOK)
           rc = rc2;
       }
@@ -748,21 +751,30 @@ inline RC PPSTxnManager::run_getpartsbyproduct_1(row_t *& r_local) {
   return RCOK;
 }
 
+// The parts_processed_count-th entry of key, or NULL past the last one. 
+// The entries are read from the index when the first one is asked for.
+row_t * PPSTxnManager::get_part_row(INDEX * index, uint64_t key, uint64_t part_id) {
+  if (parts_processed_count == 0) {
+    part_item_cnt = index_read_multiple(index, key, part_id, part_items, g_max_parts_per);
+    if (part_item_cnt > g_max_parts_per)
+      part_item_cnt = g_max_parts_per;
+  }
+  if (parts_processed_count >= part_item_cnt)
+    return NULL;
+  return (row_t *) part_items[parts_processed_count]->location;
+}
+
 inline RC PPSTxnManager::run_getpartsbyproduct_2(uint64_t product_key, row_t *& r_local) {
   /*
     SELECT PART_KEY FROM USES WHERE PRODUCT_KEY = ? 
    */
   DEBUG("Getting product_key %ld count %ld\n",product_key,parts_processed_count);
     RC rc;
-    itemid_t * item;
-		INDEX * index = _wl->i_uses;
-		item = index_read(index, product_key, products_to_partition(product_key),parts_processed_count);
-    if (item == NULL) {
+    row_t * r_loc = get_part_row(_wl->i_uses, product_key, products_to_partition(product_key));
+    if (r_loc == NULL) {
       r_local = NULL;
       return RCOK;
     }
-		assert(item != NULL);
-		row_t* r_loc = (row_t *) item->location;
     rc = get_row(r_loc, RD, r_local);
   DEBUG("From product_key %ld -- %lx\n",product_key,(uint64_t)r_local);
     return rc;
@@ -775,8 +787,7 @@ inline RC PPSTxnManager::run_getpartsbyproduct_3(uint64_t &part_key, row_t *& r_
   //r_local->get_value(PART_KEY,part_key);
   //char * data __attribute__((unused));
   //data = r_local->get_data();
-  // PART_KEY is located at column 1
-  r_local->get_value(1,part_key);
+  r_local->get_value<pps_schema::USES::PART_KEY>(part_key);
   DEBUG("Read part_key %ld\n",part_key);
   return RCOK;
 }
@@ -833,15 +844,11 @@ inline RC PPSTxnManager::run_orderproduct_2(uint64_t product_key, row_t *& r_loc
      */
     DEBUG("Getting product_key %ld count %ld\n",product_key,parts_processed_count);
     RC rc;
-    itemid_t * item;
-    INDEX * index = _wl->i_uses;
-    item = index_read(index, product_key, products_to_partition(product_key),parts_processed_count);
-    if (item == NULL) {
+    row_t * r_loc = get_part_row(_wl->i_uses, product_key, products_to_partition(product_key));
+    if (r_loc == NULL) {
         r_local = NULL;
         return RCOK;
     }
-    assert(item != NULL);
-    row_t* r_loc = (row_t *) item->location;
     rc = get_row(r_loc, RD, r_local);
     DEBUG("From product_key %ld -- %lx\n",product_key,(uint64_t)r_local);
     return rc;
@@ -854,8 +861,7 @@ inline RC PPSTxnManager::run_orderproduct_3(uint64_t &part_key, row_t *& r_local
   //r_local->get_value(PART_KEY,part_key);
   //char * data __attribute__((unused));
   //data = r_local->get_data();
-  // PART_KEY is located at column 1
-  r_local->get_value(1,part_key);
+  r_local->get_value<pps_schema::USES::PART_KEY>(part_key);
   DEBUG("Read part_key %ld\n",part_key);
   return RCOK;
 }
@@ -883,8 +889,8 @@ inline RC PPSTxnManager::run_orderproduct_5(row_t *& r_local) {
   // update
   // If part_amount is 0, should abort
   uint64_t part_amount;
-  r_local->get_value(PART_AMOUNT,part_amount);
-  r_local->set_value(PART_AMOUNT,part_amount-1);
+  r_local->get_value<pps_schema::PARTS::PART_AMOUNT>(part_amount);
+  r_local->set_value<pps_schema::PARTS::PART_AMOUNT>(part_amount-1);
   return RCOK;
 }
 
@@ -916,15 +922,11 @@ inline RC PPSTxnManager::run_getpartsbysupplier_2(uint64_t supplier_key, row_t *
     SELECT PART_KEY FROM USES WHERE supplier_KEY = ? 
    */
     RC rc;
-    itemid_t * item;
-    INDEX * index = _wl->i_supplies;
-    item = index_read(index, supplier_key, suppliers_to_partition(supplier_key),parts_processed_count);
-    if (item == NULL) {
+    row_t * r_loc = get_part_row(_wl->i_supplies, supplier_key, suppliers_to_partition(supplier_key));
+    if (r_loc == NULL) {
         r_local = NULL;
         return RCOK;
     }
-    assert(item != NULL);
-    row_t* r_loc = (row_t *) item->location;
     rc = get_row(r_loc, RD, r_local);
     return rc;
 }
@@ -932,7 +934,7 @@ inline RC PPSTxnManager::run_getpartsbysupplier_3(uint64_t &part_key, row_t *& r
   /*
     SELECT PART_KEY FROM USES WHERE supplier_KEY = ? 
    */
-    r_local->get_value(1,part_key);
+    r_local->get_value<pps_schema::SUPPLIES::PART_KEY>(part_key);
     DEBUG("Read part_key %ld\n",part_key);
     return RCOK;
 }
@@ -977,7 +979,7 @@ inline RC PPSTxnManager::run_updateproductpart_1(uint64_t part_key, row_t *& r_l
     UPDATE PART_KEY FROM PRODUCTS WHERE PRODUCT_KEY = ? 
    */
   assert(r_local);
-  r_local->set_value(1,part_key);
+  r_local->set_value<pps_schema::USES::PART_KEY>(part_key);
   return RCOK;
 }
 
@@ -1000,8 +1002,8 @@ inline RC PPSTxnManager::run_updatepart_1(row_t *& r_local) {
    */
   assert(r_local);
   uint64_t amount;
-  r_local->get_value(1,amount);
-  r_local->set_value(1,amount+100);
+  r_local->get_value<pps_schema::PARTS::PART_AMOUNT>(amount);
+  r_local->set_value<pps_schema::PARTS::PART_AMOUNT>(amount+100);
   return RCOK;
 }
 
@@ -1122,12 +1124,12 @@ RC PPSTxnManager::run_pps_phase2() {
                 ++parts_processed_count;
                 rc = run_getpartsbysupplier_3(part_key, row);
                 if (isRecon()) {
-                    pps_query->part_keys.add(part_key);
+                    pps_query->recon_keys.add(part_key);
                 }
                 else {
                     break;
                     // check if the parts have changed since we did recon
-                    if (!pps_query->part_keys.contains(part_key)) {
+                    if (!pps_query->recon_keys.contains(part_key)) {
                         txn->rc = Abort;
                         break;
                     }
@@ -1140,8 +1142,8 @@ RC PPSTxnManager::run_pps_phase2() {
             break;
         }
         if (!isRecon()) {
-            for (uint64_t key = 0; key < pps_query->part_keys.size();key++) {
-                part_key = pps_query->part_keys[key];
+            for (uint64_t key = 0; key < pps_query->recon_keys.size();key++) {
+                part_key = pps_query->recon_keys[key];
                 part_loc = GET_NODE_ID(parts_to_partition(part_key)) == g_node_id;
                 if (part_loc) {
                     rc = run_getpartsbysupplier_4(part_key, row);
@@ -1159,11 +1161,11 @@ RC PPSTxnManager::run_pps_phase2() {
                 ++parts_processed_count;
                 rc = run_getpartsbyproduct_3(part_key, row);
                 if (isRecon()) {
-                    pps_query->part_keys.add(part_key);
+                    pps_query->recon_keys.add(part_key);
                 }
                 else {
                     // check if the parts have changed since we did recon
-                    if (!pps_query->part_keys.contains(part_key)) {
+                    if (!pps_query->recon_keys.contains(part_key)) {
                         txn->rc = Abort;
                         break;
                     }
@@ -1176,8 +1178,8 @@ RC PPSTxnManager::run_pps_phase2() {
             break;
         }
         if (!isRecon()) {
-            for (uint64_t key = 0; key < pps_query->part_keys.size();key++) {
-                part_key = pps_query->part_keys[key];
+            for (uint64_t key = 0; key < pps_query->recon_keys.size();key++) {
+                part_key = pps_query->recon_keys[key];
                 part_loc = GET_NODE_ID(parts_to_partition(part_key)) == g_node_id;
                 if (part_loc) {
                     rc = run_getpartsbyproduct_4(part_key, row);
@@ -1195,11 +1197,11 @@ RC PPSTxnManager::run_pps_phase2() {
                 ++parts_processed_count;
                 rc = run_orderproduct_3(part_key, row);
                 if (isRecon()) {
-                    pps_query->part_keys.add(part_key);
+                    pps_query->recon_keys.add(part_key);
                 }
                 else {
                     // check if the parts have changed since we did recon
-                    if (!pps_query->part_keys.contains(part_key)) {
+                    if (!pps_query->recon_keys.contains(part_key)) {
                         txn->rc = Abort;
                         break;
                     }
@@ -1241,8 +1243,8 @@ RC PPSTxnManager::run_pps_phase5() {
   case PPS_GETPARTBYPRODUCT:
       break;
   case PPS_ORDERPRODUCT:
-      for (uint64_t key = 0; key < pps_query->part_keys.size();key++) {
-          part_key = pps_query->part_keys[key];
+      for (uint64_t key = 0; key < pps_query->recon_keys.size();key++) {
+          part_key = pps_query->recon_keys[key];
           part_loc = GET_NODE_ID(parts_to_partition(part_key)) == g_node_id;
           if (part_loc) {
               rc = run_orderproduct_4(part_key, row);
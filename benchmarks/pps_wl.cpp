@@ -22,11 +22,13 @@
 #include "table.h"
 #include "index_hash.h"
 #include "index_btree.h"
+#include "index_art.h"
 #include "pps_helper.h"
 #include "row.h"
 #include "query.h"
 #include "txn.h"
 #include "mem_alloc.h"
+#include "pps_schema.h"
 
 RC PPSWorkload::init() {
 	Workload::init();
@@ -54,6 +56,7 @@ RC PPSWorkload::init() {
 
 RC PPSWorkload::init_schema(const char * schema_file) {
 	Workload::init_schema(schema_file);
+	check_schema(pps_schema::columns, sizeof(pps_schema::columns) / sizeof(static_column));
 	t_suppliers = tables["SUPPLIERS"];
 	t_products = tables["PRODUCTS"];
 	t_parts = tables["PARTS"];
@@ -119,7 +122,7 @@ void PPSWorkload::init_tab_parts() {
       continue;
 		row_t * row;
 		uint64_t row_id;
-    t_parts->get_new_row(row, 0, row_id);
+    t_parts->get_new_row(row, parts_to_partition(id), row_id);
     row->set_primary_key(id);
     row->set_value(0,id); // part id
     row->set_value(PART_AMOUNT,1000); // # of parts
@@ -150,7 +153,7 @@ void PPSWorkload::init_tab_suppliers() {
       continue;
 		row_t * row;
 		uint64_t row_id;
-    t_suppliers->get_new_row(row, 0, row_id);
+    t_suppliers->get_new_row(row, suppliers_to_partition(id), row_id);
     row->set_primary_key(id);
     row->set_value(0,id);
     row->set_value(FIELD1,padding);
@@ -179,7 +182,7 @@ void PPSWorkload::init_tab_products() {
       continue;
 		row_t * row;
 		uint64_t row_id;
-    t_products->get_new_row(row, 0, row_id);
+    t_products->get_new_row(row, products_to_partition(id), row_id);
     row->set_primary_key(id);
     row->set_value(0,id);
     row->set_value(FIELD1,padding);
@@ -209,7 +212,7 @@ void PPSWorkload::init_tab_supplies() {
       row_t * row;
       uint64_t row_id;
       uint64_t part_id = *it;
-      t_supplies->get_new_row(row, 0, row_id);
+      t_supplies->get_new_row(row, suppliers_to_partition(id), row_id);
       row->set_primary_key(id);
       //row->set_value(SUPPLIER_KEY,id);
       //row->set_value(PART_KEY,part_id);
@@ -231,7 +234,7 @@ void PPSWorkload::init_tab_uses() {
       row_t * row;
       uint64_t row_id;
       uint64_t part_id = *it;
-      t_uses->get_new_row(row, 0, row_id);
+      t_uses->get_new_row(row, products_to_partition(id), row_id);
       row->set_primary_key(id);
       //row->set_value(PRODUCT_KEY,id);
       //row->set_value(PART_KEY,part_id);
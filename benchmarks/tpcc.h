@@ -26,6 +26,9 @@ class TPCCQuery;
 class TPCCQueryMessage;
 struct Item_no;
 
+// matches returned by a customer lookup by last name
+#define MAX_CUST_PER_LAST 64
+
 class table_t;
 class INDEX;
 class TPCCQuery;
@@ -48,6 +51,14 @@ enum TPCCRemTxnType {
   TPCC_NEWORDER7,
   TPCC_NEWORDER8,
   TPCC_NEWORDER9,
+  TPCC_DELIVERY_S,
+  TPCC_DELIVERY0,
+  TPCC_DELIVERY1,
+  TPCC_DELIVERY2,
+  TPCC_DELIVERY3,
+  TPCC_DELIVERY4,
+  TPCC_DELIVERY5,
+  TPCC_DELIVERY6,
   TPCC_FIN,
   TPCC_RDONE};
 
@@ -58,6 +69,8 @@ public:
 	RC init_table();
 	RC init_schema(const char * schema_file);
 	RC get_txn_man(TxnManager *& txn_manager);
+	idx_key_t index_key(INDEX * index, row_t * row);
+	void index_remove_row(row_t * row, uint64_t thd_id);
 	table_t * 		t_warehouse;
 	table_t * 		t_district;
 	table_t * 		t_customer;
@@ -79,15 +92,17 @@ public:
 //	INDEX * 	i_order_wdc; // key = (w_id, d_id, c_id)
 	INDEX * 	i_orderline; // key = (w_id, d_id, o_id)
 	INDEX * 	i_orderline_wd; // key = (w_id, d_id). 
-	
-	// XXX HACK
-	// For delivary. Only one txn can be delivering a warehouse at a time.
-	// *_delivering[warehouse_id] -> the warehouse is delivering.
-	bool ** delivering;
-//	bool volatile ** delivering;
+	INDEX * 	i_neworder; // key = (w_id, d_id, o_id)
+
+	// Oldest undelivered order of a district, i.e. the smallest NO_O_ID in 
+	// NEW-ORDER_IDX. Delivery probes this order and moves the cursor when 
+	// it commits the delete of the NEW-ORDER row.
+	uint64_t get_delivery_o_id(uint64_t w_id, uint64_t d_id);
 
 private:
 	uint64_t num_wh;
+	// [distKey(d_id, w_id)]
+	volatile uint64_t * delivery_o_id;
 	void init_tab_item(int id);
 	void init_tab_wh();
 	void init_tab_dist(uint64_t w_id);
@@ -96,6 +111,8 @@ private:
 	void init_tab_cust(int id, uint64_t d_id, uint64_t w_id);
 	void init_tab_hist(uint64_t c_id, uint64_t d_id, uint64_t w_id);
 	void init_tab_order(int id,uint64_t d_id, uint64_t w_id);
+	// checks the loaded tables of this node's partitions with table scans
+	void check_table();
 	
 	UInt32 perm_count;
 	uint64_t * perm_c_id;
@@ -122,7 +139,7 @@ class TPCCTxnManager : public TxnManager
 public:
 	void init(uint64_t thd_id, Workload * h_wl);
   void reset();
-  RC acquire_locks(); 
+  RC acquire_locks(uint64_t lock_part); 
 	RC run_txn();
 	RC run_txn_post_wait();
 	RC run_calvin_txn(); 
@@ -137,12 +154,25 @@ private:
 
   uint64_t next_item_id;
 
+  // Delivery: the district being delivered, its oldest new order and the
+  // lines of that order
+  uint64_t deliv_d_id;
+  uint64_t deliv_o_id;
+  uint64_t deliv_c_id;
+  row_t * deliv_no_row;
+  itemid_t ** deliv_ol_items;
+  uint64_t deliv_ol_max;
+  uint64_t deliv_ol_cnt;
+  uint64_t deliv_ol_idx;
+  double deliv_amount;
+
 void next_tpcc_state();
 RC run_txn_state();
   bool is_done();
   bool is_local_item(uint64_t idx);
   RC send_remote_request(); 
 
+	row_t * get_cust_by_last(char * c_last, uint64_t c_d_id, uint64_t c_w_id);
 	RC run_payment_0(uint64_t w_id, uint64_t d_id, uint64_t d_w_id, double h_amount, row_t *& r_wh_local);
 	RC run_payment_1(uint64_t w_id, uint64_t d_id, uint64_t d_w_id, double h_amount, row_t * r_wh_local);
 	RC run_payment_2(uint64_t w_id, uint64_t d_id, uint64_t d_w_id, double h_amount, row_t *& r_dist_local);
@@ -159,8 +189,14 @@ RC run_txn_state();
 	RC new_order_7(uint64_t ol_i_id, row_t * r_item_local);
 	RC new_order_8(uint64_t w_id,uint64_t  d_id,bool remote, uint64_t ol_i_id, uint64_t ol_supply_w_id, uint64_t ol_quantity,uint64_t  ol_number,uint64_t  o_id, row_t *& r_stock_local);
 	RC new_order_9(uint64_t w_id,uint64_t  d_id,bool remote, uint64_t ol_i_id, uint64_t ol_supply_w_id, uint64_t ol_quantity,uint64_t  ol_number,uint64_t ol_amount, uint64_t  o_id, row_t * r_stock_local);
+	RC delivery_0(uint64_t w_id, row_t *& r_no_local);
+	RC delivery_1(uint64_t w_id, row_t *& r_order_local);
+	RC delivery_2(uint64_t w_id, uint64_t o_carrier_id, row_t * r_order_local);
+	RC delivery_3(row_t *& r_ol_local);
+	RC delivery_4(uint64_t ol_delivery_d, row_t * r_ol_local);
+	RC delivery_5(uint64_t w_id, row_t *& r_cust_local);
+	RC delivery_6(row_t * r_cust_local);
 	RC run_order_status(TPCCQuery * query);
-	RC run_delivery(TPCCQuery * query);
 	RC run_stock_level(TPCCQuery * query);
 };
 
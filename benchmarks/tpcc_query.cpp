@@ -27,6 +27,11 @@ BaseQuery * TPCCQueryGenerator::create_query(Workload * h_wl,uint64_t home_parti
   double x = (double)(rand() % 100) / 100.0;
 	if (x < g_perc_payment)
 		return gen_payment(home_partition_id);
+// Calvin and VLL lock up front; acquire_locks has no Delivery lock set
+#if CC_ALG != CALVIN && CC_ALG != VLL && !TPCC_SMALL
+	else if (x < g_perc_payment + g_perc_delivery)
+		return gen_delivery(home_partition_id);
+#endif
 	else 
 		return gen_new_order(home_partition_id);
 
@@ -34,11 +39,15 @@ BaseQuery * TPCCQueryGenerator::create_query(Workload * h_wl,uint64_t home_parti
 
 void TPCCQuery::init(uint64_t thd_id, Workload * h_wl) {
   items.init(g_max_items_per_txn);
+  // the customer a payment by last name picks
+  recon_keys.init(1);
   BaseQuery::init();
 }
 
 void TPCCQuery::init() {
   items.init(g_max_items_per_txn);
+  // the customer a payment by last name picks
+  recon_keys.init(1);
   BaseQuery::init();
 }
 
@@ -75,6 +84,9 @@ std::set<uint64_t> TPCCQuery::participants(Message * msg, Workload * wl) {
   switch(tpcc_msg->txn_type) {
     case TPCC_PAYMENT:
       id = GET_NODE_ID(wh_to_part(tpcc_msg->c_w_id));
+      // the recon run only looks up the customer
+      if(tpcc_msg->recon)
+        participant_set.clear();
       participant_set.insert(id);
       break;
     case TPCC_NEW_ORDER: 
@@ -83,6 +95,8 @@ std::set<uint64_t> TPCCQuery::participants(Message * msg, Workload * wl) {
         participant_set.insert(req_nid);
       }
       break;
+    case TPCC_DELIVERY:
+      break;
     default: assert(false);
   }
 
@@ -136,6 +150,13 @@ uint64_t TPCCQuery::participants(bool *& pps,Workload * wl) {
         }
       }
       break;
+    case TPCC_DELIVERY:
+      id = GET_NODE_ID(wh_to_part(w_id));
+      if(!pps[id]) {
+        pps[id] = true;
+        n++;
+      }
+      break;
     default: assert(false);
   }
 
@@ -262,6 +283,24 @@ BaseQuery * TPCCQueryGenerator::gen_new_order(uint64_t home_partition) {
 
 }
 
+// Delivery reads the new orders of all districts of one warehouse. Unlike 
+// the other transactions it always runs on the node of its warehouse.
+BaseQuery * TPCCQueryGenerator::gen_delivery(uint64_t home_partition) {
+  TPCCQuery * query = new TPCCQuery;
+
+	query->txn_type = TPCC_DELIVERY;
+  while(GET_NODE_ID(wh_to_part(query->w_id = URand(1, g_num_wh))) != home_partition) {}
+	query->d_w_id = query->w_id;
+	query->c_w_id = query->w_id;
+	query->o_carrier_id = URand(1, 10);
+	query->ol_delivery_d = 2013;
+	query->rbk = false;
+
+  query->partitions.init(1);
+  query->partitions.add(wh_to_part(query->w_id));
+  return query;
+}
+
 uint64_t TPCCQuery::get_participants(Workload * wl) {
    uint64_t participant_cnt = 0;
    uint64_t active_cnt = 0;
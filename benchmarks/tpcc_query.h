@@ -47,6 +47,7 @@ private:
 	BaseQuery * gen_requests(uint64_t home_partition_id, Workload * h_wl);
   BaseQuery * gen_payment(uint64_t home_partition); 
   BaseQuery * gen_new_order(uint64_t home_partition); 
+  BaseQuery * gen_delivery(uint64_t home_partition); 
 	myrand * mrand;
 };
 
@@ -62,6 +63,9 @@ public:
   uint64_t participants(bool *& pps,Workload * wl); 
   uint64_t get_participants(Workload * wl); 
   bool readonly();
+  virtual bool isReconQuery() {
+    return txn_type == TPCC_PAYMENT && by_last_name;
+  }
 
 	TPCCTxnType txn_type;
 	// common txn input for both payment & new-order
@@ -0,0 +1,525 @@
+// Generated by scripts/gen_schema.py. Do not edit.
+#ifndef _TPCC_SCHEMA_H_
+#define _TPCC_SCHEMA_H_
+
+#include "global.h"
+#include "catalog.h"
+
+#if TPCC_SMALL
+// TPCC_short_schema.txt
+namespace tpcc_schema {
+namespace WAREHOUSE {
+	struct W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 105 }; };
+	struct W_NAME { typedef char type; static const bool pax = false;
+		enum { id = 1, size = 10, index = 8, group = 0, group_index = 8, group_size = 105 }; };
+	struct W_STREET_1 { typedef char type; static const bool pax = false;
+		enum { id = 2, size = 20, index = 18, group = 0, group_index = 18, group_size = 105 }; };
+	struct W_STREET_2 { typedef char type; static const bool pax = false;
+		enum { id = 3, size = 20, index = 38, group = 0, group_index = 38, group_size = 105 }; };
+	struct W_CITY { typedef char type; static const bool pax = false;
+		enum { id = 4, size = 20, index = 58, group = 0, group_index = 58, group_size = 105 }; };
+	struct W_STATE { typedef char type; static const bool pax = false;
+		enum { id = 5, size = 2, index = 78, group = 0, group_index = 78, group_size = 105 }; };
+	struct W_ZIP { typedef char type; static const bool pax = false;
+		enum { id = 6, size = 9, index = 80, group = 0, group_index = 80, group_size = 105 }; };
+	struct W_TAX { typedef double type; static const bool pax = false;
+		enum { id = 7, size = 8, index = 89, group = 0, group_index = 89, group_size = 105 }; };
+	struct W_YTD { typedef double type; static const bool pax = false;
+		enum { id = 8, size = 8, index = 97, group = 0, group_index = 97, group_size = 105 }; };
+}
+namespace DISTRICT {
+	struct D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 121 }; };
+	struct D_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 121 }; };
+	struct D_NAME { typedef char type; static const bool pax = false;
+		enum { id = 2, size = 10, index = 16, group = 0, group_index = 16, group_size = 121 }; };
+	struct D_STREET_1 { typedef char type; static const bool pax = false;
+		enum { id = 3, size = 20, index = 26, group = 0, group_index = 26, group_size = 121 }; };
+	struct D_STREET_2 { typedef char type; static const bool pax = false;
+		enum { id = 4, size = 20, index = 46, group = 0, group_index = 46, group_size = 121 }; };
+	struct D_CITY { typedef char type; static const bool pax = false;
+		enum { id = 5, size = 20, index = 66, group = 0, group_index = 66, group_size = 121 }; };
+	struct D_STATE { typedef char type; static const bool pax = false;
+		enum { id = 6, size = 2, index = 86, group = 0, group_index = 86, group_size = 121 }; };
+	struct D_ZIP { typedef char type; static const bool pax = false;
+		enum { id = 7, size = 9, index = 88, group = 0, group_index = 88, group_size = 121 }; };
+	struct D_TAX { typedef double type; static const bool pax = false;
+		enum { id = 8, size = 8, index = 97, group = 0, group_index = 97, group_size = 121 }; };
+	struct D_YTD { typedef double type; static const bool pax = false;
+		enum { id = 9, size = 8, index = 105, group = 0, group_index = 105, group_size = 121 }; };
+	struct D_NEXT_O_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 10, size = 8, index = 113, group = 0, group_index = 113, group_size = 121 }; };
+}
+namespace CUSTOMER {
+	struct C_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 78 }; };
+	struct C_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 78 }; };
+	struct C_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 78 }; };
+	struct C_MIDDLE { typedef char type; static const bool pax = false;
+		enum { id = 3, size = 2, index = 24, group = 0, group_index = 24, group_size = 78 }; };
+	struct C_LAST { typedef char type; static const bool pax = false;
+		enum { id = 4, size = 16, index = 26, group = 0, group_index = 26, group_size = 78 }; };
+	struct C_STATE { typedef char type; static const bool pax = false;
+		enum { id = 5, size = 2, index = 42, group = 0, group_index = 42, group_size = 78 }; };
+	struct C_CREDIT { typedef char type; static const bool pax = false;
+		enum { id = 6, size = 2, index = 44, group = 0, group_index = 44, group_size = 78 }; };
+	struct C_DISCOUNT { typedef int64_t type; static const bool pax = false;
+		enum { id = 7, size = 8, index = 46, group = 0, group_index = 46, group_size = 78 }; };
+	struct C_BALANCE { typedef double type; static const bool pax = false;
+		enum { id = 8, size = 8, index = 54, group = 0, group_index = 54, group_size = 78 }; };
+	struct C_YTD_PAYMENT { typedef double type; static const bool pax = false;
+		enum { id = 9, size = 8, index = 62, group = 0, group_index = 62, group_size = 78 }; };
+	struct C_PAYMENT_CNT { typedef uint64_t type; static const bool pax = false;
+		enum { id = 10, size = 8, index = 70, group = 0, group_index = 70, group_size = 78 }; };
+}
+namespace HISTORY {
+	struct H_C_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 56 }; };
+	struct H_C_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 56 }; };
+	struct H_C_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 56 }; };
+	struct H_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 3, size = 8, index = 24, group = 0, group_index = 24, group_size = 56 }; };
+	struct H_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 4, size = 8, index = 32, group = 0, group_index = 32, group_size = 56 }; };
+	struct H_DATE { typedef int64_t type; static const bool pax = false;
+		enum { id = 5, size = 8, index = 40, group = 0, group_index = 40, group_size = 56 }; };
+	struct H_AMOUNT { typedef double type; static const bool pax = false;
+		enum { id = 6, size = 8, index = 48, group = 0, group_index = 48, group_size = 56 }; };
+}
+namespace NEW_ORDER {
+	struct NO_O_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 24 }; };
+	struct NO_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 24 }; };
+	struct NO_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 24 }; };
+}
+namespace ORDER {
+	struct O_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 64 }; };
+	struct O_C_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 64 }; };
+	struct O_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 64 }; };
+	struct O_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 3, size = 8, index = 24, group = 0, group_index = 24, group_size = 64 }; };
+	struct O_ENTRY_D { typedef int64_t type; static const bool pax = false;
+		enum { id = 4, size = 8, index = 32, group = 0, group_index = 32, group_size = 64 }; };
+	struct O_CARRIER_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 5, size = 8, index = 40, group = 0, group_index = 40, group_size = 64 }; };
+	struct O_OL_CNT { typedef int64_t type; static const bool pax = false;
+		enum { id = 6, size = 8, index = 48, group = 0, group_index = 48, group_size = 64 }; };
+	struct O_ALL_LOCAL { typedef int64_t type; static const bool pax = false;
+		enum { id = 7, size = 8, index = 56, group = 0, group_index = 56, group_size = 64 }; };
+}
+namespace ORDER_LINE {
+	struct OL_O_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 40 }; };
+	struct OL_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 40 }; };
+	struct OL_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 40 }; };
+	struct OL_NUMBER { typedef int64_t type; static const bool pax = false;
+		enum { id = 3, size = 8, index = 24, group = 0, group_index = 24, group_size = 40 }; };
+	struct OL_I_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 4, size = 8, index = 32, group = 0, group_index = 32, group_size = 40 }; };
+}
+namespace ITEM {
+	struct I_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 98 }; };
+	struct I_IM_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 98 }; };
+	struct I_NAME { typedef char type; static const bool pax = false;
+		enum { id = 2, size = 24, index = 16, group = 0, group_index = 16, group_size = 98 }; };
+	struct I_PRICE { typedef int64_t type; static const bool pax = false;
+		enum { id = 3, size = 8, index = 40, group = 0, group_index = 40, group_size = 98 }; };
+	struct I_DATA { typedef char type; static const bool pax = false;
+		enum { id = 4, size = 50, index = 48, group = 0, group_index = 48, group_size = 98 }; };
+}
+namespace STOCK {
+	struct S_I_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 32 }; };
+	struct S_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 32 }; };
+	struct S_QUANTITY { typedef int64_t type; static const bool pax = false;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 32 }; };
+	struct S_REMOTE_CNT { typedef int64_t type; static const bool pax = false;
+		enum { id = 3, size = 8, index = 24, group = 0, group_index = 24, group_size = 32 }; };
+}
+// checked against the parsed schema by Workload::check_schema
+static const static_column columns[] = {
+	{"WAREHOUSE", 0, 8, 0, 0, 0, 105, false},
+	{"WAREHOUSE", 1, 10, 8, 0, 8, 105, false},
+	{"WAREHOUSE", 2, 20, 18, 0, 18, 105, false},
+	{"WAREHOUSE", 3, 20, 38, 0, 38, 105, false},
+	{"WAREHOUSE", 4, 20, 58, 0, 58, 105, false},
+	{"WAREHOUSE", 5, 2, 78, 0, 78, 105, false},
+	{"WAREHOUSE", 6, 9, 80, 0, 80, 105, false},
+	{"WAREHOUSE", 7, 8, 89, 0, 89, 105, false},
+	{"WAREHOUSE", 8, 8, 97, 0, 97, 105, false},
+	{"DISTRICT", 0, 8, 0, 0, 0, 121, false},
+	{"DISTRICT", 1, 8, 8, 0, 8, 121, false},
+	{"DISTRICT", 2, 10, 16, 0, 16, 121, false},
+	{"DISTRICT", 3, 20, 26, 0, 26, 121, false},
+	{"DISTRICT", 4, 20, 46, 0, 46, 121, false},
+	{"DISTRICT", 5, 20, 66, 0, 66, 121, false},
+	{"DISTRICT", 6, 2, 86, 0, 86, 121, false},
+	{"DISTRICT", 7, 9, 88, 0, 88, 121, false},
+	{"DISTRICT", 8, 8, 97, 0, 97, 121, false},
+	{"DISTRICT", 9, 8, 105, 0, 105, 121, false},
+	{"DISTRICT", 10, 8, 113, 0, 113, 121, false},
+	{"CUSTOMER", 0, 8, 0, 0, 0, 78, false},
+	{"CUSTOMER", 1, 8, 8, 0, 8, 78, false},
+	{"CUSTOMER", 2, 8, 16, 0, 16, 78, false},
+	{"CUSTOMER", 3, 2, 24, 0, 24, 78, false},
+	{"CUSTOMER", 4, 16, 26, 0, 26, 78, false},
+	{"CUSTOMER", 5, 2, 42, 0, 42, 78, false},
+	{"CUSTOMER", 6, 2, 44, 0, 44, 78, false},
+	{"CUSTOMER", 7, 8, 46, 0, 46, 78, false},
+	{"CUSTOMER", 8, 8, 54, 0, 54, 78, false},
+	{"CUSTOMER", 9, 8, 62, 0, 62, 78, false},
+	{"CUSTOMER", 10, 8, 70, 0, 70, 78, false},
+	{"HISTORY", 0, 8, 0, 0, 0, 56, false},
+	{"HISTORY", 1, 8, 8, 0, 8, 56, false},
+	{"HISTORY", 2, 8, 16, 0, 16, 56, false},
+	{"HISTORY", 3, 8, 24, 0, 24, 56, false},
+	{"HISTORY", 4, 8, 32, 0, 32, 56, false},
+	{"HISTORY", 5, 8, 40, 0, 40, 56, false},
+	{"HISTORY", 6, 8, 48, 0, 48, 56, false},
+	{"NEW-ORDER", 0, 8, 0, 0, 0, 24, false},
+	{"NEW-ORDER", 1, 8, 8, 0, 8, 24, false},
+	{"NEW-ORDER", 2, 8, 16, 0, 16, 24, false},
+	{"ORDER", 0, 8, 0, 0, 0, 64, false},
+	{"ORDER", 1, 8, 8, 0, 8, 64, false},
+	{"ORDER", 2, 8, 16, 0, 16, 64, false},
+	{"ORDER", 3, 8, 24, 0, 24, 64, false},
+	{"ORDER", 4, 8, 32, 0, 32, 64, false},
+	{"ORDER", 5, 8, 40, 0, 40, 64, false},
+	{"ORDER", 6, 8, 48, 0, 48, 64, false},
+	{"ORDER", 7, 8, 56, 0, 56, 64, false},
+	{"ORDER-LINE", 0, 8, 0, 0, 0, 40, false},
+	{"ORDER-LINE", 1, 8, 8, 0, 8, 40, false},
+	{"ORDER-LINE", 2, 8, 16, 0, 16, 40, false},
+	{"ORDER-LINE", 3, 8, 24, 0, 24, 40, false},
+	{"ORDER-LINE", 4, 8, 32, 0, 32, 40, false},
+	{"ITEM", 0, 8, 0, 0, 0, 98, false},
+	{"ITEM", 1, 8, 8, 0, 8, 98, false},
+	{"ITEM", 2, 24, 16, 0, 16, 98, false},
+	{"ITEM", 3, 8, 40, 0, 40, 98, false},
+	{"ITEM", 4, 50, 48, 0, 48, 98, false},
+	{"STOCK", 0, 8, 0, 0, 0, 32, false},
+	{"STOCK", 1, 8, 8, 0, 8, 32, false},
+	{"STOCK", 2, 8, 16, 0, 16, 32, false},
+	{"STOCK", 3, 8, 24, 0, 24, 32, false},
+};
+}
+#else
+// TPCC_full_schema.txt
+namespace tpcc_schema {
+namespace WAREHOUSE {
+	struct W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 105 }; };
+	struct W_NAME { typedef char type; static const bool pax = false;
+		enum { id = 1, size = 10, index = 8, group = 0, group_index = 8, group_size = 105 }; };
+	struct W_STREET_1 { typedef char type; static const bool pax = false;
+		enum { id = 2, size = 20, index = 18, group = 0, group_index = 18, group_size = 105 }; };
+	struct W_STREET_2 { typedef char type; static const bool pax = false;
+		enum { id = 3, size = 20, index = 38, group = 0, group_index = 38, group_size = 105 }; };
+	struct W_CITY { typedef char type; static const bool pax = false;
+		enum { id = 4, size = 20, index = 58, group = 0, group_index = 58, group_size = 105 }; };
+	struct W_STATE { typedef char type; static const bool pax = false;
+		enum { id = 5, size = 2, index = 78, group = 0, group_index = 78, group_size = 105 }; };
+	struct W_ZIP { typedef char type; static const bool pax = false;
+		enum { id = 6, size = 9, index = 80, group = 0, group_index = 80, group_size = 105 }; };
+	struct W_TAX { typedef double type; static const bool pax = false;
+		enum { id = 7, size = 8, index = 89, group = 0, group_index = 89, group_size = 105 }; };
+	struct W_YTD { typedef double type; static const bool pax = false;
+		enum { id = 8, size = 8, index = 97, group = 0, group_index = 97, group_size = 105 }; };
+}
+namespace DISTRICT {
+	struct D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 121 }; };
+	struct D_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 121 }; };
+	struct D_NAME { typedef char type; static const bool pax = false;
+		enum { id = 2, size = 10, index = 16, group = 0, group_index = 16, group_size = 121 }; };
+	struct D_STREET_1 { typedef char type; static const bool pax = false;
+		enum { id = 3, size = 20, index = 26, group = 0, group_index = 26, group_size = 121 }; };
+	struct D_STREET_2 { typedef char type; static const bool pax = false;
+		enum { id = 4, size = 20, index = 46, group = 0, group_index = 46, group_size = 121 }; };
+	struct D_CITY { typedef char type; static const bool pax = false;
+		enum { id = 5, size = 20, index = 66, group = 0, group_index = 66, group_size = 121 }; };
+	struct D_STATE { typedef char type; static const bool pax = false;
+		enum { id = 6, size = 2, index = 86, group = 0, group_index = 86, group_size = 121 }; };
+	struct D_ZIP { typedef char type; static const bool pax = false;
+		enum { id = 7, size = 9, index = 88, group = 0, group_index = 88, group_size = 121 }; };
+	struct D_TAX { typedef double type; static const bool pax = false;
+		enum { id = 8, size = 8, index = 97, group = 0, group_index = 97, group_size = 121 }; };
+	struct D_YTD { typedef double type; static const bool pax = false;
+		enum { id = 9, size = 8, index = 105, group = 0, group_index = 105, group_size = 121 }; };
+	struct D_NEXT_O_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 10, size = 8, index = 113, group = 0, group_index = 113, group_size = 121 }; };
+}
+namespace CUSTOMER {
+	struct C_ID { typedef int64_t type; static const bool pax = true;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 24 }; };
+	struct C_D_ID { typedef int64_t type; static const bool pax = true;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 24 }; };
+	struct C_W_ID { typedef int64_t type; static const bool pax = true;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 24 }; };
+	struct C_FIRST { typedef char type; static const bool pax = true;
+		enum { id = 3, size = 16, index = 24, group = 1, group_index = 0, group_size = 34 }; };
+	struct C_MIDDLE { typedef char type; static const bool pax = true;
+		enum { id = 4, size = 2, index = 40, group = 1, group_index = 16, group_size = 34 }; };
+	struct C_LAST { typedef char type; static const bool pax = true;
+		enum { id = 5, size = 16, index = 42, group = 1, group_index = 18, group_size = 34 }; };
+	struct C_STREET_1 { typedef char type; static const bool pax = true;
+		enum { id = 6, size = 20, index = 58, group = 2, group_index = 0, group_size = 87 }; };
+	struct C_STREET_2 { typedef char type; static const bool pax = true;
+		enum { id = 7, size = 20, index = 78, group = 2, group_index = 20, group_size = 87 }; };
+	struct C_CITY { typedef char type; static const bool pax = true;
+		enum { id = 8, size = 20, index = 98, group = 2, group_index = 40, group_size = 87 }; };
+	struct C_STATE { typedef char type; static const bool pax = true;
+		enum { id = 9, size = 2, index = 118, group = 2, group_index = 60, group_size = 87 }; };
+	struct C_ZIP { typedef char type; static const bool pax = true;
+		enum { id = 10, size = 9, index = 120, group = 2, group_index = 62, group_size = 87 }; };
+	struct C_PHONE { typedef char type; static const bool pax = true;
+		enum { id = 11, size = 16, index = 129, group = 2, group_index = 71, group_size = 87 }; };
+	struct C_SINCE { typedef int64_t type; static const bool pax = true;
+		enum { id = 12, size = 8, index = 145, group = 3, group_index = 0, group_size = 18 }; };
+	struct C_CREDIT { typedef char type; static const bool pax = true;
+		enum { id = 13, size = 2, index = 153, group = 3, group_index = 8, group_size = 18 }; };
+	struct C_CREDIT_LIM { typedef int64_t type; static const bool pax = true;
+		enum { id = 14, size = 8, index = 155, group = 3, group_index = 10, group_size = 18 }; };
+	struct C_DISCOUNT { typedef int64_t type; static const bool pax = true;
+		enum { id = 15, size = 8, index = 163, group = 4, group_index = 0, group_size = 40 }; };
+	struct C_BALANCE { typedef double type; static const bool pax = true;
+		enum { id = 16, size = 8, index = 171, group = 4, group_index = 8, group_size = 40 }; };
+	struct C_YTD_PAYMENT { typedef double type; static const bool pax = true;
+		enum { id = 17, size = 8, index = 179, group = 4, group_index = 16, group_size = 40 }; };
+	struct C_PAYMENT_CNT { typedef uint64_t type; static const bool pax = true;
+		enum { id = 18, size = 8, index = 187, group = 4, group_index = 24, group_size = 40 }; };
+	struct C_DELIVERY_CNT { typedef uint64_t type; static const bool pax = true;
+		enum { id = 19, size = 8, index = 195, group = 4, group_index = 32, group_size = 40 }; };
+	struct C_DATA { typedef char type; static const bool pax = true;
+		enum { id = 20, size = 500, index = 203, group = 5, group_index = 0, group_size = 500 }; };
+}
+namespace HISTORY {
+	struct H_C_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 80 }; };
+	struct H_C_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 80 }; };
+	struct H_C_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 80 }; };
+	struct H_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 3, size = 8, index = 24, group = 0, group_index = 24, group_size = 80 }; };
+	struct H_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 4, size = 8, index = 32, group = 0, group_index = 32, group_size = 80 }; };
+	struct H_DATE { typedef int64_t type; static const bool pax = false;
+		enum { id = 5, size = 8, index = 40, group = 0, group_index = 40, group_size = 80 }; };
+	struct H_AMOUNT { typedef double type; static const bool pax = false;
+		enum { id = 6, size = 8, index = 48, group = 0, group_index = 48, group_size = 80 }; };
+	struct H_DATA { typedef char type; static const bool pax = false;
+		enum { id = 7, size = 24, index = 56, group = 0, group_index = 56, group_size = 80 }; };
+}
+namespace NEW_ORDER {
+	struct NO_O_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 24 }; };
+	struct NO_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 24 }; };
+	struct NO_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 24 }; };
+}
+namespace ORDER {
+	struct O_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 64 }; };
+	struct O_C_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 64 }; };
+	struct O_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 64 }; };
+	struct O_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 3, size = 8, index = 24, group = 0, group_index = 24, group_size = 64 }; };
+	struct O_ENTRY_D { typedef int64_t type; static const bool pax = false;
+		enum { id = 4, size = 8, index = 32, group = 0, group_index = 32, group_size = 64 }; };
+	struct O_CARRIER_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 5, size = 8, index = 40, group = 0, group_index = 40, group_size = 64 }; };
+	struct O_OL_CNT { typedef int64_t type; static const bool pax = false;
+		enum { id = 6, size = 8, index = 48, group = 0, group_index = 48, group_size = 64 }; };
+	struct O_ALL_LOCAL { typedef int64_t type; static const bool pax = false;
+		enum { id = 7, size = 8, index = 56, group = 0, group_index = 56, group_size = 64 }; };
+}
+namespace ORDER_LINE {
+	struct OL_O_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 80 }; };
+	struct OL_D_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 80 }; };
+	struct OL_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 2, size = 8, index = 16, group = 0, group_index = 16, group_size = 80 }; };
+	struct OL_NUMBER { typedef int64_t type; static const bool pax = false;
+		enum { id = 3, size = 8, index = 24, group = 0, group_index = 24, group_size = 80 }; };
+	struct OL_I_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 4, size = 8, index = 32, group = 0, group_index = 32, group_size = 80 }; };
+	struct OL_SUPPLY_W_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 5, size = 8, index = 40, group = 0, group_index = 40, group_size = 80 }; };
+	struct OL_DELIVERY_D { typedef int64_t type; static const bool pax = false;
+		enum { id = 6, size = 8, index = 48, group = 0, group_index = 48, group_size = 80 }; };
+	struct OL_QUANTITY { typedef int64_t type; static const bool pax = false;
+		enum { id = 7, size = 8, index = 56, group = 0, group_index = 56, group_size = 80 }; };
+	struct OL_AMOUNT { typedef double type; static const bool pax = false;
+		enum { id = 8, size = 8, index = 64, group = 0, group_index = 64, group_size = 80 }; };
+	struct OL_DIST_INFO { typedef int64_t type; static const bool pax = false;
+		enum { id = 9, size = 8, index = 72, group = 0, group_index = 72, group_size = 80 }; };
+}
+namespace ITEM {
+	struct I_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 98 }; };
+	struct I_IM_ID { typedef int64_t type; static const bool pax = false;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 98 }; };
+	struct I_NAME { typedef char type; static const bool pax = false;
+		enum { id = 2, size = 24, index = 16, group = 0, group_index = 16, group_size = 98 }; };
+	struct I_PRICE { typedef int64_t type; static const bool pax = false;
+		enum { id = 3, size = 8, index = 40, group = 0, group_index = 40, group_size = 98 }; };
+	struct I_DATA { typedef char type; static const bool pax = false;
+		enum { id = 4, size = 50, index = 48, group = 0, group_index = 48, group_size = 98 }; };
+}
+namespace STOCK {
+	struct S_I_ID { typedef int64_t type; static const bool pax = true;
+		enum { id = 0, size = 8, index = 0, group = 0, group_index = 0, group_size = 16 }; };
+	struct S_W_ID { typedef int64_t type; static const bool pax = true;
+		enum { id = 1, size = 8, index = 8, group = 0, group_index = 8, group_size = 16 }; };
+	struct S_QUANTITY { typedef int64_t type; static const bool pax = true;
+		enum { id = 2, size = 8, index = 16, group = 1, group_index = 0, group_size = 32 }; };
+	struct S_DIST_01 { typedef char type; static const bool pax = true;
+		enum { id = 3, size = 24, index = 24, group = 2, group_index = 0, group_size = 240 }; };
+	struct S_DIST_02 { typedef char type; static const bool pax = true;
+		enum { id = 4, size = 24, index = 48, group = 2, group_index = 24, group_size = 240 }; };
+	struct S_DIST_03 { typedef char type; static const bool pax = true;
+		enum { id = 5, size = 24, index = 72, group = 2, group_index = 48, group_size = 240 }; };
+	struct S_DIST_04 { typedef char type; static const bool pax = true;
+		enum { id = 6, size = 24, index = 96, group = 2, group_index = 72, group_size = 240 }; };
+	struct S_DIST_05 { typedef char type; static const bool pax = true;
+		enum { id = 7, size = 24, index = 120, group = 2, group_index = 96, group_size = 240 }; };
+	struct S_DIST_06 { typedef char type; static const bool pax = true;
+		enum { id = 8, size = 24, index = 144, group = 2, group_index = 120, group_size = 240 }; };
+	struct S_DIST_07 { typedef char type; static const bool pax = true;
+		enum { id = 9, size = 24, index = 168, group = 2, group_index = 144, group_size = 240 }; };
+	struct S_DIST_08 { typedef char type; static const bool pax = true;
+		enum { id = 10, size = 24, index = 192, group = 2, group_index = 168, group_size = 240 }; };
+	struct S_DIST_09 { typedef char type; static const bool pax = true;
+		enum { id = 11, size = 24, index = 216, group = 2, group_index = 192, group_size = 240 }; };
+	struct S_DIST_10 { typedef char type; static const bool pax = true;
+		enum { id = 12, size = 24, index = 240, group = 2, group_index = 216, group_size = 240 }; };
+	struct S_YTD { typedef int64_t type; static const bool pax = true;
+		enum { id = 13, size = 8, index = 264, group = 1, group_index = 8, group_size = 32 }; };
+	struct S_ORDER_CNT { typedef int64_t type; static const bool pax = true;
+		enum { id = 14, size = 8, index = 272, group = 1, group_index = 16, group_size = 32 }; };
+	struct S_REMOTE_CNT { typedef int64_t type; static const bool pax = true;
+		enum { id = 15, size = 8, index = 280, group = 1, group_index = 24, group_size = 32 }; };
+	struct S_DATA { typedef char type; static const bool pax = true;
+		enum { id = 16, size = 50, index = 288, group = 3, group_index = 0, group_size = 50 }; };
+}
+// checked against the parsed schema by Workload::check_schema
+static const static_column columns[] = {
+	{"WAREHOUSE", 0, 8, 0, 0, 0, 105, false},
+	{"WAREHOUSE", 1, 10, 8, 0, 8, 105, false},
+	{"WAREHOUSE", 2, 20, 18, 0, 18, 105, false},
+	{"WAREHOUSE", 3, 20, 38, 0, 38, 105, false},
+	{"WAREHOUSE", 4, 20, 58, 0, 58, 105, false},
+	{"WAREHOUSE", 5, 2, 78, 0, 78, 105, false},
+	{"WAREHOUSE", 6, 9, 80, 0, 80, 105, false},
+	{"WAREHOUSE", 7, 8, 89, 0, 89, 105, false},
+	{"WAREHOUSE", 8, 8, 97, 0, 97, 105, false},
+	{"DISTRICT", 0, 8, 0, 0, 0, 121, false},
+	{"DISTRICT", 1, 8, 8, 0, 8, 121, false},
+	{"DISTRICT", 2, 10, 16, 0, 16, 121, false},
+	{"DISTRICT", 3, 20, 26, 0, 26, 121, false},
+	{"DISTRICT", 4, 20, 46, 0, 46, 121, false},
+	{"DISTRICT", 5, 20, 66, 0, 66, 121, false},
+	{"DISTRICT", 6, 2, 86, 0, 86, 121, false},
+	{"DISTRICT", 7, 9, 88, 0, 88, 121, false},
+	{"DISTRICT", 8, 8, 97, 0, 97, 121, false},
+	{"DISTRICT", 9, 8, 105, 0, 105, 121, false},
+	{"DISTRICT", 10, 8, 113, 0, 113, 121, false},
+	{"CUSTOMER", 0, 8, 0, 0, 0, 24, true},
+	{"CUSTOMER", 1, 8, 8, 0, 8, 24, true},
+	{"CUSTOMER", 2, 8, 16, 0, 16, 24, true},
+	{"CUSTOMER", 3, 16, 24, 1, 0, 34, true},
+	{"CUSTOMER", 4, 2, 40, 1, 16, 34, true},
+	{"CUSTOMER", 5, 16, 42, 1, 18, 34, true},
+	{"CUSTOMER", 6, 20, 58, 2, 0, 87, true},
+	{"CUSTOMER", 7, 20, 78, 2, 20, 87, true},
+	{"CUSTOMER", 8, 20, 98, 2, 40, 87, true},
+	{"CUSTOMER", 9, 2, 118, 2, 60, 87, true},
+	{"CUSTOMER", 10, 9, 120, 2, 62, 87, true},
+	{"CUSTOMER", 11, 16, 129, 2, 71, 87, true},
+	{"CUSTOMER", 12, 8, 145, 3, 0, 18, true},
+	{"CUSTOMER", 13, 2, 153, 3, 8, 18, true},
+	{"CUSTOMER", 14, 8, 155, 3, 10, 18, true},
+	{"CUSTOMER", 15, 8, 163, 4, 0, 40, true},
+	{"CUSTOMER", 16, 8, 171, 4, 8, 40, true},
+	{"CUSTOMER", 17, 8, 179, 4, 16, 40, true},
+	{"CUSTOMER", 18, 8, 187, 4, 24, 40, true},
+	{"CUSTOMER", 19, 8, 195, 4, 32, 40, true},
+	{"CUSTOMER", 20, 500, 203, 5, 0, 500, true},
+	{"HISTORY", 0, 8, 0, 0, 0, 80, false},
+	{"HISTORY", 1, 8, 8, 0, 8, 80, false},
+	{"HISTORY", 2, 8, 16, 0, 16, 80, false},
+	{"HISTORY", 3, 8, 24, 0, 24, 80, false},
+	{"HISTORY", 4, 8, 32, 0, 32, 80, false},
+	{"HISTORY", 5, 8, 40, 0, 40, 80, false},
+	{"HISTORY", 6, 8, 48, 0, 48, 80, false},
+	{"HISTORY", 7, 24, 56, 0, 56, 80, false},
+	{"NEW-ORDER", 0, 8, 0, 0, 0, 24, false},
+	{"NEW-ORDER", 1, 8, 8, 0, 8, 24, false},
+	{"NEW-ORDER", 2, 8, 16, 0, 16, 24, false},
+	{"ORDER", 0, 8, 0, 0, 0, 64, false},
+	{"ORDER", 1, 8, 8, 0, 8, 64, false},
+	{"ORDER", 2, 8, 16, 0, 16, 64, false},
+	{"ORDER", 3, 8, 24, 0, 24, 64, false},
+	{"ORDER", 4, 8, 32, 0, 32, 64, false},
+	{"ORDER", 5, 8, 40, 0, 40, 64, false},
+	{"ORDER", 6, 8, 48, 0, 48, 64, false},
+	{"ORDER", 7, 8, 56, 0, 56, 64, false},
+	{"ORDER-LINE", 0, 8, 0, 0, 0, 80, false},
+	{"ORDER-LINE", 1, 8, 8, 0, 8, 80, false},
+	{"ORDER-LINE", 2, 8, 16, 0, 16, 80, false},
+	{"ORDER-LINE", 3, 8, 24, 0, 24, 80, false},
+	{"ORDER-LINE", 4, 8, 32, 0, 32, 80, false},
+	{"ORDER-LINE", 5, 8, 40, 0, 40, 80, false},
+	{"ORDER-LINE", 6, 8, 48, 0, 48, 80, false},
+	{"ORDER-LINE", 7, 8, 56, 0, 56, 80, false},
+	{"ORDER-LINE", 8, 8, 64, 0, 64, 80, false},
+	{"ORDER-LINE", 9, 8, 72, 0, 72, 80, false},
+	{"ITEM", 0, 8, 0, 0, 0, 98, false},
+	{"ITEM", 1, 8, 8, 0, 8, 98, false},
+	{"ITEM", 2, 24, 16, 0, 16, 98, false},
+	{"ITEM", 3, 8, 40, 0, 40, 98, false},
+	{"ITEM", 4, 50, 48, 0, 48, 98, false},
+	{"STOCK", 0, 8, 0, 0, 0, 16, true},
+	{"STOCK", 1, 8, 8, 0, 8, 16, true},
+	{"STOCK", 2, 8, 16, 1, 0, 32, true},
+	{"STOCK", 3, 24, 24, 2, 0, 240, true},
+	{"STOCK", 4, 24, 48, 2, 24, 240, true},
+	{"STOCK", 5, 24, 72, 2, 48, 240, true},
+	{"STOCK", 6, 24, 96, 2, 72, 240, true},
+	{"STOCK", 7, 24, 120, 2, 96, 240, true},
+	{"STOCK", 8, 24, 144, 2, 120, 240, true},
+	{"STOCK", 9, 24, 168, 2, 144, 240, true},
+	{"STOCK", 10, 24, 192, 2, 168, 240, true},
+	{"STOCK", 11, 24, 216, 2, 192, 240, true},
+	{"STOCK", 12, 24, 240, 2, 216, 240, true},
+	{"STOCK", 13, 8, 264, 1, 8, 32, true},
+	{"STOCK", 14, 8, 272, 1, 16, 32, true},
+	{"STOCK", 15, 8, 280, 1, 24, 32, true},
+	{"STOCK", 16, 50, 288, 3, 0, 50, true},
+};
+}
+#endif
+
+#endif
@@ -24,14 +24,20 @@
 #include "row.h"
 #include "index_hash.h"
 #include "index_btree.h"
+#include "index_art.h"
 #include "tpcc_const.h"
+#include "tpcc_schema.h"
 #include "transport.h"
 #include "msg_queue.h"
 #include "message.h"
+#include <algorithm>
 
 void TPCCTxnManager::init(uint64_t thd_id, Workload * h_wl) {
 	TxnManager::init(thd_id, h_wl);
 	_wl = (TPCCWorkload *) h_wl;
+  // orders are loaded with up to 15 lines
+  deliv_ol_max = max(g_max_items_per_txn, (UInt32) 15);
+  deliv_ol_items = (itemid_t **) mem_allocator.alloc(sizeof(itemid_t *) * deliv_ol_max);
   reset();
 	TxnManager::reset();
 }
@@ -43,8 +49,14 @@ void TPCCTxnManager::reset() {
     state = TPCC_PAYMENT0;
   } else if (tpcc_query->txn_type == TPCC_NEW_ORDER) {
     state = TPCC_NEWORDER0;
+  } else if (tpcc_query->txn_type == TPCC_DELIVERY) {
+    state = TPCC_DELIVERY0;
   }
   next_item_id = 0;
+  deliv_d_id = 1;
+  deliv_no_row = NULL;
+  deliv_ol_cnt = 0;
+  deliv_ol_idx = 0;
 	TxnManager::reset();
 }
 
@@ -67,7 +79,7 @@ RC TPCCTxnManager::run_txn() {
   return rc;
 #endif
 
-  if(IS_LOCAL(txn->txn_id) && (state == TPCC_PAYMENT0 || state == TPCC_NEWORDER0)) {
+  if(IS_LOCAL(txn->txn_id) && (state == TPCC_PAYMENT0 || state == TPCC_NEWORDER0 || state == TPCC_DELIVERY0)) {
     DEBUG("Running txn %ld\n",txn->txn_id);
 #if DISTR_DEBUG
     query->print();
@@ -107,6 +119,9 @@ bool TPCCTxnManager::is_done() {
       //done = next_item_id == tpcc_query->ol_cnt || state == TPCC_FIN;
       done = next_item_id == tpcc_query->items.size() || state == TPCC_FIN;
       break;
+    case TPCC_DELIVERY:
+      done = state == TPCC_FIN;
+      break;
     default: assert(false);
   }
 
@@ -114,9 +129,9 @@ bool TPCCTxnManager::is_done() {
   return done;
 }
 
-RC TPCCTxnManager::acquire_locks() {
+RC TPCCTxnManager::acquire_locks(uint64_t lock_part) {
   uint64_t starttime = get_sys_clock();
-  assert(CC_ALG == CALVIN);
+  assert(CC_ALG == CALVIN || CC_ALG == VLL);
   locking_done = false;
   RC rc = RCOK;
   RC rc2;
@@ -133,54 +148,64 @@ RC TPCCTxnManager::acquire_locks() {
   uint64_t d_w_id = tpcc_query->d_w_id;
   uint64_t c_w_id = tpcc_query->c_w_id;
   uint64_t c_d_id = tpcc_query->c_d_id;
+#if CC_ALG != CALVIN
 	char * c_last = tpcc_query->c_last;
+#endif
   uint64_t part_id_w = wh_to_part(w_id);
   uint64_t part_id_c_w = wh_to_part(c_w_id);
   switch(tpcc_query->txn_type) {
     case TPCC_PAYMENT:
+      // The recon run only reads immutable customer columns
+      if(isRecon())
+        break;
+      // a row's primary key is its id within its warehouse or district, see
+      // TPCCWorkload. The index is only read for rows this lock thread owns
       if(GET_NODE_ID(part_id_w) == g_node_id) {
       // WH
-        index = _wl->i_warehouse;
-        item = index_read(index, w_id, part_id_w);
-        row_t * row = ((row_t *)item->location);
-        rc2 = get_lock(row,g_wh_update? WR:RD);
-        if(rc2 != RCOK)
-          rc = rc2;
+        if(calvin_owns_row(w_id,lock_part)) {
+          index = _wl->i_warehouse;
+          item = index_read(index, w_id, part_id_w);
+          row_t * row = ((row_t *)item->location);
+          rc2 = get_lock(row,g_wh_update? WR:RD,lock_part);
+          if(rc2 != RCOK)
+            rc = rc2;
+        }
 
       // Dist
-        key = distKey(d_id, d_w_id);
-        item = index_read(_wl->i_district, key, part_id_w);
-        row = ((row_t *)item->location);
-        rc2 = get_lock(row, WR);
-        if(rc2 != RCOK)
-          rc = rc2;
+        if(calvin_owns_row(d_id,lock_part)) {
+          key = distKey(d_id, d_w_id);
+          item = index_read(_wl->i_district, key, part_id_w);
+          row = ((row_t *)item->location);
+          rc2 = get_lock(row, WR,lock_part);
+          if(rc2 != RCOK)
+            rc = rc2;
+        }
       }
       if(GET_NODE_ID(part_id_c_w) == g_node_id) {
       // Cust
         if (tpcc_query->by_last_name) { 
-
-          key = custNPKey(c_last, c_d_id, c_w_id);
-          index = _wl->i_customer_last;
+#if CC_ALG == CALVIN
+          // lock the customer the recon run picked
+          assert(tpcc_query->recon_keys.size() == 1);
+          if(!calvin_owns_row(tpcc_query->recon_keys[0],lock_part))
+            break;
+          key = custKey(tpcc_query->recon_keys[0], c_d_id, c_w_id);
+          index = _wl->i_customer_id;
           item = index_read(index, key, part_id_c_w);
-          int cnt = 0;
-          itemid_t * it = item;
-          itemid_t * mid = item;
-          while (it != NULL) {
-            cnt ++;
-            it = it->next;
-            if (cnt % 2 == 0)
-              mid = mid->next;
-          }
-          row = ((row_t *)mid->location);
-          
+          row = (row_t *) item->location;
+#else
+          row = get_cust_by_last(c_last, c_d_id, c_w_id);
+#endif
         }
         else { 
+          if(!calvin_owns_row(c_id,lock_part))
+            break;
           key = custKey(c_id, c_d_id, c_w_id);
           index = _wl->i_customer_id;
           item = index_read(index, key, part_id_c_w);
           row = (row_t *) item->location;
         }
-        rc2  = get_lock(row, WR);
+        rc2  = get_lock(row, WR,lock_part);
         if(rc2 != RCOK)
           rc = rc2;
  
@@ -189,44 +214,53 @@ RC TPCCTxnManager::acquire_locks() {
     case TPCC_NEW_ORDER:
       if(GET_NODE_ID(part_id_w) == g_node_id) {
       // WH
-        index = _wl->i_warehouse;
-        item = index_read(index, w_id, part_id_w);
-        row_t * row = ((row_t *)item->location);
-        rc2 = get_lock(row,RD);
-        if(rc2 != RCOK)
-          rc = rc2;
+        if(calvin_owns_row(w_id,lock_part)) {
+          index = _wl->i_warehouse;
+          item = index_read(index, w_id, part_id_w);
+          row_t * row = ((row_t *)item->location);
+          rc2 = get_lock(row,RD,lock_part);
+          if(rc2 != RCOK)
+            rc = rc2;
+        }
       // Cust
-        index = _wl->i_customer_id;
-        key = custKey(c_id, d_id, w_id);
-        item = index_read(index, key, wh_to_part(w_id));
-        row = (row_t *) item->location;
-        rc2 = get_lock(row, RD);
-        if(rc2 != RCOK)
-          rc = rc2;
+        if(calvin_owns_row(c_id,lock_part)) {
+          index = _wl->i_customer_id;
+          key = custKey(c_id, d_id, w_id);
+          item = index_read(index, key, wh_to_part(w_id));
+          row = (row_t *) item->location;
+          rc2 = get_lock(row, RD,lock_part);
+          if(rc2 != RCOK)
+            rc = rc2;
+        }
       // Dist
-        key = distKey(d_id, w_id);
-        item = index_read(_wl->i_district, key, wh_to_part(w_id));
-        row = ((row_t *)item->location);
-        rc2 = get_lock(row, WR);
-        if(rc2 != RCOK)
-          rc = rc2;
+        if(calvin_owns_row(d_id,lock_part)) {
+          key = distKey(d_id, w_id);
+          item = index_read(_wl->i_district, key, wh_to_part(w_id));
+          row = ((row_t *)item->location);
+          rc2 = get_lock(row, WR,lock_part);
+          if(rc2 != RCOK)
+            rc = rc2;
+        }
       }
       // Items
         for(uint64_t i = 0; i < tpcc_query->ol_cnt; i++) {
           if(GET_NODE_ID(wh_to_part(tpcc_query->items[i]->ol_supply_w_id)) != g_node_id) 
             continue;
+          // the item and its stock row share the item id as primary key
+          if(!calvin_owns_row(tpcc_query->items[i]->ol_i_id,lock_part))
+            continue;
 
           key = tpcc_query->items[i]->ol_i_id;
           item = index_read(_wl->i_item, key, 0);
           row = ((row_t *)item->location);
-          rc2 = get_lock(row, RD);
+          rc2 = get_lock(row, RD,lock_part);
           if(rc2 != RCOK)
             rc = rc2;
           key = stockKey(tpcc_query->items[i]->ol_i_id, tpcc_query->items[i]->ol_supply_w_id);
           index = _wl->i_stock;
           item = index_read(index, key, wh_to_part(tpcc_query->items[i]->ol_supply_w_id));
           row = ((row_t *)item->location);
-          rc2 = get_lock(row, WR);
+          rc2 = get_lock(row, WR,lock_part);
           if(rc2 != RCOK)
             rc = rc2;
         }
@@ -313,6 +347,36 @@ void TPCCTxnManager::next_tpcc_state() {
         state = TPCC_FIN;
       }
       break;
+    case TPCC_DELIVERY_S:
+      state = TPCC_DELIVERY0;
+      break;
+    case TPCC_DELIVERY0:
+      // delivery_0 skips districts without new orders
+      if(deliv_d_id > g_dist_per_wh)
+        state = TPCC_FIN;
+      else
+        state = TPCC_DELIVERY1;
+      break;
+    case TPCC_DELIVERY1:
+      state = TPCC_DELIVERY2;
+      break;
+    case TPCC_DELIVERY2:
+      state = deliv_ol_cnt > 0 ? TPCC_DELIVERY3 : TPCC_DELIVERY5;
+      break;
+    case TPCC_DELIVERY3: // loop over the order lines
+      state = TPCC_DELIVERY4;
+      break;
+    case TPCC_DELIVERY4:
+      ++deliv_ol_idx;
+      state = deliv_ol_idx < deliv_ol_cnt ? TPCC_DELIVERY3 : TPCC_DELIVERY5;
+      break;
+    case TPCC_DELIVERY5:
+      state = TPCC_DELIVERY6;
+      break;
+    case TPCC_DELIVERY6: // next district
+      ++deliv_d_id;
+      state = TPCC_DELIVERY0;
+      break;
     case TPCC_FIN:
       break;
     default:
@@ -482,6 +546,28 @@ RC TPCCTxnManager::run_txn_state() {
 		case TPCC_NEWORDER9 :
             rc = new_order_9( w_id, d_id, remote, ol_i_id, ol_supply_w_id, ol_quantity,  ol_number, ol_amount, o_id, row);
             break;
+		case TPCC_DELIVERY0 :
+            assert(w_loc);
+            rc = delivery_0(w_id, row);
+            break;
+		case TPCC_DELIVERY1 :
+            rc = delivery_1(w_id, row);
+            break;
+		case TPCC_DELIVERY2 :
+            rc = delivery_2(w_id, tpcc_query->o_carrier_id, row);
+            break;
+		case TPCC_DELIVERY3 :
+            rc = delivery_3(row);
+            break;
+		case TPCC_DELIVERY4 :
+            rc = delivery_4(tpcc_query->ol_delivery_d, row);
+            break;
+		case TPCC_DELIVERY5 :
+            rc = delivery_5(w_id, row);
+            break;
+		case TPCC_DELIVERY6 :
+            rc = delivery_6(row);
+            break;
     case TPCC_FIN :
         state = TPCC_FIN;
         if(tpcc_query->rbk)
@@ -543,9 +629,9 @@ inline RC TPCCTxnManager::run_payment_1(uint64_t w_id, uint64_t d_id, uint64_t d
 
 
 	double w_ytd;
-	r_wh_local->get_value(W_YTD, w_ytd);
+	r_wh_local->get_value<tpcc_schema::WAREHOUSE::W_YTD>(w_ytd);
 	if (g_wh_update) {
-		r_wh_local->set_value(W_YTD, w_ytd + h_amount);
+		r_wh_local->set_value<tpcc_schema::WAREHOUSE::W_YTD>(w_ytd + h_amount);
 	}
   return RCOK;
 }
@@ -574,12 +660,41 @@ inline RC TPCCTxnManager::run_payment_3(uint64_t w_id, uint64_t d_id, uint64_t d
 		WHERE d_w_id=:w_id AND d_id=:d_id;
 	+=====================================================*/
 	double d_ytd;
-	r_dist_local->get_value(D_YTD, d_ytd);
-	r_dist_local->set_value(D_YTD, d_ytd + h_amount);
+	r_dist_local->get_value<tpcc_schema::DISTRICT::D_YTD>(d_ytd);
+	r_dist_local->set_value<tpcc_schema::DISTRICT::D_YTD>(d_ytd + h_amount);
 
 	return RCOK;
 }
 
+// The customers named c_last in the district, ordered by c_first; the one 
+// at position ceil(n/2) is chosen (TPC-C 2.5.2.2). Only immutable columns 
+// are read, so the rows are not accessed through the CC manager here.
+row_t * TPCCTxnManager::get_cust_by_last(char * c_last, uint64_t c_d_id, uint64_t c_w_id) {
+	itemid_t * items[MAX_CUST_PER_LAST];
+	row_t * custs[MAX_CUST_PER_LAST];
+	uint64_t key = custNPKey(c_last, c_d_id, c_w_id);
+	uint64_t cnt = index_read_multiple(_wl->i_customer_last, key, wh_to_part(c_w_id), items, MAX_CUST_PER_LAST);
+	if (cnt > MAX_CUST_PER_LAST)
+		cnt = MAX_CUST_PER_LAST;
+	// different last names may share a key
+	uint64_t n = 0;
+	for (uint64_t i = 0; i < cnt; i++) {
+		row_t * r = (row_t *) items[i]->location;
+		if (strncmp(r->get_value<tpcc_schema::CUSTOMER::C_LAST>(), c_last, 
+				tpcc_schema::CUSTOMER::C_LAST::size) == 0)
+			custs[n++] = r;
+	}
+	assert(n > 0);
+#if !TPCC_SMALL
+	std::sort(custs, custs + n, [](row_t * a, row_t * b) {
+		return strncmp(a->get_value<tpcc_schema::CUSTOMER::C_FIRST>(), 
+			b->get_value<tpcc_schema::CUSTOMER::C_FIRST>(), 
+			tpcc_schema::CUSTOMER::C_FIRST::size) < 0;
+	});
+#endif
+	return custs[(n - 1) / 2];
+}
+
 inline RC TPCCTxnManager::run_payment_4(uint64_t w_id, uint64_t d_id,uint64_t c_id,uint64_t c_w_id, uint64_t c_d_id, char * c_last, double h_amount, bool by_last_name, row_t *& r_cust_local) { 
 	/*====================================================================+
 		EXEC SQL SELECT d_street_1, d_street_2, d_city, d_state, d_zip, d_name
@@ -607,23 +722,7 @@ inline RC TPCCTxnManager::run_payment_4(uint64_t w_id, uint64_t d_id,uint64_t c_
 			EXEC SQL OPEN c_byname;
 		+===========================================================================*/
 
-		key = custNPKey(c_last, c_d_id, c_w_id);
-		// XXX: the list is not sorted. But let's assume it's sorted... 
-		// The performance won't be much different.
-		INDEX * index = _wl->i_customer_last;
-		item = index_read(index, key, wh_to_part(c_w_id));
-		assert(item != NULL);
-		
-		int cnt = 0;
-		itemid_t * it = item;
-		itemid_t * mid = item;
-		while (it != NULL) {
-			cnt ++;
-			it = it->next;
-			if (cnt % 2 == 0)
-				mid = mid->next;
-		}
-		r_cust = ((row_t *)mid->location);
+		r_cust = get_cust_by_last(c_last, c_d_id, c_w_id);
 		
 		/*============================================================================+
 			for (n=0; n<namecnt/2; n++) {
@@ -671,12 +770,12 @@ inline RC TPCCTxnManager::run_payment_5(uint64_t w_id, uint64_t d_id,uint64_t c_
 	double c_ytd_payment;
 	double c_payment_cnt;
 
-	r_cust_local->get_value(C_BALANCE, c_balance);
-	r_cust_local->set_value(C_BALANCE, c_balance - h_amount);
-	r_cust_local->get_value(C_YTD_PAYMENT, c_ytd_payment);
-	r_cust_local->set_value(C_YTD_PAYMENT, c_ytd_payment + h_amount);
-	r_cust_local->get_value(C_PAYMENT_CNT, c_payment_cnt);
-	r_cust_local->set_value(C_PAYMENT_CNT, c_payment_cnt + 1);
+	r_cust_local->get_value<tpcc_schema::CUSTOMER::C_BALANCE>(c_balance);
+	r_cust_local->set_value<tpcc_schema::CUSTOMER::C_BALANCE>(c_balance - h_amount);
+	r_cust_local->get_value<tpcc_schema::CUSTOMER::C_YTD_PAYMENT>(c_ytd_payment);
+	r_cust_local->set_value<tpcc_schema::CUSTOMER::C_YTD_PAYMENT>(c_ytd_payment + h_amount);
+	r_cust_local->get_value<tpcc_schema::CUSTOMER::C_PAYMENT_CNT>(c_payment_cnt);
+	r_cust_local->set_value<tpcc_schema::CUSTOMER::C_PAYMENT_CNT>(c_payment_cnt + 1);
 
 	//char * c_credit = r_cust_local->get_value(C_CREDIT);
 
@@ -689,14 +788,14 @@ inline RC TPCCTxnManager::run_payment_5(uint64_t w_id, uint64_t d_id,uint64_t c_
 	uint64_t row_id;
 	// Which partition should we be inserting into?
 	_wl->t_history->get_new_row(r_hist, wh_to_part(c_w_id), row_id);
-	r_hist->set_value(H_C_ID, c_id);
-	r_hist->set_value(H_C_D_ID, c_d_id);
-	r_hist->set_value(H_C_W_ID, c_w_id);
-	r_hist->set_value(H_D_ID, d_id);
-	r_hist->set_value(H_W_ID, w_id);
+	r_hist->set_value<tpcc_schema::HISTORY::H_C_ID>(c_id);
+	r_hist->set_value<tpcc_schema::HISTORY::H_C_D_ID>(c_d_id);
+	r_hist->set_value<tpcc_schema::HISTORY::H_C_W_ID>(c_w_id);
+	r_hist->set_value<tpcc_schema::HISTORY::H_D_ID>(d_id);
+	r_hist->set_value<tpcc_schema::HISTORY::H_W_ID>(w_id);
 	int64_t date = 2013;		
-	r_hist->set_value(H_DATE, date);
-	r_hist->set_value(H_AMOUNT, h_amount);
+	r_hist->set_value<tpcc_schema::HISTORY::H_DATE>(date);
+	r_hist->set_value<tpcc_schema::HISTORY::H_AMOUNT>(h_amount);
 	insert_row(r_hist, _wl->t_history);
 
 	return RCOK;
@@ -726,7 +825,7 @@ inline RC TPCCTxnManager::new_order_0(uint64_t w_id, uint64_t d_id, uint64_t c_i
 inline RC TPCCTxnManager::new_order_1(uint64_t w_id, uint64_t d_id, uint64_t c_id, bool remote, uint64_t  ol_cnt,uint64_t  o_entry_d, uint64_t * o_id, row_t * r_wh_local) {
   assert(r_wh_local != NULL);
 	double w_tax;
-	r_wh_local->get_value(W_TAX, w_tax); 
+	r_wh_local->get_value<tpcc_schema::WAREHOUSE::W_TAX>(w_tax); 
   return RCOK;
 }
 
@@ -747,7 +846,7 @@ inline RC TPCCTxnManager::new_order_3(uint64_t w_id, uint64_t d_id, uint64_t c_i
 	uint64_t c_discount;
 	//char * c_last;
 	//char * c_credit;
-	r_cust_local->get_value(C_DISCOUNT, c_discount);
+	r_cust_local->get_value<tpcc_schema::CUSTOMER::C_DISCOUNT>(c_discount);
 	//c_last = r_cust_local->get_value(C_LAST);
 	//c_credit = r_cust_local->get_value(C_CREDIT);
   return RCOK;
@@ -776,9 +875,9 @@ inline RC TPCCTxnManager::new_order_5(uint64_t w_id, uint64_t d_id, uint64_t c_i
 	//double d_tax;
 	//int64_t o_id;
 	//d_tax = *(double *) r_dist_local->get_value(D_TAX);
-	*o_id = *(int64_t *) r_dist_local->get_value(D_NEXT_O_ID);
-	(*o_id) ++;
-	r_dist_local->set_value(D_NEXT_O_ID, *o_id);
+	// order ids are dense, so Delivery can step through them one by one
+	r_dist_local->get_value<tpcc_schema::DISTRICT::D_NEXT_O_ID>(*o_id);
+	r_dist_local->set_value<tpcc_schema::DISTRICT::D_NEXT_O_ID>(*o_id + 1);
 
 	// return o_id
 	/*========================================================================================+
@@ -788,14 +887,14 @@ inline RC TPCCTxnManager::new_order_5(uint64_t w_id, uint64_t d_id, uint64_t c_i
 	row_t * r_order;
 	uint64_t row_id;
 	_wl->t_order->get_new_row(r_order, wh_to_part(w_id), row_id);
-	r_order->set_value(O_ID, *o_id);
-	r_order->set_value(O_C_ID, c_id);
-	r_order->set_value(O_D_ID, d_id);
-	r_order->set_value(O_W_ID, w_id);
-	r_order->set_value(O_ENTRY_D, o_entry_d);
-	r_order->set_value(O_OL_CNT, ol_cnt);
+	r_order->set_value<tpcc_schema::ORDER::O_ID>(*o_id);
+	r_order->set_value<tpcc_schema::ORDER::O_C_ID>(c_id);
+	r_order->set_value<tpcc_schema::ORDER::O_D_ID>(d_id);
+	r_order->set_value<tpcc_schema::ORDER::O_W_ID>(w_id);
+	r_order->set_value<tpcc_schema::ORDER::O_ENTRY_D>(o_entry_d);
+	r_order->set_value<tpcc_schema::ORDER::O_OL_CNT>(ol_cnt);
 	int64_t all_local = (remote? 0 : 1);
-	r_order->set_value(O_ALL_LOCAL, all_local);
+	r_order->set_value<tpcc_schema::ORDER::O_ALL_LOCAL>(all_local);
 	insert_row(r_order, _wl->t_order);
 	/*=======================================================+
     EXEC SQL INSERT INTO NEW_ORDER (no_o_id, no_d_id, no_w_id)
@@ -803,9 +902,9 @@ inline RC TPCCTxnManager::new_order_5(uint64_t w_id, uint64_t d_id, uint64_t c_i
     +=======================================================*/
 	row_t * r_no;
 	_wl->t_neworder->get_new_row(r_no, wh_to_part(w_id), row_id);
-	r_no->set_value(NO_O_ID, *o_id);
-	r_no->set_value(NO_D_ID, d_id);
-	r_no->set_value(NO_W_ID, w_id);
+	r_no->set_value<tpcc_schema::NEW_ORDER::NO_O_ID>(*o_id);
+	r_no->set_value<tpcc_schema::NEW_ORDER::NO_D_ID>(d_id);
+	r_no->set_value<tpcc_schema::NEW_ORDER::NO_W_ID>(w_id);
 	insert_row(r_no, _wl->t_neworder);
 
 	return RCOK;
@@ -839,7 +938,7 @@ inline RC TPCCTxnManager::new_order_7(uint64_t ol_i_id, row_t * r_item_local) {
 		//char * i_name;
 		//char * i_data;
 		
-		r_item_local->get_value(I_PRICE, i_price);
+		r_item_local->get_value<tpcc_schema::ITEM::I_PRICE>(i_price);
 		//i_name = r_item_local->get_value(I_NAME);
 		//i_data = r_item_local->get_value(I_DATA);
 
@@ -880,22 +979,22 @@ inline RC TPCCTxnManager::new_order_9(uint64_t w_id,uint64_t  d_id,bool remote,
 		// XXX s_dist_xx are not retrieved.
 		UInt64 s_quantity;
 		int64_t s_remote_cnt;
-		s_quantity = *(int64_t *)r_stock_local->get_value(S_QUANTITY);
+		r_stock_local->get_value<tpcc_schema::STOCK::S_QUANTITY>(s_quantity);
 #if !TPCC_SMALL
 		int64_t s_ytd;
 		int64_t s_order_cnt;
 		char * s_data __attribute__ ((unused));
-		r_stock_local->get_value(S_YTD, s_ytd);
-		r_stock_local->set_value(S_YTD, s_ytd + ol_quantity);
+		r_stock_local->get_value<tpcc_schema::STOCK::S_YTD>(s_ytd);
+		r_stock_local->set_value<tpcc_schema::STOCK::S_YTD>(s_ytd + ol_quantity);
     // In Coordination Avoidance, this record must be protected!
-		r_stock_local->get_value(S_ORDER_CNT, s_order_cnt);
-		r_stock_local->set_value(S_ORDER_CNT, s_order_cnt + 1);
-		s_data = r_stock_local->get_value(S_DATA);
+		r_stock_local->get_value<tpcc_schema::STOCK::S_ORDER_CNT>(s_order_cnt);
+		r_stock_local->set_value<tpcc_schema::STOCK::S_ORDER_CNT>(s_order_cnt + 1);
+		s_data = r_stock_local->get_value<tpcc_schema::STOCK::S_DATA>();
 #endif
 		if (remote) {
-			s_remote_cnt = *(int64_t*)r_stock_local->get_value(S_REMOTE_CNT);
+			r_stock_local->get_value<tpcc_schema::STOCK::S_REMOTE_CNT>(s_remote_cnt);
 			s_remote_cnt ++;
-			r_stock_local->set_value(S_REMOTE_CNT, &s_remote_cnt);
+			r_stock_local->set_value<tpcc_schema::STOCK::S_REMOTE_CNT>(s_remote_cnt);
 		}
 		uint64_t quantity;
 		if (s_quantity > ol_quantity + 10) {
@@ -903,7 +1002,7 @@ inline RC TPCCTxnManager::new_order_9(uint64_t w_id,uint64_t  d_id,bool remote,
 		} else {
 			quantity = s_quantity - ol_quantity + 91;
 		}
-		r_stock_local->set_value(S_QUANTITY, &quantity);
+		r_stock_local->set_value<tpcc_schema::STOCK::S_QUANTITY>(quantity);
 
 		/*====================================================+
 		EXEC SQL INSERT
@@ -916,22 +1015,130 @@ inline RC TPCCTxnManager::new_order_9(uint64_t w_id,uint64_t  d_id,bool remote,
 		+====================================================*/
 		row_t * r_ol;
 		uint64_t row_id;
-		_wl->t_orderline->get_new_row(r_ol, wh_to_part(ol_supply_w_id), row_id);
-		r_ol->set_value(OL_O_ID, &o_id);
-		r_ol->set_value(OL_D_ID, &d_id);
-		r_ol->set_value(OL_W_ID, &w_id);
-		r_ol->set_value(OL_NUMBER, &ol_number);
-		r_ol->set_value(OL_I_ID, &ol_i_id);
+		// the line belongs to its order's warehouse, where ORDER-LINE_IDX finds it
+		_wl->t_orderline->get_new_row(r_ol, wh_to_part(w_id), row_id);
+		r_ol->set_value<tpcc_schema::ORDER_LINE::OL_O_ID>(o_id);
+		r_ol->set_value<tpcc_schema::ORDER_LINE::OL_D_ID>(d_id);
+		r_ol->set_value<tpcc_schema::ORDER_LINE::OL_W_ID>(w_id);
+		r_ol->set_value<tpcc_schema::ORDER_LINE::OL_NUMBER>(ol_number);
+		r_ol->set_value<tpcc_schema::ORDER_LINE::OL_I_ID>(ol_i_id);
 #if !TPCC_SMALL
-		r_ol->set_value(OL_SUPPLY_W_ID, &ol_supply_w_id);
-		r_ol->set_value(OL_QUANTITY, &ol_quantity);
-		r_ol->set_value(OL_AMOUNT, &ol_amount);
+		r_ol->set_value<tpcc_schema::ORDER_LINE::OL_SUPPLY_W_ID>(ol_supply_w_id);
+		r_ol->set_value<tpcc_schema::ORDER_LINE::OL_QUANTITY>(ol_quantity);
+		r_ol->set_value<tpcc_schema::ORDER_LINE::OL_AMOUNT>(ol_amount);
 #endif		
 		insert_row(r_ol, _wl->t_orderline);
 
 	return RCOK;
 }
 
+// Delivery: for each district of the warehouse, take the oldest new order
+// off NEW-ORDER, set its carrier and delivery dates, and charge its total
+// to the customer. Order lines that were supplied by a remote node live 
+// there and are not visited.
+inline RC TPCCTxnManager::delivery_0(uint64_t w_id, row_t *& r_no_local) {
+	/*===================================================================+
+	EXEC SQL DECLARE c_no CURSOR FOR
+		SELECT no_o_id FROM new_order
+		WHERE no_d_id = :d_id AND no_w_id = :w_id
+		ORDER BY no_o_id ASC;
+	EXEC SQL OPEN c_no;
+	EXEC SQL FETCH c_no INTO :no_o_id;
+	EXEC SQL DELETE FROM new_order WHERE CURRENT OF c_no;
+	+===================================================================*/
+	for (; deliv_d_id <= g_dist_per_wh; deliv_d_id ++) {
+		deliv_o_id = _wl->get_delivery_o_id(w_id, deliv_d_id);
+		itemid_t * item;
+		uint64_t cnt = index_read_multiple(_wl->i_neworder, orderPrimaryKey(w_id, deliv_d_id, deliv_o_id), 
+			wh_to_part(w_id), &item, 1);
+		// no new order in this district
+		if (cnt == 0)
+			continue;
+		deliv_no_row = (row_t *) item->location;
+		return get_row(deliv_no_row, WR, r_no_local);
+	}
+	return RCOK;
+}
+
+inline RC TPCCTxnManager::delivery_1(uint64_t w_id, row_t *& r_order_local) {
+	// another delivery took the order first
+	if (!deliv_no_row->live)
+		return Abort;
+	delete_row(deliv_no_row);
+	/*=================================================+
+	EXEC SQL SELECT o_c_id INTO :c_id FROM orders
+		WHERE o_id = :no_o_id AND o_d_id = :d_id AND o_w_id = :w_id;
+	EXEC SQL UPDATE orders SET o_carrier_id = :o_carrier_id
+		WHERE o_id = :no_o_id AND o_d_id = :d_id AND o_w_id = :w_id;
+	+=================================================*/
+	itemid_t * item = index_read(_wl->i_order, orderPrimaryKey(w_id, deliv_d_id, deliv_o_id), wh_to_part(w_id));
+	assert(item != NULL);
+	row_t * r_order = (row_t *) item->location;
+	return get_row(r_order, WR, r_order_local);
+}
+
+inline RC TPCCTxnManager::delivery_2(uint64_t w_id, uint64_t o_carrier_id, row_t * r_order_local) {
+	assert(r_order_local != NULL);
+	int64_t c_id;
+	r_order_local->get_value<tpcc_schema::ORDER::O_C_ID>(c_id);
+	deliv_c_id = c_id;
+	r_order_local->set_value<tpcc_schema::ORDER::O_CARRIER_ID>((int64_t) o_carrier_id);
+	deliv_amount = 0;
+	deliv_ol_idx = 0;
+	deliv_ol_cnt = index_read_multiple(_wl->i_orderline, orderlineKey(w_id, deliv_d_id, deliv_o_id), 
+		wh_to_part(w_id), deliv_ol_items, deliv_ol_max);
+	assert(deliv_ol_cnt <= deliv_ol_max);
+	return RCOK;
+}
+
+inline RC TPCCTxnManager::delivery_3(row_t *& r_ol_local) {
+	/*===========================================================+
+	EXEC SQL UPDATE order_line SET ol_delivery_d = :datetime
+		WHERE ol_o_id = :no_o_id AND ol_d_id = :d_id AND ol_w_id = :w_id;
+	EXEC SQL SELECT SUM(ol_amount) INTO :ol_total FROM order_line
+		WHERE ol_o_id = :no_o_id AND ol_d_id = :d_id AND ol_w_id = :w_id;
+	+===========================================================*/
+	row_t * r_ol = (row_t *) deliv_ol_items[deliv_ol_idx]->location;
+	return get_row(r_ol, WR, r_ol_local);
+}
+
+inline RC TPCCTxnManager::delivery_4(uint64_t ol_delivery_d, row_t * r_ol_local) {
+	assert(r_ol_local != NULL);
+#if !TPCC_SMALL
+	double ol_amount;
+	r_ol_local->get_value<tpcc_schema::ORDER_LINE::OL_AMOUNT>(ol_amount);
+	deliv_amount += ol_amount;
+	r_ol_local->set_value<tpcc_schema::ORDER_LINE::OL_DELIVERY_D>((int64_t) ol_delivery_d);
+#endif
+	return RCOK;
+}
+
+inline RC TPCCTxnManager::delivery_5(uint64_t w_id, row_t *& r_cust_local) {
+	/*=====================================================+
+	EXEC SQL UPDATE customer SET c_balance = c_balance + :ol_total,
+		c_delivery_cnt = c_delivery_cnt + 1
+		WHERE c_id = :c_id AND c_d_id = :d_id AND c_w_id = :w_id;
+	+=====================================================*/
+	itemid_t * item = index_read(_wl->i_customer_id, custKey(deliv_c_id, deliv_d_id, w_id), wh_to_part(w_id));
+	assert(item != NULL);
+	row_t * r_cust = (row_t *) item->location;
+	return get_row(r_cust, WR, r_cust_local);
+}
+
+inline RC TPCCTxnManager::delivery_6(row_t * r_cust_local) {
+	assert(r_cust_local != NULL);
+	double c_balance;
+#if !TPCC_SMALL
+	uint64_t c_delivery_cnt;
+#endif
+	r_cust_local->get_value<tpcc_schema::CUSTOMER::C_BALANCE>(c_balance);
+	r_cust_local->set_value<tpcc_schema::CUSTOMER::C_BALANCE>(c_balance + deliv_amount);
+#if !TPCC_SMALL
+	r_cust_local->get_value<tpcc_schema::CUSTOMER::C_DELIVERY_CNT>(c_delivery_cnt);
+	r_cust_local->set_value<tpcc_schema::CUSTOMER::C_DELIVERY_CNT>(c_delivery_cnt + 1);
+#endif
+	return RCOK;
+}
 
 RC TPCCTxnManager::run_calvin_txn() {
   RC rc = RCOK;
@@ -957,8 +1164,12 @@ RC TPCCTxnManager::run_calvin_txn() {
         DEBUG("(%ld,%ld) local reads\n",txn->txn_id,txn->batch_id);
         rc = run_tpcc_phase2();
         //release_read_locks(tpcc_query);
-
-        this->phase = CALVIN_SERVE_RD;
+        if (isRecon()) {
+            this->phase = CALVIN_DONE;
+        }
+        else {
+            this->phase = CALVIN_SERVE_RD;
+        }
         break;
       case CALVIN_SERVE_RD:
         // Phase 3: Serve remote reads
@@ -986,7 +1197,9 @@ RC TPCCTxnManager::run_calvin_txn() {
       case CALVIN_EXEC_WR:
         // Phase 5: Execute transaction / perform local writes
         DEBUG("(%ld,%ld) execute writes\n",txn->txn_id,txn->batch_id);
-        rc = run_tpcc_phase5();
+        if (txn->rc == RCOK) {
+            rc = run_tpcc_phase5();
+        }
         this->phase = CALVIN_DONE;
         break;
       default:
@@ -1011,24 +1224,36 @@ RC TPCCTxnManager::run_tpcc_phase2() {
   uint64_t d_id = tpcc_query->d_id;
   uint64_t c_id = tpcc_query->c_id;
   //uint64_t d_w_id = tpcc_query->d_w_id;
-  //uint64_t c_w_id = tpcc_query->c_w_id;
-  //uint64_t c_d_id = tpcc_query->c_d_id;
-	//char * c_last = tpcc_query->c_last;
+  uint64_t c_w_id = tpcc_query->c_w_id;
+  uint64_t c_d_id = tpcc_query->c_d_id;
+	char * c_last = tpcc_query->c_last;
   //double h_amount = tpcc_query->h_amount;
-	//bool by_last_name = tpcc_query->by_last_name;
+	bool by_last_name = tpcc_query->by_last_name;
 	bool remote = tpcc_query->remote;
 	uint64_t ol_cnt = tpcc_query->ol_cnt;
 	uint64_t o_entry_d = tpcc_query->o_entry_d;
   //uint64_t o_id = tpcc_query->o_id;
 
 	uint64_t part_id_w = wh_to_part(w_id);
-	//uint64_t part_id_c_w = wh_to_part(c_w_id);
+	uint64_t part_id_c_w = wh_to_part(c_w_id);
   bool w_loc = GET_NODE_ID(part_id_w) == g_node_id;
-  //bool c_w_loc = GET_NODE_ID(part_id_c_w) == g_node_id;
+  bool c_w_loc = GET_NODE_ID(part_id_c_w) == g_node_id;
 
 
 	switch (tpcc_query->txn_type) {
 		case TPCC_PAYMENT :
+      if(c_w_loc && by_last_name) {
+        int64_t cust_id;
+        row_t * r_cust = get_cust_by_last(c_last, c_d_id, c_w_id);
+        r_cust->get_value<tpcc_schema::CUSTOMER::C_ID>(cust_id);
+        if (isRecon()) {
+          tpcc_query->recon_keys.add(cust_id);
+        }
+        // check if the customer has changed since we did recon
+        else if (!tpcc_query->recon_keys.contains(cust_id)) {
+          txn->rc = Abort;
+        }
+      }
       break;
 		case TPCC_NEW_ORDER :
       if(w_loc) {
@@ -1037,7 +1262,7 @@ RC TPCCTxnManager::run_tpcc_phase2() {
         rc = new_order_2( w_id, d_id, c_id, remote, ol_cnt, o_entry_d, &tpcc_query->o_id, row); 
         rc = new_order_3( w_id, d_id, c_id, remote, ol_cnt, o_entry_d, &tpcc_query->o_id, row); 
         rc = new_order_4( w_id, d_id, c_id, remote, ol_cnt, o_entry_d, &tpcc_query->o_id, row); 
-        tpcc_query->o_id = *(int64_t *) row->get_value(D_NEXT_O_ID);
+        row->get_value<tpcc_schema::DISTRICT::D_NEXT_O_ID>(tpcc_query->o_id);
         //rc = new_order_5( w_id, d_id, c_id, remote, ol_cnt, o_entry_d, &tpcc_query->o_id, row); 
       }
         for(uint64_t i = 0; i < tpcc_query->ol_cnt; i++) {
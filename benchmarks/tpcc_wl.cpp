@@ -22,12 +22,14 @@
 #include "table.h"
 #include "index_hash.h"
 #include "index_btree.h"
+#include "index_art.h"
 #include "tpcc_helper.h"
 #include "row.h"
 #include "query.h"
 #include "txn.h"
 #include "mem_alloc.h"
 #include "tpcc_const.h"
+#include "tpcc_schema.h"
 
 RC TPCCWorkload::init() {
 	Workload::init();
@@ -47,10 +49,12 @@ RC TPCCWorkload::init() {
 	path += "TPCC_full_schema.txt";
 #endif
 	cout << "reading schema file: " << path << endl;
-	delivering = new bool * [g_num_wh + 1];
-	for (UInt32 wid = 1; wid <= g_num_wh; wid ++)
-		delivering[wid] = (bool *) mem_allocator.alloc(CL_SIZE);
-	
+	// the loader enqueues orders 2101 and up in NEW-ORDER
+	uint64_t dist_cnt = distKey(g_dist_per_wh, g_num_wh) + 1;
+	delivery_o_id = (volatile uint64_t *) mem_allocator.alloc(sizeof(uint64_t) * dist_cnt);
+	for (uint64_t i = 0; i < dist_cnt; i++)
+		delivery_o_id[i] = g_cust_per_dist < 2101 ? g_cust_per_dist + 1 : 2101;
+
   printf("Initializing schema... ");
   fflush(stdout);
 	init_schema( path.c_str() );
@@ -65,6 +69,7 @@ RC TPCCWorkload::init() {
 
 RC TPCCWorkload::init_schema(const char * schema_file) {
 	Workload::init_schema(schema_file);
+	check_schema(tpcc_schema::columns, sizeof(tpcc_schema::columns) / sizeof(static_column));
 	t_warehouse = tables["WAREHOUSE"];
 	t_district = tables["DISTRICT"];
 	t_customer = tables["CUSTOMER"];
@@ -81,11 +86,54 @@ RC TPCCWorkload::init_schema(const char * schema_file) {
 	i_customer_id = indexes["CUSTOMER_ID_IDX"];
 	i_customer_last = indexes["CUSTOMER_LAST_IDX"];
 	i_stock = indexes["STOCK_IDX"];
-//	i_order = indexes["ORDER_IDX"];
-//	i_orderline = indexes["ORDER-LINE_IDX"];
+	// the short schema has no order indexes
+	i_order = indexes.count("ORDER_IDX") ? indexes["ORDER_IDX"] : NULL;
+	i_orderline = indexes.count("ORDER-LINE_IDX") ? indexes["ORDER-LINE_IDX"] : NULL;
+	i_neworder = indexes.count("NEW-ORDER_IDX") ? indexes["NEW-ORDER_IDX"] : NULL;
 	return RCOK;
 }
 
+// keys of the rows that transactions insert. see Workload::index_insert_row
+idx_key_t TPCCWorkload::index_key(INDEX * index, row_t * row) {
+	int64_t w_id, d_id, o_id;
+	if (index == i_order) {
+		row->get_value<tpcc_schema::ORDER::O_W_ID>(w_id);
+		row->get_value<tpcc_schema::ORDER::O_D_ID>(d_id);
+		row->get_value<tpcc_schema::ORDER::O_ID>(o_id);
+		return orderPrimaryKey(w_id, d_id, o_id);
+	}
+	if (index == i_orderline) {
+		row->get_value<tpcc_schema::ORDER_LINE::OL_W_ID>(w_id);
+		row->get_value<tpcc_schema::ORDER_LINE::OL_D_ID>(d_id);
+		row->get_value<tpcc_schema::ORDER_LINE::OL_O_ID>(o_id);
+		return orderlineKey(w_id, d_id, o_id);
+	}
+	if (index == i_neworder) {
+		row->get_value<tpcc_schema::NEW_ORDER::NO_W_ID>(w_id);
+		row->get_value<tpcc_schema::NEW_ORDER::NO_D_ID>(d_id);
+		row->get_value<tpcc_schema::NEW_ORDER::NO_O_ID>(o_id);
+		return orderPrimaryKey(w_id, d_id, o_id);
+	}
+	return Workload::index_key(index, row);
+}
+
+// Deliveries of a district all write the NEW-ORDER row at its cursor, so 
+// only one of them commits the delete and moves the cursor on.
+void TPCCWorkload::index_remove_row(row_t * row, uint64_t thd_id) {
+	Workload::index_remove_row(row, thd_id);
+	if (row->get_table() != t_neworder)
+		return;
+	int64_t w_id, d_id, o_id;
+	row->get_value<tpcc_schema::NEW_ORDER::NO_W_ID>(w_id);
+	row->get_value<tpcc_schema::NEW_ORDER::NO_D_ID>(d_id);
+	row->get_value<tpcc_schema::NEW_ORDER::NO_O_ID>(o_id);
+	ATOM_CAS(delivery_o_id[distKey(d_id, w_id)], (uint64_t) o_id, (uint64_t) o_id + 1);
+}
+
+uint64_t TPCCWorkload::get_delivery_o_id(uint64_t w_id, uint64_t d_id) {
+	return delivery_o_id[distKey(d_id, w_id)];
+}
+
 RC TPCCWorkload::init_table() {
 	num_wh = g_num_wh;
 
@@ -203,10 +251,71 @@ RC TPCCWorkload::init_table() {
 		}
 	}
   */
+	check_table();
 	printf("\nData Initialization Complete!\n\n");
 	return RCOK;
 }
 
+// Counts the rows the loader put into each partition and checks the initial
+// column values. WAREHOUSE and DISTRICT use the row layout; CUSTOMER and
+// STOCK use PAX in the full schema.
+void TPCCWorkload::check_table() {
+	for (uint64_t part_id = 0; part_id < g_part_cnt; part_id++) {
+		if (GET_NODE_ID(part_id) != g_node_id)
+			continue;
+		uint64_t wh_expected = 0;
+		for (uint64_t wid = 1; wid <= g_num_wh; wid++) {
+			if (wh_to_part(wid) == part_id)
+				wh_expected++;
+		}
+
+		uint64_t wh_cnt = 0;
+		t_warehouse->scan(part_id, [&](row_t * row) {
+			wh_cnt++;
+			return true;
+		});
+		uint64_t dist_cnt = 0;
+		double d_ytd = 0;
+		t_district->scan_column(part_id, D_YTD, [&](column_run & run) {
+			for (uint64_t i = 0; i < run.cnt; i++) {
+				if (!run.row(i)->live)
+					continue;
+				dist_cnt++;
+				d_ytd += run.value<double>(i);
+			}
+			return true;
+		});
+		uint64_t cust_cnt = 0;
+		double c_balance = 0;
+		t_customer->scan_column(part_id, C_BALANCE, [&](column_run & run) {
+			for (uint64_t i = 0; i < run.cnt; i++) {
+				if (!run.row(i)->live)
+					continue;
+				cust_cnt++;
+				c_balance += run.value<double>(i);
+			}
+			return true;
+		});
+		uint64_t stock_cnt = 0;
+		bool stock_ok = true;
+		t_stock->scan(part_id, [&](row_t * row) {
+			int64_t quantity;
+			row->get_value(S_QUANTITY, quantity);
+			stock_ok = quantity >= 10 && quantity <= 100;
+			stock_cnt++;
+			return stock_ok;
+		});
+
+		M_ASSERT_V(wh_cnt == wh_expected, "WAREHOUSE of part %ld: %ld rows\n", part_id, wh_cnt);
+		M_ASSERT_V(dist_cnt == wh_cnt * g_dist_per_wh && d_ytd == 30000.0 * dist_cnt,
+			"DISTRICT of part %ld: %ld rows, D_YTD %f\n", part_id, dist_cnt, d_ytd);
+		M_ASSERT_V(cust_cnt == dist_cnt * g_cust_per_dist && c_balance == -10.0 * cust_cnt,
+			"CUSTOMER of part %ld: %ld rows, C_BALANCE %f\n", part_id, cust_cnt, c_balance);
+		M_ASSERT_V(stock_ok && stock_cnt == wh_cnt * g_max_items,
+			"STOCK of part %ld: %ld rows\n", part_id, stock_cnt);
+	}
+}
+
 RC TPCCWorkload::get_txn_man(TxnManager *& txn_manager) {
   DEBUG_M("TPCCWorkload::get_txn_man TPCCTxnManager alloc\n");
 	txn_manager = (TPCCTxnManager *)
@@ -247,7 +356,7 @@ void TPCCWorkload::init_tab_wh() {
     if(GET_NODE_ID(wh_to_part(wid)) != g_node_id) continue;
 		row_t * row;
 		uint64_t row_id;
-		t_warehouse->get_new_row(row, 0, row_id);
+		t_warehouse->get_new_row(row, wh_to_part(wid), row_id);
 		row->set_primary_key(wid);
 
 		row->set_value(W_ID, wid);
@@ -282,7 +391,7 @@ void TPCCWorkload::init_tab_dist(uint64_t wid) {
 	for (uint64_t did = 1; did <= g_dist_per_wh; did++) {
 		row_t * row;
 		uint64_t row_id;
-		t_district->get_new_row(row, 0, row_id);
+		t_district->get_new_row(row, wh_to_part(wid), row_id);
 		row->set_primary_key(did);
 		
 		row->set_value(D_ID, did);
@@ -307,7 +416,8 @@ void TPCCWorkload::init_tab_dist(uint64_t wid) {
     	double w_ytd=30000.00;
 		row->set_value(D_TAX, tax);
 		row->set_value(D_YTD, w_ytd);
-		row->set_value(D_NEXT_O_ID, 3001);
+		// orders 1 to g_cust_per_dist are loaded below
+		row->set_value(D_NEXT_O_ID, (int64_t) g_cust_per_dist + 1);
 		
 		index_insert(i_district, distKey(did, wid), row, wh_to_part(wid));
 	}
@@ -318,7 +428,7 @@ void TPCCWorkload::init_tab_stock(int id, uint64_t wid) {
 	for (UInt32 sid = id + 1; sid <= g_max_items; sid+=g_init_parallelism) {
 		row_t * row;
 		uint64_t row_id;
-		t_stock->get_new_row(row, 0, row_id);
+		t_stock->get_new_row(row, wh_to_part(wid), row_id);
 		row->set_primary_key(sid);
 		row->set_value(S_I_ID, sid);
 		row->set_value(S_W_ID, wid);
@@ -360,7 +470,7 @@ void TPCCWorkload::init_tab_cust(int id, uint64_t did, uint64_t wid) {
 	for (UInt32 cid = id+1; cid <= g_cust_per_dist; cid += g_init_parallelism) {
 		row_t * row;
 		uint64_t row_id;
-		t_customer->get_new_row(row, 0, row_id);
+		t_customer->get_new_row(row, wh_to_part(wid), row_id);
 		row->set_primary_key(cid);
 
 		row->set_value(C_ID, cid);		
@@ -419,7 +529,7 @@ void TPCCWorkload::init_tab_cust(int id, uint64_t did, uint64_t wid) {
 		row->set_value(C_PAYMENT_CNT, 1);
 		uint64_t key;
 		key = custNPKey(c_last, did, wid);
-		index_insert(i_customer_last, key, row, wh_to_part(wid));
+		index_insert_nonunique(i_customer_last, key, row, wh_to_part(wid));
 		key = custKey(cid, did, wid);
 		index_insert(i_customer_id, key, row, wh_to_part(wid));
 	}
@@ -428,7 +538,7 @@ void TPCCWorkload::init_tab_cust(int id, uint64_t did, uint64_t wid) {
 void TPCCWorkload::init_tab_hist(uint64_t c_id, uint64_t d_id, uint64_t w_id) {
 	row_t * row;
 	uint64_t row_id;
-	t_history->get_new_row(row, 0, row_id);
+	t_history->get_new_row(row, wh_to_part(w_id), row_id);
 	row->set_primary_key(0);
 	row->set_value(H_C_ID, c_id);
 	row->set_value(H_C_D_ID, d_id);
@@ -450,7 +560,7 @@ void TPCCWorkload::init_tab_order(int id, uint64_t did, uint64_t wid) {
 	for (UInt32 oid = id+1; oid <= g_cust_per_dist; oid+=g_init_parallelism) {
 		row_t * row;
 		uint64_t row_id;
-		t_order->get_new_row(row, 0, row_id);
+		t_order->get_new_row(row, wh_to_part(wid), row_id);
 		row->set_primary_key(oid);
 		uint64_t o_ol_cnt = 1;
 		uint64_t cid = get_permutation();
@@ -472,13 +582,13 @@ void TPCCWorkload::init_tab_order(int id, uint64_t did, uint64_t wid) {
 //		uint64_t key = custKey(cid, did, wid);
 //		index_insert(i_order_wdc, key, row, wh_to_part(wid));
 
-//		key = orderPrimaryKey(wid, did, oid);
-//		index_insert(i_order_wdo, key, row, wh_to_part(wid));
+		if (i_order != NULL)
+			index_insert(i_order, orderPrimaryKey(wid, did, oid), row, wh_to_part(wid));
 
 		// ORDER-LINE	
 #if !TPCC_SMALL
 		for (uint64_t ol = 1; ol <= o_ol_cnt; ol++) {
-			t_orderline->get_new_row(row, 0, row_id);
+			t_orderline->get_new_row(row, wh_to_part(wid), row_id);
 			row->set_value(OL_O_ID, oid);
 			row->set_value(OL_D_ID, did);
 			row->set_value(OL_W_ID, wid);
@@ -497,8 +607,7 @@ void TPCCWorkload::init_tab_order(int id, uint64_t did, uint64_t wid) {
 	        MakeAlphaString(24, 24, ol_dist_info);
 			row->set_value(OL_DIST_INFO, ol_dist_info);
 
-//			uint64_t key = orderlineKey(wid, did, oid);
-//			index_insert(i_orderline, key, row, wh_to_part(wid));
+			index_insert_nonunique(i_orderline, orderlineKey(wid, did, oid), row, wh_to_part(wid));
 			
 //			key = distKey(did, wid);
 //			index_insert(i_orderline_wd, key, row, wh_to_part(wid));
@@ -506,10 +615,12 @@ void TPCCWorkload::init_tab_order(int id, uint64_t did, uint64_t wid) {
 #endif
 		// NEW ORDER
 		if (oid > 2100) {
-			t_neworder->get_new_row(row, 0, row_id);
+			t_neworder->get_new_row(row, wh_to_part(wid), row_id);
 			row->set_value(NO_O_ID, oid);
 			row->set_value(NO_D_ID, did);
 			row->set_value(NO_W_ID, wid);
+			if (i_neworder != NULL)
+				index_insert(i_neworder, orderPrimaryKey(wid, did, oid), row, wh_to_part(wid));
 		}
 	}
 }
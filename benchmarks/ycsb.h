@@ -21,6 +21,11 @@
 #include "txn.h"
 #include "global.h"
 #include "helper.h"
+#if INDEX_STRUCT == IDX_BTREE
+#include "index_btree.h"
+#elif INDEX_STRUCT == IDX_ART
+#include "index_art.h"
+#endif
 
 class YCSBQuery;
 class YCSBQueryMessage;
@@ -54,13 +59,23 @@ private:
 	static int next_tid;
 };
 
+// how far a SCAN request has got
+struct ycsb_scan_pos {
+  uint64_t idx;
+#if INDEX_STRUCT == IDX_BTREE
+  bt_cursor cur;
+#elif INDEX_STRUCT == IDX_ART
+  art_cursor cur;
+#endif
+};
+
 class YCSBTxnManager : public TxnManager
 {
 public:
 	void init(uint64_t thd_id, Workload * h_wl);
 	void reset();
 	void partial_reset();
-  RC acquire_locks(); 
+  RC acquire_locks(uint64_t lock_part); 
 	RC run_txn();
   RC run_txn_post_wait(); 
 	RC run_calvin_txn();
@@ -70,6 +85,10 @@ private:
   RC run_txn_state();
   RC run_ycsb_0(ycsb_request * req,row_t *& row_local);
   RC run_ycsb_1(access_t acctype, row_t * row_local);
+  RC run_ycsb_scan(ycsb_request * req,row_t *& row_local);
+  row_t * next_scan_row(ycsb_request * req, ycsb_scan_pos & pos);
+  uint64_t scan_row_cnt(ycsb_request * req);
+  bool scan_pending();
   RC run_ycsb();
   bool is_done() ;
   bool is_local_request(uint64_t idx) ;
@@ -79,6 +98,8 @@ private:
 	YCSBWorkload * _wl;
 	YCSBRemTxnType state;
   uint64_t next_record_id;
+  // the current SCAN request
+  ycsb_scan_pos scan;
 };
 
 #endif
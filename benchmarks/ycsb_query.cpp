@@ -52,7 +52,10 @@ BaseQuery * YCSBQueryGenerator::create_query(Workload * h_wl, uint64_t home_part
 void YCSBQuery::print() {
   
   for(uint64_t i = 0; i < requests.size(); i++) {
-    printf("%d %ld, ",requests[i]->acctype,requests[i]->key);
+    if(requests[i]->acctype == SCAN)
+      printf("%d %ld+%d, ",requests[i]->acctype,requests[i]->key,requests[i]->scan_len);
+    else
+      printf("%d %ld, ",requests[i]->acctype,requests[i]->key);
   }
   printf("\n");
   /*
@@ -129,7 +132,7 @@ uint64_t YCSBQuery::get_participants(Workload * wl) {
   assert(active_nodes.size()==g_node_cnt);
   for(uint64_t i = 0; i < requests.size(); i++) {
     uint64_t req_nid = GET_NODE_ID(((YCSBWorkload*)wl)->key_to_part(requests[i]->key));
-    if(requests[i]->acctype == RD) {
+    if(requests[i]->acctype != WR) {
       if(participant_nodes[req_nid] == 0)
         ++participant_cnt;
       participant_nodes.set(req_nid,1);
@@ -173,6 +176,41 @@ bool YCSBQuery::readonly() {
   return true;
 }
 
+// Turns req into a range scan with probability g_scan_perc. As in YCSB-E, 
+// the scan length is uniform in [1, g_scan_len]. Scans read through the 
+// partition of their start key, whose keys are g_part_cnt apart.
+void YCSBQueryGenerator::gen_scan(ycsb_request * req, uint64_t &row_budget) {
+  req->scan_len = 0;
+  if (g_scan_perc == 0 || g_scan_len == 0)
+    return;
+	double r = (double)(mrand->next() % 10000) / 10000;		
+  if (r >= g_scan_perc)
+    return;
+  uint64_t scan_len = mrand->next() % g_scan_len + 1;
+  uint64_t max_len = (g_synth_table_size - 1 - req->key) / g_part_cnt + 1;
+  if (scan_len > max_len)
+    scan_len = max_len;
+  // a scan also locks the key after its range, see YCSBTxnManager::run_ycsb_scan
+  if (scan_len > row_budget)
+    scan_len = row_budget;
+  if (scan_len == 0)
+    return;
+  req->acctype = SCAN;
+  req->scan_len = scan_len;
+}
+
+// Reserves every key req touches; fails if one of them is already taken.
+bool YCSBQueryGenerator::claim_keys(ycsb_request * req, set<uint64_t> &all_keys) {
+  uint64_t row_cnt = req->acctype == SCAN ? req->scan_len + 1 : 1;
+  for (uint64_t i = 0; i < row_cnt; i++) {
+    if (all_keys.find(req->key + i * g_part_cnt) != all_keys.end())
+      return false;
+  }
+  for (uint64_t i = 0; i < row_cnt; i++)
+    all_keys.insert(req->key + i * g_part_cnt);
+  return true;
+}
+
 // The following algorithm comes from the paper:
 // Quickly generating billion-record synthetic databases
 // However, it seems there is a small bug. 
@@ -217,6 +255,8 @@ BaseQuery * YCSBQueryGenerator::gen_requests_hot(uint64_t home_partition_id, Wor
     part_limit = 1;
   uint64_t hot_key_max = (uint64_t)g_data_perc;
   double r_twr = (double)(mrand->next() % 10000) / 10000;		
+  // rows that scans may touch beyond one row per request
+  uint64_t row_budget = g_req_per_query < MAX_ROW_PER_TXN ? MAX_ROW_PER_TXN - g_req_per_query : 0;
 
 	int rid = 0;
 	for (UInt32 i = 0; i < g_req_per_query; i ++) {		
@@ -265,10 +305,12 @@ BaseQuery * YCSBQueryGenerator::gen_requests_hot(uint64_t home_partition_id, Wor
 		//uint64_t part_id = row_id % g_part_cnt;
 		req->key = primary_key;
 		req->value = mrand->next() % (1<<8);
+		gen_scan(req, row_budget);
 		// Make sure a single row is not accessed twice
-		if (all_keys.find(req->key) == all_keys.end()) {
-			all_keys.insert(req->key);
+		if (claim_keys(req, all_keys)) {
 			access_cnt ++;
+			if (req->acctype == SCAN)
+				row_budget -= req->scan_len;
 		} else {
       // Need to have the full g_req_per_query amount
       i--;
@@ -311,6 +353,8 @@ BaseQuery * YCSBQueryGenerator::gen_requests_zipf(uint64_t home_partition_id, Wo
   uint64_t table_size = g_synth_table_size / g_part_cnt;
 
   double r_twr = (double)(mrand->next() % 10000) / 10000;		
+  // rows that scans may touch beyond one row per request
+  uint64_t row_budget = g_req_per_query < MAX_ROW_PER_TXN ? MAX_ROW_PER_TXN - g_req_per_query : 0;
 
 	int rid = 0;
 	for (UInt32 i = 0; i < g_req_per_query; i ++) {		
@@ -339,10 +383,12 @@ BaseQuery * YCSBQueryGenerator::gen_requests_zipf(uint64_t home_partition_id, Wo
 
 		req->key = primary_key;
 		req->value = mrand->next() % (1<<8);
+		gen_scan(req, row_budget);
 		// Make sure a single row is not accessed twice
-		if (all_keys.find(req->key) == all_keys.end()) {
-			all_keys.insert(req->key);
+		if (claim_keys(req, all_keys)) {
 			access_cnt ++;
+			if (req->acctype == SCAN)
+				row_budget -= req->scan_len;
 		} else {
       // Need to have the full g_req_per_query amount
       i--;
@@ -35,18 +35,19 @@ class YCSBClientQueryMessage;
 class ycsb_request {
 public:
   ycsb_request() {}
-  ycsb_request(const ycsb_request& req) : acctype(req.acctype), key(req.key), value(req.value) { }
+  ycsb_request(const ycsb_request& req) : acctype(req.acctype), key(req.key), value(req.value), scan_len(req.scan_len) { }
   void copy(ycsb_request * req) {
     this->acctype = req->acctype;
     this->key = req->key;
     this->value = req->value;
+    this->scan_len = req->scan_len;
   }
 //	char table_name[80];
 	access_t acctype; 
 	uint64_t key;
 	char value;
-	// only for (qtype == SCAN)
-	//UInt32 scan_len;
+	// only for (acctype == SCAN): rows of key's partition read, starting at key
+	UInt32 scan_len;
 };
 
 class YCSBQueryGenerator : public QueryGenerator {
@@ -57,6 +58,8 @@ public:
 private:
 	BaseQuery * gen_requests_hot(uint64_t home_partition_id, Workload * h_wl);
 	BaseQuery * gen_requests_zipf(uint64_t home_partition_id, Workload * h_wl);
+	void gen_scan(ycsb_request * req, uint64_t &row_budget);
+	bool claim_keys(ycsb_request * req, set<uint64_t> &all_keys);
 	// for Zipfian distribution
 	double zeta(uint64_t n, double theta);
 	uint64_t zipf(uint64_t n, double theta);
@@ -24,6 +24,7 @@
 #include "row.h"
 #include "index_hash.h"
 #include "index_btree.h"
+#include "index_art.h"
 #include "catalog.h"
 #include "manager.h"
 #include "row_lock.h"
@@ -43,29 +44,48 @@ void YCSBTxnManager::init(uint64_t thd_id, Workload * h_wl) {
 void YCSBTxnManager::reset() {
   state = YCSB_0;
   next_record_id = 0;
+  scan.idx = 0;
 	TxnManager::reset();
 }
 
-RC YCSBTxnManager::acquire_locks() {
+RC YCSBTxnManager::acquire_locks(uint64_t lock_part) {
   uint64_t starttime = get_sys_clock();
-  assert(CC_ALG == CALVIN);
+  assert(CC_ALG == CALVIN || CC_ALG == VLL);
   YCSBQuery* ycsb_query = (YCSBQuery*) query;
   locking_done = false;
   RC rc = RCOK;
   incr_lr();
-  assert(ycsb_query->requests.size() == g_req_per_query);
-  assert(phase == CALVIN_RW_ANALYSIS);
+  // a VLL participant knows only the requests it received so far
+  assert(CC_ALG == VLL || ycsb_query->requests.size() == g_req_per_query);
+  assert(CC_ALG == VLL || phase == CALVIN_RW_ANALYSIS);
 	for (uint32_t rid = 0; rid < ycsb_query->requests.size(); rid ++) {
 		ycsb_request * req = ycsb_query->requests[rid];
 		uint64_t part_id = _wl->key_to_part( req->key );
     DEBUG("LK Acquire (%ld,%ld) %d,%ld -> %ld\n",get_txn_id(),get_batch_id(),req->acctype,req->key,GET_NODE_ID(part_id));
     if(GET_NODE_ID(part_id) != g_node_id)
       continue;
+    // skip the index lookup for a row another lock thread owns
+    if(req->acctype != SCAN && !calvin_owns_row(req->key,lock_part))
+      continue;
+    if(req->acctype == SCAN) {
+      // the scanned rows are known before execution since YCSB never inserts.
+      // Every lock thread walks the scan, so the cursor is its own
+      ycsb_scan_pos pos;
+      pos.idx = 0;
+      row_t * row;
+      while((row = next_scan_row(req, pos)) != NULL) {
+        RC rc2 = get_lock(row,RD,lock_part);
+        if(rc2 != RCOK) {
+          rc = rc2;
+        }
+      }
+      continue;
+    }
 		INDEX * index = _wl->the_index;
 		itemid_t * item;
 		item = index_read(index, req->key, part_id);
 		row_t * row = ((row_t *)item->location);
-		RC rc2 = get_lock(row,req->acctype);
+		RC rc2 = get_lock(row,req->acctype,lock_part);
     if(rc2 != RCOK) {
       rc = rc2;
     }
@@ -138,6 +158,11 @@ void YCSBTxnManager::next_ycsb_state() {
       state = YCSB_1;
       break;
     case YCSB_1:
+      if(scan_pending()) {
+        state = YCSB_0;
+        break;
+      }
+      scan.idx = 0;
       next_record_id++;
       if(!IS_LOCAL(txn->txn_id) || !is_done()) {
         state = YCSB_0;
@@ -184,7 +209,9 @@ RC YCSBTxnManager::run_txn_state() {
 
 	switch (state) {
 		case YCSB_0 :
-      if(loc) {
+      if(loc && req->acctype == SCAN) {
+        rc = run_ycsb_scan(req,row);
+      } else if(loc) {
         rc = run_ycsb_0(req,row);
       } else {
         rc = send_remote_request();
@@ -224,17 +251,66 @@ RC YCSBTxnManager::run_ycsb_0(ycsb_request * req,row_t *& row_local) {
 
 }
 
+// Lock-based algorithms also lock the row that follows the scanned range
+// (next-key locking), so the range cannot change until they commit.
+uint64_t YCSBTxnManager::scan_row_cnt(ycsb_request * req) {
+#if CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == CALVIN \
+  || CC_ALG == VLL
+  return req->scan_len + 1;
+#else
+  return req->scan_len;
+#endif
+}
+
+// Returns the next row of the scan, or NULL once the scan is complete or 
+// runs past the last key of the partition.
+row_t * YCSBTxnManager::next_scan_row(ycsb_request * req, ycsb_scan_pos & pos) {
+  if(pos.idx >= scan_row_cnt(req))
+    return NULL;
+  int part_id = _wl->key_to_part( req->key );
+  itemid_t * m_item;
+#if INDEX_STRUCT == IDX_BTREE || INDEX_STRUCT == IDX_ART
+  // walk the partition's tree in key order
+  uint64_t starttime = get_sys_clock();
+  if(pos.idx == 0)
+    _wl->the_index->index_scan(req->key, pos.cur, part_id);
+  idx_key_t key;
+  _wl->the_index->index_next(pos.cur, m_item, key);
+  INC_STATS(get_thd_id(), txn_index_time, get_sys_clock() - starttime);
+#else
+  // the hash index is unordered, but YCSB keys of a partition are dense
+  uint64_t key = req->key + pos.idx * g_part_cnt;
+  m_item = key < g_synth_table_size ? index_read(_wl->the_index, key, part_id) : NULL;
+#endif
+  if(m_item == NULL)
+    return NULL;
+  pos.idx++;
+  return (row_t *)m_item->location;
+}
+
+bool YCSBTxnManager::scan_pending() {
+  ycsb_request * req = ((YCSBQuery*)query)->requests[next_record_id];
+  return req->acctype == SCAN && row != NULL && scan.idx < scan_row_cnt(req);
+}
+
+RC YCSBTxnManager::run_ycsb_scan(ycsb_request * req,row_t *& row_local) {
+  row_t * row = next_scan_row(req, scan);
+  if(row == NULL) {
+    // the range ended before scan_len rows
+    row_local = NULL;
+    return RCOK;
+  }
+  return get_row(row, RD, row_local);
+}
+
 RC YCSBTxnManager::run_ycsb_1(access_t acctype, row_t * row_local) {
-  if (acctype == RD || acctype == SCAN) {
+  if (row_local == NULL) {
+    assert(acctype == SCAN);
+  } else if (acctype == RD || acctype == SCAN) {
     int fid = 0;
 		char * data = row_local->get_data();
 		uint64_t fval __attribute__ ((unused));
     fval = *(uint64_t *)(&data[fid * 100]);
-#if ISOLATION_LEVEL == READ_COMMITTED || ISOLATION_LEVEL == READ_UNCOMMITTED
-    // Release lock after read
-    release_last_row_lock(); 
-#endif
-
   } else {
     assert(acctype == WR);
 		int fid = 0;
@@ -244,11 +320,6 @@ RC YCSBTxnManager::run_ycsb_1(access_t acctype, row_t * row_local) {
     if(data[0] == 'a')
       return RCOK;
 #endif
-
-#if ISOLATION_LEVEL == READ_UNCOMMITTED
-    // Release lock after write
-    release_last_row_lock(); 
-#endif
   } 
   return RCOK;
 }
@@ -333,7 +404,7 @@ RC YCSBTxnManager::run_ycsb() {
 	  ycsb_request * req = ycsb_query->requests[i];
     if(this->phase == CALVIN_LOC_RD && req->acctype == WR)
       continue;
-    if(this->phase == CALVIN_EXEC_WR && req->acctype == RD)
+    if(this->phase == CALVIN_EXEC_WR && req->acctype != WR)
       continue;
 
 		uint64_t part_id = _wl->key_to_part( req->key );
@@ -342,6 +413,17 @@ RC YCSBTxnManager::run_ycsb() {
     if(!loc)
       continue;
 
+    if(req->acctype == SCAN) {
+      scan.idx = 0;
+      do {
+        rc = run_ycsb_scan(req,row);
+        assert(rc == RCOK);
+        rc = run_ycsb_1(req->acctype,row);
+        assert(rc == RCOK);
+      } while(row != NULL);
+      continue;
+    }
+
     rc = run_ycsb_0(req,row);
     assert(rc == RCOK);
 
@@ -23,6 +23,7 @@
 #include "row.h"
 #include "index_hash.h"
 #include "index_btree.h"
+#include "index_art.h"
 #include "catalog.h"
 #include "manager.h"
 #include "row_lock.h"
@@ -0,0 +1,226 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "global.h"
+#include "helper.h"
+#include "txn.h"
+#include "row.h"
+#include "row_lock.h"
+#include "dl_detect.h"
+#include "message.h"
+#include "msg_queue.h"
+#include "txn_table.h"
+
+void DL_detect::init() {
+	pthread_mutex_init(&latch, NULL);
+	node_edges = new std::vector<uint64_t>[g_node_cnt];
+	last_run = 0;
+}
+
+void DL_detect::add_dep(TxnManager * txn, row_t * row, uint64_t * txnids, int txncnt) {
+	pthread_mutex_lock(&latch);
+	// lock_get has dropped the row latch, so the lock may have been granted
+	// and clear_dep run already. Recording the wait then would leave an
+	// edge for a txn that no longer waits
+	if (!txn->lock_ready) {
+		DLWait & wait = waits[txn->get_txn_id()];
+		wait.ts = txn->get_timestamp();
+		wait.txn = txn;
+		wait.row = row;
+		wait.waits_for.assign(txnids, txnids + txncnt);
+	}
+	pthread_mutex_unlock(&latch);
+}
+
+void DL_detect::clear_dep(uint64_t txn_id) {
+	pthread_mutex_lock(&latch);
+	waits.erase(txn_id);
+	pthread_mutex_unlock(&latch);
+}
+
+void DL_detect::add_local_vertices(std::map<uint64_t, DLVertex> & graph) {
+	for (std::map<uint64_t, DLWait>::iterator it = waits.begin(); it != waits.end(); it++) {
+		DLVertex & v = graph[it->first];
+		v.ts = it->second.ts;
+		v.node_id = g_node_id;
+		v.waits_for = it->second.waits_for;
+	}
+}
+
+void DL_detect::run(uint64_t thd_id) {
+	uint64_t now = get_sys_clock();
+	if (now - last_run < DL_LOOP_DETECT)
+		return;
+	last_run = now;
+
+	std::map<uint64_t, DLVertex> graph;
+	std::vector<DLDetectMessage *> msgs;
+	pthread_mutex_lock(&latch);
+	add_local_vertices(graph);
+	if (g_node_id != 0) {
+		// report the local edges, split so that every message fits into a
+		// message buffer. an empty report is sent too, to clear the last one.
+		uint64_t edge_cnt = 0;
+		for (std::map<uint64_t, DLWait>::iterator it = waits.begin(); it != waits.end(); it++)
+			edge_cnt += it->second.waits_for.size();
+		uint64_t left = edge_cnt;
+		DLDetectMessage * msg = NULL;
+		for (std::map<uint64_t, DLWait>::iterator it = waits.begin(); it != waits.end(); it++) {
+			for (uint64_t i = 0; i < it->second.waits_for.size(); i++) {
+				if (msg == NULL || msg->edges.is_full()) {
+					msg = new_graph_msg(msgs.empty(), left);
+					msgs.push_back(msg);
+				}
+				msg->edges.add(it->first);
+				msg->edges.add(it->second.ts);
+				msg->edges.add(it->second.waits_for[i]);
+				left --;
+			}
+		}
+		if (msgs.empty())
+			msgs.push_back(new_graph_msg(true, 0));
+	} else {
+		for (uint64_t n = 1; n < g_node_cnt; n++) {
+			std::vector<uint64_t> & edges = node_edges[n];
+			for (uint64_t i = 0; i < edges.size(); i += 3) {
+				DLVertex & v = graph[edges[i]];
+				if (v.waits_for.empty()) {
+					v.ts = edges[i + 1];
+					v.node_id = n;
+				}
+				v.waits_for.push_back(edges[i + 2]);
+			}
+		}
+	}
+	detect(thd_id, graph);
+	pthread_mutex_unlock(&latch);
+	for (uint64_t i = 0; i < msgs.size(); i++)
+		msg_queue.enqueue(thd_id, msgs[i], 0);
+}
+
+DLDetectMessage * DL_detect::new_graph_msg(bool first, uint64_t edge_cnt) {
+	DLDetectMessage * msg = (DLDetectMessage *) Message::create_message(DL_GRAPH);
+	msg->first = first;
+	msg->edges.init(min(edge_cnt, DL_MSG_EDGES) * 3);
+	return msg;
+}
+
+void DL_detect::process(uint64_t thd_id, Message * msg) {
+	pthread_mutex_lock(&latch);
+	if (msg->rtype == DL_GRAPH) {
+		assert(g_node_id == 0);
+		Array<uint64_t> & edges = ((DLDetectMessage *) msg)->edges;
+		std::vector<uint64_t> & last = node_edges[msg->return_node_id];
+		if (((DLDetectMessage *) msg)->first)
+			last.clear();
+		for (uint64_t i = 0; i < edges.size(); i++)
+			last.push_back(edges[i]);
+	} else if (msg->rtype == DL_ABORT) {
+		if (abort_victim(thd_id, msg->txn_id))
+			INC_STATS(thd_id,twopl_deadlock_cnt,1);
+	} else {
+		assert(msg->rtype == RWOUND);
+		// the node that wounded the txn resumes it itself
+		if (txn_table.wound_txn(thd_id, msg->txn_id))
+			abort_victim(thd_id, msg->txn_id);
+	}
+	pthread_mutex_unlock(&latch);
+}
+
+void DL_detect::wound(uint64_t thd_id, uint64_t txn_id, bool notify) {
+	pthread_mutex_lock(&latch);
+	abort_victim(thd_id, txn_id);
+	pthread_mutex_unlock(&latch);
+	for (uint64_t n = 0; n < g_node_cnt && notify; n++) {
+		if (n != g_node_id)
+			msg_queue.enqueue(thd_id, Message::create_message(txn_id, RWOUND), n);
+	}
+}
+
+void DL_detect::detect(uint64_t thd_id, std::map<uint64_t, DLVertex> & graph) {
+	uint64_t victim;
+	while (find_cycle(graph, victim)) {
+		DLVertex & v = graph[victim];
+		DEBUG("deadlock victim %ld ts %ld at node %ld\n",victim,v.ts,v.node_id);
+		if (v.node_id == g_node_id) {
+			if (abort_victim(thd_id, victim))
+				INC_STATS(thd_id,twopl_deadlock_cnt,1);
+		} else
+			msg_queue.enqueue(thd_id, Message::create_message(victim, DL_ABORT), v.node_id);
+		graph.erase(victim);
+	}
+}
+
+bool DL_detect::find_cycle(std::map<uint64_t, DLVertex> & graph, uint64_t &victim) {
+	// 1 while on the DFS stack, 2 once all successors are visited
+	std::map<uint64_t, int> color;
+	// txn_id and the index of the next edge to follow
+	std::vector<std::pair<uint64_t, uint64_t> > stack;
+	for (std::map<uint64_t, DLVertex>::iterator it = graph.begin(); it != graph.end(); it++) {
+		if (color[it->first] != 0)
+			continue;
+		color[it->first] = 1;
+		stack.push_back(std::make_pair(it->first, 0));
+		while (!stack.empty()) {
+			DLVertex & u = graph[stack.back().first];
+			if (stack.back().second == u.waits_for.size()) {
+				color[stack.back().first] = 2;
+				stack.pop_back();
+				continue;
+			}
+			uint64_t w = u.waits_for[stack.back().second ++];
+			// a txn that is not blocked is not on a cycle
+			if (graph.find(w) == graph.end() || color[w] == 2)
+				continue;
+			if (color[w] == 0) {
+				color[w] = 1;
+				stack.push_back(std::make_pair(w, 0));
+				continue;
+			}
+			// the stack from w up is a cycle. ties go to the larger txn_id
+			victim = w;
+			for (uint64_t i = stack.size() - 1; stack[i].first != w; i--) {
+				uint64_t id = stack[i].first;
+				if (graph[id].ts > graph[victim].ts ||
+						(graph[id].ts == graph[victim].ts && id > victim))
+					victim = id;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool DL_detect::abort_victim(uint64_t thd_id, uint64_t txn_id) {
+#if CC_ALG == DL_DETECT || CC_ALG == WOUND_WAIT
+	std::map<uint64_t, DLWait>::iterator it = waits.find(txn_id);
+	if (it == waits.end())
+		return false;
+	TxnManager * txn = it->second.txn;
+	// the lock may have been granted since the graph was taken
+	if (!it->second.row->manager->lock_cancel(txn,thd_id))
+		return false;
+	waits.erase(it);
+	txn->lock_cancelled = true;
+	// resume the txn as if it got the lock; it aborts when it sees
+	// lock_cancelled
+	if (txn->decr_lr() == 0 && ATOM_CAS(txn->lock_ready,false,true))
+		txn_table.restart_txn(thd_id,txn->get_txn_id(),txn->get_batch_id());
+	return true;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,97 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef _DL_DETECT_H_
+#define _DL_DETECT_H_
+
+#include "global.h"
+#include <map>
+#include <vector>
+
+class TxnManager;
+class Message;
+class DLDetectMessage;
+
+// edges per DL_GRAPH message, so that it fits into half a message buffer
+#define DL_MSG_EDGES 	(g_msg_size / 2 / (3 * sizeof(uint64_t)))
+
+// A lock request that is blocked at this node
+struct DLWait {
+	uint64_t 	ts;
+	TxnManager * txn;
+	row_t * 	row;
+	// the owners of the lock and the txns queued before this one
+	std::vector<uint64_t> waits_for;
+};
+
+// One vertex of the waits-for graph searched for cycles
+struct DLVertex {
+	uint64_t 	ts;
+	// the node at which the txn is blocked
+	uint64_t 	node_id;
+	std::vector<uint64_t> waits_for;
+};
+
+// Deadlock detection for two-phase locking. Every node keeps the edges of the
+// lock requests that are blocked on its rows. Worker thread 0 of every node
+// periodically searches them for cycles, and ships them to node 0, which
+// searches the union of the graphs of all nodes for cycles across nodes.
+// Of each cycle the youngest txn (largest timestamp) is the victim: its
+// blocked request is taken out of the waiter list of the row, and the txn
+// is resumed and aborts.
+//
+// The graphs of other nodes are up to DL_LOOP_DETECT old at node 0, so a
+// cycle found there may already be gone. The victim is only aborted if it
+// is still blocked on the same request.
+//
+// WOUND_WAIT does not search for cycles. It only uses the blocked requests,
+// to resume a wounded txn that is blocked so that it aborts.
+class DL_detect {
+public:
+	void 		init();
+	// txn is blocked on the lock of row by the txns in txnids. ignored if
+	// the lock has been granted meanwhile
+	void 		add_dep(TxnManager * txn, row_t * row, uint64_t * txnids, int txncnt);
+	// txn is not blocked anymore. called by txn when it resumes
+	void 		clear_dep(uint64_t txn_id);
+	// runs the detection every DL_LOOP_DETECT
+	void 		run(uint64_t thd_id);
+	// DL_GRAPH at node 0, DL_ABORT at the node where the victim is blocked,
+	// RWOUND at every node
+	void 		process(uint64_t thd_id, Message * msg);
+	// [WOUND_WAIT] txn_id was wounded. resumes it if it is blocked here, and
+	// with notify tells the other nodes, where it may be blocked too
+	void 		wound(uint64_t thd_id, uint64_t txn_id, bool notify);
+private:
+	void 		detect(uint64_t thd_id, std::map<uint64_t, DLVertex> & graph);
+	// sets victim to the youngest txn of a cycle. false if there is none
+	bool 		find_cycle(std::map<uint64_t, DLVertex> & graph, uint64_t &victim);
+	// cancels the blocked request of txn_id. false if it is not blocked
+	bool 		abort_victim(uint64_t thd_id, uint64_t txn_id);
+	void 		add_local_vertices(std::map<uint64_t, DLVertex> & graph);
+	DLDetectMessage * new_graph_msg(bool first, uint64_t edge_cnt);
+
+	// protects waits and node_edges
+	pthread_mutex_t latch;
+	// blocked requests at this node, by txn_id
+	std::map<uint64_t, DLWait> waits;
+	// node 0 only: the edges last reported by every node, as
+	// (txn_id, ts, waits-for txn_id) triples
+	std::vector<uint64_t> * node_edges;
+	uint64_t 	last_run;
+};
+
+#endif
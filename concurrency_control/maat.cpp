@@ -21,6 +21,7 @@
 #include "manager.h"
 #include "mem_alloc.h"
 #include "row_maat.h"
+#include "epoch.h"
 
 void Maat::init() {
   sem_init(&_semaphore, 0, 1);
@@ -37,6 +38,11 @@ RC Maat::validate(TxnManager * txn) {
   INC_STATS(txn->get_thd_id(),maat_cs_wait_time,timespan);
   start_time = get_sys_clock();
   RC rc = RCOK;
+  // accesses append every id they see; the sets are deduped once here, and
+  // commit looks them up by binary search
+  txn->uncommitted_writes.sort_unique();
+  txn->uncommitted_writes_y.sort_unique();
+  txn->uncommitted_reads.sort_unique();
   uint64_t lower = time_table.get_lower(txn->get_thd_id(),txn->get_txn_id());
   uint64_t upper = time_table.get_upper(txn->get_thd_id(),txn->get_txn_id());
   DEBUG("MAAT Validate Start %ld: [%lu,%lu]\n",txn->get_txn_id(),lower,upper);
@@ -48,10 +54,11 @@ RC Maat::validate(TxnManager * txn) {
     INC_STATS(txn->get_thd_id(),maat_case1_cnt,1);
   }
   // lower bound of uncommitted writes greater than upper bound of txn
-  for(auto it = txn->uncommitted_writes->begin(); it != txn->uncommitted_writes->end();it++) {
-    uint64_t it_lower = time_table.get_lower(txn->get_thd_id(),*it);
+  for(uint64_t i = 0; i < txn->uncommitted_writes.size(); i++) {
+    uint64_t id = txn->uncommitted_writes[i];
+    uint64_t it_lower = time_table.get_lower(txn->get_thd_id(),id);
     if(upper >= it_lower) {
-      MAATState state = time_table.get_state(txn->get_thd_id(),*it);
+      MAATState state = time_table.get_state(txn->get_thd_id(),id);
       if(state == MAAT_VALIDATED || state == MAAT_COMMITTED) {
         INC_STATS(txn->get_thd_id(),maat_case2_cnt,1);
         if(it_lower > 0) {
@@ -61,7 +68,7 @@ RC Maat::validate(TxnManager * txn) {
         }
       }
       if(state == MAAT_RUNNING) {
-        after.insert(*it);
+        after.insert(id);
       }
     }
   }
@@ -71,10 +78,11 @@ RC Maat::validate(TxnManager * txn) {
     INC_STATS(txn->get_thd_id(),maat_case3_cnt,1);
   }
   // upper bound of uncommitted reads less than lower bound of txn
-  for(auto it = txn->uncommitted_reads->begin(); it != txn->uncommitted_reads->end();it++) {
-    uint64_t it_upper = time_table.get_upper(txn->get_thd_id(),*it);
+  for(uint64_t i = 0; i < txn->uncommitted_reads.size(); i++) {
+    uint64_t id = txn->uncommitted_reads[i];
+    uint64_t it_upper = time_table.get_upper(txn->get_thd_id(),id);
     if(lower <= it_upper) {
-      MAATState state = time_table.get_state(txn->get_thd_id(),*it);
+      MAATState state = time_table.get_state(txn->get_thd_id(),id);
       if(state == MAAT_VALIDATED || state == MAAT_COMMITTED) {
         INC_STATS(txn->get_thd_id(),maat_case4_cnt,1);
         if(it_upper < UINT64_MAX) {
@@ -84,14 +92,15 @@ RC Maat::validate(TxnManager * txn) {
         }
       }
       if(state == MAAT_RUNNING) {
-        before.insert(*it);
+        before.insert(id);
       }
     }
   }
   // upper bound of uncommitted write writes less than lower bound of txn
-  for(auto it = txn->uncommitted_writes_y->begin(); it != txn->uncommitted_writes_y->end();it++) {
-      MAATState state = time_table.get_state(txn->get_thd_id(),*it);
-    uint64_t it_upper = time_table.get_upper(txn->get_thd_id(),*it);
+  for(uint64_t i = 0; i < txn->uncommitted_writes_y.size(); i++) {
+    uint64_t id = txn->uncommitted_writes_y[i];
+      MAATState state = time_table.get_state(txn->get_thd_id(),id);
+    uint64_t it_upper = time_table.get_upper(txn->get_thd_id(),id);
       if(state == MAAT_ABORTED) {
         continue;
       }
@@ -106,7 +115,7 @@ RC Maat::validate(TxnManager * txn) {
         }
       }
       if(state == MAAT_RUNNING) {
-        after.insert(*it);
+        after.insert(id);
       }
   }
   if(lower >= upper) {
@@ -124,14 +133,13 @@ RC Maat::validate(TxnManager * txn) {
         lower = it_upper + 1;
       }
     }
+    // other txns narrow these bounds concurrently at commit, so they are
+    // only ever moved inwards
     for(auto it = before.begin(); it != before.end();it++) {
-      uint64_t it_upper = time_table.get_upper(txn->get_thd_id(),*it);
-      if(it_upper >= lower) {
-        if(lower > 0) {
-          time_table.set_upper(txn->get_thd_id(),*it,lower-1);
-        } else {
-          time_table.set_upper(txn->get_thd_id(),*it,lower);
-        }
+      if(lower > 0) {
+        time_table.cap_upper(txn->get_thd_id(),*it,lower-1);
+      } else {
+        time_table.cap_upper(txn->get_thd_id(),*it,lower);
       }
     }
     for(auto it = after.begin(); it != after.end();it++) {
@@ -146,13 +154,10 @@ RC Maat::validate(TxnManager * txn) {
     }
     // set all upper and lower bounds to meet inequality
     for(auto it = after.begin(); it != after.end();it++) {
-      uint64_t it_lower = time_table.get_lower(txn->get_thd_id(),*it);
-      if(it_lower <= upper) {
-        if(upper < UINT64_MAX) {
-          time_table.set_lower(txn->get_thd_id(),*it,upper+1);
-        } else {
-          time_table.set_lower(txn->get_thd_id(),*it,upper);
-        }
+      if(upper < UINT64_MAX) {
+        time_table.raise_lower(txn->get_thd_id(),*it,upper+1);
+      } else {
+        time_table.raise_lower(txn->get_thd_id(),*it,upper);
       }
     }
 
@@ -160,8 +165,9 @@ RC Maat::validate(TxnManager * txn) {
     INC_STATS(txn->get_thd_id(),maat_range,upper-lower);
     INC_STATS(txn->get_thd_id(),maat_commit_cnt,1);
   }
-  time_table.set_lower(txn->get_thd_id(),txn->get_txn_id(),lower);
-  time_table.set_upper(txn->get_thd_id(),txn->get_txn_id(),upper);
+  // a commit may have narrowed the txn's own range since it was read above
+  time_table.raise_lower(txn->get_thd_id(),txn->get_txn_id(),lower);
+  time_table.cap_upper(txn->get_thd_id(),txn->get_txn_id(),upper);
   INC_STATS(txn->get_thd_id(),maat_validate_cnt,1);
   timespan = get_sys_clock() - start_time;
   INC_STATS(txn->get_thd_id(),maat_validate_time,timespan);
@@ -190,134 +196,163 @@ RC Maat::find_bound(TxnManager * txn) {
 }
 
 void TimeTable::init() {
-  //table_size = g_inflight_max * g_node_cnt * 2 + 1;
-  table_size = g_inflight_max + 1;
+  // every txn that can be in flight at this node, with room for the slots
+  // that wait for their epoch, at a quarter load
+  uint64_t max_entries = g_inflight_max * g_node_cnt + g_this_total_thread_cnt * EPOCH_RECLAIM_BATCH;
+  table_bits = 0;
+  while((1UL << table_bits) < max_entries * 4)
+    table_bits++;
+  table_size = 1UL << table_bits;
   DEBUG_M("TimeTable::init table alloc\n");
-  table = (TimeTableNode*) mem_allocator.alloc(sizeof(TimeTableNode) * table_size);
+  table = (TimeTableEntry*) mem_allocator.align_alloc(sizeof(TimeTableEntry) * table_size);
   for(uint64_t i = 0; i < table_size;i++) {
-    table[i].init();
+    // nobody knows the txn before it accesses a row
+    table[i].lower = 0;
+    table[i].upper = UINT64_MAX;
+    table[i].state = MAAT_RUNNING;
+    table[i].key = TT_EMPTY;
   }
+  overflow = NULL;
 }
 
 uint64_t TimeTable::hash(uint64_t key) {
-  return key % table_size;
+  // the txn ids of a node are strided by the node count
+  return (key * 11400714819323198485UL) >> (64 - table_bits);
 }
 
+// A slot below the home slot of a key is never emptied again, so the search
+// stops at the first empty slot
 TimeTableEntry* TimeTable::find(uint64_t key) {
-  TimeTableEntry * entry = table[hash(key)].head;
-  while(entry) {
-    if(entry->key == key) 
+  uint64_t idx = hash(key);
+  for(uint64_t i = 0; i < TT_PROBE_LEN; i++) {
+    TimeTableEntry * entry = &table[(idx + i) & (table_size - 1)];
+    uint64_t k = entry->key;
+    if(k == key)
+      return entry;
+    if(k == TT_EMPTY)
       break;
-    entry = entry->next;
   }
-  return entry;
-
+  for(TimeTableOverflow * o = overflow; o != NULL; o = o->next) {
+    if(o->entry.key == key)
+      return &o->entry;
+  }
+  return NULL;
 }
 
 void TimeTable::init(uint64_t thd_id, uint64_t key) {
+  if(find(key))
+    return;
+  TimeTableEntry * entry = NULL;
   uint64_t idx = hash(key);
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  pthread_mutex_lock(&table[idx].mtx);
-  INC_STATS(thd_id,mtx[34],get_sys_clock() - mtx_wait_starttime);
-  TimeTableEntry* entry = find(key);
+  for(uint64_t i = 0; i < TT_PROBE_LEN && !entry; i++) {
+    TimeTableEntry * e = &table[(idx + i) & (table_size - 1)];
+    uint64_t k = e->key;
+    if((k == TT_EMPTY || k == TT_FREE) && ATOM_CAS(e->key,k,key))
+      entry = e;
+  }
+  if(!entry) {
+    INC_STATS(thd_id,maat_tt_overflow_cnt,1);
+    for(TimeTableOverflow * o = overflow; o != NULL && !entry; o = o->next) {
+      if(o->entry.key == TT_FREE && ATOM_CAS(o->entry.key,TT_FREE,key))
+        entry = &o->entry;
+    }
+  }
   if(!entry) {
-    DEBUG_M("TimeTable::init entry alloc\n");
-    entry = (TimeTableEntry*) mem_allocator.alloc(sizeof(TimeTableEntry));
-    entry->init(key);
-    LIST_PUT_TAIL(table[idx].head,table[idx].tail,entry);
+    DEBUG_M("TimeTable::init overflow alloc\n");
+    TimeTableOverflow * o = (TimeTableOverflow*) mem_allocator.alloc(sizeof(TimeTableOverflow));
+    o->entry.key = key;
+    // set the bounds before the entry is published
+    o->entry.lower = 0;
+    o->entry.upper = UINT64_MAX;
+    o->entry.state = MAAT_RUNNING;
+    do {
+      o->next = overflow;
+    } while(!ATOM_CAS(overflow,o->next,o));
   }
-  pthread_mutex_unlock(&table[idx].mtx);
 }
 
 void TimeTable::release(uint64_t thd_id, uint64_t key) {
-  uint64_t idx = hash(key);
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  pthread_mutex_lock(&table[idx].mtx);
-  INC_STATS(thd_id,mtx[35],get_sys_clock() - mtx_wait_starttime);
   TimeTableEntry* entry = find(key);
   if(entry) {
-    LIST_REMOVE_HT(entry,table[idx].head,table[idx].tail);
-    DEBUG_M("TimeTable::release entry free\n");
-    mem_allocator.free(entry,sizeof(TimeTableEntry));
+    entry->key = TT_DEAD;
+    epoch_man.retire_tt_entry(thd_id,entry);
   }
-  pthread_mutex_unlock(&table[idx].mtx);
+}
+
+void TimeTable::free_entry(TimeTableEntry * entry) {
+  assert(entry->key == TT_DEAD);
+  // reset before the slot can be claimed, so a new owner never shows the
+  // bounds or state of the old one
+  entry->lower = 0;
+  entry->upper = UINT64_MAX;
+  entry->state = MAAT_RUNNING;
+  MEM_BARRIER();
+  entry->key = TT_FREE;
 }
 
 uint64_t TimeTable::get_lower(uint64_t thd_id, uint64_t key) {
-  uint64_t idx = hash(key);
   uint64_t value = 0;
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  pthread_mutex_lock(&table[idx].mtx);
-  INC_STATS(thd_id,mtx[36],get_sys_clock() - mtx_wait_starttime);
   TimeTableEntry* entry = find(key);
   if(entry) {
     value = entry->lower;
   }
-  pthread_mutex_unlock(&table[idx].mtx);
   return value;
 }
 
 uint64_t TimeTable::get_upper(uint64_t thd_id, uint64_t key) {
-  uint64_t idx = hash(key);
   uint64_t value = UINT64_MAX;
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  pthread_mutex_lock(&table[idx].mtx);
-  INC_STATS(thd_id,mtx[37],get_sys_clock() - mtx_wait_starttime);
   TimeTableEntry* entry = find(key);
   if(entry) {
     value = entry->upper;
   }
-  pthread_mutex_unlock(&table[idx].mtx);
   return value;
 }
 
 
 void TimeTable::set_lower(uint64_t thd_id, uint64_t key, uint64_t value) {
-  uint64_t idx = hash(key);
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  pthread_mutex_lock(&table[idx].mtx);
-  INC_STATS(thd_id,mtx[38],get_sys_clock() - mtx_wait_starttime);
   TimeTableEntry* entry = find(key);
   if(entry) {
     entry->lower = value;
   }
-  pthread_mutex_unlock(&table[idx].mtx);
 }
 
 void TimeTable::set_upper(uint64_t thd_id, uint64_t key, uint64_t value) {
-  uint64_t idx = hash(key);
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  pthread_mutex_lock(&table[idx].mtx);
-  INC_STATS(thd_id,mtx[39],get_sys_clock() - mtx_wait_starttime);
   TimeTableEntry* entry = find(key);
   if(entry) {
     entry->upper = value;
   }
-  pthread_mutex_unlock(&table[idx].mtx);
+}
+
+void TimeTable::raise_lower(uint64_t thd_id, uint64_t key, uint64_t value) {
+  TimeTableEntry* entry = find(key);
+  if(entry) {
+    uint64_t lower = entry->lower;
+    while(lower < value && !ATOM_CAS(entry->lower,lower,value))
+      lower = entry->lower;
+  }
+}
+
+void TimeTable::cap_upper(uint64_t thd_id, uint64_t key, uint64_t value) {
+  TimeTableEntry* entry = find(key);
+  if(entry) {
+    uint64_t upper = entry->upper;
+    while(upper > value && !ATOM_CAS(entry->upper,upper,value))
+      upper = entry->upper;
+  }
 }
 
 MAATState TimeTable::get_state(uint64_t thd_id, uint64_t key) {
-  uint64_t idx = hash(key);
   MAATState state = MAAT_ABORTED;
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  pthread_mutex_lock(&table[idx].mtx);
-  INC_STATS(thd_id,mtx[40],get_sys_clock() - mtx_wait_starttime);
   TimeTableEntry* entry = find(key);
   if(entry) {
     state = entry->state;
   }
-  pthread_mutex_unlock(&table[idx].mtx);
   return state;
 }
 
 void TimeTable::set_state(uint64_t thd_id, uint64_t key, MAATState value) {
-  uint64_t idx = hash(key);
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  pthread_mutex_lock(&table[idx].mtx);
-  INC_STATS(thd_id,mtx[41],get_sys_clock() - mtx_wait_starttime);
   TimeTableEntry* entry = find(key);
   if(entry) {
     entry->state = value;
   }
-  pthread_mutex_unlock(&table[idx].mtx);
 }
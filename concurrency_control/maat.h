@@ -34,32 +34,28 @@ private:
  	sem_t 	_semaphore;
 };
 
+// The time table is an open-addressed array of slots keyed by txn id. A
+// txn lives in one of the TT_PROBE_LEN slots from its home slot, so nothing
+// is latched: a slot is claimed with a CAS on its key and the bounds are
+// single words. A released slot stays dead until the epoch manager resets
+// and frees it, so a txn never finds a slot that was taken over by another
+// txn while it was looking at it. A txn that finds its whole window taken goes to an
+// overflow list; its entries are reused the same way and never unlinked.
+#define TT_EMPTY UINT64_MAX
+#define TT_DEAD (UINT64_MAX - 1)
+#define TT_FREE (UINT64_MAX - 2)
+#define TT_PROBE_LEN 32
+
 struct TimeTableEntry{
-  uint64_t lower;
-  uint64_t upper;
-  uint64_t key;
-  MAATState state;
-  TimeTableEntry * next;
-  TimeTableEntry * prev;
-  void init(uint64_t key) {
-    lower = 0;
-    upper = UINT64_MAX;
-    this->key = key;
-    state = MAAT_RUNNING;
-    next = NULL;
-    prev = NULL;
-  }
+  volatile uint64_t key;
+  volatile uint64_t lower;
+  volatile uint64_t upper;
+  volatile MAATState state;
 };
 
-struct TimeTableNode {
-  TimeTableEntry * head;
-  TimeTableEntry * tail;
-  pthread_mutex_t mtx;
-  void init() {
-    head = NULL;
-    tail = NULL;
-    pthread_mutex_init(&mtx,NULL);
-  }
+struct TimeTableOverflow {
+  TimeTableEntry entry;
+  TimeTableOverflow * volatile next;
 };
 
 class TimeTable {
@@ -71,18 +67,20 @@ public:
   uint64_t get_upper(uint64_t thd_id, uint64_t key);
   void set_lower(uint64_t thd_id, uint64_t key, uint64_t value);
   void set_upper(uint64_t thd_id, uint64_t key, uint64_t value);
+  // move the bound only if that narrows the range
+  void raise_lower(uint64_t thd_id, uint64_t key, uint64_t value);
+  void cap_upper(uint64_t thd_id, uint64_t key, uint64_t value);
   MAATState get_state(uint64_t thd_id, uint64_t key);
   void set_state(uint64_t thd_id, uint64_t key, MAATState value);
+  // called by the epoch manager once nobody can hold the slot any more
+  void free_entry(TimeTableEntry * entry);
 private:
-  // hash table
   uint64_t hash(uint64_t key);
-  uint64_t table_size;
-  TimeTableNode* table;
   TimeTableEntry* find(uint64_t key);
-
-  TimeTableEntry * find_entry(uint64_t id);
-	
- 	sem_t 	_semaphore;
+  uint64_t table_size;
+  uint64_t table_bits;
+  TimeTableEntry* table;
+  TimeTableOverflow * volatile overflow;
 };
 
 #endif
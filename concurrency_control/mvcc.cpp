@@ -0,0 +1,95 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "global.h"
+#include "helper.h"
+#include "mvcc.h"
+#include "txn.h"
+#include "mem_alloc.h"
+
+void Mvcc::init() {
+	min_ts = 0;
+	last_run = 0;
+	slot_cnt = g_this_total_thread_cnt;
+	slots = (ts_slot *) mem_allocator.align_alloc(sizeof(ts_slot) * slot_cnt);
+	for (uint64_t i = 0; i < slot_cnt; i++) {
+		slots[i].latch = false;
+		slots[i].head = NULL;
+		slots[i].tail = NULL;
+	}
+}
+
+void Mvcc::lock(ts_slot * slot) {
+	while (!ATOM_CAS(slot->latch, false, true)) { }
+}
+
+void Mvcc::unlock(ts_slot * slot) {
+	ATOM_CAS(slot->latch, true, false);
+}
+
+bool Mvcc::start(uint64_t thd_id, TxnManager * txn, bool pending) {
+	// a restarted txn stays in its slot; its new timestamp is read from there
+	if (txn->mvcc_slot != NULL)
+		return true;
+	ts_slot * slot = &slots[thd_id % slot_cnt];
+	lock(slot);
+	if (pending)
+		txn->set_timestamp(MVCC_TS_PENDING);
+	bool ok = pending || txn->get_timestamp() >= min_ts;
+	if (ok) {
+		LIST_PUT_TAIL(slot->head, slot->tail, txn);
+		txn->mvcc_slot = slot;
+	}
+	unlock(slot);
+	return ok;
+}
+
+void Mvcc::finish(TxnManager * txn) {
+	ts_slot * slot = txn->mvcc_slot;
+	if (slot == NULL)
+		return;
+	lock(slot);
+	LIST_REMOVE_HT(txn, slot->head, slot->tail);
+	txn->mvcc_slot = NULL;
+	unlock(slot);
+}
+
+void Mvcc::run(uint64_t thd_id) {
+	uint64_t now = get_sys_clock();
+	if (now - last_run < MIN_TS_INTVL)
+		return;
+	last_run = now;
+
+	ts_t min = UINT64_MAX;
+	for (uint64_t i = 0; i < slot_cnt; i++) {
+		ts_slot * slot = &slots[i];
+		lock(slot);
+		for (TxnManager * txn = slot->head; txn != NULL; txn = txn->next) {
+			ts_t ts = txn->get_timestamp();
+			// the txn may still draw a timestamp at the current mark
+			if (ts == MVCC_TS_PENDING)
+				ts = min_ts;
+			if (ts < min)
+				min = ts;
+		}
+	}
+	// with no txn active, the mark stays where it is
+	if (min != UINT64_MAX && min > min_ts)
+		min_ts = min;
+	for (uint64_t i = 0; i < slot_cnt; i++)
+		unlock(&slots[i]);
+	INC_STATS(thd_id, mvcc_min_ts_time, get_sys_clock() - now);
+}
@@ -0,0 +1,65 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef _MVCC_H_
+#define _MVCC_H_
+
+#include "global.h"
+
+class TxnManager;
+
+#define MVCC_TS_PENDING UINT64_MAX
+
+// per-thread list of the txns that registered their timestamp on the thread,
+// padded to avoid false sharing between threads
+struct ts_slot {
+	volatile bool 	latch;
+	TxnManager * 	head;
+	TxnManager * 	tail;
+	char 			pad[CL_SIZE - sizeof(bool) - sizeof(TxnManager *) * 2];
+};
+
+// The low-water mark of MVCC: no txn active at this node has a timestamp
+// below it, so a row only keeps the newest version older than it. A txn
+// registers its timestamp in the slot of the thread it starts on, and leaves
+// it when its txn manager is released, possibly on another thread. The
+// collector, run by worker 0 every MIN_TS_INTVL, publishes the minimum over
+// all slots; rows trim their versions against it whenever they are written.
+// The collector holds every slot while it publishes, so a txn that registers
+// either counts towards the new mark or sees it.
+class Mvcc {
+public:
+	void 		init();
+	// registers the current timestamp of txn; called again after a restart.
+	// A pending txn draws its timestamp after registering and holds the mark
+	// until it has one. Otherwise false if the timestamp is below the mark
+	// already, in which case the txn must not run.
+	bool 		start(uint64_t thd_id, TxnManager * txn, bool pending);
+	void 		finish(TxnManager * txn);
+	ts_t 		get_min_ts() { return min_ts; };
+	void 		run(uint64_t thd_id);
+private:
+	void 		lock(ts_slot * slot);
+	void 		unlock(ts_slot * slot);
+
+	volatile ts_t 	min_ts;
+	char 			pad[CL_SIZE - sizeof(ts_t)];
+	uint64_t 		last_run;
+	ts_slot * 		slots;
+	uint64_t 		slot_cnt;
+};
+
+#endif
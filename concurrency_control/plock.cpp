@@ -0,0 +1,218 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "global.h"
+#include "helper.h"
+#include "txn.h"
+#include "query.h"
+#include "plock.h"
+#include "txn_table.h"
+#include "mem_alloc.h"
+
+void PartMan::init(uint64_t part_id) {
+	this->part_id = part_id;
+	pthread_mutex_init(&latch, NULL);
+	owner = NULL;
+	prepared = false;
+	spec = NULL;
+}
+
+RC PartMan::lock(TxnManager * txn) {
+	RC rc;
+	pthread_mutex_lock(&latch);
+	if (owner == NULL) {
+		assert(waiters.empty());
+		owner = txn;
+		rc = RCOK;
+	} else if (prepared && spec == NULL && can_spec(txn)) {
+		spec = txn;
+		txn->spec = true;
+		DEBUG("spec %ld behind %ld, part %ld\n",txn->get_txn_id(),owner->get_txn_id(),part_id);
+		rc = RCOK;
+	} else if (owner->get_timestamp() > txn->get_timestamp()) {
+		// the owner is younger
+		rc = Abort;
+	} else {
+		std::vector<TxnManager *>::iterator it = waiters.begin();
+		while (it != waiters.end() && (*it)->get_timestamp() < txn->get_timestamp())
+			it++;
+		waiters.insert(it, txn);
+		ATOM_ADD(txn->ready_part,1);
+		rc = WAIT;
+	}
+	pthread_mutex_unlock(&latch);
+	return rc;
+}
+
+void PartMan::unlock(TxnManager * txn, RC rc, uint64_t thd_id) {
+	pthread_mutex_lock(&latch);
+	if (owner == txn) {
+		owner = NULL;
+		prepared = false;
+		if (spec != NULL) {
+			// the speculative txn commits or aborts with the owner
+			if (rc == Abort)
+				spec->spec_aborted = true;
+			else
+				owner = spec;
+			if (spec->spec_waiting) {
+				spec->spec_waiting = false;
+				txn_table.restart_txn(thd_id,spec->get_txn_id(),0);
+			}
+			spec = NULL;
+		}
+		if (owner == NULL)
+			grant(thd_id);
+	} else if (spec == txn) {
+		// aborted on its own
+		spec = NULL;
+		grant_spec(thd_id);
+	} else {
+		for (std::vector<TxnManager *>::iterator it = waiters.begin(); it != waiters.end(); it++) {
+			if (*it == txn) {
+				waiters.erase(it);
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock(&latch);
+}
+
+void PartMan::prepare(TxnManager * txn, uint64_t thd_id) {
+	pthread_mutex_lock(&latch);
+	if (owner == txn) {
+		prepared = true;
+		grant_spec(thd_id);
+	}
+	pthread_mutex_unlock(&latch);
+}
+
+RC PartMan::spec_commit(TxnManager * txn) {
+	RC rc = RCOK;
+	pthread_mutex_lock(&latch);
+	if (txn->spec_aborted) {
+		rc = Abort;
+	} else if (spec == txn) {
+		// resumed by unlock of the owner
+		txn->spec_waiting = true;
+		rc = WAIT;
+	} else {
+		assert(owner == txn);
+	}
+	pthread_mutex_unlock(&latch);
+	return rc;
+}
+
+void PartMan::grant(uint64_t thd_id) {
+	if (waiters.empty())
+		return;
+	owner = waiters.front();
+	waiters.erase(waiters.begin());
+	wake(owner, thd_id);
+}
+
+void PartMan::grant_spec(uint64_t thd_id) {
+	if (!prepared || spec != NULL)
+		return;
+	for (std::vector<TxnManager *>::iterator it = waiters.begin(); it != waiters.end(); it++) {
+		if (can_spec(*it)) {
+			spec = *it;
+			waiters.erase(it);
+			spec->spec = true;
+			DEBUG("spec %ld behind %ld, part %ld\n",spec->get_txn_id(),owner->get_txn_id(),part_id);
+			wake(spec, thd_id);
+			return;
+		}
+	}
+}
+
+bool PartMan::can_spec(TxnManager * txn) {
+#if CC_ALG == HSTORE_SPEC
+	// the response of a remote txn cannot be held back, so only txns of this
+	// node that need no other partition run speculatively
+	return IS_LOCAL(txn->get_txn_id()) && txn->query->partitions.size() == 1;
+#else
+	return false;
+#endif
+}
+
+void PartMan::wake(TxnManager * txn, uint64_t thd_id) {
+	if (ATOM_SUB_FETCH(txn->ready_part,1) == 0)
+		txn_table.restart_txn(thd_id,txn->get_txn_id(),0);
+}
+
+/************************/
+
+void Plock::init() {
+	uint64_t part_cnt = g_part_cnt / g_node_cnt + 1;
+	part_mans = (PartMan **) mem_allocator.alloc(sizeof(PartMan *) * part_cnt);
+	for (uint64_t i = 0; i < part_cnt; i++) {
+		part_mans[i] = (PartMan *) mem_allocator.alloc(sizeof(PartMan));
+		new (part_mans[i]) PartMan();
+		part_mans[i]->init(GET_PART_ID_FROM_IDX(i));
+	}
+}
+
+PartMan * Plock::get_part_man(uint64_t part_id) {
+	assert(GET_NODE_ID(part_id) == g_node_id);
+	return part_mans[GET_PART_ID_IDX(part_id)];
+}
+
+RC Plock::lock(TxnManager * txn, uint64_t thd_id) {
+	RC rc = RCOK;
+	assert(!txn->part_locked);
+	txn->part_locked = true;
+	// held until every partition is requested, so that the txn is not
+	// resumed before
+	txn->ready_part = 1;
+	Array<uint64_t> & parts = txn->query->partitions;
+	for (uint64_t i = 0; i < parts.size() && rc != Abort; i++) {
+		if (GET_NODE_ID(parts[i]) == g_node_id)
+			rc = get_part_man(parts[i])->lock(txn);
+	}
+	if (rc == Abort) {
+		unlock(txn, Abort, thd_id);
+		txn->ready_part = 0;
+		return Abort;
+	}
+	if (ATOM_SUB_FETCH(txn->ready_part,1) == 0)
+		return RCOK;
+	return WAIT;
+}
+
+void Plock::unlock(TxnManager * txn, RC rc, uint64_t thd_id) {
+	if (!txn->part_locked)
+		return;
+	txn->part_locked = false;
+	Array<uint64_t> & parts = txn->query->partitions;
+	for (uint64_t i = 0; i < parts.size(); i++) {
+		if (GET_NODE_ID(parts[i]) == g_node_id)
+			get_part_man(parts[i])->unlock(txn, rc, thd_id);
+	}
+}
+
+void Plock::prepare(TxnManager * txn, uint64_t thd_id) {
+	Array<uint64_t> & parts = txn->query->partitions;
+	for (uint64_t i = 0; i < parts.size(); i++) {
+		if (GET_NODE_ID(parts[i]) == g_node_id)
+			get_part_man(parts[i])->prepare(txn, thd_id);
+	}
+}
+
+RC Plock::spec_commit(TxnManager * txn) {
+	assert(txn->spec && txn->query->partitions.size() == 1);
+	return get_part_man(txn->query->partitions[0])->spec_commit(txn);
+}
@@ -0,0 +1,85 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef _PLOCK_H_
+#define _PLOCK_H_
+
+#include "global.h"
+#include <vector>
+
+class TxnManager;
+
+// The lock of one partition
+class PartMan {
+public:
+	void 		init(uint64_t part_id);
+	RC 			lock(TxnManager * txn);
+	void 		unlock(TxnManager * txn, RC rc, uint64_t thd_id);
+	// [HSTORE_SPEC]
+	void 		prepare(TxnManager * txn, uint64_t thd_id);
+	RC 			spec_commit(TxnManager * txn);
+private:
+	// makes the oldest waiter the owner
+	void 		grant(uint64_t thd_id);
+	// [HSTORE_SPEC] lets a waiter run speculatively behind the prepared owner
+	void 		grant_spec(uint64_t thd_id);
+	bool 		can_spec(TxnManager * txn);
+	// resumes txn once it holds all of its partitions at this node
+	void 		wake(TxnManager * txn, uint64_t thd_id);
+
+	pthread_mutex_t latch;
+	uint64_t 	part_id;
+	TxnManager * owner;
+	// in timestamp order, the oldest txn first
+	std::vector<TxnManager *> waiters;
+	// [HSTORE_SPEC] the owner waits for the outcome of 2PC, and spec runs
+	// behind it
+	bool 		prepared;
+	TxnManager * spec;
+};
+
+// Partition locking for H-Store (Kallman et al., VLDB'08). A txn locks all
+// partitions it accesses at a node before it runs there, and holds them until
+// it commits or aborts, so the rows need no concurrency control at all.
+// A requester waits for an older owner and aborts on a younger one. Waits
+// only go from younger to older txns, so they cannot deadlock, across nodes
+// neither. A restarted txn takes a new timestamp and so waits the next time.
+//
+// [HSTORE_SPEC] Once the owner of a partition has done its work and waits for
+// the outcome of 2PC, one single-partition txn of this node runs
+// speculatively on the partition. It works on private copies of the rows it
+// accesses and cannot commit before the owner. If the owner commits, the
+// speculative txn takes over the partition and commits; if the owner aborts,
+// so does the speculative txn.
+class Plock {
+public:
+	void 		init();
+	// locks the partitions of txn at this node. WAIT if txn waits for any of
+	// them; it is resumed with restart_txn once it holds all of them
+	RC 			lock(TxnManager * txn, uint64_t thd_id);
+	// releases the partitions of txn or withdraws its requests
+	void 		unlock(TxnManager * txn, RC rc, uint64_t thd_id);
+	// [HSTORE_SPEC] txn is done at this node and waits for the outcome of 2PC
+	void 		prepare(TxnManager * txn, uint64_t thd_id);
+	// [HSTORE_SPEC] whether the speculative txn can commit yet. WAIT until
+	// the owner commits, Abort if the owner aborted
+	RC 			spec_commit(TxnManager * txn);
+private:
+	PartMan * 	get_part_man(uint64_t part_id);
+	PartMan ** 	part_mans;
+};
+
+#endif
@@ -25,9 +25,13 @@ void Row_lock::init(row_t * row) {
     _row = row;
     owners_size = 1;//1031;
     owners = NULL;
+#if ROW_LOCK_WORD
+    lock_word = 0;
+#else
     owners = (LockEntry**) mem_allocator.alloc(sizeof(LockEntry*)*owners_size);
     for(uint64_t i = 0; i < owners_size; i++)
         owners[i] = NULL;
+#endif
     waiters_head = NULL;
     waiters_tail = NULL;
     owner_cnt = 0;
@@ -46,11 +50,218 @@ void Row_lock::init(row_t * row) {
 RC Row_lock::lock_get(lock_t type, TxnManager * txn) {
 	uint64_t *txnids = NULL;
 	int txncnt = 0;
-	return lock_get(type, txn, txnids, txncnt);
+	int txncap = 0;
+	return lock_get(type, txn, txnids, txncnt, txncap);
+}
+
+#if ROW_LOCK_WORD
+
+#define LW_EX       (1UL << 63)
+// the waiter list is not empty; set and cleared under the latch
+#define LW_WAITERS  (1UL << 62)
+#define LW_CNT_MASK ((1UL << 32) - 1)
+
+bool Row_lock::word_conflict(uint64_t w, lock_t type) {
+    if ((w & LW_CNT_MASK) == 0)
+        return false;
+#if TWOPL_LITE
+    return true;
+#endif
+    return type == LOCK_EX || (w & LW_EX);
+}
+
+uint64_t Row_lock::word_add(uint64_t w, lock_t type) {
+    return (type == LOCK_EX ? w | LW_EX : w) + 1;
+}
+
+bool Row_lock::word_grant(lock_t type) {
+    uint64_t w;
+    do {
+        w = lock_word;
+        if (word_conflict(w, type))
+            return false;
+    } while (!ATOM_CAS(lock_word, w, word_add(w, type)));
+    if ((w & LW_CNT_MASK) == 0)
+        own_starttime = get_sys_clock();
+    return true;
+}
+
+RC Row_lock::lock_get(lock_t type, TxnManager * txn, uint64_t* &txnids, int &txncnt, int &txncap) {
+    assert (CC_ALG == NO_WAIT || CC_ALG == CALVIN);
+    RC rc = WAIT;
+    uint64_t starttime = get_sys_clock();
+    uint64_t w = lock_word;
+
+    // No waiters and compatible owners: join them without the latch
+    while (!(w & LW_WAITERS) && !word_conflict(w, type)) {
+        if (ATOM_CAS(lock_word, w, word_add(w, type))) {
+            rc = RCOK;
+            break;
+        }
+        w = lock_word;
+    }
+
+#if CC_ALG == NO_WAIT
+    if (rc != RCOK) {
+        rc = Abort;
+        DEBUG("abort %ld,%ld %ld %lx\n",txn->get_txn_id(),txn->get_batch_id(),_row->get_primary_key(),(uint64_t)_row);
+    }
+#else
+    if (rc != RCOK) {
+        if (g_central_man) {
+            glob_manager.lock_row(_row);
+        }
+        else {
+            uint64_t mtx_wait_starttime = get_sys_clock();
+            pthread_mutex_lock( latch );
+            INC_STATS(txn->get_thd_id(),mtx[17],get_sys_clock() - mtx_wait_starttime);
+        }
+        // The owners may have left meanwhile. Setting LW_WAITERS fails if
+        // the word changed, so the last owner always sees it and grants us
+        while (true) {
+            w = lock_word;
+            if (!(w & LW_WAITERS) && !word_conflict(w, type)) {
+                if (ATOM_CAS(lock_word, w, word_add(w, type))) {
+                    rc = RCOK;
+                    break;
+                }
+            } else if ((w & LW_WAITERS) || ATOM_CAS(lock_word, w, w | LW_WAITERS)) {
+                LockEntry * entry = get_entry();
+                entry->start_ts = get_sys_clock();
+                entry->txn = txn;
+                entry->type = type;
+                DEBUG("lk_wait (%ld,%ld): lock word %lx, req type %d, key %ld %lx\n",txn->get_txn_id(),txn->get_batch_id(),w,type,_row->get_primary_key(),(uint64_t)_row);
+                LIST_PUT_TAIL(waiters_head, waiters_tail, entry);
+                waiter_cnt ++;
+                ATOM_CAS(txn->lock_ready,true,false);
+                txn->incr_lr();
+                break;
+            }
+        }
+        if (g_central_man)
+            glob_manager.release_row(_row);
+        else
+            pthread_mutex_unlock( latch );
+    }
+#endif
+
+    if (rc == RCOK) {
+        DEBUG("1lock (%ld,%ld): lock word %lx, req type %d, key %ld %lx\n",txn->get_txn_id(),txn->get_batch_id(),w,type,_row->get_primary_key(),(uint64_t)_row);
+        if (w & LW_CNT_MASK) {
+          assert(type == LOCK_SH);
+          INC_STATS(txn->get_thd_id(),twopl_already_owned_cnt,1);
+          INC_STATS(txn->get_thd_id(),twopl_sh_bypass_cnt,1);
+        } else {
+          own_starttime = get_sys_clock();
+        }
+    }
+
+    uint64_t curr_time = get_sys_clock();
+    uint64_t timespan = curr_time - starttime;
+    if (rc == WAIT && txn->twopl_wait_start == 0) {
+        txn->twopl_wait_start = curr_time;
+    }
+    txn->txn_stats.cc_time += timespan;
+    txn->txn_stats.cc_time_short += timespan;
+    INC_STATS(txn->get_thd_id(),twopl_getlock_time,timespan);
+    INC_STATS(txn->get_thd_id(),twopl_getlock_cnt,1);
+    return rc;
 }
 
-RC Row_lock::lock_get(lock_t type, TxnManager * txn, uint64_t* &txnids, int &txncnt) {
-    assert (CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == CALVIN);
+RC Row_lock::lock_release(TxnManager * txn) {
+
+#if CC_ALG == CALVIN
+    if (txn->isRecon()) {
+        return RCOK;
+    }
+#endif
+    uint64_t starttime = get_sys_clock();
+    uint64_t w, nw;
+    do {
+        w = lock_word;
+        assert(w & LW_CNT_MASK);
+        nw = w - 1;
+        if ((nw & LW_CNT_MASK) == 0)
+            nw &= ~LW_EX;
+    } while (!ATOM_CAS(lock_word, w, nw));
+
+    DEBUG("unlock (%ld,%ld): lock word %lx, key %ld %lx\n",txn->get_txn_id(),txn->get_batch_id(),w,_row->get_primary_key(),(uint64_t)_row);
+
+    if ((nw & LW_CNT_MASK) == 0) {
+        INC_STATS(txn->get_thd_id(),twopl_owned_cnt,1);
+        uint64_t endtime = get_sys_clock();
+        INC_STATS(txn->get_thd_id(),twopl_owned_time,endtime - own_starttime);
+        if(w & LW_EX) {
+          INC_STATS(txn->get_thd_id(),twopl_ex_owned_time,endtime - own_starttime);
+          INC_STATS(txn->get_thd_id(),twopl_ex_owned_cnt,1);
+        }
+        else {
+          INC_STATS(txn->get_thd_id(),twopl_sh_owned_time,endtime - own_starttime);
+          INC_STATS(txn->get_thd_id(),twopl_sh_owned_cnt,1);
+        }
+        // the last owner hands the row to the waiters
+        if (nw & LW_WAITERS) {
+            if (g_central_man)
+                glob_manager.lock_row(_row);
+            else {
+                uint64_t mtx_wait_starttime = get_sys_clock();
+                pthread_mutex_lock( latch );
+                INC_STATS(txn->get_thd_id(),mtx[18],get_sys_clock() - mtx_wait_starttime);
+            }
+            grant_waiters(txn->get_thd_id());
+            if (g_central_man)
+                glob_manager.release_row(_row);
+            else
+                pthread_mutex_unlock( latch );
+        }
+    }
+
+    uint64_t timespan = get_sys_clock() - starttime;
+    txn->txn_stats.cc_time += timespan;
+    txn->txn_stats.cc_time_short += timespan;
+    INC_STATS(txn->get_thd_id(),twopl_release_time,timespan);
+    INC_STATS(txn->get_thd_id(),twopl_release_cnt,1);
+    return RCOK;
+}
+
+void Row_lock::grant_waiters(uint64_t thd_id) {
+    LockEntry * entry;
+    // Waiters join the owners in arrival order
+    while (waiters_head && word_grant(waiters_head->type)) {
+        LIST_GET_HEAD(waiters_head, waiters_tail, entry);
+        DEBUG("2lock (%ld,%ld): lock word %lx, req type %d, key %ld %lx\n",entry->txn->get_txn_id(),entry->txn->get_batch_id(),lock_word,entry->type,_row->get_primary_key(),(uint64_t)_row);
+        uint64_t timespan = get_sys_clock() - entry->txn->twopl_wait_start;
+        entry->txn->twopl_wait_start = 0;
+        INC_STATS(thd_id,twopl_wait_time,timespan);
+        waiter_cnt --;
+        ASSERT(entry->txn->lock_ready == false);
+        if(entry->txn->decr_lr() == 0) {
+            if(ATOM_CAS(entry->txn->lock_ready,false,true)) {
+                entry->txn->txn_stats.cc_block_time += timespan;
+                entry->txn->txn_stats.cc_block_time_short += timespan;
+                txn_table.restart_txn(thd_id,entry->txn->get_txn_id(),entry->txn->get_batch_id());
+            }
+        }
+        return_entry(entry);
+    }
+    // new requests may take the fast path again
+    if (waiters_head == NULL) {
+        uint64_t w;
+        do {
+            w = lock_word;
+        } while (!ATOM_CAS(lock_word, w, w & ~LW_WAITERS));
+    }
+}
+
+bool Row_lock::lock_cancel(TxnManager * txn, uint64_t thd_id) {
+    assert(false);
+    return false;
+}
+
+#else
+
+RC Row_lock::lock_get(lock_t type, TxnManager * txn, uint64_t* &txnids, int &txncnt, int &txncap) {
+    assert (CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == CALVIN);
     RC rc;
     uint64_t starttime = get_sys_clock();
 
@@ -75,7 +286,13 @@ RC Row_lock::lock_get(lock_t type, TxnManager * txn, uint64_t* &txnids, int &txn
 			conflict = true;
 		}
 	}
-    if (CC_ALG == CALVIN && !conflict) {
+	// older waiters go first
+	if (CC_ALG == WOUND_WAIT && !conflict) {
+		if (waiters_head && txn->get_timestamp() > waiters_head->txn->get_timestamp()) {
+			conflict = true;
+		}
+	}
+    if ((CC_ALG == CALVIN || CC_ALG == DL_DETECT) && !conflict) {
         if(waiters_head)
           conflict = true;
     }
@@ -149,6 +366,71 @@ RC Row_lock::lock_get(lock_t type, TxnManager * txn, uint64_t* &txnids, int &txn
               DEBUG("abort (%ld,%ld): owners %d, own type %d, req type %d, key %ld %lx\n",txn->get_txn_id(),txn->get_batch_id(),owner_cnt,lock_type,type,_row->get_primary_key(),(uint64_t)_row);
               rc = Abort;
             }
+        } else if (CC_ALG == DL_DETECT) {
+            // wait behind the owners and every earlier waiter
+            txncap = owner_cnt + waiter_cnt;
+            txnids = (uint64_t *) mem_allocator.alloc(sizeof(uint64_t) * txncap);
+            txncnt = 0;
+            LockEntry * en;
+            for(uint64_t i = 0; i < owners_size; i++) {
+              for (en = owners[i]; en != NULL; en = en->next)
+                txnids[txncnt++] = en->txn->get_txn_id();
+            }
+            for (en = waiters_head; en != NULL; en = en->next)
+              txnids[txncnt++] = en->txn->get_txn_id();
+            LockEntry * entry = get_entry();
+            entry->start_ts = get_sys_clock();
+            entry->txn = txn;
+            entry->type = type;
+            LIST_PUT_TAIL(waiters_head, waiters_tail, entry);
+            waiter_cnt ++;
+            DEBUG("lk_wait (%ld,%ld): owners %d, own type %d, req type %d, key %ld %lx\n",txn->get_txn_id(),txn->get_batch_id(),owner_cnt,lock_type,type,_row->get_primary_key(),(uint64_t)_row);
+            ATOM_CAS(txn->lock_ready,1,0);
+            txn->incr_lr();
+            rc = WAIT;
+        } else if (CC_ALG == WOUND_WAIT) {
+            ///////////////////////////////////////////////////////////
+            //  - T is the txn currently running
+            //  T wounds every owner younger than T
+            //  T waits in any case
+            //////////////////////////////////////////////////////////
+            // txnids are the owners wounded by T. the caller resumes them
+            // if they are blocked, after the latch is released.
+            if (owner_cnt > 0) {
+              txncap = owner_cnt;
+              txnids = (uint64_t *) mem_allocator.alloc(sizeof(uint64_t) * txncap);
+            }
+            txncnt = 0;
+            LockEntry * en;
+            for(uint64_t i = 0; i < owners_size && owner_cnt > 0; i++) {
+              for (en = owners[i]; en != NULL; en = en->next) {
+                assert(txn->get_txn_id() != en->txn->get_txn_id());
+                if (txn->get_timestamp() < en->txn->get_timestamp() &&
+                    ATOM_CAS(en->txn->wounded,false,true)) {
+                  DEBUG("wound (%ld,%ld) by %ld, key %ld\n",en->txn->get_txn_id(),en->txn->get_batch_id(),txn->get_txn_id(),_row->get_primary_key());
+                  INC_STATS(txn->get_thd_id(),twopl_wound_cnt,1);
+                  txnids[txncnt++] = en->txn->get_txn_id();
+                }
+              }
+            }
+            // the waiter list is in timestamp order, the oldest txn first
+            LockEntry * entry = get_entry();
+            entry->start_ts = get_sys_clock();
+            entry->txn = txn;
+            entry->type = type;
+            en = waiters_head;
+            while (en != NULL && en->txn->get_timestamp() < txn->get_timestamp())
+              en = en->next;
+            if (en) {
+              LIST_INSERT_BEFORE(en, entry,waiters_head);
+            } else {
+              LIST_PUT_TAIL(waiters_head, waiters_tail, entry);
+            }
+            waiter_cnt ++;
+            DEBUG("lk_wait (%ld,%ld): owners %d, own type %d, req type %d, key %ld %lx\n",txn->get_txn_id(),txn->get_batch_id(),owner_cnt,lock_type,type,_row->get_primary_key(),(uint64_t)_row);
+            ATOM_CAS(txn->lock_ready,1,0);
+            txn->incr_lr();
+            rc = WAIT;
         } else if (CC_ALG == CALVIN){
             LockEntry * entry = get_entry();
             entry->start_ts = get_sys_clock();
@@ -311,50 +593,14 @@ RC Row_lock::lock_release(TxnManager * txn) {
       for (en = waiters_head; en != NULL && en->next != NULL; en = en->next)
         assert(en->txn->get_txn_id() !=txn->get_txn_id());
 #endif
-
-      LockEntry * entry;
-      // If any waiter can join the owners, just do it!
-      while (waiters_head && !conflict_lock(lock_type, waiters_head->type)) {
-          LIST_GET_HEAD(waiters_head, waiters_tail, entry);
-#if DEBUG_TIMELINE
-          printf("LOCK %ld %ld\n",entry->txn->get_txn_id(),get_sys_clock());
-#endif
-          DEBUG("2lock (%ld,%ld): owners %d, own type %d, req type %d, key %ld %lx\n",entry->txn->get_txn_id(),entry->txn->get_batch_id(),owner_cnt,lock_type,entry->type,_row->get_primary_key(),(uint64_t)_row);
-          uint64_t timespan = get_sys_clock() - entry->txn->twopl_wait_start;
-          entry->txn->twopl_wait_start = 0;
-#if CC_ALG != CALVIN
-          entry->txn->txn_stats.cc_block_time += timespan;
-          entry->txn->txn_stats.cc_block_time_short += timespan;
+#if DEBUG_ASSERT && CC_ALG == WOUND_WAIT
+      for (en = waiters_head; en != NULL && en->next != NULL; en = en->next)
+        assert(en->next->txn->get_timestamp() >= en->txn->get_timestamp());
+      for (en = waiters_head; en != NULL && en->next != NULL; en = en->next)
+        assert(en->txn->get_txn_id() !=txn->get_txn_id());
 #endif
-          INC_STATS(txn->get_thd_id(),twopl_wait_time,timespan);
 
-#if CC_ALG != NO_WAIT
-          STACK_PUSH(owners[hash(entry->txn->get_txn_id())], entry);
-#endif 
-          owner_cnt ++;
-          waiter_cnt --;
-          if(entry->txn->get_timestamp() > max_owner_ts) {
-              max_owner_ts = entry->txn->get_timestamp();
-          }
-          ASSERT(entry->txn->lock_ready == false);
-      //if(entry->txn->decr_lr() == 0 && entry->txn->locking_done) {
-          if(entry->txn->decr_lr() == 0) {
-              if(ATOM_CAS(entry->txn->lock_ready,false,true)) {
-#if CC_ALG == CALVIN
-                  entry->txn->txn_stats.cc_block_time += timespan;
-                  entry->txn->txn_stats.cc_block_time_short += timespan;
-#endif
-                  txn_table.restart_txn(txn->get_thd_id(),entry->txn->get_txn_id(),entry->txn->get_batch_id());
-              }
-          }
-          if(lock_type == LOCK_NONE) {
-              own_starttime = get_sys_clock();
-          }
-          lock_type = entry->type;
-#if CC_AlG == NO_WAIT
-          return_entry(entry);
-#endif
-      }
+      grant_waiters(txn->get_thd_id());
 
       uint64_t timespan = get_sys_clock() - starttime;
       txn->txn_stats.cc_time += timespan;
@@ -371,6 +617,85 @@ RC Row_lock::lock_release(TxnManager * txn) {
     return RCOK;
 }
 
+void Row_lock::grant_waiters(uint64_t thd_id) {
+    LockEntry * entry;
+    // If any waiter can join the owners, just do it!
+    while (waiters_head && !conflict_lock(lock_type, waiters_head->type)) {
+        LIST_GET_HEAD(waiters_head, waiters_tail, entry);
+#if DEBUG_TIMELINE
+        printf("LOCK %ld %ld\n",entry->txn->get_txn_id(),get_sys_clock());
+#endif
+        DEBUG("2lock (%ld,%ld): owners %d, own type %d, req type %d, key %ld %lx\n",entry->txn->get_txn_id(),entry->txn->get_batch_id(),owner_cnt,lock_type,entry->type,_row->get_primary_key(),(uint64_t)_row);
+        uint64_t timespan = get_sys_clock() - entry->txn->twopl_wait_start;
+        entry->txn->twopl_wait_start = 0;
+#if CC_ALG != CALVIN
+        entry->txn->txn_stats.cc_block_time += timespan;
+        entry->txn->txn_stats.cc_block_time_short += timespan;
+#endif
+        INC_STATS(thd_id,twopl_wait_time,timespan);
+
+#if CC_ALG != NO_WAIT
+        STACK_PUSH(owners[hash(entry->txn->get_txn_id())], entry);
+#endif 
+        owner_cnt ++;
+        waiter_cnt --;
+        if(entry->txn->get_timestamp() > max_owner_ts) {
+            max_owner_ts = entry->txn->get_timestamp();
+        }
+        ASSERT(entry->txn->lock_ready == false);
+    //if(entry->txn->decr_lr() == 0 && entry->txn->locking_done) {
+        if(entry->txn->decr_lr() == 0) {
+            if(ATOM_CAS(entry->txn->lock_ready,false,true)) {
+#if CC_ALG == CALVIN
+                entry->txn->txn_stats.cc_block_time += timespan;
+                entry->txn->txn_stats.cc_block_time_short += timespan;
+#endif
+                txn_table.restart_txn(thd_id,entry->txn->get_txn_id(),entry->txn->get_batch_id());
+            }
+        }
+        if(lock_type == LOCK_NONE) {
+            own_starttime = get_sys_clock();
+        }
+        lock_type = entry->type;
+#if CC_AlG == NO_WAIT
+        return_entry(entry);
+#endif
+    }
+}
+
+bool Row_lock::lock_cancel(TxnManager * txn, uint64_t thd_id) {
+    assert(CC_ALG == DL_DETECT || CC_ALG == WOUND_WAIT);
+    if (g_central_man)
+        glob_manager.lock_row(_row);
+    else
+        pthread_mutex_lock( latch );
+
+    LockEntry * en = waiters_head;
+    while (en != NULL && en->txn != txn)
+        en = en->next;
+    if (en) {
+        DEBUG("cancel (%ld,%ld): owners %d, own type %d, req type %d, key %ld %lx\n",txn->get_txn_id(),txn->get_batch_id(),owner_cnt,lock_type,en->type,_row->get_primary_key(),(uint64_t)_row);
+        LIST_REMOVE(en);
+        if (en == waiters_head)
+            waiters_head = en->next;
+        if (en == waiters_tail)
+            waiters_tail = en->prev;
+        return_entry(en);
+        waiter_cnt --;
+        txn->twopl_wait_start = 0;
+        // the requests behind the cancelled one may be compatible with the owners
+        grant_waiters(thd_id);
+    }
+
+    if (g_central_man)
+        glob_manager.release_row(_row);
+    else
+        pthread_mutex_unlock( latch );
+    return en != NULL;
+}
+
+#endif
+
 bool Row_lock::conflict_lock(lock_t l1, lock_t l2) {
     if (l1 == LOCK_NONE || l2 == LOCK_NONE)
         return false;
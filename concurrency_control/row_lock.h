@@ -17,6 +17,11 @@
 #ifndef ROW_LOCK_H
 #define ROW_LOCK_H
 
+// NO_WAIT and CALVIN never look at who owns a row. Their owners are only a
+// count in a lock word, and a request without a conflict takes the lock
+// with one CAS. The latch and LockEntry are only used once a txn waits
+#define ROW_LOCK_WORD (CC_ALG == NO_WAIT || CC_ALG == CALVIN)
+
 struct LockEntry {
     lock_t type;
     ts_t   start_ts;
@@ -29,15 +34,31 @@ class Row_lock {
 public:
 	void init(row_t * row);
 	// [DL_DETECT] txnids are the txn_ids that current txn is waiting for.
+	// [WOUND_WAIT] txnids are the txn_ids that current txn wounded.
+	// The array is allocated by lock_get for txncap entries and freed by the caller.
     RC lock_get(lock_t type, TxnManager * txn);
-    RC lock_get(lock_t type, TxnManager * txn, uint64_t* &txnids, int &txncnt);
+    RC lock_get(lock_t type, TxnManager * txn, uint64_t* &txnids, int &txncnt, int &txncap);
     RC lock_release(TxnManager * txn);
+	// [DL_DETECT, WOUND_WAIT] removes the waiting request of txn. false if txn is not
+	// waiting for this lock
+	bool lock_cancel(TxnManager * txn, uint64_t thd_id);
 	
 private:
     pthread_mutex_t * latch;
 	bool blatch;
 	
+#if ROW_LOCK_WORD
+	// [LW_EX | LW_WAITERS | owner count]
+	volatile uint64_t lock_word;
+	// true if a request of type cannot join the owners in w
+	bool 		word_conflict(uint64_t w, lock_t type);
+	uint64_t 	word_add(uint64_t w, lock_t type);
+	// adds a waiter to the owners unless it conflicts with them
+	bool 		word_grant(lock_t type);
+#endif
 	bool 		conflict_lock(lock_t l1, lock_t l2);
+	// moves the waiters at the head that do not conflict to the owners
+	void 		grant_waiters(uint64_t thd_id);
 	LockEntry * get_entry();
 	void 		return_entry(LockEntry * entry);
 	row_t * _row;
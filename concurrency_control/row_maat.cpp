@@ -28,123 +28,186 @@ void Row_maat::init(row_t * row) {
   timestamp_last_read = 0;
   timestamp_last_write = 0;
   maat_avail = true;
-  uncommitted_writes = new std::set<uint64_t>();
-  uncommitted_reads = new std::set<uint64_t>();
-  assert(uncommitted_writes->begin() == uncommitted_writes->end());
-  assert(uncommitted_writes->size() == 0);
-	
+  set_init(&uncommitted_reads);
+  set_init(&uncommitted_writes);
+}
+
+void Row_maat::set_init(maat_set * set) {
+  for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++)
+    set->ids[i] = MAAT_FREE_SLOT;
+  set->next = NULL;
+}
+
+// Only the txn itself adds or removes its id, so the id is not in the set
+// twice. Chunks are never unlinked, so a chunk another thread is looking at
+// stays valid
+void Row_maat::set_add(maat_set * set, uint64_t txn_id, uint64_t thd_id) {
+  for(maat_set * s = set; s != NULL; s = s->next) {
+    for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+      if(s->ids[i] == txn_id)
+        return;
+    }
+  }
+  maat_set * s = set;
+  while(true) {
+    for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+      if(s->ids[i] == MAAT_FREE_SLOT && ATOM_CAS(s->ids[i],MAAT_FREE_SLOT,txn_id))
+        return;
+    }
+    if(s->next == NULL) {
+      // every chunk is full; chain another one that holds the id already
+      INC_STATS(thd_id,maat_row_set_overflow_cnt,1);
+      maat_set * chunk = (maat_set *) mem_allocator.alloc(sizeof(maat_set));
+      set_init(chunk);
+      chunk->ids[0] = txn_id;
+      if(ATOM_CAS(s->next,NULL,chunk))
+        return;
+      mem_allocator.free(chunk,sizeof(maat_set));
+    }
+    s = s->next;
+  }
+}
+
+void Row_maat::set_remove(maat_set * set, uint64_t txn_id) {
+  for(maat_set * s = set; s != NULL; s = s->next) {
+    for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+      if(s->ids[i] == txn_id) {
+        s->ids[i] = MAAT_FREE_SLOT;
+        return;
+      }
+    }
+  }
+}
+
+void Row_maat::set_raise(volatile uint64_t & ts, uint64_t value) {
+  uint64_t old = ts;
+  while(old < value && !ATOM_CAS(ts,old,value))
+    old = ts;
 }
 
 RC Row_maat::access(access_t type, TxnManager * txn) {
     uint64_t starttime = get_sys_clock();
+    RC rc = RCOK;
 #if WORKLOAD == TPCC
-  read_and_prewrite(txn);
+  rc = read_and_prewrite(txn);
 #else
   if(type == RD)
-    read(txn);
+    rc = read(txn);
   if(type == WR)
-    prewrite(txn);
+    rc = prewrite(txn);
 #endif
   uint64_t timespan = get_sys_clock() - starttime;
   txn->txn_stats.cc_time += timespan;
   txn->txn_stats.cc_time_short += timespan;
-  return RCOK;
+  return rc;
 }
 
 RC Row_maat::read_and_prewrite(TxnManager * txn) {
 	assert (CC_ALG == MAAT);
-	RC rc = RCOK;
+  uint64_t txn_id = txn->get_txn_id();
 
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  while(!ATOM_CAS(maat_avail,true,false)) { }
-  INC_STATS(txn->get_thd_id(),mtx[30],get_sys_clock() - mtx_wait_starttime);
-  DEBUG("READ + PREWRITE %ld -- %ld: lw %ld\n",txn->get_txn_id(),_row->get_primary_key(),timestamp_last_write);
+#if ISOLATION_LEVEL != READ_COMMITTED
+  //Add to uncommitted reads (soft lock)
+  set_add(&uncommitted_reads,txn_id,txn->get_thd_id());
+#endif
+  //Add to uncommitted writes (soft lock)
+  set_add(&uncommitted_writes,txn_id,txn->get_thd_id());
+  MEM_BARRIER();
+  DEBUG("READ + PREWRITE %ld -- %ld: lw %ld\n",txn_id,_row->get_primary_key(),timestamp_last_write);
 
   // Copy uncommitted writes
-  for(auto it = uncommitted_writes->begin(); it != uncommitted_writes->end(); it++) {
-    uint64_t txn_id = *it;
-    txn->uncommitted_writes->insert(txn_id);
-    txn->uncommitted_writes_y->insert(txn_id);
-    DEBUG("    UW %ld -- %ld: %ld\n",txn->get_txn_id(),_row->get_primary_key(),txn_id);
+  for(maat_set * s = &uncommitted_writes; s != NULL; s = s->next)
+  for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+    uint64_t id = s->ids[i];
+    if(id == MAAT_FREE_SLOT || id == txn_id)
+      continue;
+#if ISOLATION_LEVEL != READ_COMMITTED
+    txn->uncommitted_writes.add_grow(id);
+#endif
+    txn->uncommitted_writes_y.add_grow(id);
+    DEBUG("    UW %ld -- %ld: %ld\n",txn_id,_row->get_primary_key(),id);
   }
 
   // Copy uncommitted reads 
-  for(auto it = uncommitted_reads->begin(); it != uncommitted_reads->end(); it++) {
-    uint64_t txn_id = *it;
-    txn->uncommitted_reads->insert(txn_id);
-    DEBUG("    UR %ld -- %ld: %ld\n",txn->get_txn_id(),_row->get_primary_key(),txn_id);
+  for(maat_set * s = &uncommitted_reads; s != NULL; s = s->next)
+  for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+    uint64_t id = s->ids[i];
+    if(id == MAAT_FREE_SLOT || id == txn_id)
+      continue;
+    txn->uncommitted_reads.add_grow(id);
+    DEBUG("    UR %ld -- %ld: %ld\n",txn_id,_row->get_primary_key(),id);
   }
 
   // Copy read timestamp
   if(txn->greatest_read_timestamp < timestamp_last_read)
     txn->greatest_read_timestamp = timestamp_last_read;
 
-
   // Copy write timestamp
   if(txn->greatest_write_timestamp < timestamp_last_write)
     txn->greatest_write_timestamp = timestamp_last_write;
 
-  //Add to uncommitted reads (soft lock)
-  uncommitted_reads->insert(txn->get_txn_id());
-
-  //Add to uncommitted writes (soft lock)
-  uncommitted_writes->insert(txn->get_txn_id());
-
-  ATOM_CAS(maat_avail,false,true);
-
-	return rc;
+	return RCOK;
 }
 
 
 RC Row_maat::read(TxnManager * txn) {
 	assert (CC_ALG == MAAT);
-	RC rc = RCOK;
+#if ISOLATION_LEVEL == READ_COMMITTED
+  // writes are applied at commit, so the row holds committed data only. The
+  // read leaves no soft lock and does not bound the commit timestamp
+  return RCOK;
+#endif
+  uint64_t txn_id = txn->get_txn_id();
 
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  while(!ATOM_CAS(maat_avail,true,false)) { }
-  INC_STATS(txn->get_thd_id(),mtx[30],get_sys_clock() - mtx_wait_starttime);
-  DEBUG("READ %ld -- %ld: lw %ld\n",txn->get_txn_id(),_row->get_primary_key(),timestamp_last_write);
+  //Add to uncommitted reads (soft lock)
+  set_add(&uncommitted_reads,txn_id,txn->get_thd_id());
+  MEM_BARRIER();
+  DEBUG("READ %ld -- %ld: lw %ld\n",txn_id,_row->get_primary_key(),timestamp_last_write);
 
   // Copy uncommitted writes
-  for(auto it = uncommitted_writes->begin(); it != uncommitted_writes->end(); it++) {
-    uint64_t txn_id = *it;
-    txn->uncommitted_writes->insert(txn_id);
-    DEBUG("    UW %ld -- %ld: %ld\n",txn->get_txn_id(),_row->get_primary_key(),txn_id);
+  for(maat_set * s = &uncommitted_writes; s != NULL; s = s->next)
+  for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+    uint64_t id = s->ids[i];
+    if(id == MAAT_FREE_SLOT || id == txn_id)
+      continue;
+    txn->uncommitted_writes.add_grow(id);
+    DEBUG("    UW %ld -- %ld: %ld\n",txn_id,_row->get_primary_key(),id);
   }
 
   // Copy write timestamp
   if(txn->greatest_write_timestamp < timestamp_last_write)
     txn->greatest_write_timestamp = timestamp_last_write;
 
-  //Add to uncommitted reads (soft lock)
-  uncommitted_reads->insert(txn->get_txn_id());
-
-  ATOM_CAS(maat_avail,false,true);
-
-	return rc;
+	return RCOK;
 }
 
 RC Row_maat::prewrite(TxnManager * txn) {
 	assert (CC_ALG == MAAT);
-	RC rc = RCOK;
+  uint64_t txn_id = txn->get_txn_id();
 
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  while(!ATOM_CAS(maat_avail,true,false)) { }
-  INC_STATS(txn->get_thd_id(),mtx[31],get_sys_clock() - mtx_wait_starttime);
-  DEBUG("PREWRITE %ld -- %ld: lw %ld, lr %ld\n",txn->get_txn_id(),_row->get_primary_key(),timestamp_last_write,timestamp_last_read);
+  //Add to uncommitted writes (soft lock)
+  set_add(&uncommitted_writes,txn_id,txn->get_thd_id());
+  MEM_BARRIER();
+  DEBUG("PREWRITE %ld -- %ld: lw %ld, lr %ld\n",txn_id,_row->get_primary_key(),timestamp_last_write,timestamp_last_read);
 
   // Copy uncommitted reads 
-  for(auto it = uncommitted_reads->begin(); it != uncommitted_reads->end(); it++) {
-    uint64_t txn_id = *it;
-    txn->uncommitted_reads->insert(txn_id);
-    DEBUG("    UR %ld -- %ld: %ld\n",txn->get_txn_id(),_row->get_primary_key(),txn_id);
+  for(maat_set * s = &uncommitted_reads; s != NULL; s = s->next)
+  for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+    uint64_t id = s->ids[i];
+    if(id == MAAT_FREE_SLOT || id == txn_id)
+      continue;
+    txn->uncommitted_reads.add_grow(id);
+    DEBUG("    UR %ld -- %ld: %ld\n",txn_id,_row->get_primary_key(),id);
   }
 
   // Copy uncommitted writes 
-  for(auto it = uncommitted_writes->begin(); it != uncommitted_writes->end(); it++) {
-    uint64_t txn_id = *it;
-    txn->uncommitted_writes_y->insert(txn_id);
-    DEBUG("    UW %ld -- %ld: %ld\n",txn->get_txn_id(),_row->get_primary_key(),txn_id);
+  for(maat_set * s = &uncommitted_writes; s != NULL; s = s->next)
+  for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+    uint64_t id = s->ids[i];
+    if(id == MAAT_FREE_SLOT || id == txn_id)
+      continue;
+    txn->uncommitted_writes_y.add_grow(id);
+    DEBUG("    UW %ld -- %ld: %ld\n",txn_id,_row->get_primary_key(),id);
   }
 
   // Copy read timestamp
@@ -155,167 +218,145 @@ RC Row_maat::prewrite(TxnManager * txn) {
   if(txn->greatest_write_timestamp < timestamp_last_write)
     txn->greatest_write_timestamp = timestamp_last_write;
 
-  //Add to uncommitted writes (soft lock)
-  uncommitted_writes->insert(txn->get_txn_id());
-
-  ATOM_CAS(maat_avail,false,true);
-
-	return rc;
+	return RCOK;
 }
 
 
 RC Row_maat::abort(access_t type, TxnManager * txn) {	
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  while(!ATOM_CAS(maat_avail,true,false)) { }
-  INC_STATS(txn->get_thd_id(),mtx[32],get_sys_clock() - mtx_wait_starttime);
   DEBUG("Maat Abort %ld: %d -- %ld\n",txn->get_txn_id(),type,_row->get_primary_key());
 #if WORKLOAD == TPCC
-    uncommitted_reads->erase(txn->get_txn_id());
-    uncommitted_writes->erase(txn->get_txn_id());
+    set_remove(&uncommitted_reads,txn->get_txn_id());
+    set_remove(&uncommitted_writes,txn->get_txn_id());
 #else
   if(type == RD) {
-    uncommitted_reads->erase(txn->get_txn_id());
+    set_remove(&uncommitted_reads,txn->get_txn_id());
   }
 
   if(type == WR) {
-    uncommitted_writes->erase(txn->get_txn_id());
+    set_remove(&uncommitted_writes,txn->get_txn_id());
   }
 #endif
 
-  ATOM_CAS(maat_avail,false,true);
   return Abort;
 }
 
 RC Row_maat::commit(access_t type, TxnManager * txn, row_t * data) {	
-  uint64_t mtx_wait_starttime = get_sys_clock();
-  while(!ATOM_CAS(maat_avail,true,false)) { }
-  INC_STATS(txn->get_thd_id(),mtx[33],get_sys_clock() - mtx_wait_starttime);
   DEBUG("Maat Commit %ld: %d,%lu -- %ld\n",txn->get_txn_id(),type,txn->get_commit_timestamp(),_row->get_primary_key());
+  uint64_t txn_commit_ts = txn->get_commit_timestamp();
 
 #if WORKLOAD == TPCC
-    if(txn->get_commit_timestamp() >  timestamp_last_read)
-      timestamp_last_read = txn->get_commit_timestamp();
-    uncommitted_reads->erase(txn->get_txn_id());
-    if(txn->get_commit_timestamp() >  timestamp_last_write)
-      timestamp_last_write = txn->get_commit_timestamp();
-    uncommitted_writes->erase(txn->get_txn_id());
+#if ISOLATION_LEVEL != READ_COMMITTED
+    set_raise(timestamp_last_read,txn_commit_ts);
+    set_remove(&uncommitted_reads,txn->get_txn_id());
+#endif
+    set_raise(timestamp_last_write,txn_commit_ts);
     // Apply write to DB
     write(data);
+    set_remove(&uncommitted_writes,txn->get_txn_id());
+    MEM_BARRIER();
 
-  uint64_t txn_commit_ts = txn->get_commit_timestamp();
+#if ISOLATION_LEVEL != READ_COMMITTED
   // Forward validation
   // Check uncommitted writes against this txn's 
-    for(auto it = uncommitted_writes->begin(); it != uncommitted_writes->end();it++) {
-      if(txn->uncommitted_writes->count(*it) == 0) {
+    for(maat_set * s = &uncommitted_writes; s != NULL; s = s->next)
+    for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+      uint64_t id = s->ids[i];
+      if(id != MAAT_FREE_SLOT && !txn->uncommitted_writes.contains_sorted(id)) {
         // apply timestamps
         // these write txns need to come AFTER this txn
-        uint64_t it_lower = time_table.get_lower(txn->get_thd_id(),*it);
-        if(it_lower <= txn_commit_ts) {
-          time_table.set_lower(txn->get_thd_id(),*it,txn_commit_ts+1);
-          DEBUG("MAAT forward val set lower %ld: %lu\n",*it,txn_commit_ts+1);
-        }
+        time_table.raise_lower(txn->get_thd_id(),id,txn_commit_ts+1);
+        DEBUG("MAAT forward val set lower %ld: %lu\n",id,txn_commit_ts+1);
       }
     }
+#endif
 
     uint64_t lower =  time_table.get_lower(txn->get_thd_id(),txn->get_txn_id());
-    for(auto it = uncommitted_writes->begin(); it != uncommitted_writes->end();it++) {
-      if(txn->uncommitted_writes_y->count(*it) == 0) {
+    for(maat_set * s = &uncommitted_writes; s != NULL; s = s->next)
+    for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+      uint64_t id = s->ids[i];
+      if(id != MAAT_FREE_SLOT && !txn->uncommitted_writes_y.contains_sorted(id)) {
         // apply timestamps
         // these write txns need to come BEFORE this txn
-        uint64_t it_upper = time_table.get_upper(txn->get_thd_id(),*it);
-        if(it_upper >= txn_commit_ts) {
-          time_table.set_upper(txn->get_thd_id(),*it,txn_commit_ts-1);
-          DEBUG("MAAT forward val set upper %ld: %lu\n",*it,txn_commit_ts-1);
-        }
+        time_table.cap_upper(txn->get_thd_id(),id,txn_commit_ts-1);
+        DEBUG("MAAT forward val set upper %ld: %lu\n",id,txn_commit_ts-1);
       }
     }
 
-    for(auto it = uncommitted_reads->begin(); it != uncommitted_reads->end();it++) {
-      if(txn->uncommitted_reads->count(*it) == 0) {
+    for(maat_set * s = &uncommitted_reads; s != NULL; s = s->next)
+    for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+      uint64_t id = s->ids[i];
+      if(id != MAAT_FREE_SLOT && !txn->uncommitted_reads.contains_sorted(id)) {
         // apply timestamps
         // these write txns need to come BEFORE this txn
-        uint64_t it_upper = time_table.get_upper(txn->get_thd_id(),*it);
-        if(it_upper >= lower) {
-          time_table.set_upper(txn->get_thd_id(),*it,lower-1);
-          DEBUG("MAAT forward val set upper %ld: %lu\n",*it,lower-1);
-        }
+        time_table.cap_upper(txn->get_thd_id(),id,lower-1);
+        DEBUG("MAAT forward val set upper %ld: %lu\n",id,lower-1);
       }
     }
 
 
 
 #else
-  uint64_t txn_commit_ts = txn->get_commit_timestamp();
-  if(type == RD) {
-    if(txn_commit_ts >  timestamp_last_read)
-      timestamp_last_read = txn_commit_ts;
-    uncommitted_reads->erase(txn->get_txn_id());
+  // under READ_COMMITTED a read did not register, see read()
+  if(type == RD && ISOLATION_LEVEL != READ_COMMITTED) {
+    set_raise(timestamp_last_read,txn_commit_ts);
+    set_remove(&uncommitted_reads,txn->get_txn_id());
+    MEM_BARRIER();
 
   // Forward validation
   // Check uncommitted writes against this txn's 
-    for(auto it = uncommitted_writes->begin(); it != uncommitted_writes->end();it++) {
-      if(txn->uncommitted_writes->count(*it) == 0) {
+    for(maat_set * s = &uncommitted_writes; s != NULL; s = s->next)
+    for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+      uint64_t id = s->ids[i];
+      if(id != MAAT_FREE_SLOT && !txn->uncommitted_writes.contains_sorted(id)) {
         // apply timestamps
         // these write txns need to come AFTER this txn
-        uint64_t it_lower = time_table.get_lower(txn->get_thd_id(),*it);
-        if(it_lower <= txn_commit_ts) {
-          time_table.set_lower(txn->get_thd_id(),*it,txn_commit_ts+1);
-          DEBUG("MAAT forward val set lower %ld: %lu\n",*it,txn_commit_ts+1);
-        }
+        time_table.raise_lower(txn->get_thd_id(),id,txn_commit_ts+1);
+        DEBUG("MAAT forward val set lower %ld: %lu\n",id,txn_commit_ts+1);
       }
     }
 
   }
-  /*
-#if WORKLOAD == TPCC
-    if(txn_commit_ts >  timestamp_last_read)
-      timestamp_last_read = txn_commit_ts;
-#endif
-*/
 
   if(type == WR) {
-    if(txn_commit_ts >  timestamp_last_write)
-      timestamp_last_write = txn_commit_ts;
-    uncommitted_writes->erase(txn->get_txn_id());
+    set_raise(timestamp_last_write,txn_commit_ts);
     // Apply write to DB
     write(data);
+    set_remove(&uncommitted_writes,txn->get_txn_id());
+    MEM_BARRIER();
     uint64_t lower =  time_table.get_lower(txn->get_thd_id(),txn->get_txn_id());
-    for(auto it = uncommitted_writes->begin(); it != uncommitted_writes->end();it++) {
-      if(txn->uncommitted_writes_y->count(*it) == 0) {
+    for(maat_set * s = &uncommitted_writes; s != NULL; s = s->next)
+    for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+      uint64_t id = s->ids[i];
+      if(id != MAAT_FREE_SLOT && !txn->uncommitted_writes_y.contains_sorted(id)) {
         // apply timestamps
         // these write txns need to come BEFORE this txn
-        uint64_t it_upper = time_table.get_upper(txn->get_thd_id(),*it);
-        if(it_upper >= txn_commit_ts) {
-          time_table.set_upper(txn->get_thd_id(),*it,txn_commit_ts-1);
-          DEBUG("MAAT forward val set upper %ld: %lu\n",*it,txn_commit_ts-1);
-        }
+        time_table.cap_upper(txn->get_thd_id(),id,txn_commit_ts-1);
+        DEBUG("MAAT forward val set upper %ld: %lu\n",id,txn_commit_ts-1);
       }
     }
 
-    for(auto it = uncommitted_reads->begin(); it != uncommitted_reads->end();it++) {
-      if(txn->uncommitted_reads->count(*it) == 0) {
+    for(maat_set * s = &uncommitted_reads; s != NULL; s = s->next)
+    for(uint64_t i = 0; i < MAAT_ROW_SET_SIZE; i++) {
+      uint64_t id = s->ids[i];
+      if(id != MAAT_FREE_SLOT && !txn->uncommitted_reads.contains_sorted(id)) {
         // apply timestamps
         // these write txns need to come BEFORE this txn
-        uint64_t it_upper = time_table.get_upper(txn->get_thd_id(),*it);
-        if(it_upper >= lower) {
-          time_table.set_upper(txn->get_thd_id(),*it,lower-1);
-          DEBUG("MAAT forward val set upper %ld: %lu\n",*it,lower-1);
-        }
+        time_table.cap_upper(txn->get_thd_id(),id,lower-1);
+        DEBUG("MAAT forward val set upper %ld: %lu\n",id,lower-1);
       }
     }
 
   }
 #endif
 
-
-
-  ATOM_CAS(maat_avail,false,true);
 	return RCOK;
 }
 
+// writers of the row commit one at a time
 void
 Row_maat::write(row_t * data) {
+  while(!ATOM_CAS(maat_avail,true,false)) { }
 	_row->copy(data);
+  ATOM_CAS(maat_avail,false,true);
 }
 
-
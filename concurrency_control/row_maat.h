@@ -17,6 +17,15 @@
 #ifndef ROW_MAAT_H
 #define ROW_MAAT_H
 
+#define MAAT_FREE_SLOT UINT64_MAX
+
+// A set of txn ids. The first chunk is part of the row; a full set chains
+// another chunk, so an access never aborts for want of a slot
+struct maat_set {
+  volatile uint64_t ids[MAAT_ROW_SET_SIZE];
+  maat_set * volatile next;
+};
+
 class Row_maat {
 public:
 	void init(row_t * row);
@@ -29,14 +38,24 @@ public:
   void write(row_t * data);
 	
 private:
+  void set_init(maat_set * set);
+  void set_add(maat_set * set, uint64_t txn_id, uint64_t thd_id);
+  void set_remove(maat_set * set, uint64_t txn_id);
+  void set_raise(volatile uint64_t & ts, uint64_t value);
+
+  // only taken to install a write
   volatile bool maat_avail;
 	
 	row_t * _row;
 	
-  std::set<uint64_t> * uncommitted_reads;
-  std::set<uint64_t> * uncommitted_writes;
-  uint64_t timestamp_last_read;
-  uint64_t timestamp_last_write;
+  // The soft locks of the row. A slot holds a txn id or MAAT_FREE_SLOT.
+  // An access registers the txn before it copies the sets and timestamps,
+  // so of two txns that access the row at the same time at least one sees
+  // the other.
+  maat_set uncommitted_reads;
+  maat_set uncommitted_writes;
+  volatile uint64_t timestamp_last_read;
+  volatile uint64_t timestamp_last_write;
 };
 
 #endif
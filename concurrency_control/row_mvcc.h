@@ -28,17 +28,32 @@ struct MVReqEntry {
 	MVReqEntry * next;
 };
 
+// A version of the row. Until its txn writes it, it is only the prewrite
+// of the txn, and readers behind it wait.
 struct MVHisEntry {	
 	ts_t ts;
-	// only for write history. The value needs to be stored.
-//	char * data;
-	row_t * row;
-	MVHisEntry * next;
-	MVHisEntry * prev;
+	// the largest timestamp that read this version
+	volatile ts_t rts;
+	// the commit timestamp under SNAPSHOT, ts otherwise
+	volatile ts_t cts;
+	volatile bool pending;
+	row_t * volatile row;
+	MVHisEntry * volatile next;
 };
 
-
-
+// The versions of a row are chained from the newest to the oldest. The row
+// itself holds the version older than all of them. A read walks the chain
+// to the newest version not after its timestamp without the latch, and
+// raises the read timestamp of that version. Prewrites, writes and aborts
+// change the chain under the latch. A prewrite between a version and one of
+// its readers is rejected by the read timestamp of the version; a read that
+// races with the prewrite is retried, see access().
+// Unlinked versions are retired to the epoch manager, since lock-free
+// readers may still hold them.
+// Under READ_COMMITTED a read takes the newest committed version. Under
+// SNAPSHOT it takes the newest version committed before its timestamp, and
+// a prewrite is rejected if the newest version is not such a version (first
+// updater wins). Neither raises read timestamps.
 class Row_mvcc {
 public:
 	void init(row_t * row);
@@ -51,24 +66,22 @@ private:
 	MVReqEntry * get_req_entry();
 	void return_req_entry(MVReqEntry * entry);
 	MVHisEntry * get_his_entry();
-	void return_his_entry(MVHisEntry * entry);
 
-	bool conflict(TsType type, ts_t ts);
-	void buffer_req(TsType type, TxnManager * txn);
-	MVReqEntry * debuffer_req( TsType type, TxnManager * txn = NULL);
+	void lock();
+	void unlock();
+	// the newest version that a read at ts sees, and the link to it. NULL
+	// for the row itself
+	MVHisEntry * find_version(ts_t ts, MVHisEntry * volatile *& link);
+	// RCOK if the version is read, WAIT if it is a pending prewrite
+	RC read_version(TxnManager * txn, ts_t ts, MVHisEntry * his);
+	void buffer_req(TxnManager * txn);
 	void update_buffer(TxnManager * txn);
-	void insert_history( ts_t ts, row_t * row);
-
-	row_t * clear_history(TsType type, ts_t ts); 
+	void clear_history(TxnManager * txn);
 
 	MVReqEntry * readreq_mvcc;
-    MVReqEntry * prereq_mvcc;
-    MVHisEntry * readhis;
-    MVHisEntry * writehis;
-	MVHisEntry * readhistail;
-	MVHisEntry * writehistail;
-	uint64_t whis_len;
-	uint64_t rhis_len;
+	MVHisEntry * volatile versions;
+	// the read timestamp of the row itself
+	volatile ts_t rts;
 	uint64_t rreq_len;
 	uint64_t preq_len;
 };
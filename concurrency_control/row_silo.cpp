@@ -0,0 +1,76 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "txn.h"
+#include "row.h"
+#include "row_silo.h"
+#include "mem_alloc.h"
+
+void 
+Row_silo::init(row_t * row) {
+	_row = row;
+	tid_word = 0;
+}
+
+RC
+Row_silo::access(TxnManager * txn, TsType type) {
+	assert(type == R_REQ);
+	uint64_t v = tid_word;
+	while (true) {
+		if (v & SILO_LOCK_BIT) {
+			INC_STATS(txn->get_thd_id(),occ_ts_abort_cnt,1);
+			return Abort;
+		}
+		COMPILER_FENCE();
+		txn->cur_row->copy(_row);
+		COMPILER_FENCE();
+		// the copy is consistent if no writer got in while it was taken
+		uint64_t v2 = tid_word;
+		if (v2 == v)
+			break;
+		v = v2;
+	}
+	txn->last_tid = v;
+	return RCOK;
+}
+
+bool
+Row_silo::try_lock() {
+	uint64_t v = tid_word;
+	return !(v & SILO_LOCK_BIT) && ATOM_CAS(tid_word, v, v | SILO_LOCK_BIT);
+}
+
+bool
+Row_silo::validate(uint64_t tid, bool locked) {
+	uint64_t v = tid_word;
+	if (!locked && (v & SILO_LOCK_BIT))
+		return false;
+	return (v & ~SILO_LOCK_BIT) == tid;
+}
+
+void
+Row_silo::write(row_t * data) {
+	assert(tid_word & SILO_LOCK_BIT);
+	_row->copy(data);
+}
+
+void
+Row_silo::release(uint64_t tid) {
+	assert(tid_word & SILO_LOCK_BIT);
+	assert(!(tid & SILO_LOCK_BIT));
+	COMPILER_FENCE();
+	tid_word = tid;
+}
@@ -0,0 +1,47 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ROW_SILO_H
+#define ROW_SILO_H
+
+class table_t;
+class Catalog;
+class TxnManager;
+
+// the top bit of the TID word is the write lock
+#define SILO_LOCK_BIT 	(1UL << 63)
+
+class Row_silo {
+public:
+	void 				init(row_t * row);
+	// copies the row into txn->cur_row and stores the TID it was read at in
+	// txn->last_tid. A row locked by a committing txn is not waited for.
+	RC 					access(TxnManager * txn, TsType type);
+	bool 				try_lock();
+	// true if the row is still at tid and, unless the caller holds its
+	// lock, not locked
+	bool				validate(uint64_t tid, bool locked);
+	// the caller holds the lock
+	void				write(row_t * data);
+	// sets the TID word to tid, which clears the lock
+	void 				release(uint64_t tid);
+	uint64_t 			get_tid() { return tid_word & ~SILO_LOCK_BIT; };
+private:
+	row_t * 			_row;
+	volatile uint64_t 	tid_word;
+};
+
+#endif
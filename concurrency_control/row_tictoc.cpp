@@ -0,0 +1,98 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "txn.h"
+#include "row.h"
+#include "row_tictoc.h"
+#include "mem_alloc.h"
+
+void 
+Row_tictoc::init(row_t * row) {
+	_row = row;
+	ts_word = 0;
+}
+
+RC
+Row_tictoc::access(TxnManager * txn, TsType type) {
+	assert(type == R_REQ);
+	uint64_t v = ts_word;
+	while (true) {
+		if (v & TICTOC_LOCK_BIT) {
+			INC_STATS(txn->get_thd_id(),occ_ts_abort_cnt,1);
+			return Abort;
+		}
+		COMPILER_FENCE();
+		txn->cur_row->copy(_row);
+		COMPILER_FENCE();
+		// an rts extension changes the word without changing the data, but
+		// telling the two apart is not worth a second read
+		uint64_t v2 = ts_word;
+		if (v2 == v)
+			break;
+		v = v2;
+	}
+	txn->last_tid = v;
+	return RCOK;
+}
+
+bool
+Row_tictoc::try_lock() {
+	uint64_t v = ts_word;
+	return !(v & TICTOC_LOCK_BIT) && ATOM_CAS(ts_word, v, v | TICTOC_LOCK_BIT);
+}
+
+bool
+Row_tictoc::validate(uint64_t word, uint64_t commit_ts, bool locked) {
+	while (true) {
+		uint64_t v = ts_word;
+		if (get_wts(v) != get_wts(word))
+			return false;
+		// the lock holder does not change the timestamps before it commits
+		if (locked || get_rts(v) >= commit_ts)
+			return true;
+		if (v & TICTOC_LOCK_BIT)
+			return false;
+		uint64_t wts = get_wts(v);
+		// when the delta does not fit, wts moves up. this is safe since no
+		// version is written between the old and the new wts, but it fails
+		// the validation of other readers of the row.
+		if (commit_ts - wts > TICTOC_MAX_DELTA)
+			wts = commit_ts - TICTOC_MAX_DELTA;
+		if (ATOM_CAS(ts_word, v, make_word(wts, commit_ts)))
+			return true;
+	}
+}
+
+void
+Row_tictoc::write(row_t * data) {
+	assert(ts_word & TICTOC_LOCK_BIT);
+	_row->copy(data);
+}
+
+void
+Row_tictoc::release(uint64_t commit_ts) {
+	assert(ts_word & TICTOC_LOCK_BIT);
+	assert(commit_ts > get_rts(ts_word));
+	assert(commit_ts <= TICTOC_WTS_MASK);
+	COMPILER_FENCE();
+	ts_word = make_word(commit_ts, commit_ts);
+}
+
+void
+Row_tictoc::unlock() {
+	assert(ts_word & TICTOC_LOCK_BIT);
+	ts_word = ts_word & ~TICTOC_LOCK_BIT;
+}
@@ -0,0 +1,63 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ROW_TICTOC_H
+#define ROW_TICTOC_H
+
+class table_t;
+class Catalog;
+class TxnManager;
+
+// The timestamp word of a row packs, from the top bit down, the write lock,
+// a 15 bit delta and a 48 bit wts. The rts of the row is wts + delta.
+#define TICTOC_LOCK_BIT 	(1UL << 63)
+#define TICTOC_DELTA_BITS 	15
+#define TICTOC_WTS_BITS 	48
+#define TICTOC_MAX_DELTA 	((1UL << TICTOC_DELTA_BITS) - 1)
+#define TICTOC_WTS_MASK 	((1UL << TICTOC_WTS_BITS) - 1)
+
+class Row_tictoc {
+public:
+	void 				init(row_t * row);
+	// copies the row into txn->cur_row and stores the timestamp word it was
+	// read at in txn->last_tid. A locked row is not waited for.
+	RC 					access(TxnManager * txn, TsType type);
+	bool 				try_lock();
+	// makes the version read at word valid up to commit_ts by extending the
+	// rts of the row. fails if the row has been overwritten since, or if it
+	// is locked by another txn and its rts is too small.
+	bool 				validate(uint64_t word, uint64_t commit_ts, bool locked);
+	// the caller holds the lock
+	void				write(row_t * data);
+	// installs wts = rts = commit_ts, which clears the lock
+	void 				release(uint64_t commit_ts);
+	// clears the lock without changing the timestamps
+	void 				unlock();
+	uint64_t 			get_word() { return ts_word; };
+
+	static uint64_t 	get_wts(uint64_t word) { return word & TICTOC_WTS_MASK; };
+	static uint64_t 	get_rts(uint64_t word) { 
+		return get_wts(word) + ((word >> TICTOC_WTS_BITS) & TICTOC_MAX_DELTA); 
+	};
+private:
+	static uint64_t 	make_word(uint64_t wts, uint64_t rts) {
+		return wts | ((rts - wts) << TICTOC_WTS_BITS);
+	};
+	row_t * 			_row;
+	volatile uint64_t 	ts_word;
+};
+
+#endif
@@ -0,0 +1,50 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "global.h"
+#include "row.h"
+#include "row_vll.h"
+
+void 
+Row_vll::init(row_t * row) {
+	_row = row;
+	cs = 0;
+	cx = 0;
+}
+
+// The counters of a row are only checked under the latches of its partition,
+// see VLLMan. They are still changed atomically, since TPC-C reads items of
+// a partition that the txn does not lock.
+bool 
+Row_vll::insert_access(access_t type) {
+	if (type == WR) {
+		ATOM_ADD(cx,1);
+		return cx > 1 || cs > 0;
+	}
+	ATOM_ADD(cs,1);
+	return cx > 0;
+}
+
+void 
+Row_vll::remove_access(access_t type) {
+	if (type == WR) {
+		assert(cx > 0);
+		ATOM_SUB(cx,1);
+	} else {
+		assert(cs > 0);
+		ATOM_SUB(cs,1);
+	}
+}
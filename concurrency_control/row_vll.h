@@ -0,0 +1,36 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ROW_VLL_H
+#define ROW_VLL_H
+
+class row_t;
+
+// [VLL] instead of a lock table entry, a row only counts the requests for it
+class Row_vll {
+public:
+	void 				init(row_t * row);
+	// adds a request of type; true if an earlier request conflicts with it
+	bool 				insert_access(access_t type);
+	void 				remove_access(access_t type);
+private:
+	row_t * 			_row;
+	// the shared and the exclusive requests of this row
+	uint64_t volatile 	cs;
+	uint64_t volatile 	cx;
+};
+
+#endif
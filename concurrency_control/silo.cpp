@@ -0,0 +1,84 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "global.h"
+#include "helper.h"
+#include "txn.h"
+#include "silo.h"
+#include "row_silo.h"
+#include "mem_alloc.h"
+
+void Silo::init() {
+	start_time = get_sys_clock();
+	last_tid = (silo_thd_tid *) mem_allocator.align_alloc(sizeof(silo_thd_tid) * g_total_thread_cnt);
+	for (uint64_t i = 0; i < g_total_thread_cnt; i++)
+		last_tid[i].tid = 0;
+}
+
+uint64_t Silo::get_epoch() {
+	return (get_sys_clock() - start_time) / SILO_EPOCH_LEN + 1;
+}
+
+RC Silo::validate(TxnManager * txn) {
+#if CC_ALG == SILO
+	uint64_t starttime = get_sys_clock();
+	Array<row_t*> & locked = txn->silo_locked_rows;
+	// phase 1: lock the write set
+	RC rc = txn->lock_write_set(locked);
+	// the locks are taken with atomic instructions, so the epoch read here
+	// is not older than any of them
+	uint64_t epoch = get_epoch();
+	// phase 2: validate every row read, including the rows written
+	uint64_t max_tid = 0;
+	for (uint64_t i = 0; i < txn->get_access_cnt() && rc == RCOK; i++) {
+		Access * access = txn->txn->accesses[i];
+		row_t * row = access->orig_row;
+		bool mine = access->type == WR || 
+			TxnManager::write_set_contains(locked, row);
+		if (!row->manager->validate(access->tid, mine))
+			rc = Abort;
+		max_tid = max(max_tid, access->tid);
+	}
+	if (rc == Abort) {
+		unlock_all(txn, Abort);
+		INC_STATS(txn->get_thd_id(),occ_validate_time,get_sys_clock() - starttime);
+		return Abort;
+	}
+	// phase 3: the commit TID is larger than every TID the txn observed, the
+	// last TID of this thread, and lies in the current epoch
+	uint64_t tid = max(max_tid, last_tid[txn->get_thd_id()].tid) + 1;
+	tid = max(tid, epoch << SILO_SEQ_BITS);
+	last_tid[txn->get_thd_id()].tid = tid;
+	txn->set_end_timestamp(tid);
+	INC_STATS(txn->get_thd_id(),occ_validate_time,get_sys_clock() - starttime);
+#endif
+	return RCOK;
+}
+
+void Silo::finish(RC rc, TxnManager * txn) {
+	unlock_all(txn, rc);
+}
+
+void Silo::unlock_all(TxnManager * txn, RC rc) {
+#if CC_ALG == SILO
+	Array<row_t*> & locked = txn->silo_locked_rows;
+	for (uint64_t i = 0; i < locked.size(); i++) {
+		row_t * row = locked[i];
+		row->manager->release(rc == RCOK ? txn->get_end_timestamp() : row->manager->get_tid());
+	}
+	locked.clear();
+#endif
+}
@@ -0,0 +1,53 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef _SILO_H_
+#define _SILO_H_
+
+#include "row.h"
+
+class TxnManager;
+
+// A commit TID is (epoch << SILO_SEQ_BITS) + sequence number
+#define SILO_SEQ_BITS 	32
+
+struct silo_thd_tid {
+	uint64_t 	tid;
+	char 		pad[CL_SIZE - sizeof(uint64_t)];
+};
+
+// Decentralized OCC after Silo (Tu et al., SOSP'13). Every row carries a TID
+// word (see Row_silo). At commit a transaction locks its write set in key
+// order, reads the epoch, and checks that every row it read is still at the
+// TID it was read at and not locked by someone else. There is no shared
+// history and no central latch; threads only meet on the rows they share.
+// Epochs are derived from the clock, so no thread has to advance them.
+class Silo {
+public:
+	void 		init();
+	RC 			validate(TxnManager * txn);
+	// releases the write locks taken by validate, installing the commit TID
+	// if the transaction committed
+	void 		finish(RC rc, TxnManager * txn);
+	uint64_t 	get_epoch();
+private:
+	void 		unlock_all(TxnManager * txn, RC rc);
+	uint64_t 	start_time;
+	// the last TID each thread committed with
+	silo_thd_tid * last_tid;
+};
+
+#endif
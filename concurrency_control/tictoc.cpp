@@ -0,0 +1,89 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "global.h"
+#include "helper.h"
+#include "txn.h"
+#include "tictoc.h"
+#include "row_tictoc.h"
+#include "mem_alloc.h"
+
+uint64_t TicToc::get_lower_bound(TxnManager * txn) {
+	uint64_t ts = 1;
+	for (uint64_t i = 0; i < txn->get_access_cnt(); i++) {
+		Access * access = txn->txn->accesses[i];
+		if (access->type == WR)
+			ts = max(ts, Row_tictoc::get_rts(access->tid) + 1);
+		else
+			ts = max(ts, Row_tictoc::get_wts(access->tid));
+	}
+	return ts;
+}
+
+RC TicToc::validate(TxnManager * txn) {
+#if CC_ALG == TICTOC
+	uint64_t starttime = get_sys_clock();
+	Array<row_t*> & locked = txn->tictoc_locked_rows;
+	// phase 1: lock the write set
+	RC rc = txn->lock_write_set(locked);
+	// phase 2: pick the commit timestamp. a write must come after every read
+	// of the row, and the rts of a locked row does not move anymore
+	uint64_t commit_ts = txn->get_commit_timestamp();
+	if (rc == RCOK && commit_ts == 0) {
+		commit_ts = get_lower_bound(txn);
+		for (uint64_t i = 0; i < locked.size(); i++)
+			commit_ts = max(commit_ts, Row_tictoc::get_rts(locked[i]->manager->get_word()) + 1);
+		txn->set_commit_timestamp(commit_ts);
+	} else if (rc == RCOK) {
+		// chosen by the home node, possibly before the rows were locked
+		for (uint64_t i = 0; i < locked.size() && rc == RCOK; i++) {
+			if (Row_tictoc::get_rts(locked[i]->manager->get_word()) >= commit_ts)
+				rc = Abort;
+		}
+	}
+	// phase 3: make every read valid at the commit timestamp
+	for (uint64_t i = 0; i < txn->get_access_cnt() && rc == RCOK; i++) {
+		Access * access = txn->txn->accesses[i];
+		row_t * row = access->orig_row;
+		assert(Row_tictoc::get_wts(access->tid) <= commit_ts);
+		bool mine = access->type == WR || 
+			TxnManager::write_set_contains(locked, row);
+		if (!row->manager->validate(access->tid, commit_ts, mine))
+			rc = Abort;
+	}
+	if (rc == Abort) {
+		finish(Abort, txn);
+		INC_STATS(txn->get_thd_id(),occ_validate_time,get_sys_clock() - starttime);
+		return Abort;
+	}
+	txn->set_end_timestamp(commit_ts);
+	INC_STATS(txn->get_thd_id(),occ_validate_time,get_sys_clock() - starttime);
+#endif
+	return RCOK;
+}
+
+void TicToc::finish(RC rc, TxnManager * txn) {
+#if CC_ALG == TICTOC
+	Array<row_t*> & locked = txn->tictoc_locked_rows;
+	for (uint64_t i = 0; i < locked.size(); i++) {
+		if (rc == RCOK)
+			locked[i]->manager->release(txn->get_commit_timestamp());
+		else
+			locked[i]->manager->unlock();
+	}
+	locked.clear();
+#endif
+}
@@ -0,0 +1,49 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef _TICTOC_H_
+#define _TICTOC_H_
+
+#include "row.h"
+
+class TxnManager;
+
+// Timestamp ordering after TicToc (Yu et al., SIGMOD'16). Every row carries
+// the interval [wts, rts] in which its current version is valid (see
+// Row_tictoc). Nothing is allocated when the txn starts; at commit the txn
+// locks its write set in key order and picks the smallest timestamp at which
+// all of its reads are still valid and all of its writes come after the
+// last read of the row. Reads are then made valid up to that timestamp by
+// extending their rts.
+//
+// With two-phase commit the home node picks the timestamp. Every
+// participant reports the bound of its accesses in its RQRY_RSP, and the
+// home sends the maximum in RPREPARE. Participants then validate against
+// that timestamp instead of computing their own.
+class TicToc {
+public:
+	void 		init() {};
+	// the commit timestamp is txn->get_commit_timestamp() if it is set,
+	// otherwise it is computed and stored there
+	RC 			validate(TxnManager * txn);
+	// releases the write locks taken by validate, installing the commit
+	// timestamp if the transaction committed
+	void 		finish(RC rc, TxnManager * txn);
+	// smallest commit timestamp the accesses of txn so far allow, at least 1
+	uint64_t 	get_lower_bound(TxnManager * txn);
+};
+
+#endif
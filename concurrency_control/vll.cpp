@@ -0,0 +1,168 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "global.h"
+#include "helper.h"
+#include "txn.h"
+#include "query.h"
+#include "row.h"
+#include "row_vll.h"
+#include "vll.h"
+#include "txn_table.h"
+#include "mem_alloc.h"
+#include <algorithm>
+
+void TxnQueue::init(uint64_t part_id) {
+	this->part_id = part_id;
+	pthread_mutex_init(&latch_, NULL);
+}
+
+void TxnQueue::latch() {
+	pthread_mutex_lock(&latch_);
+}
+
+void TxnQueue::unlatch() {
+	pthread_mutex_unlock(&latch_);
+}
+
+bool TxnQueue::full() {
+	return txns.size() >= TXN_QUEUE_SIZE_LIMIT;
+}
+
+void TxnQueue::add(TxnManager * txn) {
+	txns.push_back(txn);
+}
+
+bool TxnQueue::is_head(TxnManager * txn) {
+	return txns.front() == txn;
+}
+
+void TxnQueue::remove(TxnManager * txn, uint64_t thd_id) {
+	std::vector<TxnManager *>::iterator it = std::find(txns.begin(), txns.end(), txn);
+	assert(it != txns.end());
+	bool head = it == txns.begin();
+	txns.erase(it);
+	if (!head || txns.empty())
+		return;
+	TxnManager * next = txns.front();
+	// a free txn, or a blocked one that runs already, does not wait
+	if (next->ready_part > 0 && ATOM_SUB_FETCH(next->ready_part,1) == 0) {
+		DEBUG("VLL resume %ld, part %ld\n",next->get_txn_id(),part_id);
+		txn_table.restart_txn(thd_id,next->get_txn_id(),0);
+	}
+}
+
+/************************/
+
+void VLLMan::init() {
+	uint64_t part_cnt = g_part_cnt / g_node_cnt + 1;
+	queues = (TxnQueue **) mem_allocator.alloc(sizeof(TxnQueue *) * part_cnt);
+	for (uint64_t i = 0; i < part_cnt; i++) {
+		queues[i] = (TxnQueue *) mem_allocator.alloc(sizeof(TxnQueue));
+		new (queues[i]) TxnQueue();
+		queues[i]->init(GET_PART_ID_FROM_IDX(i));
+	}
+}
+
+TxnQueue * VLLMan::get_queue(uint64_t part_id) {
+	assert(GET_NODE_ID(part_id) == g_node_id);
+	return queues[GET_PART_ID_IDX(part_id)];
+}
+
+void VLLMan::get_queues(TxnManager * txn, std::vector<TxnQueue *> & qs) {
+	std::vector<uint64_t> idxs;
+	Array<uint64_t> & parts = txn->query->partitions;
+	for (uint64_t i = 0; i < parts.size(); i++) {
+		if (GET_NODE_ID(parts[i]) == g_node_id)
+			idxs.push_back(GET_PART_ID_IDX(parts[i]));
+	}
+	// latches are taken in partition order
+	std::sort(idxs.begin(), idxs.end());
+	idxs.erase(std::unique(idxs.begin(), idxs.end()), idxs.end());
+	for (uint64_t i = 0; i < idxs.size(); i++)
+		qs.push_back(queues[idxs[i]]);
+}
+
+RC VLLMan::lock(TxnManager * txn, uint64_t thd_id) {
+	RC rc = RCOK;
+	std::vector<TxnQueue *> qs;
+	get_queues(txn, qs);
+	for (uint64_t i = 0; i < qs.size(); i++)
+		qs[i]->latch();
+
+	bool first = !txn->part_locked;
+	txn->vll_blocked = false;
+	// requests every row of txn at this node through get_lock
+	txn->acquire_locks(0);
+
+	if (txn->vll_blocked) {
+		bool can_wait = first && IS_LOCAL(txn->get_txn_id());
+		Array<uint64_t> & parts = txn->query->partitions;
+		for (uint64_t i = 0; i < parts.size() && can_wait; i++) {
+			if (GET_NODE_ID(parts[i]) != g_node_id)
+				can_wait = false;
+		}
+		for (uint64_t i = 0; i < qs.size() && can_wait; i++) {
+			if (qs[i]->full())
+				can_wait = false;
+		}
+		if (!can_wait)
+			rc = Abort;
+	}
+	if (first) {
+		// the txn leaves the queues in unlock, also if it aborts now
+		txn->part_locked = true;
+		for (uint64_t i = 0; i < qs.size(); i++)
+			qs[i]->add(txn);
+	}
+	if (rc == RCOK && txn->vll_blocked) {
+		assert(txn->ready_part == 0);
+		for (uint64_t i = 0; i < qs.size(); i++) {
+			if (!qs[i]->is_head(txn))
+				txn->ready_part++;
+		}
+		if (txn->ready_part > 0) {
+			INC_STATS(thd_id,txn_wait_cnt,1);
+			rc = WAIT;
+		}
+	}
+
+	for (uint64_t i = qs.size(); i > 0; i--)
+		qs[i - 1]->unlatch();
+	return rc;
+}
+
+void VLLMan::unlock(TxnManager * txn, uint64_t thd_id) {
+	if (!txn->part_locked)
+		return;
+	std::vector<TxnQueue *> qs;
+	get_queues(txn, qs);
+	for (uint64_t i = 0; i < qs.size(); i++)
+		qs[i]->latch();
+
+	txn->part_locked = false;
+#if CC_ALG == VLL
+	for (uint64_t i = 0; i < txn->calvin_locked_rows.size(); i++)
+		txn->calvin_locked_rows[i]->manager->remove_access(txn->vll_lock_types[i]);
+#endif
+	txn->calvin_locked_rows.clear();
+	txn->vll_lock_types.clear();
+	for (uint64_t i = 0; i < qs.size(); i++)
+		qs[i]->remove(txn, thd_id);
+
+	for (uint64_t i = qs.size(); i > 0; i--)
+		qs[i - 1]->unlatch();
+}
@@ -0,0 +1,69 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef _VLL_H_
+#define _VLL_H_
+
+#include "global.h"
+#include <vector>
+
+class TxnManager;
+
+// The txns of one partition in the order they requested their rows
+class TxnQueue {
+public:
+	void 		init(uint64_t part_id);
+	void 		latch();
+	void 		unlatch();
+	bool 		full();
+	void 		add(TxnManager * txn);
+	bool 		is_head(TxnManager * txn);
+	// removes txn and resumes the new head if it waits for this partition
+	void 		remove(TxnManager * txn, uint64_t thd_id);
+private:
+	pthread_mutex_t latch_;
+	uint64_t 	part_id;
+	std::vector<TxnManager *> txns;
+};
+
+// Very lightweight locking (Ren et al., VLDB'12). A row counts its shared and
+// exclusive requests (Row_vll) instead of keeping a queue of lock entries.
+// A txn requests all of its rows at a node at once, under the latches of its
+// partitions there, and joins the TxnQueue of each of them. If no earlier
+// request conflicts with its own, the txn is free and runs at once. Otherwise
+// it is blocked, and runs once it is the head of all of its queues, since then
+// every txn that requested the rows before it is done.
+//
+// A blocked txn only waits if it is a txn of this node that accesses no other
+// node, so waits never span nodes. Otherwise, or if one of its queues already
+// holds TXN_QUEUE_SIZE_LIMIT txns, it aborts. A participant requests the rows
+// of each RQRY when it arrives.
+class VLLMan {
+public:
+	void 		init();
+	// requests the rows of txn that are not requested yet. WAIT if txn is
+	// blocked; it is resumed with restart_txn once it is the head of its queues
+	RC 			lock(TxnManager * txn, uint64_t thd_id);
+	// releases the rows of txn and leaves its queues
+	void 		unlock(TxnManager * txn, uint64_t thd_id);
+private:
+	TxnQueue * 	get_queue(uint64_t part_id);
+	// the queues of the partitions of txn at this node, in latch order
+	void 		get_queues(TxnManager * txn, std::vector<TxnQueue *> & queues);
+	TxnQueue ** queues;
+};
+
+#endif
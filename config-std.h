@@ -47,7 +47,7 @@
 /***********************************************/
 // Concurrency Control
 /***********************************************/
-// WAIT_DIE, NO_WAIT, DL_DETECT, TIMESTAMP, MVCC, HSTORE, OCC, VLL
+// WAIT_DIE, NO_WAIT, WOUND_WAIT, DL_DETECT, TIMESTAMP, MVCC, HSTORE, OCC, VLL
 #define CC_ALG 						DL_DETECT
 
 // all transactions acquire tuples according to the primary key order.
@@ -59,7 +59,6 @@
 #define BUCKET_CNT					31
 #define ABORT_PENALTY				1000000UL    // in ns.
 // [ INDEX ]
-#define ENABLE_LATCH				false
 #define CENTRAL_INDEX				false
 #define CENTRAL_MANAGER 			false
 #define INDEX_STRUCT				IDX_HASH
@@ -76,21 +75,22 @@
 #define TS_BATCH_ALLOC				false
 #define TS_BATCH_NUM				1
 // [MVCC]
-// when read/write history is longer than HIS_RECYCLE_LEN
-// the history should be recycled.
-#define HIS_RECYCLE_LEN				10
 #define MAX_PRE_REQ					1024
 #define MAX_READ_REQ				1024
 #define MIN_TS_INTVL				10000000 //10 ms
 // [OCC]
 #define MAX_WRITE_SET				10
 #define PER_ROW_VALID				true
+// [SILO]
+#define SILO_EPOCH_LEN				(40 * 1000000UL) // 40ms
 // [HSTORE]
 // when set to true, hstore will not access the global timestamp.
 // This is fine for single partition transactions. 
 #define HSTORE_LOCAL_TS				false
 // [VLL] 
 #define TXN_QUEUE_SIZE_LIMIT		THREAD_CNT
+// [MAAT] ids per chunk of a row's soft-lock sets; a full set chains another
+#define MAAT_ROW_SET_SIZE			8
 
 /***********************************************/
 // Logging
@@ -140,6 +140,7 @@ extern TPCCTxnType 					g_tpcc_txn_type;
 
 //#define TXN_TYPE					TPCC_ALL
 #define PERC_PAYMENT 				0.5
+#define PERC_DELIVERY 				0.0
 #define FIRSTNAME_MINLEN 			8
 #define FIRSTNAME_LEN 				16
 #define LASTNAME_LEN 				16
@@ -183,6 +184,7 @@ extern TestCases					g_test_case;
 // INDEX_STRUCT
 #define IDX_HASH 					1
 #define IDX_BTREE					2
+#define IDX_ART						3
 // WORKLOAD
 #define YCSB						1
 #define TPCC						2
@@ -196,6 +198,9 @@ extern TestCases					g_test_case;
 #define HSTORE						6
 #define OCC							7
 #define VLL							8
+#define SILO						13
+#define TICTOC						14
+#define WOUND_WAIT					15
 // TIMESTAMP allocation method.
 #define TS_MUTEX					1
 #define TS_CAS						2
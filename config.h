@@ -97,8 +97,12 @@
 /***********************************************/
 // Concurrency Control
 /***********************************************/
-// WAIT_DIE, NO_WAIT, TIMESTAMP, MVCC, CALVIN, MAAT
+// WAIT_DIE, NO_WAIT, WOUND_WAIT, DL_DETECT, TIMESTAMP, MVCC, HSTORE, HSTORE_SPEC,
+// CALVIN, MAAT, SILO, TICTOC
 #define CC_ALG TIMESTAMP
+// SERIALIZABLE, NOLOCK for all CC_ALG. READ_COMMITTED for the 2PL algorithms
+// (short read locks), MVCC and MAAT. READ_UNCOMMITTED for the 2PL algorithms.
+// SNAPSHOT for MVCC.
 #define ISOLATION_LEVEL SERIALIZABLE
 #define YCSB_ABORT_MODE false
 
@@ -113,31 +117,42 @@
 #define ABORT_PENALTY_MAX 5 * 100 * 1000000UL   // in ns.
 #define BACKOFF true
 // [ INDEX ]
-#define ENABLE_LATCH        false
 #define CENTRAL_INDEX       false
 #define CENTRAL_MANAGER       false
 #define INDEX_STRUCT        IDX_HASH
 #define BTREE_ORDER         16
 
+// [DL_DETECT]
+// interval of the deadlock detection
+#define DL_LOOP_DETECT      1000000UL // 1ms
 // [TIMESTAMP]
 #define TS_TWR            false
 #define TS_ALLOC          TS_CLOCK
 #define TS_BATCH_ALLOC        false
 #define TS_BATCH_NUM        1
+// [TS_HLC] a thread renews its lease of clock values after this many us
+#define TS_HLC_LEASE        100
 // [MVCC]
-// when read/write history is longer than HIS_RECYCLE_LEN
-// the history should be recycled.
-#define HIS_RECYCLE_LEN       10
 #define MAX_PRE_REQ         MAX_TXN_IN_FLIGHT * NODE_CNT//1024
 #define MAX_READ_REQ        MAX_TXN_IN_FLIGHT * NODE_CNT//1024
+// how often the low-water mark of the active timestamps is refreshed
 #define MIN_TS_INTVL        10 * 1000000UL // 10ms
 // [OCC]
 #define MAX_WRITE_SET       10
 #define PER_ROW_VALID       false
-// [VLL] 
+// [SILO]
+// length of a commit epoch
+#define SILO_EPOCH_LEN      (40 * 1000000UL) // 40ms
+// [VLL] a blocked txn aborts if the queue of one of its partitions holds this many txns
 #define TXN_QUEUE_SIZE_LIMIT    THREAD_CNT
+// [MAAT] a row keeps room for this many uncommitted readers and as many
+// writers. More chain another chunk of the same size
+#define MAAT_ROW_SET_SIZE   8
 // [CALVIN]
-#define SEQ_THREAD_CNT 4 
+// number of sequencer threads; thread 0 also closes the epochs
+#define SEQ_THREAD_CNT 1 
+// number of scheduler threads; each locks the rows whose key maps to it
+#define CALVIN_LOCK_THREAD_CNT 1
 
 /***********************************************/
 // Logging
@@ -170,6 +185,7 @@
 #define ZIPF_THETA 0.3
 #define TXN_WRITE_PERC 0.0
 #define TUP_WRITE_PERC 0.0
+// SCAN_PERC of the requests are range scans of 1 to SCAN_LEN rows
 #define SCAN_PERC           0
 #define SCAN_LEN          20
 #define PART_PER_TXN PART_CNT
@@ -216,6 +232,8 @@ extern TPCCTxnType          g_tpcc_txn_type;
 
 //#define TXN_TYPE          TPCC_ALL
 #define PERC_PAYMENT 0.0
+// rest of the mix is new-order. Delivery is not run under CALVIN or TPCC_SMALL
+#define PERC_DELIVERY 0.0
 #define FIRSTNAME_MINLEN      8
 #define FIRSTNAME_LEN         16
 #define LASTNAME_LEN        16
@@ -287,6 +305,7 @@ enum PPSTxnType {PPS_ALL = 0,
 // INDEX_STRUCT
 #define IDX_HASH          1
 #define IDX_BTREE         2
+#define IDX_ART           3
 // WORKLOAD
 #define YCSB            1
 #define TPCC            2
@@ -305,11 +324,16 @@ enum PPSTxnType {PPS_ALL = 0,
 #define CALVIN      10
 #define MAAT      11
 #define WDL           12
+#define SILO          13
+#define TICTOC        14
+#define WOUND_WAIT    15
 // TIMESTAMP allocation method.
 #define TS_MUTEX          1
 #define TS_CAS            2
 #define TS_HW           3
 #define TS_CLOCK          4
+// hybrid logical clock; per-thread leases, corrected by remote timestamps
+#define TS_HLC            5
 // MODES
 // NORMAL < NOCC < QRY_ONLY < SETUP < SIMPLE
 #define NORMAL_MODE 1
@@ -338,6 +362,7 @@ enum PPSTxnType {PPS_ALL = 0,
 #define READ_COMMITTED 2 
 #define READ_UNCOMMITTED 3 
 #define NOLOCK 4 
+#define SNAPSHOT 5
 
 // Stats and timeout
 #define BILLION 1000000000UL // in ns => 1 second
@@ -346,6 +371,11 @@ enum PPSTxnType {PPS_ALL = 0,
 #define PROG_TIMER 10 * BILLION // in s
 #define BATCH_TIMER 0
 #define SEQ_BATCH_TIMER 5 * 1 * MILLION // ~5ms -- same as CALVIN paper
+// epochs close on a grid of SEQ_BATCH_MIN_TIMER ticks shared by all nodes,
+// and last between one tick and SEQ_BATCH_TIMER depending on the arrival
+// rate. An epoch takes at most SEQ_BATCH_MAX_TXNS txns
+#define SEQ_BATCH_MIN_TIMER 100 * 1000 // ~0.1ms
+#define SEQ_BATCH_MAX_TXNS 4096
 #define DONE_TIMER 1 * 60 * BILLION // ~1 minutes
 #define WARMUP_TIMER 1 * 60 * BILLION // ~1 minutes
 
@@ -0,0 +1,109 @@
+#!/usr/bin/env python
+# Turns the schema files into static column layouts (benchmarks/*_schema.h),
+# so that typed row accessors compile to a single load or store.
+# Run from the repository root: python scripts/gen_schema.py
+# The layout rules must match Workload::init_schema and Catalog::add_col.
+import os,re,sys
+
+TYPES = {
+    "int64_t" : "int64_t",
+    "uint64_t" : "uint64_t",
+    "double" : "double",
+    "string" : "char",
+}
+
+# output header, namespace, [(guard, schema file)]
+OUTPUTS = [
+    ("benchmarks/tpcc_schema.h", "tpcc_schema", [
+        ("TPCC_SMALL", "benchmarks/TPCC_short_schema.txt"),
+        (None, "benchmarks/TPCC_full_schema.txt")]),
+    ("benchmarks/pps_schema.h", "pps_schema", [
+        (None, "benchmarks/PPS_schema.txt")]),
+]
+
+def parse(path):
+    tables = []
+    lines = open(path).read().split("\n")
+    i = 0
+    while i < len(lines):
+        line = lines[i]
+        i += 1
+        if not line.startswith("TABLE="):
+            continue
+        name = line[6:]
+        pax = False
+        if "," in name:
+            name,layout = name.split(",",1)
+            pax = layout.startswith("PAX")
+        cols = []
+        groups = []
+        while i < len(lines) and len(lines[i]) > 1:
+            items = lines[i].strip().split(",")
+            i += 1
+            size,ctype,cname = int(items[0]),items[1],items[2]
+            tag = items[3] if len(items) > 3 else None
+            g = len(groups)
+            if pax and tag is not None:
+                for j,(gtag,gsize) in enumerate(groups):
+                    if gtag == tag:
+                        g = j
+                        break
+            elif not pax and len(groups) > 0:
+                g = 0
+            if g == len(groups):
+                groups.append([tag if pax else None,0])
+            cols.append({"name":cname, "type":TYPES[ctype], "size":size,
+                "index":sum(c["size"] for c in cols), "group":g,
+                "group_index":groups[g][1]})
+            groups[g][1] += size
+        for c in cols:
+            c["group_size"] = groups[c["group"]][1]
+        tables.append((name,pax,cols))
+    return tables
+
+def ident(name):
+    return re.sub("[^A-Za-z0-9_]","_",name)
+
+def emit(out, ns, sources):
+    guard = "_" + ident(os.path.basename(out)).upper() + "_"
+    o = []
+    o.append("// Generated by scripts/gen_schema.py. Do not edit.")
+    o.append("#ifndef %s" % guard)
+    o.append("#define %s" % guard)
+    o.append("")
+    o.append("#include \"global.h\"")
+    o.append("#include \"catalog.h\"")
+    o.append("")
+    for k,(cond,path) in enumerate(sources):
+        if cond is not None:
+            o.append("#if %s" % cond)
+        elif k > 0:
+            o.append("#else")
+        o.append("// %s" % os.path.basename(path))
+        o.append("namespace %s {" % ns)
+        rows = []
+        for (tname,pax,cols) in parse(path):
+            o.append("namespace %s {" % ident(tname))
+            for c in cols:
+                o.append("\tstruct %s { typedef %s type; static const bool pax = %s;"
+                    % (c["name"], c["type"], "true" if pax else "false"))
+                o.append("\t\tenum { id = %d, size = %d, index = %d, group = %d, group_index = %d, group_size = %d }; };"
+                    % (cols.index(c), c["size"], c["index"], c["group"], c["group_index"], c["group_size"]))
+                rows.append("\t{\"%s\", %d, %d, %d, %d, %d, %d, %s}," % (tname, cols.index(c),
+                    c["size"], c["index"], c["group"], c["group_index"], c["group_size"],
+                    "true" if pax else "false"))
+            o.append("}")
+        o.append("// checked against the parsed schema by Workload::check_schema")
+        o.append("static const static_column columns[] = {")
+        o.extend(rows)
+        o.append("};")
+        o.append("}")
+    if len(sources) > 1:
+        o.append("#endif")
+    o.append("")
+    o.append("#endif")
+    open(out,"w").write("\n".join(o) + "\n")
+
+if __name__ == "__main__":
+    for (out,ns,sources) in OUTPUTS:
+        emit(out,ns,sources)
@@ -287,6 +287,8 @@ stat_map = OrderedDict([
   ('maat_range', []),
   ('maat_commit_cnt', []),
   ('maat_range_avg', []),
+  ('maat_row_set_overflow_cnt', []),
+  ('maat_tt_overflow_cnt', []),
 
   # Logging
   ('log_write_cnt', []),
@@ -553,6 +555,8 @@ stat_map2 = {
   'maat_range': [],
   'maat_commit_cnt': [],
   'maat_range_avg': [],
+  'maat_row_set_overflow_cnt': [],
+  'maat_tt_overflow_cnt': [],
 
   # Logging
   'log_write_cnt': [],
@@ -157,6 +157,8 @@ void Stats_thd::clear() {
   twopl_sh_owned_cnt=0;
   twopl_ex_owned_cnt=0;
   twopl_sh_bypass_cnt=0;
+  twopl_deadlock_cnt=0;
+  twopl_wound_cnt=0;
   twopl_owned_time=0;
   twopl_sh_owned_time=0;
   twopl_ex_owned_time=0;
@@ -219,6 +221,8 @@ void Stats_thd::clear() {
   maat_case5_cnt=0;
   maat_range=0;
   maat_commit_cnt=0;
+  maat_row_set_overflow_cnt=0;
+  maat_tt_overflow_cnt=0;
 
 
   // Logging
@@ -236,7 +240,7 @@ void Stats_thd::clear() {
   txn_table_cflt_size=0;
   txn_table_get_time=0;
   txn_table_release_time=0;
-  txn_table_min_ts_time=0;
+  mvcc_min_ts_time=0;
 
   for(uint64_t i = 0; i < 40; i ++) {
     mtx[i]=0;
@@ -764,6 +768,8 @@ void Stats_thd::print(FILE * outf, bool prog) {
     ",twopl_sh_owned_cnt=%ld"
     ",twopl_ex_owned_cnt=%ld"
     ",twopl_sh_bypass_cnt=%ld"
+    ",twopl_deadlock_cnt=%ld"
+    ",twopl_wound_cnt=%ld"
     ",twopl_owned_time=%f"
     ",twopl_sh_owned_time=%f"
     ",twopl_ex_owned_time=%f"
@@ -780,6 +786,8 @@ void Stats_thd::print(FILE * outf, bool prog) {
     ,twopl_sh_owned_cnt
     ,twopl_ex_owned_cnt
     ,twopl_sh_bypass_cnt
+    ,twopl_deadlock_cnt
+    ,twopl_wound_cnt
     ,twopl_owned_time / BILLION
     ,twopl_sh_owned_time / BILLION
     ,twopl_ex_owned_time / BILLION
@@ -909,6 +917,8 @@ void Stats_thd::print(FILE * outf, bool prog) {
   ",maat_commit_cnt=%ld"
   ",maat_commit_avg=%ld"
   ",maat_range_avg=%f"
+  ",maat_row_set_overflow_cnt=%ld"
+  ",maat_tt_overflow_cnt=%ld"
   ,maat_validate_cnt
   ,maat_validate_time / BILLION
   ,maat_validate_avg / BILLION
@@ -923,6 +933,8 @@ void Stats_thd::print(FILE * outf, bool prog) {
   ,maat_commit_cnt
   ,maat_commit_avg
   ,maat_range_avg
+  ,maat_row_set_overflow_cnt
+  ,maat_tt_overflow_cnt
   );
 
 
@@ -965,7 +977,7 @@ void Stats_thd::print(FILE * outf, bool prog) {
     ",txn_table_cflt_size=%ld"
     ",txn_table_get_time=%f"
     ",txn_table_release_time=%f"
-    ",txn_table_min_ts_time=%f"
+    ",mvcc_min_ts_time=%f"
     ",txn_table_get_avg_time=%f"
     ",txn_table_release_avg_time=%f"
     // Transaction Table
@@ -976,7 +988,7 @@ void Stats_thd::print(FILE * outf, bool prog) {
     ,txn_table_cflt_size
     ,txn_table_get_time / BILLION
     ,txn_table_release_time / BILLION
-    ,txn_table_min_ts_time / BILLION
+    ,mvcc_min_ts_time / BILLION
     ,txn_table_get_avg_time / BILLION
     ,txn_table_release_avg_time / BILLION
   );
@@ -1298,6 +1310,8 @@ void Stats_thd::combine(Stats_thd * stats) {
   twopl_sh_owned_cnt+=stats->twopl_sh_owned_cnt;
   twopl_ex_owned_cnt+=stats->twopl_ex_owned_cnt;
   twopl_sh_bypass_cnt+=stats->twopl_sh_bypass_cnt;
+  twopl_deadlock_cnt+=stats->twopl_deadlock_cnt;
+  twopl_wound_cnt+=stats->twopl_wound_cnt;
   twopl_owned_time+=stats->twopl_owned_time;
   twopl_sh_owned_time+=stats->twopl_sh_owned_time;
   twopl_ex_owned_time+=stats->twopl_ex_owned_time;
@@ -1358,6 +1372,8 @@ void Stats_thd::combine(Stats_thd * stats) {
   maat_case5_cnt+=stats->maat_case5_cnt;
   maat_range+=stats->maat_range;
   maat_commit_cnt+=stats->maat_commit_cnt;
+  maat_row_set_overflow_cnt+=stats->maat_row_set_overflow_cnt;
+  maat_tt_overflow_cnt+=stats->maat_tt_overflow_cnt;
 
   // Logging
   log_write_cnt+=stats->log_write_cnt;
@@ -1374,7 +1390,7 @@ void Stats_thd::combine(Stats_thd * stats) {
   txn_table_cflt_size+=stats->txn_table_cflt_size;
   txn_table_get_time+=stats->txn_table_get_time;
   txn_table_release_time+=stats->txn_table_release_time;
-  txn_table_min_ts_time+=stats->txn_table_min_ts_time;
+  mvcc_min_ts_time+=stats->mvcc_min_ts_time;
 
   for(uint64_t i = 0; i < 40; i ++) {
     mtx[i]+=stats->mtx[i];
@@ -152,6 +152,8 @@ public:
   uint64_t twopl_ex_owned_cnt;
   uint64_t twopl_get_cnt;
   uint64_t twopl_sh_bypass_cnt;
+  uint64_t twopl_deadlock_cnt;
+  uint64_t twopl_wound_cnt;
   double twopl_owned_time;
   double twopl_sh_owned_time;
   double twopl_ex_owned_time;
@@ -213,6 +215,8 @@ public:
   uint64_t maat_case5_cnt;
   double maat_range;
   uint64_t maat_commit_cnt;
+  uint64_t maat_row_set_overflow_cnt;
+  uint64_t maat_tt_overflow_cnt;
 
   // Logging
   uint64_t log_write_cnt;
@@ -229,7 +233,7 @@ public:
   uint64_t txn_table_cflt_size;
   double txn_table_get_time;
   double txn_table_release_time;
-  double txn_table_min_ts_time;
+  double mvcc_min_ts_time;
 
   // Latency
   StatsArr client_client_latency;
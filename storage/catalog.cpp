@@ -19,20 +19,42 @@
 #include "helper.h"
 
 void 
-Catalog::init(const char * table_name, uint32_t table_id, int field_cnt) {
+Catalog::init(const char * table_name, uint32_t table_id, int field_cnt, bool pax) {
 	this->table_name = table_name;
 	this->table_id = table_id;
 	this->field_cnt = 0;
 	this->_columns = new Column [field_cnt];
 	this->tuple_size = 0;
+	this->pax = pax;
+	this->group_cnt = 0;
+	this->group_size = new UInt32 [field_cnt];
+	this->group_names = new char * [field_cnt];
 }
 
-void Catalog::add_col(char * col_name, uint64_t size, char * type) {
+void Catalog::add_col(char * col_name, uint64_t size, char * type, const char * group) {
+	UInt32 g = 0;
+	if (pax) {
+		while (g < group_cnt && (group == NULL || group_names[g] == NULL 
+					|| strcmp(group, group_names[g]) != 0))
+			g ++;
+	}
+	if (g == group_cnt) {
+		group_size[g] = 0;
+		group_names[g] = NULL;
+		if (pax && group != NULL) {
+			group_names[g] = new char[strlen(group) + 1];
+			strcpy(group_names[g], group);
+		}
+		group_cnt ++;
+	}
 	_columns[field_cnt].size = size;
 	strcpy(_columns[field_cnt].type, type);
 	strcpy(_columns[field_cnt].name, col_name);
 	_columns[field_cnt].id = field_cnt;
 	_columns[field_cnt].index = tuple_size;
+	_columns[field_cnt].group = g;
+	_columns[field_cnt].group_index = group_size[g];
+	group_size[g] += size;
 	tuple_size += size;
 	field_cnt ++;
 }
@@ -65,9 +87,17 @@ uint64_t Catalog::get_field_index(char * name) {
 }
 
 void Catalog::print_schema() {
-	printf("\n[Catalog] %s\n", table_name);
+	printf("\n[Catalog] %s%s\n", table_name, pax ? " (PAX)" : "");
 	for (UInt32 i = 0; i < field_cnt; i++) {
-		printf("\t%s\t%s\t%ld\n", get_field_name(i), 
-			get_field_type(i), get_field_size(i));
+		printf("\t%s\t%s\t%ld\t%d\n", get_field_name(i), 
+			get_field_type(i), get_field_size(i), _columns[i].group);
 	}
 }
+
+bool Catalog::check_column(const static_column & col) {
+	if (col.id >= field_cnt || col.pax != pax)
+		return false;
+	Column * c = &_columns[col.id];
+	return c->size == col.size && c->index == col.index && c->group == col.group
+		&& c->group_index == col.group_index && group_size[c->group] == col.group_size;
+}
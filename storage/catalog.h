@@ -42,18 +42,36 @@ public:
 
 	UInt64 id;
 	UInt32 size;
+	// offset in the flat tuple
 	UInt32 index;
+	// column group and offset inside the group (see Catalog)
+	UInt32 group;
+	UInt32 group_index;
 	char * type;
 	char * name;
-	char pad[CL_SIZE - sizeof(uint64_t)*3 - sizeof(char *)*2];
+	char pad[CL_SIZE - sizeof(uint64_t)*4 - sizeof(char *)*2];
+};
+
+// Column layout computed from a schema file by scripts/gen_schema.py.
+struct static_column {
+	const char * table_name;
+	UInt32 id;
+	UInt32 size;
+	UInt32 index;
+	UInt32 group;
+	UInt32 group_index;
+	UInt32 group_size;
+	bool pax;
 };
 
 class Catalog {
 public:
 	// abandoned init function
 	// field_size is the size of each each field.
-	void init(const char * table_name, uint32_t table_id, int field_cnt);
-	void add_col(char * col_name, uint64_t size, char * type);
+	void init(const char * table_name, uint32_t table_id, int field_cnt, bool pax = false);
+	// group names the column group of a PAX table. Columns of the same group
+	// are stored together; a column without group is stored on its own.
+	void add_col(char * col_name, uint64_t size, char * type, const char * group = NULL);
 
 	UInt32 			field_cnt;
  	const char * 	table_name;
@@ -71,10 +89,18 @@ public:
 	uint64_t 		get_field_index(char * name);
 
 	void 			print_schema();
+	// true if the parsed layout of the column equals the generated one
+	bool 			check_column(const static_column & col);
 	Column * 		_columns;
 	UInt32 			tuple_size;
+	// PAX tables keep each column group in its own minipage of the row heap.
+	// Otherwise the whole tuple forms group 0.
+	bool 			pax;
+	UInt32 			group_cnt;
+	UInt32 * 		group_size;
 private:
-	char pad[CL_SIZE - sizeof(uint64_t)*2 - sizeof(int) - sizeof(char *)*2 - sizeof(uint32_t)];
+	char ** 		group_names;
+	char pad[CL_SIZE - sizeof(uint64_t)*2 - sizeof(int)*2 - sizeof(char *)*4 - sizeof(uint32_t) - sizeof(bool)];
 };
 
 #endif
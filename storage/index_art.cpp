@@ -0,0 +1,649 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "mem_alloc.h"
+#include "index_art.h"
+#include "row.h"
+#include "epoch.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static uint64_t art_node_size(uint8_t type) {
+	switch (type) {
+		case ART_N4: 	return sizeof(art_node4);
+		case ART_N16: 	return sizeof(art_node16);
+		case ART_N48: 	return sizeof(art_node48);
+		default: 		return sizeof(art_node256);
+	}
+}
+
+RC IndexArt::init(uint64_t part_cnt) {
+	this->part_cnt = part_cnt;
+	roots = (art_node **) malloc(part_cnt * sizeof(art_node *));
+	retired = (art_node **) malloc(part_cnt * sizeof(art_node *));
+	for (uint64_t part_id = 0; part_id < part_cnt; part_id ++) {
+		roots[part_id] = make_node(ART_N256, part_id);
+		retired[part_id] = NULL;
+	}
+	return RCOK;
+}
+
+RC IndexArt::init(uint64_t part_cnt, table_t * table, uint64_t table_size) {
+	this->table = table;
+	return init(part_cnt);
+}
+
+void IndexArt::index_delete() {
+	for (uint64_t part_id = 0; part_id < part_cnt; part_id ++) {
+		free_node(roots[part_id]);
+		// replaced nodes share their children with the live tree
+		art_node * node = retired[part_id];
+		while (node != NULL) {
+			art_node * next = node->retired;
+			mem_allocator.free(node, art_node_size(node->type));
+			node = next;
+		}
+	}
+	free(roots);
+	free((void *) retired);
+	roots = NULL;
+	retired = NULL;
+}
+
+void IndexArt::free_node(art_node * node) {
+	uint8_t cb;
+	for (uint32_t b = 0; b < 256; b = cb + 1) {
+		art_node * child = next_child(node, b, cb);
+		if (child == NULL)
+			break;
+		if (is_leaf(child)) {
+			art_leaf * leaf = to_leaf(child);
+			if (leaf->items != NULL)
+				((row_t *)leaf->items->location)->free_row();
+			mem_allocator.free(leaf, sizeof(art_leaf));
+		} else
+			free_node(child);
+	}
+	mem_allocator.free(node, art_node_size(node->type));
+}
+
+/************** optimistic lock coupling ******************/
+
+bool IndexArt::read_lock(art_node * node, uint64_t &version) {
+	version = node->version;
+	while (version & ART_LOCKED) {
+		SPIN_PAUSE();
+		version = node->version;
+	}
+	COMPILER_FENCE();
+	return !(version & ART_OBSOLETE);
+}
+
+// true if nobody wrote the node since version was read
+bool IndexArt::validate(art_node * node, uint64_t version) {
+	COMPILER_FENCE();
+	return node->version == version;
+}
+
+bool IndexArt::upgrade_lock(art_node * node, uint64_t version) {
+	return ATOM_CAS(node->version, version, version + ART_LOCKED);
+}
+
+void IndexArt::write_unlock(art_node * node) {
+	ATOM_ADD(node->version, ART_LOCKED);
+}
+
+void IndexArt::write_unlock_obsolete(art_node * node) {
+	ATOM_ADD(node->version, ART_LOCKED + ART_OBSOLETE);
+}
+
+/************** nodes ******************/
+
+// Nodes are zeroed, so a reader that races with add_child sees either an
+// old child or NULL, never garbage.
+art_node * IndexArt::make_node(ArtNodeType type, uint64_t part_id) {
+	uint64_t size = art_node_size(type);
+	art_node * node = (art_node *) mem_allocator.part_alloc(size, part_id);
+	assert(node != NULL);
+	memset(node, 0, size);
+	node->type = type;
+	return node;
+}
+
+art_leaf * IndexArt::make_leaf(idx_key_t key, itemid_t * item) {
+	art_leaf * leaf = (art_leaf *) mem_allocator.alloc(sizeof(art_leaf));
+	item->next = NULL;
+	leaf->key = key;
+	leaf->items = item;
+	return leaf;
+}
+
+bool IndexArt::is_full(art_node * node) {
+	switch (node->type) {
+		case ART_N4: 	return node->count == 4;
+		case ART_N16: 	return node->count == 16;
+		case ART_N48: 	return node->count == 48;
+		default: 		return false;
+	}
+}
+
+// Readers call this on nodes that may change under them, so it only
+// relies on count staying within the capacity of the node.
+art_node * IndexArt::find_child(art_node * node, uint8_t b) {
+	switch (node->type) {
+		case ART_N4: {
+			art_node4 * n = (art_node4 *) node;
+			uint32_t cnt = n->hdr.count;
+			for (uint32_t i = 0; i < cnt && i < 4; i++)
+				if (n->keys[i] == b)
+					return n->children[i];
+			return NULL;
+		}
+		case ART_N16: {
+			art_node16 * n = (art_node16 *) node;
+			uint32_t cnt = n->hdr.count;
+			if (cnt > 16)
+				return NULL;
+#if defined(__SSE2__)
+			__m128i hit = _mm_cmpeq_epi8(_mm_set1_epi8((char) b),
+					_mm_loadu_si128((const __m128i *) n->keys));
+			uint32_t mask = _mm_movemask_epi8(hit) & ((1U << cnt) - 1);
+			return mask ? n->children[__builtin_ctz(mask)] : NULL;
+#else
+			for (uint32_t i = 0; i < cnt; i++)
+				if (n->keys[i] == b)
+					return n->children[i];
+			return NULL;
+#endif
+		}
+		case ART_N48: {
+			art_node48 * n = (art_node48 *) node;
+			uint8_t slot = n->child_index[b];
+			return slot ? n->children[slot - 1] : NULL;
+		}
+		default:
+			return ((art_node256 *) node)->children[b];
+	}
+}
+
+art_node * IndexArt::next_child(art_node * node, uint32_t b, uint8_t &cb) {
+	switch (node->type) {
+		case ART_N4:
+		case ART_N16: {
+			uint32_t cap = node->type == ART_N4 ? 4 : 16;
+			uint8_t * keys = node->type == ART_N4 ?
+				((art_node4 *) node)->keys : ((art_node16 *) node)->keys;
+			art_node * volatile * children = node->type == ART_N4 ?
+				((art_node4 *) node)->children : ((art_node16 *) node)->children;
+			uint32_t cnt = node->count;
+			for (uint32_t i = 0; i < cnt && i < cap; i++) {
+				if (keys[i] >= b) {
+					cb = keys[i];
+					return children[i];
+				}
+			}
+			return NULL;
+		}
+		case ART_N48: {
+			art_node48 * n = (art_node48 *) node;
+			for (; b < 256; b++) {
+				uint8_t slot = n->child_index[b];
+				if (slot) {
+					cb = b;
+					return n->children[slot - 1];
+				}
+			}
+			return NULL;
+		}
+		default: {
+			art_node256 * n = (art_node256 *) node;
+			for (; b < 256; b++) {
+				if (n->children[b] != NULL) {
+					cb = b;
+					return n->children[b];
+				}
+			}
+			return NULL;
+		}
+	}
+}
+
+// the child is written before count, so readers never see an empty slot
+// within count
+void IndexArt::add_child(art_node * node, uint8_t b, art_node * child) {
+	switch (node->type) {
+		case ART_N4:
+		case ART_N16: {
+			uint8_t * keys = node->type == ART_N4 ?
+				((art_node4 *) node)->keys : ((art_node16 *) node)->keys;
+			art_node * volatile * children = node->type == ART_N4 ?
+				((art_node4 *) node)->children : ((art_node16 *) node)->children;
+			uint32_t pos = 0;
+			while (pos < node->count && keys[pos] < b)
+				pos ++;
+			for (uint32_t i = node->count; i > pos; i--) {
+				keys[i] = keys[i - 1];
+				children[i] = children[i - 1];
+			}
+			keys[pos] = b;
+			children[pos] = child;
+			break;
+		}
+		case ART_N48: {
+			art_node48 * n = (art_node48 *) node;
+			// children are never removed, so the used slots are [0, count)
+			n->children[n->hdr.count] = child;
+			COMPILER_FENCE();
+			n->child_index[b] = n->hdr.count + 1;
+			break;
+		}
+		default:
+			((art_node256 *) node)->children[b] = child;
+	}
+	COMPILER_FENCE();
+	node->count ++;
+}
+
+void IndexArt::replace_child(art_node * node, uint8_t b, art_node * child) {
+	// the new child must be complete before it is published
+	COMPILER_FENCE();
+	switch (node->type) {
+		case ART_N4: {
+			art_node4 * n = (art_node4 *) node;
+			for (uint32_t i = 0; i < n->hdr.count; i++)
+				if (n->keys[i] == b)
+					n->children[i] = child;
+			break;
+		}
+		case ART_N16: {
+			art_node16 * n = (art_node16 *) node;
+			for (uint32_t i = 0; i < n->hdr.count; i++)
+				if (n->keys[i] == b)
+					n->children[i] = child;
+			break;
+		}
+		case ART_N48: {
+			art_node48 * n = (art_node48 *) node;
+			n->children[n->child_index[b] - 1] = child;
+			break;
+		}
+		default:
+			((art_node256 *) node)->children[b] = child;
+	}
+}
+
+// copies node into the next larger node type. The caller holds the write
+// locks of node and its parent.
+art_node * IndexArt::grow(art_node * node, uint64_t part_id) {
+	art_node * bigger = make_node((ArtNodeType) (node->type + 1), part_id);
+	bigger->prefix_len = node->prefix_len;
+	memcpy(bigger->prefix, node->prefix, ART_KEY_LEN);
+	uint8_t cb;
+	for (uint32_t b = 0; b < 256; b = cb + 1) {
+		art_node * child = next_child(node, b, cb);
+		if (child == NULL)
+			break;
+		add_child(bigger, cb, child);
+	}
+	return bigger;
+}
+
+/************** read ******************/
+
+bool IndexArt::index_exist(idx_key_t key) {
+	for (uint64_t part_id = 0; part_id < part_cnt; part_id ++) {
+		if (read_items(roots[part_id], key) != NULL)
+			return true;
+	}
+	return false;
+}
+
+RC IndexArt::index_read(idx_key_t key, itemid_t * &item, int part_id) {
+	item = read_items(get_root(part_id), key);
+	M_ASSERT_V(item != NULL, "Key does not exist! %ld\n",key);
+	return RCOK;
+}
+
+// returns the count-th item inserted under key, or NULL
+RC IndexArt::index_read(idx_key_t key, int count, itemid_t * &item, int part_id) {
+	item = read_items(get_root(part_id), key);
+	for (int n = 0; n < count && item != NULL; n++)
+		item = item->next;
+	return RCOK;
+}
+
+RC IndexArt::index_read(idx_key_t key, itemid_t * &item, int part_id, int thd_id) {
+	item = read_items(get_root(part_id), key);
+	M_ASSERT_V(item != NULL, "Key does not exist! %ld\n",key);
+	return RCOK;
+}
+
+// As in the B+tree, the head of the item list is read under the version of
+// the leaf's parent and the rest of the list is walked after validation.
+RC IndexArt::index_read_multiple(idx_key_t key, itemid_t ** items,
+	uint64_t &count, int part_id)
+{
+	uint64_t cap = count;
+	count = 0;
+	for (itemid_t * item = read_items(get_root(part_id), key); item != NULL; item = item->next) {
+		if (count < cap)
+			items[count] = item;
+		count ++;
+	}
+	return RCOK;
+}
+
+itemid_t * IndexArt::read_items(art_node * root, idx_key_t key) {
+	itemid_t * items;
+	while (lookup_olc(root, key, items) != RCOK) {}
+	return items;
+}
+
+RC IndexArt::lookup_olc(art_node * root, idx_key_t key, itemid_t *& items) {
+	art_node * node = root;
+	uint64_t v;
+	read_lock(node, v);
+	uint32_t depth = 0;
+	items = NULL;
+	while (true) {
+		uint32_t plen = node->prefix_len;
+		if (depth + plen >= ART_KEY_LEN)
+			return Abort;
+		for (uint32_t i = 0; i < plen; i++) {
+			if (node->prefix[i] != key_byte(key, depth + i))
+				return validate(node, v) ? RCOK : Abort;
+		}
+		depth += plen;
+		art_node * child = find_child(node, key_byte(key, depth));
+		if (!validate(node, v))
+			return Abort;
+		if (child == NULL)
+			return RCOK;
+		if (is_leaf(child)) {
+			art_leaf * leaf = to_leaf(child);
+			if (leaf->key == key)
+				items = leaf->items;
+			return validate(node, v) ? RCOK : Abort;
+		}
+		uint64_t child_v;
+		if (!read_lock(child, child_v) || !validate(node, v))
+			return Abort;
+		node = child;
+		v = child_v;
+		depth ++;
+	}
+}
+
+RC IndexArt::index_scan(idx_key_t key, art_cursor &cur, int part_id) {
+	assert(part_id != -1);
+	cur.part_id = part_id;
+	cur.last_key = key;
+	cur.inclusive = true;
+	return RCOK;
+}
+
+RC IndexArt::index_next(art_cursor &cur, itemid_t * &item, idx_key_t &key) {
+	item = NULL;
+	if (!cur.inclusive && cur.last_key == UINT64_MAX)
+		return RCOK;
+	idx_key_t from = cur.inclusive ? cur.last_key : cur.last_key + 1;
+	art_node * root = get_root(cur.part_id);
+	idx_key_t found = 0;
+	uint64_t v;
+	do {
+		read_lock(root, v);
+	} while (lower_bound(root, v, 0, from, true, found, item) != RCOK);
+	if (item == NULL)
+		return RCOK;
+	key = found;
+	cur.last_key = found;
+	cur.inclusive = false;
+	return RCOK;
+}
+
+// Finds the smallest key >= key in the subtree of node that still has
+// items. tight is set while the path to node equals the leading bytes of
+// key; otherwise every key in the subtree is larger and the first one wins.
+RC IndexArt::lower_bound(art_node * node, uint64_t version, uint32_t depth,
+	idx_key_t key, bool tight, idx_key_t &found, itemid_t *& items)
+{
+	items = NULL;
+	uint32_t plen = node->prefix_len;
+	if (depth + plen >= ART_KEY_LEN)
+		return Abort;
+	for (uint32_t i = 0; tight && i < plen; i++) {
+		uint8_t kb = key_byte(key, depth + i);
+		if (node->prefix[i] < kb)
+			// the whole subtree is smaller than key
+			return validate(node, version) ? RCOK : Abort;
+		if (node->prefix[i] > kb)
+			tight = false;
+	}
+	depth += plen;
+	uint8_t cb;
+	for (uint32_t b = tight ? key_byte(key, depth) : 0; b < 256; b = cb + 1) {
+		art_node * child = next_child(node, b, cb);
+		if (child == NULL)
+			break;
+		if (is_leaf(child)) {
+			art_leaf * leaf = to_leaf(child);
+			idx_key_t k = leaf->key;
+			itemid_t * head = leaf->items;
+			if (!validate(node, version))
+				return Abort;
+			if (head != NULL && k >= key) {
+				found = k;
+				items = head;
+				return RCOK;
+			}
+			continue;
+		}
+		uint64_t child_v;
+		if (!read_lock(child, child_v) || !validate(node, version))
+			return Abort;
+		bool child_tight = tight && cb == key_byte(key, depth);
+		RC rc = lower_bound(child, child_v, depth + 1, key, child_tight, found, items);
+		if (rc != RCOK || items != NULL)
+			return rc;
+	}
+	return validate(node, version) ? RCOK : Abort;
+}
+
+/************** insert ******************/
+
+RC IndexArt::index_insert(idx_key_t key, itemid_t * item, int part_id) {
+	uint64_t pid = part_id < 0 ? 0 : (uint64_t) part_id % part_cnt;
+	while (insert_olc(pid, key, item) != RCOK) {}
+	return RCOK;
+}
+
+// Items with the same key are kept in one list at the leaf, so a
+// non-unique insert is the same as inserting a duplicate key.
+RC IndexArt::index_insert_nonunique(idx_key_t key, itemid_t * item, int part_id) {
+	return index_insert(key, item, part_id);
+}
+
+// The new leaf and any new nodes are only allocated once the nodes they
+// go into are locked, so a restart never leaks them. The root has no
+// prefix and never fills up, so every node that is split or grown has a
+// parent.
+RC IndexArt::insert_olc(uint64_t part_id, idx_key_t key, itemid_t * item) {
+	art_node * node = roots[part_id];
+	uint64_t v;
+	read_lock(node, v);
+	art_node * parent = NULL;
+	uint64_t parent_v = 0;
+	uint8_t parent_b = 0;
+	uint32_t depth = 0;
+	while (true) {
+		uint32_t plen = node->prefix_len;
+		if (depth + plen >= ART_KEY_LEN)
+			return Abort;
+		uint32_t i = 0;
+		while (i < plen && node->prefix[i] == key_byte(key, depth + i))
+			i ++;
+		if (i < plen) {
+			// the key leaves the prefix at byte i. put a node4 above node
+			assert(parent != NULL);
+			if (!upgrade_lock(parent, parent_v))
+				return Abort;
+			if (!upgrade_lock(node, v)) {
+				write_unlock(parent);
+				return Abort;
+			}
+			art_node * split = make_node(ART_N4, part_id);
+			split->prefix_len = i;
+			memcpy(split->prefix, node->prefix, i);
+			add_child(split, node->prefix[i], node);
+			add_child(split, key_byte(key, depth + i), from_leaf(make_leaf(key, item)));
+			memmove(node->prefix, node->prefix + i + 1, plen - i - 1);
+			node->prefix_len = plen - i - 1;
+			replace_child(parent, parent_b, split);
+			write_unlock(node);
+			write_unlock(parent);
+			return RCOK;
+		}
+		depth += plen;
+		uint8_t b = key_byte(key, depth);
+		art_node * child = find_child(node, b);
+		if (!validate(node, v))
+			return Abort;
+		if (child == NULL) {
+			if (!is_full(node)) {
+				if (!upgrade_lock(node, v))
+					return Abort;
+				add_child(node, b, from_leaf(make_leaf(key, item)));
+				write_unlock(node);
+				return RCOK;
+			}
+			assert(parent != NULL);
+			if (!upgrade_lock(parent, parent_v))
+				return Abort;
+			if (!upgrade_lock(node, v)) {
+				write_unlock(parent);
+				return Abort;
+			}
+			art_node * bigger = grow(node, part_id);
+			add_child(bigger, b, from_leaf(make_leaf(key, item)));
+			replace_child(parent, parent_b, bigger);
+			write_unlock_obsolete(node);
+			write_unlock(parent);
+			// readers may still be in node. keep it until index_delete
+			do {
+				node->retired = retired[part_id];
+			} while (!ATOM_CAS(retired[part_id], node->retired, node));
+			return RCOK;
+		}
+		if (is_leaf(child)) {
+			if (!upgrade_lock(node, v))
+				return Abort;
+			art_leaf * leaf = to_leaf(child);
+			if (leaf->key == key) {
+				item->next = leaf->items;
+				COMPILER_FENCE();
+				leaf->items = item;
+				write_unlock(node);
+				return RCOK;
+			}
+			// the two keys agree up to depth. a node4 takes the rest of
+			// their common bytes as its prefix
+			uint32_t d = depth + 1;
+			while (key_byte(leaf->key, d) == key_byte(key, d))
+				d ++;
+			art_node * split = make_node(ART_N4, part_id);
+			split->prefix_len = d - depth - 1;
+			for (uint32_t k = 0; k < split->prefix_len; k++)
+				split->prefix[k] = key_byte(key, depth + 1 + k);
+			add_child(split, key_byte(leaf->key, d), child);
+			add_child(split, key_byte(key, d), from_leaf(make_leaf(key, item)));
+			replace_child(node, b, split);
+			write_unlock(node);
+			return RCOK;
+		}
+		uint64_t child_v;
+		if (!read_lock(child, child_v) || !validate(node, v))
+			return Abort;
+		parent = node;
+		parent_v = v;
+		parent_b = b;
+		node = child;
+		v = child_v;
+		depth ++;
+	}
+}
+
+/************** remove ******************/
+
+RC IndexArt::index_remove(idx_key_t key, row_t * row, int part_id, int thd_id) {
+	art_node * root = get_root(part_id);
+	RC rc;
+	while ((rc = remove_olc(root, key, row, thd_id)) == Abort) {}
+	return rc;
+}
+
+// The item is unlinked under the lock of the leaf's parent and retired,
+// so that readers still walking the list can step past it. An emptied
+// leaf stays in the tree.
+RC IndexArt::remove_olc(art_node * root, idx_key_t key, row_t * row, int thd_id) {
+	art_node * node = root;
+	uint64_t v;
+	read_lock(node, v);
+	uint32_t depth = 0;
+	while (true) {
+		uint32_t plen = node->prefix_len;
+		if (depth + plen >= ART_KEY_LEN)
+			return Abort;
+		for (uint32_t i = 0; i < plen; i++) {
+			if (node->prefix[i] != key_byte(key, depth + i))
+				return validate(node, v) ? ERROR : Abort;
+		}
+		depth += plen;
+		art_node * child = find_child(node, key_byte(key, depth));
+		if (!validate(node, v))
+			return Abort;
+		if (child == NULL)
+			return ERROR;
+		if (is_leaf(child)) {
+			if (!upgrade_lock(node, v))
+				return Abort;
+			art_leaf * leaf = to_leaf(child);
+			itemid_t * prev = NULL;
+			itemid_t * item = leaf->key == key ? leaf->items : NULL;
+			while (item != NULL && item->location != (void *) row) {
+				prev = item;
+				item = item->next;
+			}
+			if (item == NULL) {
+				write_unlock(node);
+				return ERROR;
+			}
+			if (prev != NULL)
+				prev->next = item->next;
+			else
+				leaf->items = item->next;
+			write_unlock(node);
+			epoch_man.retire_item(thd_id, item);
+			return RCOK;
+		}
+		uint64_t child_v;
+		if (!read_lock(child, child_v) || !validate(node, v))
+			return Abort;
+		node = child;
+		v = child_v;
+		depth ++;
+	}
+}
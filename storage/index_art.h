@@ -0,0 +1,165 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef _INDEX_ART_H_
+#define _INDEX_ART_H_
+
+#include "global.h"
+#include "helper.h"
+#include "index_base.h"
+
+// keys are split into bytes, most significant first
+#define ART_KEY_LEN 	sizeof(idx_key_t)
+// optimistic lock coupling: bit 1 of art_node::version is the writer lock,
+// bit 0 marks a node that has been replaced and must not be written anymore.
+#define ART_OBSOLETE 	1UL
+#define ART_LOCKED 		2UL
+// child pointers with the low bit set point to an art_leaf
+#define ART_LEAF_TAG 	1UL
+
+enum ArtNodeType {ART_N4 = 0, ART_N16, ART_N48, ART_N256};
+
+// One key and the items indexed under it. A leaf can hang at any depth;
+// the bytes below its parent are only checked against the full key.
+// items is changed under the lock of the parent node. It is NULL once
+// every item has been removed, and the leaf stays until the key comes back.
+struct art_leaf {
+	idx_key_t 			key;
+	itemid_t * volatile items;
+};
+
+// Header of every inner node. The node consumes prefix_len bytes of the key
+// (path compression) and then dispatches on the next one. Keys are at most
+// ART_KEY_LEN bytes, so the whole prefix is stored.
+struct art_node {
+	volatile uint64_t 	version;
+	volatile uint16_t 	count;
+	uint8_t 			type;
+	uint8_t 			prefix_len;
+	uint8_t 			prefix[ART_KEY_LEN];
+	// the node that was replaced before this one. kept until index_delete
+	art_node * 			retired;
+};
+
+// up to 4 children, kept sorted by key byte
+struct art_node4 {
+	art_node 			hdr;
+	uint8_t 			keys[4];
+	art_node * volatile children[4];
+};
+
+// up to 16 children, kept sorted by key byte
+struct art_node16 {
+	art_node 			hdr;
+	uint8_t 			keys[16];
+	art_node * volatile children[16];
+};
+
+// up to 48 children. child_index maps a key byte to its slot + 1
+struct art_node48 {
+	art_node 			hdr;
+	volatile uint8_t 	child_index[256];
+	art_node * volatile children[48];
+};
+
+// one child per key byte
+struct art_node256 {
+	art_node 			hdr;
+	art_node * volatile children[256];
+};
+
+// Position of an ordered scan. Like bt_cursor, the scan owns the cursor.
+// Every step looks up the first key after last_key from the root, which
+// costs at most ART_KEY_LEN node visits.
+struct art_cursor {
+	idx_key_t 	last_key;
+	// last_key itself has not been returned yet
+	bool 		inclusive;
+	uint64_t 	part_id;
+};
+
+// Adaptive radix tree with optimistic lock coupling, after Leis et al.
+// Readers never write to shared nodes; they validate node versions and
+// restart on conflict. Writers lock the node they change, and its parent
+// when the node is replaced by a larger one. Children are never removed: a
+// removed key leaves an empty leaf, so nodes only grow. Each partition has
+// its own tree, whose root is a node256 that is never replaced.
+class IndexArt : public index_base {
+public:
+	RC			init(uint64_t part_cnt);
+	// the tree grows on demand, so table_size is not used
+	RC			init(uint64_t part_cnt, table_t * table, uint64_t table_size);
+	void 		index_delete();
+	bool 		index_exist(idx_key_t key); // check if the key exist.
+	RC 			index_insert(idx_key_t key, itemid_t * item, int part_id = -1);
+	RC 			index_insert_nonunique(idx_key_t key, itemid_t * item, int part_id = -1);
+	RC	 		index_read(idx_key_t key, itemid_t * &item, int part_id = -1);
+	RC	 		index_read(idx_key_t key, int count, itemid_t * &item, int part_id = -1);
+	RC	 		index_read(idx_key_t key, itemid_t * &item, int part_id, int thd_id);
+	RC 			index_read_multiple(idx_key_t key, itemid_t ** items,
+					uint64_t &count, int part_id = -1);
+	RC 			index_remove(idx_key_t key, row_t * row, int part_id = -1, int thd_id = 0);
+	// range scan: position cur at the first key >= key, then index_next
+	// returns the following items in key order, or NULL past the last key.
+	RC 			index_scan(idx_key_t key, art_cursor &cur, int part_id);
+	RC 			index_next(art_cursor &cur, itemid_t * &item, idx_key_t &key);
+
+private:
+	uint64_t 	part_cnt;
+	art_node ** roots;
+	// nodes replaced by larger ones, per partition
+	art_node * volatile * retired;
+	art_node * 	get_root(int part_id) {
+		return roots[part_id < 0 ? 0 : (uint64_t) part_id % part_cnt];
+	};
+
+	static bool 		is_leaf(art_node * n) { return (uint64_t) n & ART_LEAF_TAG; };
+	static art_leaf * 	to_leaf(art_node * n) { return (art_leaf *) ((uint64_t) n & ~ART_LEAF_TAG); };
+	static art_node * 	from_leaf(art_leaf * l) { return (art_node *) ((uint64_t) l | ART_LEAF_TAG); };
+	static uint8_t 		key_byte(idx_key_t key, uint32_t depth) {
+		return (uint8_t) (key >> (8 * (ART_KEY_LEN - 1 - depth)));
+	};
+
+	art_node * 	make_node(ArtNodeType type, uint64_t part_id);
+	art_leaf * 	make_leaf(idx_key_t key, itemid_t * item);
+	art_node * 	find_child(art_node * node, uint8_t b);
+	// first child whose key byte is >= b, or NULL
+	art_node * 	next_child(art_node * node, uint32_t b, uint8_t &cb);
+	bool 		is_full(art_node * node);
+	// the caller holds the write lock of node, which must not be full
+	void 		add_child(art_node * node, uint8_t b, art_node * child);
+	void 		replace_child(art_node * node, uint8_t b, art_node * child);
+	art_node * 	grow(art_node * node, uint64_t part_id);
+	void 		free_node(art_node * node);
+
+	// returns the item list of key, or NULL
+	itemid_t * 	read_items(art_node * root, idx_key_t key);
+	// returns Abort whenever the operation has to restart
+	RC 			lookup_olc(art_node * root, idx_key_t key, itemid_t *& items);
+	RC 			insert_olc(uint64_t part_id, idx_key_t key, itemid_t * item);
+	RC 			remove_olc(art_node * root, idx_key_t key, row_t * row, int thd_id);
+	RC 			lower_bound(art_node * node, uint64_t version, uint32_t depth,
+					idx_key_t key, bool tight, idx_key_t &found, itemid_t *& items);
+
+	// optimistic lock coupling. read_lock fails on an obsolete node
+	bool 		read_lock(art_node * node, uint64_t &version);
+	bool 		validate(art_node * node, uint64_t version);
+	bool 		upgrade_lock(art_node * node, uint64_t version);
+	void 		write_unlock(art_node * node);
+	void 		write_unlock_obsolete(art_node * node);
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include "global.h"
 
 class table_t;
+class row_t;
 
 class index_base {
 public:
@@ -45,11 +46,25 @@ public:
 							itemid_t * &item,
 							int part_id=-1, int thd_id=0)=0;
 
-	// TODO implement index_remove
-	virtual RC 			index_remove(idx_key_t key) { return RCOK; };
+	// returns every item under key in one call. count is the capacity of 
+	// items on entry and the number of matches on exit; if it exceeds the 
+	// capacity, only the first matches were stored.
+	virtual RC 			index_read_multiple(idx_key_t key, 
+							itemid_t ** items, 
+							uint64_t &count, 
+							int part_id=-1)=0;
+
+	// unlinks the item of row from the items under key. The item is retired 
+	// to the epoch manager, since concurrent readers may still hold it. 
+	// Returns ERROR if row is not indexed under key.
+	virtual RC 			index_remove(idx_key_t key, 
+							row_t * row, 
+							int part_id=-1, int thd_id=0)=0;
 	
 	// the index in on "table". The key is the merged key of "fields"
 	table_t * 			table;
+	// false for indexes declared INDEX=<name>,NONUNIQUE in the schema
+	bool 				unique;
 };
 
 #endif
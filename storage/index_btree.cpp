@@ -17,20 +17,49 @@
 #include "mem_alloc.h"
 #include "index_btree.h"
 #include "row.h"
+#include "epoch.h"
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+// Number of keys in keys[0, n) that are smaller than key, or no larger than 
+// key if or_equal is set. keys must be sorted. Readers call this on nodes
+// that may change under them, so it only relies on n being in bounds.
+static inline UInt32 bt_rank(const idx_key_t * keys, UInt32 n, idx_key_t key, bool or_equal) {
+	UInt32 cnt = 0;
+#if defined(__SSE4_2__)
+	// SSE compares are signed. flipping the top bit keeps the unsigned order
+	const __m128i bias = _mm_set1_epi64x((int64_t) (1UL << 63));
+	const __m128i k = _mm_xor_si128(_mm_set1_epi64x((int64_t) key), bias);
+	for (UInt32 i = 0; i < n; i += 2) {
+		__m128i v = _mm_xor_si128(_mm_load_si128((const __m128i *) &keys[i]), bias);
+		__m128i hit = or_equal ? 
+			_mm_xor_si128(_mm_cmpgt_epi64(v, k), _mm_set1_epi64x(-1)) : 
+			_mm_cmpgt_epi64(k, v);
+		int mask = _mm_movemask_pd(_mm_castsi128_pd(hit));
+		if (i + 1 == n)
+			mask &= 1;
+		cnt += __builtin_popcount(mask);
+	}
+#else
+	for (UInt32 i = 0; i < n; i++)
+		cnt += or_equal ? (keys[i] <= key) : (keys[i] < key);
+#endif
+	return cnt;
+}
 
 RC index_btree::init(uint64_t part_cnt) {
 	this->part_cnt = part_cnt;
 	order = BTREE_ORDER;
 	// these pointers can be mapped anywhere. They won't be changed
 	roots = (bt_node **) malloc(part_cnt * sizeof(bt_node *));
-	// "cur_xxx_per_thd" is only for SCAN queries.
-	ARR_PTR(bt_node *, cur_leaf_per_thd, g_thread_cnt);
-	ARR_PTR(UInt32, cur_idx_per_thd, g_thread_cnt);
 	// the index tree of each partition musted be mapped to corresponding l2 slices
 	for (UInt32 part_id = 0; part_id < part_cnt; part_id ++) {
 		RC rc;
-		rc = make_lf(part_id, roots[part_id]);
+		bt_node * root;
+		rc = make_lf(part_id, root);
 		assert (rc == RCOK);
+		roots[part_id] = root;
 	}
 	return RCOK;
 }
@@ -46,43 +75,112 @@ bt_node * index_btree::find_root(uint64_t part_id) {
 	return roots[part_id];
 }
 
+/************** optimistic lock coupling ******************/
+
+bool index_btree::read_lock(bt_node * node, uint64_t &version) {
+	version = node->version;
+	while (version & BT_LOCKED) {
+		SPIN_PAUSE();
+		version = node->version;
+	}
+	COMPILER_FENCE();
+	return true;
+}
+
+// true if nobody wrote the node since version was read
+bool index_btree::validate(bt_node * node, uint64_t version) {
+	COMPILER_FENCE();
+	return node->version == version;
+}
+
+bool index_btree::upgrade_lock(bt_node * node, uint64_t version) {
+	return ATOM_CAS(node->version, version, version + BT_LOCKED);
+}
+
+void index_btree::write_unlock(bt_node * node) {
+	ATOM_ADD(node->version, BT_LOCKED);
+}
+
+/************** read ******************/
+
 bool index_btree::index_exist(idx_key_t key) {
 	assert(false); // part_id is not correct now.
 	glob_param params;
 	params.part_id = key_to_part(key) % part_cnt;
 	bt_node * leaf;
-	// does not matter which thread check existence
-	find_leaf(params, key, INDEX_NONE, leaf);
-	if (leaf == NULL) return false;
-	for (UInt32 i = 0; i < leaf->num_keys; i++)
-    	if (leaf->keys[i] == key) {
-            // the record is found!
-			return true;
-        }
-	return false;
-}
-
-RC index_btree::index_next(uint64_t thd_id, itemid_t * &item, bool samekey) {
-	int idx = *cur_idx_per_thd[thd_id];
-	bt_node * leaf = *cur_leaf_per_thd[thd_id];
-	idx_key_t cur_key = leaf->keys[idx] ;
-	
-	*cur_idx_per_thd[thd_id] += 1;
-	if (*cur_idx_per_thd[thd_id] >= leaf->num_keys) {
-		leaf = leaf->next;
-		*cur_leaf_per_thd[thd_id] = leaf;
-		*cur_idx_per_thd[thd_id] = 0;
-	}
-	if (leaf == NULL)
-		item = NULL;
-	else {
-		assert( leaf->is_leaf );
-		if ( samekey && leaf->keys[ *cur_idx_per_thd[thd_id] ] != cur_key)
+	uint64_t version;
+	bool found;
+	do {
+		while (find_leaf(params, key, leaf, version) != RCOK) {}
+		found = leaf_has_key(leaf, key) >= 0;
+	} while (!validate(leaf, version));
+	return found;
+}
+
+RC index_btree::index_scan(idx_key_t key, bt_cursor &cur, int part_id) {
+	assert(part_id != -1);
+	cur.part_id = part_id;
+	cur.last_key = key;
+	cur.inclusive = true;
+	seek(cur);
+	return RCOK;
+}
+
+// (re)position cur at the first key after last_key, or at last_key itself 
+// if it is inclusive
+void index_btree::seek(bt_cursor &cur) {
+	glob_param params;
+	params.part_id = cur.part_id;
+	bt_node * leaf;
+	uint64_t version;
+	UInt32 idx;
+	do {
+		while (find_leaf(params, cur.last_key, leaf, version) != RCOK) {}
+		UInt32 n = leaf->num_keys;
+		idx = n > order - 1 ? 0 : bt_rank(leaf->keys, n, cur.last_key, !cur.inclusive);
+	} while (!validate(leaf, version));
+	cur.leaf = leaf;
+	cur.version = version;
+	cur.idx = idx;
+}
+
+RC index_btree::index_next(bt_cursor &cur, itemid_t * &item, idx_key_t &key) {
+	while (true) {
+		bt_node * leaf = cur.leaf;
+		if (leaf == NULL) {
 			item = NULL;
-		else 
-			item = (itemid_t *) leaf->pointers[ *cur_idx_per_thd[thd_id] ];
+			return RCOK;
+		}
+		uint64_t version;
+		read_lock(leaf, version);
+		if (version != cur.version) {
+			seek(cur);
+			continue;
+		}
+		if (cur.idx >= leaf->num_keys) {
+			// step to the next leaf, coupling on the current one
+			bt_node * next = leaf->next;
+			if (!validate(leaf, version))
+				continue;
+			uint64_t next_version = 0;
+			if (next != NULL) 
+				read_lock(next, next_version);
+			if (!validate(leaf, version))
+				continue;
+			cur.leaf = next;
+			cur.version = next_version;
+			cur.idx = 0;
+			continue;
+		}
+		key = leaf->keys[cur.idx];
+		item = (itemid_t *) leaf->pointers[cur.idx];
+		if (!validate(leaf, version))
+			continue;
+		cur.idx ++;
+		cur.last_key = key;
+		cur.inclusive = false;
+		return RCOK;
 	}
-	return RCOK;
 }
 
 RC index_btree::index_read(idx_key_t key, itemid_t *& item) {
@@ -95,85 +193,246 @@ index_btree::index_read(idx_key_t key,
 	itemid_t *& item, 
 	int part_id) {
 	
-	return index_read(key, item, 0, part_id);
+	return index_read(key, item, (uint64_t) 0, (int64_t) part_id);
+}
+
+RC 
+index_btree::index_read(idx_key_t key, 
+	itemid_t *& item, 
+	int part_id, int thd_id) {
+	
+	return index_read(key, item, (uint64_t) thd_id, (int64_t) part_id);
+}
+
+// returns the count-th item inserted under key, or NULL
+RC 
+index_btree::index_read(idx_key_t key, int count, 
+	itemid_t *& item, 
+	int part_id) {
+	
+	RC rc = index_read(key, item, (uint64_t) 0, (int64_t) part_id);
+	for (int n = 0; n < count && item != NULL; n++)
+		item = item->next;
+	return rc;
 }
 
 RC index_btree::index_read(idx_key_t key, itemid_t *& item, 
 	uint64_t thd_id, int64_t part_id) 
 {
-	RC rc = Abort;
 	glob_param params;
 	assert(part_id != -1);
 	params.part_id = part_id;
 	bt_node * leaf;
-	find_leaf(params, key, INDEX_READ, leaf);
-	if (leaf == NULL)
-		M_ASSERT(false, "the leaf does not exist!");
-	for (UInt32 i = 0; i < leaf->num_keys; i++) 
-		if (leaf->keys[i] == key) {
-			item = (itemid_t *)leaf->pointers[i];
-			release_latch(leaf);
-			(*cur_leaf_per_thd[thd_id]) = leaf;
-			*cur_idx_per_thd[thd_id] = i;
-			return RCOK;
-		}
-	// release the latch after reading the node
+	uint64_t version;
+	int idx;
+	do {
+		while (find_leaf(params, key, leaf, version) != RCOK) {}
+		idx = leaf_has_key(leaf, key);
+		if (idx >= 0)
+			item = (itemid_t *)leaf->pointers[idx];
+	} while (!validate(leaf, version));
+	if (idx < 0) {
+		printf("key = %ld\n", key);
+		M_ASSERT(false, "the key does not exist!");
+		return Abort;
+	}
+	return RCOK;
+}
 
-	printf("key = %ld\n", key);
-	M_ASSERT(false, "the key does not exist!");
-	return rc;
+// The head of the item list is read under the leaf version. Items are 
+// pushed at the head with next already set, and removed items keep their 
+// next pointer until they are reclaimed, so the rest of the list is walked 
+// after validation.
+RC index_btree::index_read_multiple(idx_key_t key, itemid_t ** items, 
+	uint64_t &count, int part_id) 
+{
+	glob_param params;
+	assert(part_id != -1);
+	params.part_id = part_id;
+	bt_node * leaf;
+	uint64_t version;
+	itemid_t * head;
+	do {
+		while (find_leaf(params, key, leaf, version) != RCOK) {}
+		int idx = leaf_has_key(leaf, key);
+		head = idx >= 0 ? (itemid_t *)leaf->pointers[idx] : NULL;
+	} while (!validate(leaf, version));
+	uint64_t cap = count;
+	count = 0;
+	for (itemid_t * item = head; item != NULL; item = item->next) {
+		if (count < cap)
+			items[count] = item;
+		count ++;
+	}
+	return RCOK;
 }
 
+RC index_btree::find_leaf(glob_param params, idx_key_t key, bt_node *& leaf, uint64_t &version) 
+{
+	bt_node * c = find_root(params.part_id);
+	uint64_t v;
+	read_lock(c, v);
+	// the root may have been split before we read its version
+	if (c != find_root(params.part_id))
+		return Abort;
+	while (!c->is_leaf) {
+		UInt32 n = c->num_keys;
+		if (n > order - 1)
+			return Abort;
+		// key should be inserted into the right side of i
+		bt_node * child = (bt_node *)c->pointers[bt_rank(c->keys, n, key, true)];
+		if (!validate(c, v))
+			return Abort;
+		uint64_t child_v;
+		read_lock(child, child_v);
+		if (!validate(c, v))
+			return Abort;
+		c = child;
+		v = child_v;
+	}
+	leaf = c;
+	version = v;
+	return RCOK;
+}
+
+/************** insert ******************/
+
 RC index_btree::index_insert(idx_key_t key, itemid_t * item, int part_id) {
 	glob_param params;
 	if (WORKLOAD == TPCC) assert(part_id != -1);
 	assert(part_id != -1);
 	params.part_id = part_id;
-	// create a tree if there does not exist one already
-	RC rc = RCOK;
-	bt_node * root = find_root(params.part_id);
-	assert(root != NULL);
-	int depth = 0;
-	// TODO tree depth < 100
-	bt_node * ex_list[100];
-	bt_node * leaf = NULL;
-	bt_node * last_ex = NULL;
-	rc = find_leaf(params, key, INDEX_INSERT, leaf, last_ex);
-	assert(rc == RCOK);
-	
-	bt_node * tmp_node = leaf;
-	if (last_ex != NULL) {
-		while (tmp_node != last_ex) {
-	//		assert( tmp_node->latch_type == LATCH_EX );
-			ex_list[depth++] = tmp_node;
-			tmp_node = tmp_node->parent;
-			assert (depth < 100);
+	while (insert_olc(params, key, item) != RCOK) {}
+	return RCOK;
+}
+
+// Items with the same key are kept in one list at the leaf, so a 
+// non-unique insert is the same as inserting a duplicate key.
+RC index_btree::index_insert_nonunique(idx_key_t key, itemid_t * item, int part_id) {
+	return index_insert(key, item, part_id);
+}
+
+// Full inner nodes are split on the way down, so a leaf split always finds 
+// room in its parent. Returns Abort whenever the insert must restart.
+RC index_btree::insert_olc(glob_param params, idx_key_t key, itemid_t * item) {
+	bt_node * c = find_root(params.part_id);
+	uint64_t v;
+	read_lock(c, v);
+	if (c != find_root(params.part_id))
+		return Abort;
+	bt_node * parent = NULL;
+	uint64_t parent_v = 0;
+	while (!c->is_leaf) {
+		if (c->num_keys == order - 1) {
+			if (parent != NULL && !upgrade_lock(parent, parent_v))
+				return Abort;
+			if (!upgrade_lock(c, v)) {
+				if (parent != NULL) write_unlock(parent);
+				return Abort;
+			}
+			if (parent == NULL && c != find_root(params.part_id)) {
+				write_unlock(c);
+				return Abort;
+			}
+			split_nl(params, c, parent);
+			write_unlock(c);
+			if (parent != NULL) write_unlock(parent);
+			return Abort;
 		}
-		ex_list[depth ++] = last_ex;
-	} else
-		ex_list[depth++] = leaf;
-	// from this point, the required data structures are all latched,
-	// so the system should not abort anymore.
-//	M_ASSERT(!index_exist(key), "the index does not exist!");
-	// insert into btree if the leaf is not full
-	if (leaf->num_keys < order - 1 || leaf_has_key(leaf, key) >= 0) {
-		rc = insert_into_leaf(params, leaf, key, item);
-		// only the leaf should be ex latched.
-//		assert( release_latch(leaf) == LATCH_EX );
-		for (int i = 0; i < depth; i++)
-			release_latch(ex_list[i]);
-//			assert( release_latch(ex_list[i]) == LATCH_EX );
+		if (parent != NULL && !validate(parent, parent_v))
+			return Abort;
+		parent = c;
+		parent_v = v;
+		UInt32 n = c->num_keys;
+		if (n > order - 1)
+			return Abort;
+		bt_node * child = (bt_node *)c->pointers[bt_rank(c->keys, n, key, true)];
+		if (!validate(c, v))
+			return Abort;
+		read_lock(child, v);
+		c = child;
 	}
-	else { // split the nodes when necessary
-		rc = split_lf_insert(params, leaf, key, item);
-		for (int i = 0; i < depth; i++)
-			release_latch(ex_list[i]);
-//			assert( release_latch(ex_list[i]) == LATCH_EX );
+	// c is leaf
+	if (c->num_keys == order - 1) {
+		if (parent != NULL && !upgrade_lock(parent, parent_v))
+			return Abort;
+		if (!upgrade_lock(c, v)) {
+			if (parent != NULL) write_unlock(parent);
+			return Abort;
+		}
+		if (parent == NULL && c != find_root(params.part_id)) {
+			write_unlock(c);
+			return Abort;
+		}
+		// from this point, the required nodes are all locked,
+		// so the insert should not abort anymore.
+		RC rc;
+		if (leaf_has_key(c, key) >= 0)
+			rc = insert_into_leaf(params, c, key, item);
+		else
+			rc = split_lf_insert(params, c, parent, key, item);
+		write_unlock(c);
+		if (parent != NULL) write_unlock(parent);
+		return rc;
 	}
-//	assert(leaf->latch_type == LATCH_NONE);
+	// the leaf version was read after the parent was last checked
+	if (parent != NULL && !validate(parent, parent_v))
+		return Abort;
+	if (!upgrade_lock(c, v))
+		return Abort;
+	RC rc = insert_into_leaf(params, c, key, item);
+	write_unlock(c);
 	return rc;
 }
 
+/************** remove ******************/
+
+RC index_btree::index_remove(idx_key_t key, row_t * row, int part_id, int thd_id) {
+	glob_param params;
+	assert(part_id != -1);
+	params.part_id = part_id;
+	RC rc;
+	while ((rc = remove_olc(params, key, row, thd_id)) == Abort) {}
+	return rc;
+}
+
+// The item is unlinked under the leaf lock and retired, so that readers 
+// still walking the list can step past it. A key without items is removed 
+// from the leaf, but underfull leaves are never merged.
+RC index_btree::remove_olc(glob_param params, idx_key_t key, row_t * row, int thd_id) {
+	bt_node * leaf;
+	uint64_t version;
+	if (find_leaf(params, key, leaf, version) != RCOK)
+		return Abort;
+	if (!upgrade_lock(leaf, version))
+		return Abort;
+	int idx = leaf_has_key(leaf, key);
+	itemid_t * prev = NULL;
+	itemid_t * item = idx >= 0 ? (itemid_t *)leaf->pointers[idx] : NULL;
+	while (item != NULL && item->location != (void *) row) {
+		prev = item;
+		item = item->next;
+	}
+	if (item == NULL) {
+		write_unlock(leaf);
+		return ERROR;
+	}
+	if (prev != NULL)
+		prev->next = item->next;
+	else if (item->next != NULL)
+		leaf->pointers[idx] = (void *) item->next;
+	else {
+		for (UInt32 i = idx; i + 1 < leaf->num_keys; i++) {
+			leaf->keys[i] = leaf->keys[i + 1];
+			leaf->pointers[i] = leaf->pointers[i + 1];
+		}
+		leaf->num_keys --;
+	}
+	write_unlock(leaf);
+	epoch_man.retire_item(thd_id, item);
+	return RCOK;
+}
+
 RC index_btree::make_lf(uint64_t part_id, bt_node *& node) {
 	RC rc = make_node(part_id, node);
 	if (rc != RCOK) return rc;
@@ -189,222 +448,25 @@ RC index_btree::make_nl(uint64_t part_id, bt_node *& node) {
 }
 
 RC index_btree::make_node(uint64_t part_id, bt_node *& node) {	
-//	printf("make_node(). part_id=%lld\n", part_id);
-	bt_node * new_node = (bt_node *) mem_allocator.alloc(sizeof(bt_node));
+	bt_node * new_node = (bt_node *) mem_allocator.part_alloc(sizeof(bt_node), part_id);
 	assert (new_node != NULL);
-	new_node->pointers = NULL;
-	new_node->keys = (idx_key_t *) mem_allocator.alloc((order - 1) * sizeof(idx_key_t));
-	new_node->pointers = (void **) mem_allocator.alloc(order * sizeof(void *));
-	assert (new_node->keys != NULL && new_node->pointers != NULL);
+	new_node->version = 0;
 	new_node->is_leaf = false;
 	new_node->num_keys = 0;
-	new_node->parent = NULL;
 	new_node->next = NULL;
-//	new_node->locked = false;
-	new_node->latch = false;
-	new_node->latch_type = LATCH_NONE;
-
 	node = new_node;
 	return RCOK;
 }
 
-RC index_btree::start_new_tree(glob_param params, idx_key_t key, itemid_t * item) {
-	RC rc;
-	uint64_t part_id = params.part_id;
-	rc = make_lf(part_id, roots[part_id % part_cnt]);
-	if (rc != RCOK) return rc;
-	bt_node * root = roots[part_id % part_cnt];
-	assert(root != NULL);
-	root->keys[0] = key;
-	root->pointers[0] = (void *)item;
-	root->parent = NULL;
-	root->num_keys++;
-	return RCOK;
-}
-
-bool index_btree::latch_node(bt_node * node, latch_t latch_type) {
-	// TODO latch is disabled 
-	if (!ENABLE_LATCH)
-		return true;
-	bool success = false;
-//		printf("%s : %d\n", __FILE__, __LINE__);
-//	if ( g_cc_alg != HSTORE ) 
-		while ( !ATOM_CAS(node->latch, false, true) ) {}
-//		pthread_mutex_lock(&node->locked);
-//		printf("%s : %d\n", __FILE__, __LINE__);
-
-	latch_t node_latch = node->latch_type;
-	if (node_latch == LATCH_NONE || 
-		(node_latch == LATCH_SH && latch_type == LATCH_SH)) { 
-		node->latch_type = latch_type;
-		if (node_latch == LATCH_NONE)
-			M_ASSERT( (node->share_cnt == 0), "share cnt none 0!" );
-		if (node->latch_type == LATCH_SH)
-			node->share_cnt ++;
-		success = true;
-	}
-	else // latch_type incompatible
-		success = false;
-//	if ( g_cc_alg != HSTORE ) 
-	bool ok = ATOM_CAS(node->latch, true, false);
-	assert(ok);
-//		pthread_mutex_unlock(&node->locked);
-//		assert(ATOM_CAS(node->locked, true, false));
-	return success;
-}
-
-latch_t index_btree::release_latch(bt_node * node) {
-	if (!ENABLE_LATCH)
-		return LATCH_SH;
-	latch_t type = node->latch_type;
-//	if ( g_cc_alg != HSTORE ) 
-		while ( !ATOM_CAS(node->latch, false, true) ) {}
-//		pthread_mutex_lock(&node->locked);
-//		while (!ATOM_CAS(node->locked, false, true)) {}
-	M_ASSERT((node->latch_type != LATCH_NONE), "release latch fault");
-	if (node->latch_type == LATCH_EX)
-		node->latch_type = LATCH_NONE;
-	else if (node->latch_type == LATCH_SH) {
-		node->share_cnt --;
-		if (node->share_cnt == 0)
-			node->latch_type = LATCH_NONE;
-	}
-//	if ( g_cc_alg != HSTORE ) 
-	bool ok = ATOM_CAS(node->latch, true, false);
-	assert(ok);
-//		pthread_mutex_unlock(&node->locked);
-//		assert(ATOM_CAS(node->locked, true, false));
-	return type;
-}
-
-RC index_btree::upgrade_latch(bt_node * node) {
-	if (!ENABLE_LATCH)
-		return RCOK;
-	bool success = false;
-//	if ( g_cc_alg != HSTORE ) 
-		while ( !ATOM_CAS(node->latch, false, true) ) {}
-//		pthread_mutex_lock(&node->locked);
-//		while (!ATOM_CAS(node->locked, false, true)) {}
-	M_ASSERT( (node->latch_type == LATCH_SH), "" );
-	if (node->share_cnt > 1) 
-		success = false;
-	else { // share_cnt == 1
-		success = true;
-		node->latch_type = LATCH_EX;
-		node->share_cnt = 0;
-	}
-	
-//	if ( g_cc_alg != HSTORE ) 
-	bool ok = ATOM_CAS(node->latch, true, false);
-	assert(ok);
-//		pthread_mutex_unlock(&node->locked);
-//		assert( ATOM_CAS(node->locked, true, false) );
-	if (success) return RCOK;
-	else return Abort;
-}
-
-RC index_btree::cleanup(bt_node * node, bt_node * last_ex) {
-	if (last_ex != NULL) {
-		do {
-			node = node->parent;
-//			assert(release_latch(node) == LATCH_EX);
-			release_latch(node);
-		}
-		while (node != last_ex);
-	}
-	return RCOK;
-}
-
-RC index_btree::find_leaf(glob_param params, idx_key_t key, idx_acc_t access_type, bt_node *& leaf) {
-	bt_node * last_ex = NULL;
-	assert(access_type != INDEX_INSERT);
-	RC rc = find_leaf(params, key, access_type, leaf, last_ex);
-	return rc;
-}
-
-RC index_btree::find_leaf(glob_param params, idx_key_t key, idx_acc_t access_type, bt_node *& leaf, bt_node  *& last_ex) 
-{
-//	RC rc;
-	UInt32 i;
-	bt_node * c = find_root(params.part_id);
-	assert(c != NULL);
-	bt_node * child;
-	if (access_type == INDEX_NONE) {
-		while (!c->is_leaf) {
-			for (i = 0; i < c->num_keys; i++) {
-				if (key < c->keys[i])
-					break;
-			}
-			c = (bt_node *)c->pointers[i];
-		}
-		leaf = c;
-		return RCOK;
-	}
-	// key should be inserted into the right side of i
-	if (!latch_node(c, LATCH_SH)) 
-		return Abort;
-	while (!c->is_leaf) {
-		assert(get_part_id(c) == params.part_id);
-		assert(get_part_id(c->keys) == params.part_id);
-		for (i = 0; i < c->num_keys; i++) {
-			if (key < c->keys[i])
-				break;
-		}
-		child = (bt_node *)c->pointers[i];
-		if (!latch_node(child, LATCH_SH)) {
-			release_latch(c);
-			cleanup(c, last_ex);
-			last_ex = NULL;
-			return Abort;
-		}	
-		if (access_type == INDEX_INSERT) {
-			if (child->num_keys == order - 1) {
-				if (upgrade_latch(c) != RCOK) {
-					release_latch(c);
-					release_latch(child);
-					cleanup(c, last_ex);
-					last_ex = NULL;
-					return Abort;
-				}
-				if (last_ex == NULL)
-					last_ex = c;
-			}
-			else { 
-				cleanup(c, last_ex);
-				last_ex = NULL;
-				release_latch(c);
-			}
-		} else
-			release_latch(c); // release the LATCH_SH on c
-		c = child;
-	}
-	// c is leaf		
-	// at this point, if the access is a read, then only the leaf is latched by LATCH_SH
-	// if the access is an insertion, then the leaf is sh latched and related nodes in the tree
-	// are ex latched.
-	if (access_type == INDEX_INSERT) {
-		if (upgrade_latch(c) != RCOK) {
-        	release_latch(c);
-            cleanup(c, last_ex);
-            return Abort;
-        }
-	}
-	leaf = c;
-	assert (leaf->is_leaf);
-	return RCOK;
-}
-
 RC index_btree::insert_into_leaf(glob_param params, bt_node * leaf, idx_key_t key, itemid_t * item) {
 	UInt32 i, insertion_point;
-    insertion_point = 0;
 	int idx = leaf_has_key(leaf, key);	
 	if (idx >= 0) {
 		item->next = (itemid_t *)leaf->pointers[idx];
 		leaf->pointers[idx] = (void *) item;
 		return RCOK;
 	}
-    while (insertion_point < leaf->num_keys && leaf->keys[insertion_point] < key)
-        insertion_point++;
+	insertion_point = bt_rank(leaf->keys, leaf->num_keys, key, false);
 	for (i = leaf->num_keys; i > insertion_point; i--) {
         leaf->keys[i] = leaf->keys[i - 1];
         leaf->pointers[i] = leaf->pointers[i - 1];
@@ -416,16 +478,14 @@ RC index_btree::insert_into_leaf(glob_param params, bt_node * leaf, idx_key_t ke
     return RCOK;
 }
 
-RC index_btree::split_lf_insert(glob_param params, bt_node * leaf, idx_key_t key, itemid_t * item) {
+RC index_btree::split_lf_insert(glob_param params, bt_node * leaf, bt_node * parent, 
+	idx_key_t key, itemid_t * item) 
+{
     RC rc;
 	UInt32 insertion_index, split, i, j;
-	idx_key_t new_key;
 
 	uint64_t part_id = params.part_id;
     bt_node * new_leaf;
-//	printf("will make_lf(). part_id=%lld, key=%lld\n", part_id, key);
-//	pthread_t id = pthread_self();
-//	printf("%08x\n", id);
 	rc = make_lf(part_id, new_leaf);
 	if (rc != RCOK) return rc;
 
@@ -433,96 +493,56 @@ RC index_btree::split_lf_insert(glob_param params, bt_node * leaf, idx_key_t key
 
 	idx_key_t temp_keys[BTREE_ORDER];
 	itemid_t * temp_pointers[BTREE_ORDER];
-    insertion_index = 0;
-    while (insertion_index < order - 1 && leaf->keys[insertion_index] < key)
-        insertion_index++;
+	insertion_index = bt_rank(leaf->keys, order - 1, key, false);
 
     for (i = 0, j = 0; i < leaf->num_keys; i++, j++) {
         if (j == insertion_index) j++;
-//		new_leaf->keys[j] = leaf->keys[i];
-//		new_leaf->pointers[j] = (itemid_t *)leaf->pointers[i];
         temp_keys[j] = leaf->keys[i];
         temp_pointers[j] = (itemid_t *)leaf->pointers[i];
     }
-//	new_leaf->keys[insertion_index] = key;
-//	new_leaf->pointers[insertion_index] = item;
     temp_keys[insertion_index] = key;
     temp_pointers[insertion_index] = item;
 	
-   	// leaf is on the left of new_leaf
+   	// leaf is on the left of new_leaf. new_leaf is filled before 
+	// it becomes reachable through leaf->next or the parent.
     split = cut(order - 1);
-    leaf->num_keys = 0;
-    for (i = 0; i < split; i++) {
-//        leaf->pointers[i] = new_leaf->pointers[i];
-//        leaf->keys[i] = new_leaf->keys[i];
-        leaf->pointers[i] = temp_pointers[i];
-        leaf->keys[i] = temp_keys[i];
-        leaf->num_keys++;
-		M_ASSERT( (leaf->num_keys < order), "too many keys in leaf" );
-    }
 	for (i = split, j = 0; i < order; i++, j++) {
-//        new_leaf->pointers[j] = new_leaf->pointers[i];
-//        new_leaf->keys[j] = new_leaf->keys[i];
         new_leaf->pointers[j] = temp_pointers[i];
         new_leaf->keys[j] = temp_keys[i];
-        new_leaf->num_keys++;
-		M_ASSERT( (leaf->num_keys < order), "too many keys in leaf" );
     }
-	
-//    delete temp_pointers;
-//    delete temp_keys;
-
+	new_leaf->num_keys = j;
 	new_leaf->next = leaf->next;
+    for (i = 0; i < split; i++) {
+        leaf->pointers[i] = temp_pointers[i];
+        leaf->keys[i] = temp_keys[i];
+    }
+	leaf->num_keys = split;
 	leaf->next = new_leaf;
-	
-//    new_leaf->pointers[order - 1] = leaf->pointers[order - 1];
-//    leaf->pointers[order - 1] = new_leaf;
-
-    for (i = leaf->num_keys; i < order - 1; i++)
-        leaf->pointers[i] = NULL;
-    for (i = new_leaf->num_keys; i < order - 1; i++)
-        new_leaf->pointers[i] = NULL;
 
-    new_leaf->parent = leaf->parent;
-    new_key = new_leaf->keys[0];
-	
-    rc = insert_into_parent(params, leaf, new_key, new_leaf);
-	return rc;
+    if (parent == NULL)
+        return insert_into_new_root(params, leaf, new_leaf->keys[0], new_leaf);
+    return insert_into_parent(params, parent, leaf, new_leaf->keys[0], new_leaf);
 }
 
 RC index_btree::insert_into_parent(
 	glob_param params,
+	bt_node * parent,
 	bt_node * left, 
 	idx_key_t key, 
 	bt_node * right) {
 	
-    bt_node * parent = left->parent;
-
-    /* Case: new root. */
-    if (parent == NULL)
-        return insert_into_new_root(params, left, key, right);
-    
-	UInt32 insert_idx = 0;
-	while (parent->keys[insert_idx] < key && insert_idx < parent->num_keys)
-		insert_idx ++;
-	// the parent has enough space, just insert into it
-    if (parent->num_keys < order - 1) {
-		for (UInt32 i = parent->num_keys-1; i >= insert_idx; i--) {
-			parent->keys[i + 1] = parent->keys[i];
-			parent->pointers[i+2] = parent->pointers[i+1];
-		}
-		parent->num_keys ++;
-		parent->keys[insert_idx] = key;
-		parent->pointers[insert_idx + 1] = right;
-		return RCOK;
+	// full parents were split on the way down
+	M_ASSERT( (parent->num_keys < order - 1), "parent is full" );
+	UInt32 insert_idx = bt_rank(parent->keys, parent->num_keys, key, false);
+	assert(parent->pointers[insert_idx] == left);
+	for (UInt32 i = parent->num_keys; i > insert_idx; i--) {
+		parent->keys[i] = parent->keys[i - 1];
+		parent->pointers[i + 1] = parent->pointers[i];
 	}
-
-    /* Harder case:  split a node in order 
-     * to preserve the B+ tree properties.
-     */
-	
-	return split_nl_insert(params, parent, insert_idx, key, right);
-//	return RCOK;
+	parent->keys[insert_idx] = key;
+	parent->pointers[insert_idx + 1] = right;
+	parent->num_keys ++;
+	return RCOK;
 }
 
 RC index_btree::insert_into_new_root(
@@ -531,123 +551,57 @@ RC index_btree::insert_into_new_root(
 	RC rc;
 	uint64_t part_id = params.part_id;
 	bt_node * new_root;
-//	printf("will make_nl(). part_id=%lld. key=%lld\n", part_id, key);
 	rc = make_nl(part_id, new_root);
 	if (rc != RCOK) return rc;
     new_root->keys[0] = key;
     new_root->pointers[0] = left;
     new_root->pointers[1] = right;
     new_root->num_keys++;
-	M_ASSERT( (new_root->num_keys < order), "too many keys in leaf" );
-    new_root->parent = NULL;
-    left->parent = new_root;
-    right->parent = new_root;
-	left->next = right;
-
+	// left is still write locked, so readers that saw it as the root restart
+	MEM_BARRIER();
 	this->roots[part_id] = new_root;	
-	// TODO this new root is not latched, at this point, other threads
-	// may start to access this new root. Is this ok?
     return RCOK;
 }
 
-RC index_btree::split_nl_insert(
+RC index_btree::split_nl(
 	glob_param params,
 	bt_node * old_node, 
-	UInt32 left_index, 
-	idx_key_t key, 
-	bt_node * right) 
+	bt_node * parent) 
 {
 	RC rc;
-	uint64_t i, j, split, k_prime;
-    bt_node * new_node, * child;
-//    idx_key_t * temp_keys;
-//    btUInt32 temp_pointers;
+	UInt32 i, j, split;
+	idx_key_t k_prime;
+    bt_node * new_node;
 	uint64_t part_id = params.part_id;
-    rc = make_node(part_id, new_node);
-
-    /* First create a temporary set of keys and pointers
-     * to hold everything in order, including
-     * the new key and pointer, inserted in their
-     * correct places. 
-     * Then create a new node and copy half of the 
-     * keys and pointers to the old node and
-     * the other half to the new.
-     */
-
-    idx_key_t temp_keys[BTREE_ORDER];
-    bt_node * temp_pointers[BTREE_ORDER + 1];
-    for (i = 0, j = 0; i < old_node->num_keys + 1; i++, j++) {
-        if (j == left_index + 1) j++;
-//		new_node->pointers[j] = (bt_node *)old_node->pointers[i];
-        temp_pointers[j] = (bt_node *)old_node->pointers[i];
-    }
-
-    for (i = 0, j = 0; i < old_node->num_keys; i++, j++) {
-        if (j == left_index) j++;
-//		new_node->keys[j] = old_node->keys[i];
-        temp_keys[j] = old_node->keys[i];
-    }
-
-//    new_node->pointers[left_index + 1] = right;
-//    new_node->keys[left_index] = key;
-    temp_pointers[left_index + 1] = right;
-    temp_keys[left_index] = key;
-
-	/* Create the new node and copy
-     * half the keys and pointers to the
-     * old and half to the new.
-     */
-    split = cut(order);
-//	printf("will make_node(). part_id=%lld, key=%lld\n", part_id, key);
+    rc = make_nl(part_id, new_node);
 	if (rc != RCOK) return rc;
 
-    old_node->num_keys = 0;
-    for (i = 0; i < split - 1; i++) {
-//        old_node->pointers[i] = new_node->pointers[i];
-//        old_node->keys[i] = new_node->keys[i];
-        old_node->pointers[i] = temp_pointers[i];
-        old_node->keys[i] = temp_keys[i];
-        old_node->num_keys++;
-		M_ASSERT( (old_node->num_keys < order), "too many keys in leaf" );
+	M_ASSERT(old_node->num_keys == order - 1, "trying to split non-full node!");
+	// keys [0, split) stay, keys[split] moves up, the rest go to new_node
+    split = cut(order - 1) - 1;
+	k_prime = old_node->keys[split];
+    for (i = split + 1, j = 0; i < old_node->num_keys; i++, j++) {
+        new_node->keys[j] = old_node->keys[i];
+        new_node->pointers[j] = old_node->pointers[i];
     }
-
+    new_node->pointers[j] = old_node->pointers[i];
+	new_node->num_keys = j;
 	new_node->next = old_node->next;
+	old_node->num_keys = split;
 	old_node->next = new_node;
 
-    old_node->pointers[i] = temp_pointers[i];
-    k_prime = temp_keys[split - 1];
-//    old_node->pointers[i] = new_node->pointers[i];
-//    k_prime = new_node->keys[split - 1];
-    for (++i, j = 0; i < order; i++, j++) {
-        new_node->pointers[j] = temp_pointers[i];
-        new_node->keys[j] = temp_keys[i];
-//        new_node->pointers[j] = new_node->pointers[i];
-//        new_node->keys[j] = new_node->keys[i];
-        new_node->num_keys++;
-		M_ASSERT( (old_node->num_keys < order), "too many keys in leaf" );
-    }
-    new_node->pointers[j] = temp_pointers[i];
-//    new_node->pointers[j] = new_node->pointers[i];
-//    delete temp_pointers;
-//    delete temp_keys;
-    new_node->parent = old_node->parent;
-    for (i = 0; i <= new_node->num_keys; i++) {
-        child = (bt_node *)new_node->pointers[i];
-        child->parent = new_node;
-    }
-
-    /* Insert a new key into the parent of the two
-     * nodes resulting from the split, with
-     * the old node to the left and the new to the right.
-     */
-
-    return insert_into_parent(params, old_node, k_prime, new_node);	
+    if (parent == NULL)
+        return insert_into_new_root(params, old_node, k_prime, new_node);
+    return insert_into_parent(params, parent, old_node, k_prime, new_node);
 }
 
 int index_btree::leaf_has_key(bt_node * leaf, idx_key_t key) {
-	for (UInt32 i = 0; i < leaf->num_keys; i++) 
-		if (leaf->keys[i] == key)
-			return i;
+	UInt32 n = leaf->num_keys;
+	if (n > order - 1)
+		return -1;
+	UInt32 i = bt_rank(leaf->keys, n, key, false);
+	if (i < n && leaf->keys[i] == key)
+		return i;
 	return -1;
 }
 
@@ -22,36 +22,69 @@
 #include "index_base.h"
 
 
+// key slots per node, rounded up to whole cache lines
+#define BT_KEY_SLOTS ((BTREE_ORDER - 1 + CL_SIZE / sizeof(idx_key_t) - 1) \
+		/ (CL_SIZE / sizeof(idx_key_t)) * (CL_SIZE / sizeof(idx_key_t)))
+// optimistic lock coupling: bit 1 of bt_node::version is the writer lock.
+// every write unlock bumps the version so that readers can validate.
+#define BT_LOCKED 2UL
+
+// Nodes are allocated cache-line aligned. The header fills the first line
+// and the keys start on their own line so that they can be searched with SIMD.
 typedef struct bt_node {
-	// TODO bad hack!
-   	void ** pointers; // for non-leaf nodes, point to bt_nodes
+	volatile uint64_t version;
+	bt_node * volatile next;
+	volatile UInt32 num_keys;
 	bool is_leaf;
-	idx_key_t * keys;
-	bt_node * parent;
-	UInt32 num_keys;
-	bt_node * next;
-	bool latch;
-	pthread_mutex_t locked;
-	latch_t latch_type;
-	UInt32 share_cnt;
+	char pad[CL_SIZE - sizeof(uint64_t) - sizeof(bt_node *) - sizeof(UInt32) - sizeof(bool)];
+	idx_key_t keys[BT_KEY_SLOTS];
+	// for non-leaf nodes, point to bt_nodes
+	void * pointers[BTREE_ORDER];
 } bt_node;
 
 struct glob_param {
 	uint64_t part_id;
 };
 
+// Position of a range scan on the leaf chain. The scan owns the cursor, so
+// it can be resumed by any thread. leaf and idx are only trusted while the 
+// leaf still has the recorded version; otherwise the scan re-seeks to the 
+// first key after last_key.
+struct bt_cursor {
+	bt_node * 	leaf;
+	uint64_t 	version;
+	UInt32 		idx;
+	idx_key_t 	last_key;
+	// last_key itself has not been returned yet
+	bool 		inclusive;
+	uint64_t 	part_id;
+};
+
+// B+tree with optimistic lock coupling. Readers never write to shared 
+// nodes; they remember a node's version and restart if it changed by the 
+// time they are done with it. Writers lock only the nodes they modify.
 class index_btree : public index_base {
 public:
 	RC			init(uint64_t part_cnt);
 	RC			init(uint64_t part_cnt, table_t * table);
+	// the tree grows on demand, so table_size is only a hint
+	RC			init(uint64_t part_cnt, table_t * table, uint64_t table_size) { return init(part_cnt, table); };
 	bool 		index_exist(idx_key_t key); // check if the key exist. 
 	RC 			index_insert(idx_key_t key, itemid_t * item, int part_id = -1);
-	RC 			index_insert_nonunique(idx_key_t key, itemid_t * item, int part_id = -1) { return RCOK;}
+	RC 			index_insert_nonunique(idx_key_t key, itemid_t * item, int part_id = -1);
 	RC	 		index_read(idx_key_t key, itemid_t * &item, 
 					uint64_t thd_id, int64_t part_id = -1);
 	RC	 		index_read(idx_key_t key, itemid_t * &item, int part_id = -1);
+	RC	 		index_read(idx_key_t key, itemid_t * &item, int part_id, int thd_id);
+	RC	 		index_read(idx_key_t key, int count, itemid_t * &item, int part_id = -1);
 	RC	 		index_read(idx_key_t key, itemid_t * &item);
-	RC 			index_next(uint64_t thd_id, itemid_t * &item, bool samekey = false);
+	RC 			index_read_multiple(idx_key_t key, itemid_t ** items, 
+					uint64_t &count, int part_id = -1);
+	RC 			index_remove(idx_key_t key, row_t * row, int part_id = -1, int thd_id = 0);
+	// range scan: position cur at the first key >= key, then index_next
+	// returns the following items in key order, or NULL past the last key.
+	RC 			index_scan(idx_key_t key, bt_cursor &cur, int part_id);
+	RC 			index_next(bt_cursor &cur, itemid_t * &item, idx_key_t &key);
 
 private:
 	// index structures may have part_cnt = 1 or PART_CNT.
@@ -60,32 +93,30 @@ private:
 	RC			make_nl(uint64_t part_id, bt_node *& node);
 	RC		 	make_node(uint64_t part_id, bt_node *& node);
 	
-	RC 			start_new_tree(glob_param params, idx_key_t key, itemid_t * item);
-	RC 			find_leaf(glob_param params, idx_key_t key, idx_acc_t access_type, bt_node *& leaf, bt_node  *& last_ex);
-	RC 			find_leaf(glob_param params, idx_key_t key, idx_acc_t access_type, bt_node *& leaf);
+	// returns Abort if the traversal has to restart
+	RC 			find_leaf(glob_param params, idx_key_t key, bt_node *& leaf, uint64_t &version);
+	RC 			insert_olc(glob_param params, idx_key_t key, itemid_t * item);
 	RC			insert_into_leaf(glob_param params, bt_node * leaf, idx_key_t key, itemid_t * item);
-	// handle split
-	RC 			split_lf_insert(glob_param params, bt_node * leaf, idx_key_t key, itemid_t * item);
-	RC 			split_nl_insert(glob_param params, bt_node * node, UInt32 left_index, idx_key_t key, bt_node * right);
-	RC 			insert_into_parent(glob_param params, bt_node * left, idx_key_t key, bt_node * right);
+	// handle split. the caller holds the write locks of the node and its parent
+	RC 			split_lf_insert(glob_param params, bt_node * leaf, bt_node * parent, idx_key_t key, itemid_t * item);
+	RC 			split_nl(glob_param params, bt_node * node, bt_node * parent);
+	RC 			insert_into_parent(glob_param params, bt_node * parent, bt_node * left, idx_key_t key, bt_node * right);
 	RC 			insert_into_new_root(glob_param params, bt_node * left, idx_key_t key, bt_node * right);
+	RC 			remove_olc(glob_param params, idx_key_t key, row_t * row, int thd_id);
 
 	int			leaf_has_key(bt_node * leaf, idx_key_t key);
 	
 	UInt32 		cut(UInt32 length);
 	UInt32	 	order; // # of keys in a node(for both leaf and non-leaf)
-	bt_node ** 	roots; // each partition has a different root
+	bt_node * volatile * roots; // each partition has a different root
 	bt_node *   find_root(uint64_t part_id);
 
-	bool 		latch_node(bt_node * node, latch_t latch_type);
-	latch_t		release_latch(bt_node * node);
-	RC		 	upgrade_latch(bt_node * node);
-	// clean up all the LATCH_EX up tp last_ex
-	RC 			cleanup(bt_node * node, bt_node * last_ex);
-
-	// the leaf and the idx within the leaf that the thread last accessed.
-	bt_node *** cur_leaf_per_thd;
-	UInt32 ** 		cur_idx_per_thd;
+	// optimistic lock coupling
+	bool 		read_lock(bt_node * node, uint64_t &version);
+	bool 		validate(bt_node * node, uint64_t version);
+	bool 		upgrade_lock(bt_node * node, uint64_t version);
+	void 		write_unlock(bt_node * node);
+	void 		seek(bt_cursor &cur);
 };
 
 #endif
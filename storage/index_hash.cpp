@@ -18,236 +18,432 @@
 #include "index_hash.h"
 #include "mem_alloc.h"
 #include "row.h"
-	
-RC IndexHash::init(uint64_t bucket_cnt) {
-	_bucket_cnt = bucket_cnt;
-	_bucket_cnt_per_part = bucket_cnt;
-	//_bucket_cnt_per_part = bucket_cnt / g_part_cnt;
-	//_buckets = new BucketHeader * [g_part_cnt];
-	_buckets = new BucketHeader * [1];
-  _buckets[0] = (BucketHeader *) mem_allocator.alloc(sizeof(BucketHeader) * _bucket_cnt_per_part);
-  uint64_t buckets_init_cnt = 0;
-  for (UInt32 n = 0; n < _bucket_cnt_per_part; n ++) {
-			_buckets[0][n].init();
-      ++buckets_init_cnt;
-  }
-  printf("Index init with %ld buckets\n",buckets_init_cnt);
-	return RCOK;
+#include "epoch.h"
+
+/************** BucketNode / HashLevel ******************/
+
+void BucketNode::init() {
+	for (uint32_t s = 0; s < HASH_SLOTS; s++) {
+		keys[s] = HASH_EMPTY_KEY;
+		items[s] = NULL;
+	}
+	next = NULL;
+	state = HASH_LIVE;
+}
+
+void HashLevel::init(uint64_t bucket_bits, uint64_t part_id) {
+	this->part_id = part_id;
+	bucket_cnt = 1UL << bucket_bits;
+	shift = 64 - bucket_bits;
+	buckets = (BucketNode *) mem_allocator.part_alloc(sizeof(BucketNode) * bucket_cnt, part_id);
+	for (uint64_t n = 0; n < bucket_cnt; n++)
+		buckets[n].init();
+	prev = NULL;
+	retired = NULL;
+	migrate_cursor = 0;
+	migrated_cnt = 0;
+	overflow_cnt = 0;
+	grow_claimed = false;
+}
+
+void HashLevel::release() {
+	for (uint64_t n = 0; n < bucket_cnt; n++) {
+		BucketNode * node = buckets[n].next;
+		while (node != NULL && node != HASH_MOVED_NODE) {
+			BucketNode * next = node->next;
+			mem_allocator.free(node, sizeof(BucketNode));
+			node = next;
+		}
+	}
+	mem_allocator.free(buckets, sizeof(BucketNode) * bucket_cnt);
+}
+
+/************** IndexHash ******************/
+
+RC IndexHash::init(uint64_t table_size) {
+	return init(1, NULL, table_size);
 }
 
 RC 
-IndexHash::init(int part_cnt, table_t * table, uint64_t bucket_cnt) {
-	init(bucket_cnt);
+IndexHash::init(int part_cnt, table_t * table, uint64_t table_size) {
 	this->table = table;
+	_part_cnt = part_cnt;
+	_parts = (HashPart *) mem_allocator.align_alloc(sizeof(HashPart) * part_cnt);
+	// table_size is the size of one partition already. start at roughly half
+	// load so a fully loaded partition rarely overflows
+	uint64_t bucket_bits = 4;
+	while ((1UL << bucket_bits) * HASH_SLOTS < table_size * 2)
+		bucket_bits ++;
+	for (int part_id = 0; part_id < part_cnt; part_id ++) {
+		HashLevel * level = (HashLevel *) mem_allocator.part_alloc(sizeof(HashLevel), part_id);
+		level->init(bucket_bits, part_id);
+		_parts[part_id].top = level;
+	}
+	printf("Index init with %d x %ld buckets\n", part_cnt, 1UL << bucket_bits);
 	return RCOK;
 }
 
 void IndexHash::index_delete() {
-  for (UInt32 n = 0; n < _bucket_cnt_per_part; n ++) {
-			_buckets[0][n].delete_bucket();
-  }
-  mem_allocator.free(_buckets[0],sizeof(BucketHeader) * _bucket_cnt_per_part);
-  delete _buckets;
+	for (uint64_t part_id = 0; part_id < _part_cnt; part_id ++)
+		index_delete(&_parts[part_id]);
+	mem_allocator.free(_parts, sizeof(HashPart) * _part_cnt);
+	_parts = NULL;
 }
 
-bool IndexHash::index_exist(idx_key_t key) {
-	assert(false);
-}
-
-void 
-IndexHash::get_latch(BucketHeader * bucket) {
-	while (!ATOM_CAS(bucket->locked, false, true)) {}
+void IndexHash::index_delete(HashPart * part) {
+	HashLevel * level = part->top;
+	HashLevel * old = level->prev;
+	// rows are reachable from the newest copy of every bucket
+	for (uint64_t n = 0; n < level->bucket_cnt; n++) {
+		BucketNode * head = &level->buckets[n];
+		if (old != NULL && old->buckets[n >> 1].state != HASH_MIGRATED)
+			head = &old->buckets[n >> 1];
+		if ((n & 1) && head != &level->buckets[n])
+			continue;
+		for (BucketNode * node = head; node != NULL && node != HASH_MOVED_NODE; node = node->next) {
+			for (uint32_t s = 0; s < HASH_SLOTS; s++) {
+				itemid_t * items = (itemid_t *) ((uint64_t) node->items[s] & ~HASH_FROZEN);
+				if (items != NULL && items != HASH_EMPTY_LIST)
+					((row_t *)items->location)->free_row();
+			}
+		}
+	}
+	while (level != NULL) {
+		HashLevel * retired = level->retired;
+		level->release();
+		mem_allocator.free(level, sizeof(HashLevel));
+		level = retired;
+	}
+	part->top = NULL;
 }
 
-void 
-IndexHash::release_latch(BucketHeader * bucket) {
-	bool ok = ATOM_CAS(bucket->locked, true, false);
-	assert(ok);
+bool IndexHash::index_exist(idx_key_t key) {
+	for (uint64_t part_id = 0; part_id < _part_cnt; part_id ++) {
+		if (read_item(&_parts[part_id], key) != NULL)
+			return true;
+	}
+	return false;
 }
 
-	
 RC IndexHash::index_insert(idx_key_t key, itemid_t * item, int part_id) {
-	RC rc = RCOK;
-	uint64_t bkt_idx = hash(key);
-	assert(bkt_idx < _bucket_cnt_per_part);
-	//BucketHeader * cur_bkt = &_buckets[part_id][bkt_idx];
-	BucketHeader * cur_bkt = &_buckets[0][bkt_idx];
-	// 1. get the ex latch
-	get_latch(cur_bkt);
-	
-	// 2. update the latch list
-	cur_bkt->insert_item(key, item, part_id);
-	
-	// 3. release the latch
-	release_latch(cur_bkt);
-	return rc;
+	HashPart * part = get_part(part_id);
+	uint64_t h = hash(key);
+	while (true) {
+		HashLevel * level = part->top;
+		HashLevel * old = level->prev;
+		if (old != NULL) {
+			// help the ongoing resize, then make sure our own bucket has moved
+			migrate_step(level, old);
+			migrate_bucket(level, old, old->bucket_idx(h));
+		}
+		if (insert_item(level, h, key, item) == RCOK)
+			return RCOK;
+		// the bucket was frozen by a resize. retry on the new level
+	}
 }
+
+// Items with the same key are kept in one list, so a non-unique insert is
+// the same as inserting a duplicate key.
 RC IndexHash::index_insert_nonunique(idx_key_t key, itemid_t * item, int part_id) {
-	RC rc = RCOK;
-	uint64_t bkt_idx = hash(key);
-	assert(bkt_idx < _bucket_cnt_per_part);
-	//BucketHeader * cur_bkt = &_buckets[part_id][bkt_idx];
-	BucketHeader * cur_bkt = &_buckets[0][bkt_idx];
-	// 1. get the ex latch
-	get_latch(cur_bkt);
-	
-	// 2. update the latch list
-	cur_bkt->insert_item_nonunique(key, item, part_id);
-	
-	// 3. release the latch
-	release_latch(cur_bkt);
-	return rc;
+	return index_insert(key, item, part_id);
 }
 
-RC IndexHash::index_read(idx_key_t key, itemid_t * &item, int part_id) {
-	uint64_t bkt_idx = hash(key);
-	assert(bkt_idx < _bucket_cnt_per_part);
-	//BucketHeader * cur_bkt = &_buckets[part_id][bkt_idx];
-	BucketHeader * cur_bkt = &_buckets[0][bkt_idx];
-	RC rc = RCOK;
-	// 1. get the sh latch
-//	get_latch(cur_bkt);
-
-	cur_bkt->read_item(key, item);
-	
-	// 3. release the latch
-//	release_latch(cur_bkt);
-	return rc;
+RC IndexHash::index_remove(idx_key_t key, row_t * row, int part_id, int thd_id) {
+	HashPart * part = get_part(part_id);
+	uint64_t h = hash(key);
+	while (true) {
+		HashLevel * level = part->top;
+		HashLevel * old = level->prev;
+		if (old != NULL) {
+			migrate_step(level, old);
+			migrate_bucket(level, old, old->bucket_idx(h));
+		}
+		RC rc = remove_item(level, h, key, row, thd_id);
+		if (rc != Abort)
+			return rc;
+	}
+}
 
+RC IndexHash::index_read(idx_key_t key, itemid_t * &item, int part_id) {
+	item = read_item(get_part(part_id), key);
+	M_ASSERT_V(item != NULL, "Key does not exist! %ld\n",key);
+	return RCOK;
 }
 
 RC IndexHash::index_read(idx_key_t key, int count, itemid_t * &item, int part_id) {
-	uint64_t bkt_idx = hash(key);
-	assert(bkt_idx < _bucket_cnt_per_part);
-	//BucketHeader * cur_bkt = &_buckets[part_id][bkt_idx];
-	BucketHeader * cur_bkt = &_buckets[0][bkt_idx];
-	RC rc = RCOK;
-	// 1. get the sh latch
-//	get_latch(cur_bkt);
-
-	cur_bkt->read_item(key, count, item);
-	
-	// 3. release the latch
-//	release_latch(cur_bkt);
-	return rc;
-
+	item = read_item(get_part(part_id), key);
+	for (int n = 0; n < count && item != NULL; n++)
+		item = item->next;
+	return RCOK;
 }
 
-
 RC IndexHash::index_read(idx_key_t key, itemid_t * &item, 
 						int part_id, int thd_id) {
-	uint64_t bkt_idx = hash(key);
-	assert(bkt_idx < _bucket_cnt_per_part);
-	//BucketHeader * cur_bkt = &_buckets[part_id][bkt_idx];
-	BucketHeader * cur_bkt = &_buckets[0][bkt_idx];
-	RC rc = RCOK;
-	// 1. get the sh latch
-//	get_latch(cur_bkt);
-
-	
-	cur_bkt->read_item(key, item);
-	
-	// 3. release the latch
-//	release_latch(cur_bkt);
-	return rc;
+	item = read_item(get_part(part_id), key);
+	M_ASSERT_V(item != NULL, "Key does not exist! %ld\n",key);
+	return RCOK;
 }
 
-/************** BucketHeader Operations ******************/
-
-void BucketHeader::init() {
-	node_cnt = 0;
-	first_node = NULL;
-	locked = false;
+// An item list only ever grows at its head, and an item's next pointer is 
+// set before the item is published. Removal swaps in a new head instead of 
+// unlinking in place, so the list can be walked without holding anything.
+RC IndexHash::index_read_multiple(idx_key_t key, itemid_t ** items, 
+						uint64_t &count, int part_id) {
+	uint64_t cap = count;
+	count = 0;
+	for (itemid_t * item = read_item(get_part(part_id), key); item != NULL; item = item->next) {
+		if (count < cap)
+			items[count] = item;
+		count ++;
+	}
+	return RCOK;
 }
 
-void BucketHeader::delete_bucket() {
-	BucketNode * cur_node = first_node;
-	while (cur_node != NULL) {
-    ((row_t *)cur_node->items->location)->free_row();
-		cur_node = cur_node->next;
+itemid_t * IndexHash::read_item(HashPart * part, idx_key_t key) {
+	uint64_t h = hash(key);
+	while (true) {
+		HashLevel * level = part->top;
+		HashLevel * old = level->prev;
+		BucketNode * bucket = &level->buckets[level->bucket_idx(h)];
+		if (old != NULL) {
+			BucketNode * old_bucket = &old->buckets[old->bucket_idx(h)];
+			if (old_bucket->state != HASH_MIGRATED)
+				bucket = old_bucket;
+		}
+		itemid_t * item = read_item(bucket, key);
+		// a bucket that finished migrating may miss later inserts
+		if (bucket->state != HASH_MIGRATED)
+			return item;
 	}
 }
 
+itemid_t * IndexHash::read_item(BucketNode * bucket, idx_key_t key) {
+	for (BucketNode * node = bucket; node != NULL && node != HASH_MOVED_NODE; node = node->next) {
+		for (uint32_t s = 0; s < HASH_SLOTS; s++) {
+			idx_key_t k = node->keys[s];
+			if (k == HASH_EMPTY_KEY || k == HASH_MOVED_KEY)
+				return NULL;
+			if (k == key) {
+				// NULL means the claiming insert has not published its item yet
+				itemid_t * items = (itemid_t *) ((uint64_t) node->items[s] & ~HASH_FROZEN);
+				if (items == HASH_EMPTY_LIST)
+					return NULL;
+				if (items != NULL)
+					return items;
+			}
+		}
+	}
+	return NULL;
+}
 
-void BucketHeader::insert_item(idx_key_t key, 
-		itemid_t * item, 
-		int part_id) 
-{
+RC IndexHash::insert_item(HashLevel * level, uint64_t h, idx_key_t key, itemid_t * item) {
+	BucketNode * node = &level->buckets[level->bucket_idx(h)];
+	while (true) {
+		uint32_t s = 0;
+		while (s < HASH_SLOTS) {
+			idx_key_t k = node->keys[s];
+			if (k == HASH_EMPTY_KEY) {
+				// on failure, look again at what the winner wrote
+				if (!ATOM_CAS(node->keys[s], HASH_EMPTY_KEY, key))
+					continue;
+				item->next = NULL;
+				MEM_BARRIER();
+				node->items[s] = item;
+				return RCOK;
+			}
+			if (k == HASH_MOVED_KEY)
+				return Abort;
+			if (k != key) {
+				s ++;
+				continue;
+			}
+			// existing key: push onto its item list
+			while (true) {
+				itemid_t * head = node->items[s];
+				if (head == NULL) {
+					SPIN_PAUSE();
+					continue;
+				}
+				if ((uint64_t) head & HASH_FROZEN)
+					return Abort;
+				item->next = head == HASH_EMPTY_LIST ? NULL : head;
+				if (ATOM_CAS(node->items[s], head, item))
+					return RCOK;
+			}
+		}
+		BucketNode * next = node->next;
+		if (next == HASH_MOVED_NODE)
+			return Abort;
+		if (next == NULL)
+			next = append_node(level, node);
+		if (next == HASH_MOVED_NODE)
+			return Abort;
+		node = next;
+	}
+}
 
-	BucketNode * cur_node = first_node;
-	BucketNode * prev_node = NULL;
-	while (cur_node != NULL) {
-		if (cur_node->key == key)
-			break;
-		prev_node = cur_node;
-		cur_node = cur_node->next;
-	}
-	if (cur_node == NULL) {		
-		BucketNode * new_node = (BucketNode *) 
-			mem_allocator.alloc(sizeof(BucketNode));		
-		new_node->init(key);
-		new_node->items = item;
-		if (prev_node != NULL) {
-			new_node->next = prev_node->next;
-			prev_node->next = new_node;
-		} else {
-			new_node->next = first_node;
-			first_node = new_node;
+// The items in front of the removed one are replaced by copies and the new
+// list is installed with a CAS on the slot, which also orders the removal 
+// against concurrent pushes and freezes. The replaced items stay valid for 
+// readers until the epoch manager frees them.
+RC IndexHash::remove_item(HashLevel * level, uint64_t h, idx_key_t key, row_t * row, int thd_id) {
+	for (BucketNode * node = &level->buckets[level->bucket_idx(h)]; 
+			node != NULL && node != HASH_MOVED_NODE; node = node->next) {
+		for (uint32_t s = 0; s < HASH_SLOTS; s++) {
+			idx_key_t k = node->keys[s];
+			if (k == HASH_EMPTY_KEY)
+				return ERROR;
+			if (k == HASH_MOVED_KEY)
+				return Abort;
+			if (k != key)
+				continue;
+			while (true) {
+				itemid_t * head = node->items[s];
+				if (head == NULL) {
+					SPIN_PAUSE();
+					continue;
+				}
+				if ((uint64_t) head & HASH_FROZEN)
+					return Abort;
+				if (head == HASH_EMPTY_LIST)
+					return ERROR;
+				itemid_t * victim = head;
+				while (victim != NULL && victim->location != (void *) row)
+					victim = victim->next;
+				if (victim == NULL)
+					return ERROR;
+				itemid_t * new_head = victim->next;
+				itemid_t * tail = NULL;
+				for (itemid_t * item = head; item != victim; item = item->next) {
+					itemid_t * copy = (itemid_t *) mem_allocator.alloc(sizeof(itemid_t));
+					*copy = *item;
+					if (tail == NULL)
+						new_head = copy;
+					else
+						tail->next = copy;
+					tail = copy;
+				}
+				if (tail != NULL)
+					tail->next = victim->next;
+				if (new_head == NULL)
+					new_head = HASH_EMPTY_LIST;
+				MEM_BARRIER();
+				if (ATOM_CAS(node->items[s], head, new_head)) {
+					for (itemid_t * item = head; item != victim->next; ) {
+						itemid_t * next = item->next;
+						epoch_man.retire_item(thd_id, item);
+						item = next;
+					}
+					return RCOK;
+				}
+				// the list changed under us. drop the copies and start over
+				for (itemid_t * copy = new_head; tail != NULL && copy != victim->next; ) {
+					itemid_t * next = copy->next;
+					mem_allocator.free(copy, sizeof(itemid_t));
+					copy = next;
+				}
+			}
 		}
-	} else {
-		item->next = cur_node->items;
-		cur_node->items = item;
 	}
+	return ERROR;
 }
 
+BucketNode * IndexHash::append_node(HashLevel * level, BucketNode * node) {
+	BucketNode * new_node = (BucketNode *) mem_allocator.part_alloc(sizeof(BucketNode), level->part_id);
+	new_node->init();
+	if (!ATOM_CAS(node->next, NULL, new_node)) {
+		mem_allocator.free(new_node, sizeof(BucketNode));
+		return node->next;
+	}
+	uint64_t overflow_cnt = ATOM_ADD_FETCH(level->overflow_cnt, 1);
+	if (overflow_cnt > level->bucket_cnt / HASH_GROW_RATIO
+			&& level->prev == NULL && _parts[level->part_id].top == level
+			&& ATOM_CAS(level->grow_claimed, false, true))
+		grow(level);
+	return new_node;
+}
 
-void BucketHeader::insert_item_nonunique(idx_key_t key, 
-		itemid_t * item, 
-		int part_id) 
-{
+void IndexHash::grow(HashLevel * level) {
+	HashLevel * new_level = (HashLevel *) mem_allocator.part_alloc(sizeof(HashLevel), level->part_id);
+	new_level->init(64 - level->shift + 1, level->part_id);
+	new_level->prev = level;
+	new_level->retired = level;
+	MEM_BARRIER();
+	_parts[level->part_id].top = new_level;
+}
 
-  BucketNode * new_node = (BucketNode *) 
-    mem_allocator.alloc(sizeof(BucketNode));		
-  new_node->init(key);
-  new_node->items = item;
-  new_node->next = first_node;
-  first_node = new_node;
+void IndexHash::migrate_step(HashLevel * level, HashLevel * old) {
+	if (level->migrate_cursor >= old->bucket_cnt)
+		return;
+	uint64_t old_idx = ATOM_FETCH_ADD(level->migrate_cursor, 1);
+	if (old_idx < old->bucket_cnt)
+		migrate_bucket(level, old, old_idx);
 }
 
-void BucketHeader::read_item(idx_key_t key, itemid_t * &item) 
-{
-	BucketNode * cur_node = first_node;
-	while (cur_node != NULL) {
-		if (cur_node->key == key)
+// Move old bucket old_idx into new buckets 2*old_idx and 2*old_idx+1. 
+// Nobody else writes those two buckets until the old one is HASH_MIGRATED.
+void IndexHash::migrate_bucket(HashLevel * level, HashLevel * old, uint64_t old_idx) {
+	BucketNode * head = &old->buckets[old_idx];
+	if (head->state == HASH_MIGRATED)
+		return;
+	if (head->state != HASH_LIVE 
+			|| !ATOM_CAS(head->state, HASH_LIVE, HASH_MIGRATING)) {
+		while (head->state != HASH_MIGRATED)
+			SPIN_PAUSE();
+		return;
+	}
+	// 1. freeze the old bucket so that inserts fail over to the new level
+	BucketNode * node = head;
+	while (true) {
+		for (uint32_t s = 0; s < HASH_SLOTS; s++) {
+			if (node->keys[s] == HASH_EMPTY_KEY 
+					&& ATOM_CAS(node->keys[s], HASH_EMPTY_KEY, HASH_MOVED_KEY))
+				continue;
+			while (true) {
+				itemid_t * items = node->items[s];
+				if (items == NULL) {
+					SPIN_PAUSE();
+					continue;
+				}
+				if (ATOM_CAS(node->items[s], items, (itemid_t *) ((uint64_t) items | HASH_FROZEN)))
+					break;
+			}
+		}
+		if (ATOM_CAS(node->next, NULL, HASH_MOVED_NODE))
 			break;
-		cur_node = cur_node->next;
-	}
-	M_ASSERT_V(cur_node != NULL, "Key does not exist! %ld\n",key);
-	//M_ASSERT(cur_node != NULL, "Key does not exist!");
-	//M_ASSERT(cur_node->key == key, "Key does not exist!");
-  //assert(cur_node != NULL);
-  assert(cur_node->key == key);
-	item = cur_node->items;
-}
-
-void BucketHeader::read_item(idx_key_t key, uint32_t count, itemid_t * &item) 
-{
-    BucketNode * cur_node = first_node;
-    uint32_t ctr = 0;
-    while (cur_node != NULL) {
-        if (cur_node->key == key) {
-            if (ctr == count) {
-                break;
-            }
-            ++ctr;
-        }
-		cur_node = cur_node->next;
-    }
-    if (cur_node == NULL) {
-        item = NULL;
-        return;
-    }
-    M_ASSERT_V(cur_node != NULL, "Key does not exist! %ld\n",key);
-    assert(cur_node->key == key);
-	item = cur_node->items;
+		node = node->next;
+	}
+	// 2. copy the frozen entries. item lists are shared, not copied.
+	BucketNode * tails[2] = {&level->buckets[old_idx << 1], &level->buckets[(old_idx << 1) + 1]};
+	uint32_t slots[2] = {0, 0};
+	for (node = head; node != HASH_MOVED_NODE; node = node->next) {
+		for (uint32_t s = 0; s < HASH_SLOTS; s++) {
+			idx_key_t key = node->keys[s];
+			if (key == HASH_MOVED_KEY)
+				break;
+			// keys whose items were all removed are dropped here
+			itemid_t * items = (itemid_t *) ((uint64_t) node->items[s] & ~HASH_FROZEN);
+			if (items == HASH_EMPTY_LIST)
+				continue;
+			uint64_t side = level->bucket_idx(hash(key)) & 1;
+			if (slots[side] == HASH_SLOTS) {
+				BucketNode * new_node = (BucketNode *) mem_allocator.part_alloc(sizeof(BucketNode), level->part_id);
+				new_node->init();
+				tails[side]->next = new_node;
+				tails[side] = new_node;
+				slots[side] = 0;
+				ATOM_ADD(level->overflow_cnt, 1);
+			}
+			tails[side]->keys[slots[side]] = key;
+			tails[side]->items[slots[side]] = items;
+			slots[side] ++;
+		}
+	}
+	MEM_BARRIER();
+	head->state = HASH_MIGRATED;
+	if (ATOM_ADD_FETCH(level->migrated_cnt, 1) == old->bucket_cnt) {
+		// the old level stays reachable through retired until index_delete, 
+		// since readers may still be walking it
+		level->prev = NULL;
+	}
 }
@@ -21,46 +21,78 @@
 #include "helper.h"
 #include "index_base.h"
 
-// each BucketNode contains items sharing the same key
+// Sentinel keys. A slot is claimed by CAS-ing its key from HASH_EMPTY_KEY to 
+// the real key. Slots are claimed in chain order, so the claimed slots of a 
+// bucket always form a prefix of the chain. HASH_MOVED_KEY seals an unclaimed 
+// slot of a bucket that has been migrated to a newer level.
+#define HASH_EMPTY_KEY		UINT64_MAX
+#define HASH_MOVED_KEY		(UINT64_MAX - 1)
+// The low bit of a slot's item pointer freezes the slot. A frozen slot has 
+// been copied to a newer level; a frozen NULL is an abandoned claim.
+#define HASH_FROZEN			1UL
+#define HASH_MOVED_NODE		((BucketNode *) HASH_FROZEN)
+// item list of a key whose items have all been removed. the key keeps its 
+// slot until the bucket is migrated.
+#define HASH_EMPTY_LIST		((itemid_t *) 2)
+#define HASH_SLOTS			3
+// grow the index when the overflow node count exceeds bucket_cnt / HASH_GROW_RATIO
+#define HASH_GROW_RATIO		8
+
+enum HashBucketState {HASH_LIVE = 0, HASH_MIGRATING, HASH_MIGRATED};
+
+// Each BucketNode fills exactly one cache line. It holds HASH_SLOTS keys 
+// inline, each with the list of items sharing that key (connected by 
+// itemid_t::next). Full nodes chain to overflow nodes through next.
 class BucketNode {
 public: 
-	BucketNode(idx_key_t key) {	init(key); };
-	void init(idx_key_t key) {
-		this->key = key;
-		next = NULL;
-		items = NULL;
-	}
-	idx_key_t 		key;
-	// The node for the next key	
-	BucketNode * 	next;	
-	// NOTE. The items can be a list of items connected by the next pointer. 
-	itemid_t * 		items;
+	void init();
+	volatile idx_key_t 	keys[HASH_SLOTS];
+	itemid_t * volatile items[HASH_SLOTS];
+	BucketNode * volatile next;
+	// [HashBucketState] only meaningful in the first node of a bucket
+	volatile uint64_t 	state;
 };
 
-// BucketHeader does concurrency control of Hash
-class BucketHeader {
+// One generation of the bucket array. While the index grows, the new level
+// points to the old one through prev until every old bucket is migrated.
+class HashLevel {
 public:
-	void init();
-	void delete_bucket();
-	void insert_item(idx_key_t key, itemid_t * item, int part_id);
-	void insert_item_nonunique(idx_key_t key, itemid_t * item, int part_id);
-	void read_item(idx_key_t key, itemid_t * &item);
-	void read_item(idx_key_t key, uint32_t count, itemid_t * &item);
-	BucketNode * 	first_node;
-	uint64_t 		node_cnt;
-	bool 			locked;
-//	latch_t latch_type;
-//	uint32_t share_cnt;
+	void init(uint64_t bucket_bits, uint64_t part_id);
+	void release();
+	uint64_t 		bucket_idx(uint64_t hash) { return hash >> shift; };
+	BucketNode * 	buckets;
+	uint64_t 		bucket_cnt;
+	uint64_t 		shift;
+	HashLevel * volatile prev;
+	// the level this one replaced. kept until index_delete
+	HashLevel * 	retired;
+	// next old bucket to migrate, and number of old buckets migrated
+	volatile uint64_t 	migrate_cursor;
+	volatile uint64_t 	migrated_cnt;
+	volatile uint64_t 	overflow_cnt;
+	volatile bool 		grow_claimed;
+	// partition whose NUMA node holds the buckets
+	uint64_t 		part_id;
 };
 
-// TODO Hash index does not support partition yet.
+// root of one partition's buckets, on its own cache line
+struct HashPart {
+	HashLevel * volatile top;
+	char 			pad[CL_SIZE - sizeof(HashLevel *)];
+};
+
+// Latch-free hash index. Inserts and removals install item lists with CAS
+// and readers never block. The bucket array doubles online: inserts migrate old buckets
+// one at a time, and readers fall back to the old level for buckets that
+// have not moved yet. Each partition has its own bucket array, allocated 
+// on the NUMA node of the partition; part_id -1 maps to partition 0.
 class IndexHash  : public index_base
 {
 public:
-	RC 			init(uint64_t bucket_cnt);
+	RC 			init(uint64_t table_size);
 	RC 			init(int part_cnt, 
 					table_t * table, 
-					uint64_t bucket_cnt);
+					uint64_t table_size);
   void    index_delete();
 	bool 		index_exist(idx_key_t key); // check if the key exist.
 	RC 			index_insert(idx_key_t key, itemid_t * item, int part_id=-1);
@@ -70,30 +102,32 @@ public:
 	RC	 		index_read(idx_key_t key, int count, itemid_t * &item, int part_id=-1);	
 	RC	 		index_read(idx_key_t key, itemid_t * &item,
 							int part_id=-1, int thd_id=0);
+	RC 			index_read_multiple(idx_key_t key, itemid_t ** items, 
+							uint64_t &count, int part_id=-1);
 
-	// the following call returns a list of items
-//	RC 			index_read(idx_key_t key, Link_Item * &li, uint64_t &item_cnt);
-
-	// TODO implement index_remove
-//	RC 			index_remove(idx_key_t key);
+	RC 			index_remove(idx_key_t key, row_t * row, int part_id=-1, int thd_id=0);
 
 private:
-//	bool get_latch(BucketHeader * bucket, latch_t latch_type);
-//	bool release_latch(BucketHeader * bucket, latch_t latch_type);
-	void get_latch(BucketHeader * bucket);
-	void release_latch(BucketHeader * bucket);
-	// TODO implement more complex hash function
+	// Fibonacci hashing. Buckets are indexed by the high bits, so old 
+	// bucket b splits exactly into new buckets 2b and 2b+1.
 	uint64_t hash(idx_key_t key) {	
-#if WORKLOAD == YCSB
-    return (key / g_part_cnt) % _bucket_cnt_per_part; 
-#else
-    return key % _bucket_cnt_per_part; 
-#endif
+    return key * 0x9E3779B97F4A7C15UL; 
   }
+	HashPart * 	get_part(int part_id) { 
+		return &_parts[part_id < 0 ? 0 : (uint64_t) part_id % _part_cnt]; 
+	};
+	itemid_t *	read_item(HashPart * part, idx_key_t key);
+	void 		index_delete(HashPart * part);
+	itemid_t * 	read_item(BucketNode * bucket, idx_key_t key);
+	RC 			insert_item(HashLevel * level, uint64_t h, idx_key_t key, itemid_t * item);
+	RC 			remove_item(HashLevel * level, uint64_t h, idx_key_t key, row_t * row, int thd_id);
+	BucketNode * append_node(HashLevel * level, BucketNode * node);
+	void 		grow(HashLevel * level);
+	void 		migrate_step(HashLevel * level, HashLevel * old);
+	void 		migrate_bucket(HashLevel * level, HashLevel * old, uint64_t old_idx);
 	
-	BucketHeader ** 	_buckets;
-	uint64_t	 		_bucket_cnt;
-	uint64_t 			_bucket_cnt_per_part;
+	HashPart * 		_parts;
+	uint64_t 		_part_cnt;
 };
 
 #endif
@@ -23,7 +23,11 @@
 #include "row_ts.h"
 #include "row_mvcc.h"
 #include "row_occ.h"
+#include "row_silo.h"
+#include "row_tictoc.h"
 #include "row_maat.h"
+#include "row_vll.h"
+#include "dl_detect.h"
 #include "mem_alloc.h"
 #include "manager.h"
 
@@ -31,7 +35,9 @@
 
 RC 
 row_t::init(table_t * host_table, uint64_t part_id, uint64_t row_id) {
-	part_info = true;
+	live = false;
+	data_inline = false;
+	pax = false;
 	_row_id = row_id;
 	_part_id = part_id;
 	this->table = host_table;
@@ -45,6 +51,36 @@ row_t::init(table_t * host_table, uint64_t part_id, uint64_t row_id) {
 	return RCOK;
 }
 
+RC 
+row_t::init(table_t * host_table, uint64_t part_id, uint64_t row_id, char * inline_data) {
+	live = false;
+	data_inline = true;
+	pax = false;
+	_row_id = row_id;
+	_part_id = part_id;
+	this->table = host_table;
+	Catalog * schema = host_table->get_schema();
+	tuple_size = schema->get_tuple_size();
+	data = inline_data;
+	return RCOK;
+}
+
+RC 
+row_t::init(table_t * host_table, uint64_t part_id, uint64_t row_id, char ** groups, uint64_t slot) {
+	live = false;
+	data_inline = true;
+	pax = true;
+	_slot = slot;
+	_row_id = row_id;
+	_part_id = part_id;
+	this->table = host_table;
+	Catalog * schema = host_table->get_schema();
+	assert(schema->pax);
+	tuple_size = schema->get_tuple_size();
+	data = (char *) groups;
+	return RCOK;
+}
+
 RC 
 row_t::switch_schema(table_t * host_table) {
 	this->table = host_table;
@@ -56,16 +92,22 @@ void row_t::init_manager(row_t * row) {
   return;
 #endif
   DEBUG_M("row_t::init_manager alloc \n");
-#if CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == CALVIN
-    manager = (Row_lock *) mem_allocator.align_alloc(sizeof(Row_lock));
+#if CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == CALVIN
+    manager = (Row_lock *) mem_allocator.part_alloc(sizeof(Row_lock), _part_id);
 #elif CC_ALG == TIMESTAMP
-    manager = (Row_ts *) mem_allocator.align_alloc(sizeof(Row_ts));
+    manager = (Row_ts *) mem_allocator.part_alloc(sizeof(Row_ts), _part_id);
 #elif CC_ALG == MVCC
-    manager = (Row_mvcc *) mem_allocator.align_alloc(sizeof(Row_mvcc));
+    manager = (Row_mvcc *) mem_allocator.part_alloc(sizeof(Row_mvcc), _part_id);
 #elif CC_ALG == OCC
-    manager = (Row_occ *) mem_allocator.align_alloc(sizeof(Row_occ));
+    manager = (Row_occ *) mem_allocator.part_alloc(sizeof(Row_occ), _part_id);
+#elif CC_ALG == SILO
+    manager = (Row_silo *) mem_allocator.part_alloc(sizeof(Row_silo), _part_id);
+#elif CC_ALG == TICTOC
+    manager = (Row_tictoc *) mem_allocator.part_alloc(sizeof(Row_tictoc), _part_id);
 #elif CC_ALG == MAAT 
-    manager = (Row_maat *) mem_allocator.align_alloc(sizeof(Row_maat));
+    manager = (Row_maat *) mem_allocator.part_alloc(sizeof(Row_maat), _part_id);
+#elif CC_ALG == VLL
+    manager = (Row_vll *) mem_allocator.part_alloc(sizeof(Row_vll), _part_id);
 #endif
 
 #if CC_ALG != HSTORE && CC_ALG != HSTORE_SPEC 
@@ -73,6 +115,19 @@ void row_t::init_manager(row_t * row) {
 #endif
 }
 
+void row_t::free_manager() {
+#if MODE==NOCC_MODE || MODE==QRY_ONLY_MODE
+  return;
+#endif
+#if CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == CALVIN \
+	|| CC_ALG == TIMESTAMP \
+	|| CC_ALG == MVCC || CC_ALG == OCC || CC_ALG == MAAT || CC_ALG == SILO \
+	|| CC_ALG == TICTOC || CC_ALG == VLL
+  DEBUG_M("row_t::free_manager free\n");
+	mem_allocator.free(manager, 0);
+#endif
+}
+
 table_t * row_t::get_table() { 
 	return table; 
 }
@@ -92,23 +147,32 @@ uint64_t row_t::get_field_cnt() {
 	return get_schema()->field_cnt;
 }
 
+char * row_t::get_field(int id) {
+	Catalog * schema = get_schema();
+	if (!pax)
+		return &data[schema->get_field_index(id)];
+	Column * col = &schema->_columns[id];
+	return ((char **) data)[col->group] 
+		+ (uint64_t) _slot * schema->group_size[col->group] + col->group_index;
+}
+
 void row_t::set_value(int id, void * ptr) {
 	int datasize = get_schema()->get_field_size(id);
-	int pos = get_schema()->get_field_index(id);
-  DEBUG("set_value pos %d datasize %d -- %lx\n",pos,datasize,(uint64_t)this);
+  DEBUG("set_value id %d datasize %d -- %lx\n",id,datasize,(uint64_t)this);
 #if SIM_FULL_ROW
-	memcpy( &data[pos], ptr, datasize);
+	memcpy( get_field(id), ptr, datasize);
 #else
+	int pos = get_schema()->get_field_index(id);
   char d[tuple_size];
 	memcpy( &d[pos], ptr, datasize);
 #endif
 }
 
 void row_t::set_value(int id, void * ptr, int size) {
-	int pos = get_schema()->get_field_index(id);
 #if SIM_FULL_ROW
-	memcpy( &data[pos], ptr, size);
+	memcpy( get_field(id), ptr, size);
 #else
+	int pos = get_schema()->get_field_index(id);
   char d[tuple_size];
 	memcpy( &d[pos], ptr, size);
 #endif
@@ -132,21 +196,17 @@ GET_VALUE(UInt32);
 GET_VALUE(SInt32);
 
 char * row_t::get_value(int id) {
-  int pos __attribute__ ((unused));
-	pos = get_schema()->get_field_index(id);
-  DEBUG("get_value pos %d -- %lx\n",pos,(uint64_t)this);
+  DEBUG("get_value id %d -- %lx\n",id,(uint64_t)this);
 #if SIM_FULL_ROW
-	return &data[pos];
+	return get_field(id);
 #else
 	return data;
 #endif
 }
 
 char * row_t::get_value(char * col_name) {
-  uint64_t pos __attribute__ ((unused));
-	pos = get_schema()->get_field_index(col_name);
 #if SIM_FULL_ROW
-	return &data[pos];
+	return get_field(get_schema()->get_field_id(col_name));
 #else
 	return data;
 #endif
@@ -159,6 +219,13 @@ char * row_t::get_data() {
 void row_t::set_data(char * data) { 
 	int tuple_size = get_schema()->get_tuple_size();
 #if SIM_FULL_ROW
+	if (pax) {
+		// scatter the flat tuple into the column groups
+		Catalog * schema = get_schema();
+		for (UInt32 i = 0; i < schema->field_cnt; i++)
+			memcpy(get_field(i), &data[schema->get_field_index(i)], schema->get_field_size(i));
+		return;
+	}
 	memcpy(this->data, data, tuple_size);
 #else
   char d[tuple_size];
@@ -169,6 +236,12 @@ void row_t::set_data(char * data) {
 void row_t::copy(row_t * src) {
 	assert(src->get_schema() == this->get_schema());
 #if SIM_FULL_ROW
+	if (src->pax) {
+		Catalog * schema = get_schema();
+		for (UInt32 i = 0; i < schema->field_cnt; i++)
+			memcpy(get_field(i), src->get_field(i), schema->get_field_size(i));
+		return;
+	}
 	set_data(src->get_data());
 #else
   char d[tuple_size];
@@ -177,6 +250,8 @@ void row_t::copy(row_t * src) {
 }
 
 void row_t::free_row() {
+	if (data_inline)
+		return;
   DEBUG_M("row_t::free_row free\n");
 #if SIM_FULL
 	mem_allocator.free(data, sizeof(char) * get_tuple_size());
@@ -190,6 +265,9 @@ RC row_t::get_lock(access_t type, TxnManager * txn) {
 #if CC_ALG == CALVIN
 	lock_t lt = (type == RD || type == SCAN)? LOCK_SH : LOCK_EX;
 	rc = this->manager->lock_get(lt, txn);
+#elif CC_ALG == VLL
+	if (this->manager->insert_access(type == WR ? WR : RD))
+		txn->vll_blocked = true;
 #endif
   return rc;
 }
@@ -204,23 +282,24 @@ RC row_t::get_row(access_t type, TxnManager * txn, row_t *& row) {
     row = this;
     return rc;
 #endif
-  /*
 #if ISOLATION_LEVEL == READ_UNCOMMITTED
-  if(type == RD) {
+  // reads take no lock; writes still lock until the txn ends
+  if(type == RD || type == SCAN) {
     row = this;
     return rc;
   }
 #endif
-*/
 #if CC_ALG == MAAT
 
+    // the soft locks of the row are full
+    rc = this->manager->access(type,txn);
+    if (rc == Abort)
+      goto end;
     DEBUG_M("row_t::get_row MAAT alloc \n");
 	txn->cur_row = (row_t *) mem_allocator.alloc(sizeof(row_t));
 	txn->cur_row->init(get_table(), get_part_id());
-    rc = this->manager->access(type,txn);
     txn->cur_row->copy(this);
 	row = txn->cur_row;
-    assert(rc == RCOK);
 	goto end;
 #endif
 #if CC_ALG == WAIT_DIE || CC_ALG == NO_WAIT 
@@ -236,6 +315,44 @@ RC row_t::get_row(access_t type, TxnManager * txn, row_t *& row) {
 
 	}
 	goto end;
+#elif CC_ALG == DL_DETECT
+	{
+		lock_t lt = (type == RD || type == SCAN)? LOCK_SH : LOCK_EX;
+		uint64_t * txnids = NULL;
+		int txncnt = 0;
+		int txncap = 0;
+		rc = this->manager->lock_get(lt, txn, txnids, txncnt, txncap);
+		if (rc == RCOK) {
+			row = this;
+		} else if (rc == WAIT) {
+			dl_detector.add_dep(txn, this, txnids, txncnt);
+		}
+		if (txnids)
+			mem_allocator.free(txnids, sizeof(uint64_t) * txncap);
+	}
+	goto end;
+#elif CC_ALG == WOUND_WAIT
+	{
+		lock_t lt = (type == RD || type == SCAN)? LOCK_SH : LOCK_EX;
+		uint64_t * txnids = NULL;
+		int txncnt = 0;
+		int txncap = 0;
+		rc = this->manager->lock_get(lt, txn, txnids, txncnt, txncap);
+		if (rc == RCOK) {
+			row = this;
+		} else if (rc == WAIT) {
+			dl_detector.add_dep(txn, this, NULL, 0);
+			// wounded before the request was registered. whoever wounded
+			// the txn has told the other nodes already
+			if (txn->wounded)
+				dl_detector.wound(txn->get_thd_id(), txn->get_txn_id(), false);
+			for (int i = 0; i < txncnt; i++)
+				dl_detector.wound(txn->get_thd_id(), txnids[i], true);
+		}
+		if (txnids)
+			mem_allocator.free(txnids, sizeof(uint64_t) * txncap);
+	}
+	goto end;
 #elif CC_ALG == TIMESTAMP || CC_ALG == MVCC 
 	//uint64_t thd_id = txn->get_thd_id();
 	// For TIMESTAMP RD, a new copy of the row will be returned.
@@ -288,13 +405,29 @@ RC row_t::get_row(access_t type, TxnManager * txn, row_t *& row) {
 	rc = this->manager->access(txn, R_REQ);
 	row = txn->cur_row;
 	goto end;
-#elif CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == CALVIN
+#elif CC_ALG == SILO || CC_ALG == TICTOC
+	// like OCC, every access works on a local copy. The copy is taken 
+	// without latching the row; its TID or timestamps are validated at commit
+  DEBUG_M("row_t::get_row SILO alloc \n");
+	txn->cur_row = (row_t *) mem_allocator.alloc(sizeof(row_t));
+	txn->cur_row->init(get_table(), get_part_id());
+	rc = this->manager->access(txn, R_REQ);
+	if (rc == Abort) {
+		txn->cur_row->free_row();
+		mem_allocator.free(txn->cur_row, sizeof(row_t));
+		txn->cur_row = NULL;
+	}
+	row = txn->cur_row;
+	goto end;
+#elif CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == CALVIN || CC_ALG == VLL
 #if CC_ALG == HSTORE_SPEC
-  if(txn_table.spec_mode) {
+  // a speculative txn must not touch the rows before the txn it speculated
+  // on commits
+  if(txn->spec) {
     DEBUG_M("row_t::get_row HSTORE_SPEC alloc \n");
 	  txn->cur_row = (row_t *) mem_allocator.alloc(sizeof(row_t));
 	  txn->cur_row->init(get_table(), get_part_id());
-	  rc = this->manager->access(txn, R_REQ);
+	  txn->cur_row->copy(this);
 	  row = txn->cur_row;
 	  goto end;
   }
@@ -313,8 +446,8 @@ end:
 RC row_t::get_row_post_wait(access_t type, TxnManager * txn, row_t *& row) {
 
   RC rc = RCOK;
-  assert(CC_ALG == WAIT_DIE || CC_ALG == MVCC || CC_ALG == TIMESTAMP);
-#if CC_ALG == WAIT_DIE
+  assert(CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == MVCC || CC_ALG == TIMESTAMP);
+#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT
   assert(txn->lock_ready);
 	rc = RCOK;
 	//ts_t endtime = get_sys_clock();
@@ -355,14 +488,12 @@ void row_t::return_row(RC rc, access_t type, TxnManager * txn, row_t * row) {
 #if ISOLATION_LEVEL == NOLOCK
   return;
 #endif
-  /*
 #if ISOLATION_LEVEL == READ_UNCOMMITTED
-  if(type == RD) {
+  if(type == RD || type == SCAN) {
     return;
   }
 #endif
-*/
-#if CC_ALG == WAIT_DIE || CC_ALG == NO_WAIT || CC_ALG == CALVIN
+#if CC_ALG == WAIT_DIE || CC_ALG == NO_WAIT || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == CALVIN
 	assert (row == NULL || row == this || type == XP);
 	if (CC_ALG != CALVIN && ROLL_BACK && type == XP) {// recover from previous writes. should not happen w/ Calvin
 		this->copy(row);
@@ -397,6 +528,16 @@ void row_t::return_row(RC rc, access_t type, TxnManager * txn, row_t * row) {
 	mem_allocator.free(row, sizeof(row_t));
   manager->release();
 	return;
+#elif CC_ALG == SILO || CC_ALG == TICTOC
+	// the write lock is held since validation and released by Silo::finish
+	// or TicToc::finish
+	assert (row != NULL);
+	if (type == WR)
+		manager->write(row);
+	row->free_row();
+  DEBUG_M("row_t::return_row SILO free \n");
+	mem_allocator.free(row, sizeof(row_t));
+	return;
 #elif CC_ALG == MAAT 
 	assert (row != NULL);
   if (rc == Abort) {
@@ -408,8 +549,19 @@ void row_t::return_row(RC rc, access_t type, TxnManager * txn, row_t * row) {
 	row->free_row();
   DEBUG_M("row_t::return_row Maat free \n");
 	mem_allocator.free(row, sizeof(row_t));
-#elif CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC 
+#elif CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == VLL
 	assert (row != NULL);
+#if CC_ALG == HSTORE_SPEC
+	if (txn->spec) {
+		// install the private copy once the txn commits
+		if (type == WR)
+			this->copy(row);
+		row->free_row();
+    DEBUG_M("row_t::return_row HSTORE_SPEC free \n");
+		mem_allocator.free(row, sizeof(row_t));
+		return;
+	}
+#endif
 	if (ROLL_BACK && type == XP) {// recover from previous writes.
 		this->copy(row);
 	}
@@ -39,9 +39,9 @@
   */
 #define GET_VALUE(type)\
 	void row_t::get_value(int col_id, type & value) {\
-		int pos = get_schema()->get_field_index(col_id);\
-    DEBUG("get_value pos %d -- %lx\n",pos,(uint64_t)this); \
-		value = *(type *)&data[pos];\
+		char * ptr = get_field(col_id);\
+    DEBUG("get_value ptr %lx -- %lx\n",(uint64_t)ptr,(uint64_t)this); \
+		value = *(type *)ptr;\
 	}
 
 class table_t;
@@ -51,7 +51,10 @@ class Row_lock;
 class Row_mvcc;
 class Row_ts;
 class Row_occ;
+class Row_silo;
+class Row_tictoc;
 class Row_maat;
+class Row_vll;
 class Row_specex;
 
 class row_t
@@ -59,9 +62,14 @@ class row_t
 public:
 
 	RC init(table_t * host_table, uint64_t part_id, uint64_t row_id = 0);
+	// tuple data lives at inline_data, owned by the table's row heap
+	RC init(table_t * host_table, uint64_t part_id, uint64_t row_id, char * inline_data);
+	// PAX row: the fields are in the column group minipages of a heap slab
+	RC init(table_t * host_table, uint64_t part_id, uint64_t row_id, char ** groups, uint64_t slot);
 	RC switch_schema(table_t * host_table);
 	// not every row has a manager
 	void init_manager(row_t * row);
+	void free_manager();
 
 	table_t * get_table();
 	Catalog * get_schema();
@@ -94,7 +102,24 @@ public:
 	DECL_GET_VALUE(UInt32);
 	DECL_GET_VALUE(SInt32);
 
-
+	// Typed accessors for a column F generated from the schema files by 
+	// scripts/gen_schema.py (e.g. tpcc_schema::STOCK::S_QUANTITY). The 
+	// layout is known at compile time, so no Catalog lookup is needed.
+	template<typename F> char * get_value() {
+		if (F::pax && pax)
+			return ((char **) data)[F::group] + (uint64_t) _slot * F::group_size + F::group_index;
+		return &data[F::index];
+	};
+	template<typename F, typename T> void get_value(T & value) {
+		value = *(typename F::type *) get_value<F>();
+	};
+	template<typename F> void set_value(typename F::type value) {
+		*(typename F::type *) get_value<F>() = value;
+	};
+
+
+	// the flat tuple. PAX rows do not have one; use get_value/set_value, 
+	// or copy() to get a flat copy.
 	void set_data(char * data);
 	char * get_data();
 
@@ -106,7 +131,7 @@ public:
   RC get_row_post_wait(access_t type, TxnManager * txn, row_t *& row); 
 	void return_row(RC rc, access_t type, TxnManager * txn, row_t * row);
 
-  #if CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == CALVIN
+  #if CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == CALVIN
     Row_lock * manager;
   #elif CC_ALG == TIMESTAMP
    	Row_ts * manager;
@@ -114,21 +139,37 @@ public:
   	Row_mvcc * manager;
   #elif CC_ALG == OCC
   	Row_occ * manager;
+  #elif CC_ALG == SILO
+  	Row_silo * manager;
+  #elif CC_ALG == TICTOC
+  	Row_tictoc * manager;
   #elif CC_ALG == MAAT 
   	Row_maat * manager;
-  #elif CC_ALG == HSTORE_SPEC
-  	Row_specex * manager;
+  #elif CC_ALG == VLL
+  	Row_vll * manager;
   #elif CC_ALG == AVOID
     Row_avoid * manager;
   #endif
 	char * data;
   int tuple_size;
 	table_t * table;
+	// set once a heap row is initialized, cleared when it is released
+	volatile bool live;
 private:
-	// primary key should be calculated from the data stored in the row.
-	uint64_t 		_primary_key;
+	friend class table_t;
+	char * get_field(int id);
+
+	union {
+		// primary key should be calculated from the data stored in the row.
+		uint64_t 		_primary_key;
+		// link in the free list of the table's row heap once released
+		row_t * 		next_free;
+	};
 	uint64_t		_part_id;
-	bool part_info;
+	bool data_inline;
+	bool pax;
+	// slot in the heap slab, used to find the fields of PAX rows
+	uint32_t _slot;
 	uint64_t _row_id;
 };
 
@@ -20,6 +20,7 @@
 #include "catalog.h"
 #include "row.h"
 #include "mem_alloc.h"
+#include "epoch.h"
 
 void table_t::init(Catalog * schema) {
 	this->table_name = schema->table_name;
@@ -31,6 +32,28 @@ void table_t::init(Catalog * schema) {
 	// sharing problems
 	char * ptr = new char[CL_SIZE*2 + sizeof(uint64_t)];
 	cur_tab_size = (uint64_t *) &ptr[CL_SIZE];
+
+	// in the PAX layout the tuple lives in the slab's column minipages
+	row_stride = sizeof(row_t);
+	if (!schema->pax)
+		row_stride += schema->get_tuple_size();
+	if (g_mem_pad && row_stride % CL_SIZE != 0)
+		row_stride += CL_SIZE - row_stride % CL_SIZE;
+	else if (row_stride % sizeof(uint64_t) != 0)
+		row_stride += sizeof(uint64_t) - row_stride % sizeof(uint64_t);
+	index_cnt = 0;
+	heaps = (row_heap *) mem_allocator.align_alloc(sizeof(row_heap) * g_part_cnt);
+	for (uint64_t part_id = 0; part_id < g_part_cnt; part_id ++) {
+		heaps[part_id].first = NULL;
+		heaps[part_id].cur = NULL;
+		heaps[part_id].free_rows = NULL;
+		heaps[part_id].latch = false;
+	}
+}
+
+void table_t::add_index(index_base * index) {
+	M_ASSERT_V(index_cnt < MAX_TABLE_INDEXES, "Too many indexes on %s\n", table_name);
+	indexes[index_cnt++] = index;
 }
 
 RC table_t::get_new_row(row_t *& row) {
@@ -43,12 +66,129 @@ RC table_t::get_new_row(row_t *& row) {
 RC table_t::get_new_row(row_t *& row, uint64_t part_id, uint64_t &row_id) {
 	RC rc = RCOK;
   DEBUG_M("table_t::get_new_row alloc\n");
-	void * ptr = mem_allocator.alloc(sizeof(row_t));
-	assert (ptr != NULL);
+	char * data;
+	uint64_t slot;
+	row = alloc_row(part_id, data, slot);
+	assert (row != NULL);
 	
-	row = (row_t *) ptr;
-	rc = row->init(this, part_id, row_id);
+	if (schema->pax)
+		rc = row->init(this, part_id, row_id, (char **) data, slot);
+	else
+		rc = row->init(this, part_id, row_id, data);
 	row->init_manager(row);
+	// publish the row to scans
+	COMPILER_FENCE();
+	row->live = true;
 
 	return rc;
 }
+
+void table_t::release_row(row_t * row) {
+	row_heap * heap = &heaps[row->get_part_id()];
+	row->live = false;
+	row->free_row();
+	while (!ATOM_CAS(heap->latch, false, true)) 
+		SPIN_PAUSE();
+	row->next_free = heap->free_rows;
+	heap->free_rows = row;
+	heap->latch = false;
+}
+
+void table_t::delete_row(row_t * row, uint64_t thd_id) {
+	assert(row->live);
+	row->live = false;
+	epoch_man.retire_row(thd_id, row);
+}
+
+// data and slot return where the tuple of the row is stored. A released row 
+// keeps both, so it can be handed out again as is.
+row_t * table_t::alloc_row(uint64_t part_id, char *& data, uint64_t & slot) {
+	assert(part_id < g_part_cnt);
+	row_heap * heap = &heaps[part_id];
+	if (heap->free_rows != NULL) {
+		row_t * row = NULL;
+		while (!ATOM_CAS(heap->latch, false, true)) 
+			SPIN_PAUSE();
+		if (heap->free_rows != NULL) {
+			row = heap->free_rows;
+			heap->free_rows = row->next_free;
+		}
+		heap->latch = false;
+		if (row != NULL) {
+			data = row->data;
+			slot = row->_slot;
+			return row;
+		}
+	}
+	while (true) {
+		row_slab * slab = heap->cur;
+		if (slab == NULL) {
+			if (heap->first == NULL) {
+				row_slab * first = new_slab(part_id, NULL);
+				if (!ATOM_CAS(heap->first, NULL, first))
+					mem_allocator.free(first, 0);
+			}
+			ATOM_CAS(heap->cur, NULL, heap->first);
+			continue;
+		}
+		if (slab->used < slab->capacity) {
+			slot = ATOM_FETCH_ADD(slab->used, 1);
+			if (slot < slab->capacity) {
+				row_t * row = (row_t *) &slab->slots[slot * row_stride];
+				data = schema->pax ? (char *) slab->groups : (char *) row + sizeof(row_t);
+				return row;
+			}
+		}
+		// the slab is full. append a new one, or help move cur forward
+		if (slab->next == NULL) {
+			row_slab * next = new_slab(part_id, slab);
+			if (!ATOM_CAS(slab->next, NULL, next))
+				mem_allocator.free(next, 0);
+		}
+		ATOM_CAS(heap->cur, slab, slab->next);
+	}
+}
+
+static inline uint64_t cl_align(uint64_t size) {
+	if (size % CL_SIZE != 0)
+		size += CL_SIZE - size % CL_SIZE;
+	return size;
+}
+
+row_slab * table_t::new_slab(uint64_t part_id, row_slab * prev) {
+	uint64_t slot_size = row_stride;
+	if (schema->pax)
+		slot_size += schema->get_tuple_size();
+	uint64_t capacity = ROW_SLAB_MIN_ROWS;
+	if (prev != NULL) {
+		capacity = prev->capacity * 2;
+		if (capacity * slot_size > ROW_SLAB_MAX_SIZE)
+			capacity = prev->capacity;
+	}
+	if (capacity * slot_size > ROW_SLAB_MAX_SIZE && capacity > ROW_SLAB_MIN_ROWS)
+		capacity = ROW_SLAB_MAX_SIZE / slot_size > 0 ? ROW_SLAB_MAX_SIZE / slot_size : 1;
+	uint64_t header_size = sizeof(row_slab);
+	uint32_t group_cnt = schema->pax ? schema->group_cnt : 0;
+	header_size = cl_align(header_size + sizeof(char *) * group_cnt);
+	uint64_t size = header_size + cl_align(capacity * row_stride);
+	for (uint32_t g = 0; g < group_cnt; g++)
+		size += cl_align(capacity * schema->group_size[g]);
+  DEBUG_M("table_t::new_slab alloc\n");
+	row_slab * slab = (row_slab *) mem_allocator.part_alloc(size, part_id);
+	// zeroed slots are not live
+	memset(slab, 0, size);
+	slab->next = NULL;
+	slab->capacity = capacity;
+	slab->used = 0;
+	slab->slots = (char *) slab + header_size;
+	slab->groups = NULL;
+	if (group_cnt > 0) {
+		slab->groups = (char **) &slab[1];
+		char * minipage = slab->slots + cl_align(capacity * row_stride);
+		for (uint32_t g = 0; g < group_cnt; g++) {
+			slab->groups[g] = minipage;
+			minipage += cl_align(capacity * schema->group_size[g]);
+		}
+	}
+	return slab;
+}
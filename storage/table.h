@@ -18,12 +18,56 @@
 #define _TABLE_H_
 
 #include "global.h"
+#include "helper.h"
+#include "row.h"
+#include "catalog.h"
 
-// TODO sequential scan is not supported yet.
-// only index access is supported for table. 
+// first slab of a partition holds ROW_SLAB_MIN_ROWS rows. each following 
+// slab doubles, until it reaches ROW_SLAB_MAX_SIZE bytes.
+#define ROW_SLAB_MIN_ROWS	16
+#define ROW_SLAB_MAX_SIZE	(1UL << 20)
+#define MAX_TABLE_INDEXES	4
 
-class Catalog;
-class row_t;
+// A slab stores rows of one partition back to back. In the row layout each 
+// slot is a row_t immediately followed by its tuple data. In the PAX layout 
+// slots only hold row_t headers and each column group of the slab has its 
+// own minipage, where the group's fields of all slots are stored contiguously.
+struct row_slab {
+	row_slab * volatile next;
+	uint64_t 		capacity;
+	// slots handed out so far. may run past capacity when the slab is full
+	volatile uint64_t used;
+	char * 			slots;
+	// minipage of each column group. NULL for the row layout
+	char ** 		groups;
+};
+
+// A run of consecutive slots of one slab, seen through one column. The 
+// field of slot i is at values + i * value_stride and its row header at 
+// rows + i * row_stride. With PAX and a single-column group, value_stride 
+// is the field size, i.e. the values form a dense array.
+struct column_run {
+	char * 			values;
+	uint64_t 		value_stride;
+	char * 			rows;
+	uint64_t 		row_stride;
+	uint64_t 		cnt;
+
+	row_t * row(uint64_t i) { return (row_t *) &rows[i * row_stride]; };
+	template<typename T> T & value(uint64_t i) { return *(T *) &values[i * value_stride]; };
+};
+
+// per-partition heap state, padded to avoid false sharing between partitions
+struct row_heap {
+	row_slab * volatile first;
+	row_slab * volatile cur;
+	// released slots, linked through row_t::next_free
+	row_t * 		free_rows;
+	volatile bool 	latch;
+	char 			pad[CL_SIZE - sizeof(void *) * 3 - sizeof(bool)];
+};
+
+class index_base;
 
 class table_t
 {
@@ -34,20 +78,84 @@ public:
 	// new row.	
 	RC get_new_row(row_t *& row); // this is equivalent to insert()
 	RC get_new_row(row_t *& row, uint64_t part_id, uint64_t &row_id);
+	// returns the slot of a row from get_new_row to its partition's heap
+	void release_row(row_t * row);
+
+	// Takes a row that was removed from all indexes out of the table. Scans 
+	// stop seeing it at once, and its slot is released once no transaction 
+	// can still hold it.
+	void delete_row(row_t * row, uint64_t thd_id);
 
-	void delete_row(); // TODO delete_row is not supportet yet
+	// Sequential scan over the rows of a partition in physical order. 
+	// callback(row_t *) returns false to stop the scan. Rows inserted or 
+	// released during the scan may or may not be visited.
+	template<typename F> void scan(uint64_t part_id, F callback);
+	// Batch column access. callback(column_run &) is called for each slab of 
+	// the partition and returns false to stop. Slots whose row is not live 
+	// must be skipped by the callback.
+	template<typename F> void scan_column(uint64_t part_id, uint64_t col_id, F callback);
 
 	uint64_t get_table_size() { return *cur_tab_size; };
 	Catalog * get_schema() { return schema; };
 	const char * get_table_name() { return table_name; };
 	uint32_t get_table_id() { return table_id; };
 
+	// indexes declared on the table in the schema file
+	void add_index(index_base * index);
+	uint32_t get_index_cnt() { return index_cnt; };
+	index_base * get_index(uint32_t i) { return indexes[i]; };
+
 	Catalog * 		schema;
+	index_base * 	indexes[MAX_TABLE_INDEXES];
+	uint32_t 		index_cnt;
 private:
+	row_t * 		alloc_row(uint64_t part_id, char *& data, uint64_t & slot);
+	// slabs are placed on the NUMA node of their partition
+	row_slab * 		new_slab(uint64_t part_id, row_slab * prev);
+
 	const char * 	table_name;
   uint32_t table_id;
 	uint64_t * 		cur_tab_size;
-	char 			pad[CL_SIZE - sizeof(void *)*3 - sizeof(uint32_t)];
+	// bytes per slot: row_t header, plus the inline tuple in the row layout
+	uint64_t 		row_stride;
+	row_heap * 		heaps;
+	char 			pad[CL_SIZE - sizeof(void *)*4 - sizeof(uint32_t) - sizeof(uint64_t)];
 };
 
+template<typename F> 
+void table_t::scan(uint64_t part_id, F callback) {
+	assert(part_id < g_part_cnt);
+	for (row_slab * slab = heaps[part_id].first; slab != NULL; slab = slab->next) {
+		uint64_t cnt = slab->used < slab->capacity ? slab->used : slab->capacity;
+		for (uint64_t i = 0; i < cnt; i++) {
+			row_t * row = (row_t *) &slab->slots[i * row_stride];
+			// claimed slots become live only once the row is initialized
+			if (row->live && !callback(row))
+				return;
+		}
+	}
+}
+
+template<typename F> 
+void table_t::scan_column(uint64_t part_id, uint64_t col_id, F callback) {
+	assert(part_id < g_part_cnt);
+	assert(col_id < schema->get_field_cnt());
+	Column * col = &schema->_columns[col_id];
+	column_run run;
+	run.row_stride = row_stride;
+	for (row_slab * slab = heaps[part_id].first; slab != NULL; slab = slab->next) {
+		run.cnt = slab->used < slab->capacity ? slab->used : slab->capacity;
+		run.rows = slab->slots;
+		if (schema->pax) {
+			run.values = slab->groups[col->group] + col->group_index;
+			run.value_stride = schema->group_size[col->group];
+		} else {
+			run.values = slab->slots + sizeof(row_t) + col->index;
+			run.value_stride = row_stride;
+		}
+		if (!callback(run))
+			return;
+	}
+}
+
 #endif
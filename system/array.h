@@ -20,6 +20,7 @@
 #include "global.h"
 #include "helper.h"
 #include "mem_alloc.h"
+#include <algorithm>
 
 template <class T> class Array {
 public:
@@ -78,6 +79,19 @@ public:
     add(item);
   }
 
+  // like add, but doubles the capacity instead of overflowing
+  void add_grow(T item){
+    if(count == capacity) {
+      DEBUG_M("Array::grow %ld*%ld\n",sizeof(T),capacity * 2);
+      T * grown = (T*) mem_allocator.alloc(sizeof(T)*capacity*2);
+      memcpy(grown,items,sizeof(T)*count);
+      mem_allocator.free(items,sizeof(T)*capacity);
+      items = grown;
+      capacity = capacity * 2;
+    }
+    add(item);
+  }
+
   void add(T item){
     assert(count < capacity);
     items[count] = item;
@@ -100,6 +114,32 @@ public:
     items[idx] = item;
   }
 
+  // sorts the items and drops the duplicates
+  void sort_unique() {
+    std::sort(items, items + count);
+    count = std::unique(items, items + count) - items;
+  }
+
+  template <class Less> void sort_unique(Less less) {
+    std::sort(items, items + count, less);
+    count = std::unique(items, items + count) - items;
+  }
+
+  // only after sort_unique
+  bool contains_sorted(T item) {
+    return std::binary_search(items, items + count, item);
+  }
+
+  template <class Less> bool contains_sorted(T item, Less less) {
+    return std::binary_search(items, items + count, item, less);
+  }
+
+  // keeps the first size items
+  void truncate(uint64_t size) {
+    assert(size <= count);
+    count = size;
+  }
+
   bool contains(T item) {
       for (uint64_t i = 0; i < count; i++) {
           if (items[i] == item) {
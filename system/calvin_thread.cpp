@@ -40,15 +40,15 @@ void CalvinLockThread::setup() {
 RC CalvinLockThread::run() {
     tsetup();
 
-    RC rc = RCOK;
-    TxnManager * txn_man;
-    uint64_t prof_starttime = get_sys_clock();
     uint64_t idle_starttime = 0;
 
     while(!simulation->is_done()) {
-        txn_man = NULL;
-
-        Message * msg = work_queue.sched_dequeue(_thd_id);
+        Message * msg;
+        if (lock_part == 0) {
+            msg = work_queue.sched_dequeue(_thd_id);
+        } else {
+            msg = work_queue.lock_dequeue(_thd_id,lock_part);
+        }
 
         if(!msg) {
             if(idle_starttime == 0)
@@ -60,51 +60,68 @@ RC CalvinLockThread::run() {
             idle_starttime = 0;
         }
 
-        prof_starttime = get_sys_clock();
-        assert(msg->get_rtype() == CL_QRY);
-        assert(msg->get_txn_id() != UINT64_MAX);
-
-        txn_man = txn_table.get_transaction_manager(get_thd_id(),msg->get_txn_id(),msg->get_batch_id());
-        while(!txn_man->unset_ready()) { }
-        assert(ISSERVERN(msg->get_return_id()));
-        txn_man->txn_stats.starttime = get_sys_clock();
-
-        txn_man->txn_stats.lat_network_time_start = msg->lat_network_time;
-        txn_man->txn_stats.lat_other_time_start = msg->lat_other_time;
-
-        msg->copy_to_txn(txn_man);
-        txn_man->register_thread(this);
-        assert(ISSERVERN(txn_man->return_id));
-
-        INC_STATS(get_thd_id(),sched_txn_table_time,get_sys_clock() - prof_starttime);
-        prof_starttime = get_sys_clock();
-
-        rc = RCOK;
-        // Acquire locks
-        if (!txn_man->isRecon()) {
-            rc = txn_man->acquire_locks();
-        }
-
-        if(rc == RCOK) {
-            work_queue.enqueue(_thd_id,msg,false);
+        if (lock_part == 0) {
+            dispatch(msg);
+        } else {
+            TxnManager * txn_man = txn_table.get_transaction_manager(get_thd_id(),msg->get_txn_id(),msg->get_batch_id());
+            lock_txn(txn_man,msg);
         }
-        txn_man->set_ready();
-
-        INC_STATS(_thd_id,mtx[33],get_sys_clock() - prof_starttime);
-        prof_starttime = get_sys_clock();
-
     }
     printf("FINISH %ld:%ld\n",_node_id,_thd_id);
     fflush(stdout);
     return FINISH;
 }
 
-void CalvinSequencerThread::setup() {
+void CalvinLockThread::dispatch(Message * msg) {
+    uint64_t prof_starttime = get_sys_clock();
+    assert(msg->get_rtype() == CL_QRY);
+    assert(msg->get_txn_id() != UINT64_MAX);
+
+    TxnManager * txn_man = txn_table.get_transaction_manager(get_thd_id(),msg->get_txn_id(),msg->get_batch_id());
+    while(!txn_man->unset_ready()) { }
+    assert(ISSERVERN(msg->get_return_id()));
+    txn_man->txn_stats.starttime = get_sys_clock();
+
+    txn_man->txn_stats.lat_network_time_start = msg->lat_network_time;
+    txn_man->txn_stats.lat_other_time_start = msg->lat_other_time;
+
+    msg->copy_to_txn(txn_man);
+    txn_man->register_thread(this);
+    assert(ISSERVERN(txn_man->return_id));
+
+    INC_STATS(get_thd_id(),sched_txn_table_time,get_sys_clock() - prof_starttime);
+    prof_starttime = get_sys_clock();
+
+    if (txn_man->isRecon()) {
+        work_queue.enqueue(_thd_id,msg,false);
+    } else {
+        // Hold the txn back until every lock thread has requested its rows;
+        // the last one drops the hold
+        txn_man->calvin_parts_left = g_calvin_lock_thread_cnt;
+        txn_man->incr_lr();
+        for (uint64_t i = 1; i < g_calvin_lock_thread_cnt; i++) {
+            work_queue.lock_enqueue(_thd_id,i,msg);
+        }
+        lock_txn(txn_man,msg);
+    }
+    txn_man->set_ready();
+
+    INC_STATS(_thd_id,mtx[33],get_sys_clock() - prof_starttime);
 }
 
-bool CalvinSequencerThread::is_batch_ready() {
-    bool ready = get_wall_clock() - simulation->last_seq_epoch_time >= g_seq_batch_time_limit;
-    return ready;
+void CalvinLockThread::lock_txn(TxnManager * txn_man, Message * msg) {
+    txn_man->acquire_locks(lock_part);
+    if (ATOM_SUB_FETCH(txn_man->calvin_parts_left,1) > 0) {
+        return;
+    }
+    // Acquired or queued for every row; ready unless a lock is still pending
+    if(txn_man->decr_lr() == 0) {
+        if(ATOM_CAS(txn_man->lock_ready,false,true))
+            work_queue.enqueue(_thd_id,msg,false);
+    }
+}
+
+void CalvinSequencerThread::setup() {
 }
 
 RC CalvinSequencerThread::run() {
@@ -118,8 +135,7 @@ RC CalvinSequencerThread::run() {
 
         prof_starttime = get_sys_clock();
 
-        if(is_batch_ready()) {
-          simulation->advance_seq_epoch();
+        if(seq_id == 0 && seq_man.is_batch_ready()) {
           //last_batchtime = get_wall_clock();
           seq_man.send_next_batch(_thd_id);
         }
@@ -146,13 +162,13 @@ RC CalvinSequencerThread::run() {
           case CL_QRY:
             // Query from client
             DEBUG("SEQ process_txn\n");
-            seq_man.process_txn(msg,get_thd_id(),0,0,0,0);
+            seq_man.process_txn(msg,get_thd_id(),seq_id,0,0,0,0);
             // Don't free message yet
             break;
           case CALVIN_ACK:
             // Ack from server
             DEBUG("SEQ process_ack (%ld,%ld) from %ld\n",msg->get_txn_id(),msg->get_batch_id(),msg->get_return_id());
-            seq_man.process_ack(msg,get_thd_id());
+            seq_man.process_ack(msg,get_thd_id(),seq_id);
             // Free message here
             msg->release();
             break;
@@ -20,6 +20,7 @@
 #include "global.h"
 
 class Workload;
+class Message;
 
 /*
 class CalvinThread : public Thread {
@@ -32,20 +33,28 @@ private:
 };
 */
 
+// Lock thread 0 takes the scheduled txns in order and hands each one to
+// the other lock threads. Every lock thread then locks the rows whose key
+// maps to it, so the lock order per row stays the schedule order.
 class CalvinLockThread : public Thread {
 public:
     RC run();
     void setup();
+    uint64_t lock_part;
 private:
+    void dispatch(Message * msg);
+    void lock_txn(TxnManager * txn_man, Message * msg);
     TxnManager * m_txn;
 };
 
+// Every sequencer thread takes client txns and acks. Thread 0 also
+// closes the epochs
 class CalvinSequencerThread : public Thread {
 public:
     RC run();
     void setup();
+    uint64_t seq_id;
 private:
-    bool is_batch_ready();
 	uint64_t last_batchtime;
 };
 
@@ -0,0 +1,121 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "global.h"
+#include "helper.h"
+#include "epoch.h"
+#include "mem_alloc.h"
+#include "row.h"
+#include "table.h"
+#include "row_mvcc.h"
+#include "maat.h"
+
+void EpochManager::init() {
+	epoch = 1;
+	shard_cnt = g_this_total_thread_cnt + 1;
+	shards = (epoch_shard *) mem_allocator.align_alloc(sizeof(epoch_shard) * shard_cnt);
+	for (uint64_t i = 0; i < shard_cnt; i++) {
+		for (uint32_t e = 0; e < 3; e++)
+			shards[i].active[e] = 0;
+		shards[i].limbo = new std::queue<epoch_obj>();
+	}
+}
+
+uint64_t EpochManager::enter(uint64_t thd_id) {
+	epoch_shard * shard = get_shard(thd_id);
+	while (true) {
+		uint64_t e = epoch;
+		ATOM_ADD(shard->active[e % 3], 1);
+		MEM_BARRIER();
+		// the epoch may have moved on before we were counted
+		if (epoch == e)
+			return e;
+		ATOM_SUB(shard->active[e % 3], 1);
+	}
+}
+
+void EpochManager::exit(uint64_t thd_id, uint64_t epoch) {
+	ATOM_SUB(get_shard(thd_id)->active[epoch % 3], 1);
+}
+
+void EpochManager::retire_item(uint64_t thd_id, itemid_t * item) {
+	retire(thd_id, item, EPOCH_ITEM);
+}
+
+// the row must no longer be reachable from any index
+void EpochManager::retire_row(uint64_t thd_id, row_t * row) {
+	retire(thd_id, row, EPOCH_ROW);
+}
+
+void EpochManager::retire_version(uint64_t thd_id, MVHisEntry * his) {
+	retire(thd_id, his, EPOCH_VERSION);
+}
+
+void EpochManager::retire_tt_entry(uint64_t thd_id, TimeTableEntry * entry) {
+	retire(thd_id, entry, EPOCH_TT_ENTRY);
+}
+
+// Limbo lists are only touched by their own thread, and each is ordered 
+// by epoch.
+void EpochManager::retire(uint64_t thd_id, void * ptr, EpochObjType type) {
+	epoch_obj obj;
+	obj.ptr = ptr;
+	obj.epoch = epoch;
+	obj.type = type;
+	std::queue<epoch_obj> * limbo = get_shard(thd_id)->limbo;
+	limbo->push(obj);
+	if (limbo->size() % EPOCH_RECLAIM_BATCH == 0) {
+		try_advance();
+		reclaim(thd_id);
+	}
+}
+
+void EpochManager::reclaim(uint64_t thd_id) {
+	std::queue<epoch_obj> * limbo = get_shard(thd_id)->limbo;
+	uint64_t e = epoch;
+	while (!limbo->empty() && limbo->front().epoch + 2 <= e) {
+		epoch_obj obj = limbo->front();
+		limbo->pop();
+		if (obj.type == EPOCH_ITEM) {
+			DEBUG_M("EpochManager::reclaim item free\n");
+			mem_allocator.free(obj.ptr, sizeof(itemid_t));
+		} else if (obj.type == EPOCH_VERSION) {
+			MVHisEntry * his = (MVHisEntry *) obj.ptr;
+			if (his->row != NULL) {
+				his->row->free_row();
+				DEBUG_M("EpochManager::reclaim version free\n");
+				mem_allocator.free(his->row, sizeof(row_t));
+			}
+			mem_allocator.free(his, sizeof(MVHisEntry));
+		} else if (obj.type == EPOCH_TT_ENTRY) {
+			time_table.free_entry((TimeTableEntry *) obj.ptr);
+		} else {
+			row_t * row = (row_t *) obj.ptr;
+			row->free_manager();
+			row->get_table()->release_row(row);
+		}
+	}
+}
+
+bool EpochManager::try_advance() {
+	uint64_t e = epoch;
+	int64_t active = 0;
+	for (uint64_t i = 0; i < shard_cnt; i++)
+		active += shards[i].active[(e - 1) % 3];
+	if (active != 0)
+		return false;
+	return ATOM_CAS(epoch, e, e + 1);
+}
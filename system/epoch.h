@@ -0,0 +1,76 @@
+/*
+   Copyright 2016 Massachusetts Institute of Technology
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef _EPOCH_H_
+#define _EPOCH_H_
+
+#include "global.h"
+#include <queue>
+
+class row_t;
+struct MVHisEntry;
+struct TimeTableEntry;
+
+// a thread tries to advance the epoch once this many objects wait in its limbo
+#define EPOCH_RECLAIM_BATCH 64
+
+enum EpochObjType { EPOCH_ITEM = 0, EPOCH_ROW, EPOCH_VERSION, EPOCH_TT_ENTRY };
+
+struct epoch_obj {
+	void * 			ptr;
+	uint64_t 		epoch;
+	EpochObjType 	type;
+};
+
+// per-thread state, padded to avoid false sharing between threads. A 
+// transaction may leave its epoch on another thread than it entered on, 
+// so only the sum of active[e % 3] over all threads is meaningful.
+struct epoch_shard {
+	volatile int64_t 	active[3];
+	std::queue<epoch_obj> * limbo;
+	char 				pad[CL_SIZE - sizeof(int64_t) * 3 - sizeof(void *)];
+};
+
+// Epoch-based reclamation for index items and rows that were removed while
+// other transactions may still hold pointers to them. Every transaction 
+// runs inside the epoch it entered. A removed object is retired with the 
+// current epoch e and freed once the global epoch reaches e + 2: the epoch 
+// only advances past e + 1 when nobody is left in epoch e.
+class EpochManager {
+public:
+	void 		init();
+	uint64_t 	enter(uint64_t thd_id);
+	void 		exit(uint64_t thd_id, uint64_t epoch);
+	void 		retire_item(uint64_t thd_id, itemid_t * item);
+	void 		retire_row(uint64_t thd_id, row_t * row);
+	// [MVCC] a version unlinked from its chain, with the row it holds
+	void 		retire_version(uint64_t thd_id, MVHisEntry * his);
+	// [MAAT] a released time table slot, taken again once it is freed
+	void 		retire_tt_entry(uint64_t thd_id, TimeTableEntry * entry);
+	uint64_t 	get_epoch() { return epoch; };
+private:
+	void 		retire(uint64_t thd_id, void * ptr, EpochObjType type);
+	void 		reclaim(uint64_t thd_id);
+	bool 		try_advance();
+	epoch_shard * get_shard(uint64_t thd_id) { return &shards[thd_id % shard_cnt]; };
+
+	volatile uint64_t 	epoch;
+	char 				pad[CL_SIZE - sizeof(uint64_t)];
+	epoch_shard * 		shards;
+	uint64_t 			shard_cnt;
+};
+
+#endif
@@ -32,6 +32,13 @@
 #include "sequencer.h"
 #include "logger.h"
 #include "maat.h"
+#include "silo.h"
+#include "tictoc.h"
+#include "plock.h"
+#include "vll.h"
+#include "mvcc.h"
+#include "dl_detect.h"
+#include "epoch.h"
 
 mem_alloc mem_allocator;
 Stats stats;
@@ -41,6 +48,12 @@ Query_queue query_queue;
 Client_query_queue client_query_queue;
 OptCC occ_man;
 Maat maat_man;
+Silo silo_man;
+TicToc tictoc_man;
+Plock part_lock_man;
+VLLMan vll_man;
+Mvcc mvcc_man;
+DL_detect dl_detector;
 Transport tport_man;
 TxnManPool txn_man_pool;
 TxnPool txn_pool;
@@ -57,6 +70,7 @@ Client_txn client_man;
 Sequencer seq_man;
 Logger logger;
 TimeTable time_table;
+EpochManager epoch_man;
 
 bool volatile warmup_done = false;
 bool volatile enable_thread_mem_pool = false;
@@ -69,6 +83,7 @@ UInt32 g_ts_alloc = TS_ALLOC;
 bool g_key_order = KEY_ORDER;
 bool g_ts_batch_alloc = TS_BATCH_ALLOC;
 UInt32 g_ts_batch_num = TS_BATCH_NUM;
+UInt32 g_ts_hlc_lease = TS_HLC_LEASE;
 int32_t g_inflight_max = MAX_TXN_IN_FLIGHT;
 //int32_t g_inflight_max = MAX_TXN_IN_FLIGHT/NODE_CNT;
 uint64_t g_msg_size = MSG_SIZE_MAX;
@@ -88,6 +103,8 @@ double g_txn_write_perc = TXN_WRITE_PERC;
 double g_tup_read_perc = 1.0 - TUP_WRITE_PERC;
 double g_tup_write_perc = TUP_WRITE_PERC;
 double g_zipf_theta = ZIPF_THETA;
+double g_scan_perc = SCAN_PERC;
+UInt32 g_scan_len = SCAN_LEN;
 double g_data_perc = DATA_PERC;
 double g_access_perc = ACCESS_PERC;
 bool g_prt_lat_distr = PRT_LAT_DISTR;
@@ -111,8 +128,8 @@ UInt32 g_logger_thread_cnt = 0;
 #endif
 UInt32 g_send_thread_cnt = SEND_THREAD_CNT;
 #if CC_ALG == CALVIN
-// sequencer + scheduler thread
-UInt32 g_total_thread_cnt = g_thread_cnt + g_rem_thread_cnt + g_send_thread_cnt + g_abort_thread_cnt + g_logger_thread_cnt + 2;
+// sequencer + scheduler threads
+UInt32 g_total_thread_cnt = g_thread_cnt + g_rem_thread_cnt + g_send_thread_cnt + g_abort_thread_cnt + g_logger_thread_cnt + SEQ_THREAD_CNT + CALVIN_LOCK_THREAD_CNT;
 #else
 UInt32 g_total_thread_cnt = g_thread_cnt + g_rem_thread_cnt + g_send_thread_cnt + g_abort_thread_cnt + g_logger_thread_cnt;
 #endif
@@ -141,6 +158,8 @@ UInt32 g_network_delay = NETWORK_DELAY;
 UInt64 g_done_timer = DONE_TIMER;
 UInt64 g_batch_time_limit = BATCH_TIMER;
 UInt64 g_seq_batch_time_limit = SEQ_BATCH_TIMER;
+UInt64 g_seq_batch_min_time = SEQ_BATCH_MIN_TIMER;
+UInt64 g_seq_batch_max_txns = SEQ_BATCH_MAX_TXNS;
 UInt64 g_prog_timer = PROG_TIMER;
 UInt64 g_warmup_timer = WARMUP_TIMER;
 UInt64 g_msg_time_limit = MSG_TIME_LIMIT;
@@ -151,10 +170,10 @@ UInt64 g_log_flush_timeout = LOG_BUF_TIMEOUT;
 // MVCC
 UInt64 g_max_read_req = MAX_READ_REQ;
 UInt64 g_max_pre_req = MAX_PRE_REQ;
-UInt64 g_his_recycle_len = HIS_RECYCLE_LEN;
 
 // CALVIN
 UInt32 g_seq_thread_cnt = SEQ_THREAD_CNT;
+UInt32 g_calvin_lock_thread_cnt = CALVIN_LOCK_THREAD_CNT;
 
 double g_mpr = MPR;
 double g_mpitem = MPIR;
@@ -176,6 +195,7 @@ double g_perc_updatepart = PERC_PPS_UPDATEPART;
 // TPCC
 UInt32 g_num_wh = NUM_WH;
 double g_perc_payment = PERC_PAYMENT;
+double g_perc_delivery = PERC_DELIVERY;
 bool g_wh_update = WH_UPDATE;
 char * output_file = NULL;
 char * input_file = NULL;
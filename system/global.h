@@ -49,6 +49,17 @@
 #include "sim_manager.h"
 //#include "maat.h"
 
+#define IS_2PL (CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT)
+#if ISOLATION_LEVEL == READ_COMMITTED && !IS_2PL && CC_ALG != MVCC && CC_ALG != MAAT
+#error "READ_COMMITTED needs a 2PL CC_ALG, MVCC or MAAT"
+#endif
+#if ISOLATION_LEVEL == READ_UNCOMMITTED && !IS_2PL
+#error "READ_UNCOMMITTED needs a 2PL CC_ALG"
+#endif
+#if ISOLATION_LEVEL == SNAPSHOT && CC_ALG != MVCC
+#error "SNAPSHOT needs CC_ALG MVCC"
+#endif
+
 using namespace std;
 
 class mem_alloc;
@@ -58,6 +69,12 @@ class Manager;
 class Query_queue;
 class OptCC;
 class Maat;
+class Silo;
+class TicToc;
+class Plock;
+class VLLMan;
+class Mvcc;
+class DL_detect;
 class Transport;
 class Remote_query;
 class TxnManPool;
@@ -76,6 +93,7 @@ class Client_txn;
 class Sequencer;
 class Logger;
 class TimeTable;
+class EpochManager;
 
 typedef uint32_t UInt32;
 typedef int32_t SInt32;
@@ -95,6 +113,12 @@ extern Query_queue query_queue;
 extern Client_query_queue client_query_queue;
 extern OptCC occ_man;
 extern Maat maat_man;
+extern Silo silo_man;
+extern TicToc tictoc_man;
+extern Plock part_lock_man;
+extern VLLMan vll_man;
+extern Mvcc mvcc_man;
+extern DL_detect dl_detector;
 extern Transport tport_man;
 extern TxnManPool txn_man_pool;
 extern TxnPool txn_pool;
@@ -111,6 +135,7 @@ extern Client_txn client_man;
 extern Sequencer seq_man;
 extern Logger logger;
 extern TimeTable time_table;
+extern EpochManager epoch_man;
 
 extern bool volatile warmup_done;
 extern bool volatile enable_thread_mem_pool;
@@ -158,6 +183,7 @@ extern UInt32 g_ts_alloc;
 extern bool g_key_order;
 extern bool g_ts_batch_alloc;
 extern UInt32 g_ts_batch_num;
+extern UInt32 g_ts_hlc_lease;
 extern int32_t g_inflight_max;
 extern uint64_t g_msg_size;
 extern uint64_t g_log_buf_max;
@@ -171,6 +197,8 @@ extern UInt32 g_network_delay;
 extern UInt64 g_done_timer;
 extern UInt64 g_batch_time_limit;
 extern UInt64 g_seq_batch_time_limit;
+extern UInt64 g_seq_batch_min_time;
+extern UInt64 g_seq_batch_max_txns;
 extern UInt64 g_prog_timer;
 extern UInt64 g_warmup_timer;
 extern UInt64 g_msg_time_limit;
@@ -178,8 +206,6 @@ extern UInt64 g_msg_time_limit;
 // MVCC
 extern UInt64 g_max_read_req;
 extern UInt64 g_max_pre_req;
-extern UInt64 g_his_recycle_len;
-
 // YCSB
 extern UInt32 g_cc_alg;
 extern ts_t g_query_intvl;
@@ -190,6 +216,8 @@ extern double g_txn_write_perc;
 extern double g_tup_read_perc;
 extern double g_tup_write_perc;
 extern double g_zipf_theta;
+extern double g_scan_perc;
+extern UInt32 g_scan_len;
 extern double g_data_perc;
 extern double g_access_perc;
 extern UInt64 g_synth_table_size;
@@ -203,6 +231,7 @@ extern double g_mpitem;
 // TPCC
 extern UInt32 g_num_wh;
 extern double g_perc_payment;
+extern double g_perc_delivery;
 extern bool g_wh_update;
 extern char * output_file;
 extern char * input_file;
@@ -228,6 +257,7 @@ extern double g_perc_updatepart;
 
 // CALVIN
 extern UInt32 g_seq_thread_cnt;
+extern UInt32 g_calvin_lock_thread_cnt;
 
 // Replication
 extern UInt32 g_repl_type;
@@ -259,6 +289,9 @@ enum RemReqType {INIT_DONE=0,
     LOG_MSG_RSP,
     LOG_FLUSHED,
     CALVIN_ACK,
+    DL_GRAPH,
+    DL_ABORT,
+    RWOUND,
     NO_MSG};
 
 // Calvin
@@ -319,6 +352,8 @@ enum TsType {R_REQ = 0, W_REQ, P_REQ, XP_REQ};
 // index structure for specific purposes. (e.g. non-primary key access should use hash)
 #if (INDEX_STRUCT == IDX_BTREE)
 #define INDEX		index_btree
+#elif (INDEX_STRUCT == IDX_ART)
+#define INDEX		IndexArt
 #else  // IDX_HASH
 #define INDEX		IndexHash
 #endif
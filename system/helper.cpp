@@ -106,10 +106,9 @@ void init_client_globals() {
 /****************************************************/
 
 uint64_t get_wall_clock() {
-	timespec * tp = new timespec;
-  clock_gettime(CLOCK_REALTIME, tp);
-  uint64_t ret = tp->tv_sec * 1000000000 + tp->tv_nsec;
-  delete tp;
+	timespec tp;
+  clock_gettime(CLOCK_REALTIME, &tp);
+  uint64_t ret = tp.tv_sec * 1000000000 + tp.tv_nsec;
   return ret;
 }
 
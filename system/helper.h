@@ -70,6 +70,19 @@
 	__sync_fetch_and_add(&(dest), value)
 #define ATOM_SUB_FETCH(dest, value) \
 	__sync_sub_and_fetch(&(dest), value)
+#define MEM_BARRIER() \
+	__sync_synchronize()
+// keeps the compiler from reordering memory accesses across this point
+#define COMPILER_FENCE() \
+	__asm__ __volatile__("" ::: "memory")
+// hint for short busy-wait loops
+#if defined(__i386__) || defined(__x86_64__)
+#define SPIN_PAUSE() \
+	__asm__ __volatile__("pause" ::: "memory")
+#else
+#define SPIN_PAUSE() \
+	COMPILER_FENCE()
+#endif
 
 /************************************************/
 // ASSERT Helper
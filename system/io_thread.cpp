@@ -30,6 +30,7 @@
 #include "message.h"
 #include "client_txn.h"
 #include "work_queue.h"
+#include "dl_detect.h"
 
 void InputThread::setup() {
 
@@ -157,6 +158,15 @@ RC InputThread::server_recv_loop() {
         msgs->erase(msgs->begin());
         continue;
       }
+#if CC_ALG == DL_DETECT || CC_ALG == WOUND_WAIT
+      // not tied to a txn, so they do not go through the work queue
+      if(msg->rtype == DL_GRAPH || msg->rtype == DL_ABORT || msg->rtype == RWOUND) {
+        dl_detector.process(get_thd_id(),msg);
+        Message::release_message(msg);
+        msgs->erase(msgs->begin());
+        continue;
+      }
+#endif
 #if CC_ALG == CALVIN
       if(msg->rtype == CALVIN_ACK ||(msg->rtype == CL_QRY && ISCLIENTN(msg->get_return_id()))) {
         work_queue.sequencer_enqueue(get_thd_id(),msg);
@@ -37,7 +37,15 @@
 #include "abort_queue.h"
 #include "work_queue.h"
 #include "maat.h"
+#include "silo.h"
+#include "tictoc.h"
+#include "plock.h"
+#include "vll.h"
+#include "mvcc.h"
+#include "dl_detect.h"
+#include "epoch.h"
 #include "client_query.h"
+#include "mem_alloc.h"
 
 void network_test();
 void network_test_recv();
@@ -61,6 +69,7 @@ int main(int argc, char* argv[])
 {
 	// 0. initialize global data structure
 	parser(argc, argv);
+	mem_allocator.init();
 #if SEED != 0
   uint64_t seed = SEED + g_node_id;
 #else
@@ -161,6 +170,10 @@ int main(int argc, char* argv[])
   fflush(stdout);
   txn_table.init();
   printf("Done\n");
+  printf("Initializing epoch manager... ");
+  fflush(stdout);
+  epoch_man.init();
+  printf("Done\n");
 #if CC_ALG == CALVIN
   printf("Initializing sequencer... ");
   fflush(stdout);
@@ -202,7 +215,7 @@ int main(int argc, char* argv[])
     all_thd_cnt += 1; // logger thread
 #endif
 #if CC_ALG == CALVIN
-    all_thd_cnt += 2; // sequencer + scheduler thread
+    all_thd_cnt += g_seq_thread_cnt + g_calvin_lock_thread_cnt; // sequencer + scheduler threads
 #endif
     assert(all_thd_cnt == g_this_total_thread_cnt);
 	
@@ -217,8 +230,8 @@ int main(int argc, char* argv[])
     abort_thds = new AbortThread[1];
     log_thds = new LogThread[1];
 #if CC_ALG == CALVIN
-    calvin_lock_thds = new CalvinLockThread[1];
-    calvin_seq_thds = new CalvinSequencerThread[1];
+    calvin_lock_thds = new CalvinLockThread[g_calvin_lock_thread_cnt];
+    calvin_seq_thds = new CalvinSequencerThread[g_seq_thread_cnt];
 #endif
 	// query_queue should be the last one to be initialized!!!
 	// because it collects txn latency
@@ -230,6 +243,36 @@ int main(int argc, char* argv[])
     occ_man.init();
     printf("Done\n");
 #endif
+#if CC_ALG == SILO
+    printf("Initializing silo manager... ");
+    silo_man.init();
+    printf("Done\n");
+#endif
+#if CC_ALG == TICTOC
+    printf("Initializing tictoc manager... ");
+    tictoc_man.init();
+    printf("Done\n");
+#endif
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
+    printf("Initializing partition lock manager... ");
+    part_lock_man.init();
+    printf("Done\n");
+#endif
+#if CC_ALG == MVCC
+    printf("Initializing MVCC low-water mark... ");
+    mvcc_man.init();
+    printf("Done\n");
+#endif
+#if CC_ALG == VLL
+    printf("Initializing VLL manager... ");
+    vll_man.init();
+    printf("Done\n");
+#endif
+#if CC_ALG == DL_DETECT || CC_ALG == WOUND_WAIT
+    printf("Initializing deadlock detector... ");
+    dl_detector.init();
+    printf("Done\n");
+#endif
 
     /*
     printf("Initializing threads... ");
@@ -258,7 +301,7 @@ int main(int argc, char* argv[])
   for (uint64_t i = 0; i < wthd_cnt; i++) {
 #if SET_AFFINITY
       CPU_ZERO(&cpus);
-      CPU_SET(cpu_cnt, &cpus);
+      CPU_SET(mem_allocator.get_thd_cpu(cpu_cnt), &cpus);
       pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpus);
       cpu_cnt++;
 #endif
@@ -289,24 +332,28 @@ int main(int argc, char* argv[])
 #endif
 
 #if CC_ALG == CALVIN
+  for (uint64_t i = 0; i < g_calvin_lock_thread_cnt; i++) {
 #if SET_AFFINITY
 		CPU_ZERO(&cpus);
-    CPU_SET(cpu_cnt, &cpus);
+    CPU_SET(mem_allocator.get_thd_cpu(cpu_cnt), &cpus);
     pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpus);
 		cpu_cnt++;
 #endif
-
-  calvin_lock_thds[0].init(id,g_node_id,m_wl);
-  pthread_create(&p_thds[id++], &attr, run_thread, (void *)&calvin_lock_thds[0]);
+    calvin_lock_thds[i].init(id,g_node_id,m_wl);
+    calvin_lock_thds[i].lock_part = i;
+    pthread_create(&p_thds[id++], &attr, run_thread, (void *)&calvin_lock_thds[i]);
+  }
+  for (uint64_t i = 0; i < g_seq_thread_cnt; i++) {
 #if SET_AFFINITY
 		CPU_ZERO(&cpus);
-    CPU_SET(cpu_cnt, &cpus);
+    CPU_SET(mem_allocator.get_thd_cpu(cpu_cnt), &cpus);
     pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpus);
 		cpu_cnt++;
 #endif
-
-  calvin_seq_thds[0].init(id,g_node_id,m_wl);
-  pthread_create(&p_thds[id++], &attr, run_thread, (void *)&calvin_seq_thds[0]);
+    calvin_seq_thds[i].init(id,g_node_id,m_wl);
+    calvin_seq_thds[i].seq_id = i;
+    pthread_create(&p_thds[id++], &attr, run_thread, (void *)&calvin_seq_thds[i]);
+  }
 #endif
 
 
@@ -18,12 +18,11 @@
 #include "row.h"
 #include "txn.h"
 #include "pthread.h"
+#include "mem_alloc.h"
 //#include <jemallloc.h>
 
 void Manager::init() {
 	timestamp = 1;
-	last_min_ts_time = 0;
-	min_ts = 0; 
 	all_ts = (ts_t *) malloc(sizeof(ts_t) * (g_thread_cnt * g_node_cnt));
 	_all_txns = new TxnManager * [g_thread_cnt + g_rem_thread_cnt];
 	for (UInt32 i = 0; i < g_thread_cnt + g_rem_thread_cnt; i++) {
@@ -35,6 +34,13 @@ void Manager::init() {
 		pthread_mutex_init( &mutexes[i], NULL );
   for (UInt32 i = 0; i < g_thread_cnt * g_node_cnt; ++i)
       all_ts[i] = 0;
+	hlc_id_cnt = g_node_cnt * g_total_thread_cnt;
+	hlc_floor = 0;
+	hlc_leases = (hlc_lease *) mem_allocator.align_alloc(sizeof(hlc_lease) * g_total_thread_cnt);
+	for (UInt32 i = 0; i < g_total_thread_cnt; i++) {
+		hlc_leases[i].next = 0;
+		hlc_leases[i].end = 0;
+	}
 }
 
 uint64_t 
@@ -61,6 +67,23 @@ Manager::get_ts(uint64_t thread_id) {
 	case TS_CLOCK :
 		time = get_wall_clock() * (g_node_cnt + g_thread_cnt) + (g_node_id * g_thread_cnt + thread_id);
 		break;
+	case TS_HLC : {
+		// The (node, thread) part makes timestamps unique, so a thread
+		// advances its own clock and shares no written cache line
+		uint64_t pt = get_wall_clock() / 1000 - HLC_EPOCH_US;
+		hlc_lease & lease = hlc_leases[thread_id];
+		if (lease.next >= lease.end || pt >= lease.end) {
+			// catch up with the other nodes when the lease runs out
+			uint64_t floor = hlc_floor;
+			uint64_t start = max(max(lease.next, pt), floor);
+			lease.next = start;
+			lease.end = start + g_ts_hlc_lease;
+		}
+		uint64_t hlc = max(lease.next, pt);
+		lease.next = hlc + 1;
+		time = hlc * hlc_id_cnt + g_node_id * g_total_thread_cnt + thread_id;
+		break;
+	}
 	default :
 		assert(false);
 	}
@@ -68,15 +91,12 @@ Manager::get_ts(uint64_t thread_id) {
 	return time;
 }
 
-ts_t Manager::get_min_ts(uint64_t tid) {
-	uint64_t now = get_sys_clock();
-	if (now - last_min_ts_time > MIN_TS_INTVL) { 
-		last_min_ts_time = now;
-    uint64_t min = txn_table.get_min_ts(tid);
-    if(min > min_ts)
-		  min_ts = min;
-	} 
-	return min_ts;
+void Manager::update_ts(ts_t ts) {
+	assert(g_ts_alloc == TS_HLC);
+	uint64_t hlc = ts / hlc_id_cnt;
+	uint64_t floor = hlc_floor;
+	while (hlc > floor && !ATOM_CAS(hlc_floor, floor, hlc))
+		floor = hlc_floor;
 }
 
 void Manager::set_txn_man(TxnManager * txn) {
@@ -23,14 +23,25 @@
 class row_t;
 class TxnManager;
 
+// [TS_HLC] clock values are us since HLC_EPOCH, so that a value times the
+// number of threads in the system still fits into a timestamp
+#define HLC_EPOCH_US 	1577836800000000UL // 2020-01-01
+
+// [TS_HLC] the clock values [next, end) a thread may hand out without
+// looking at the node's clock floor
+struct hlc_lease {
+	uint64_t 	next;
+	uint64_t 	end;
+	char 		pad[CL_SIZE - sizeof(uint64_t) * 2];
+};
+
 class Manager {
 public:
 	void 			init();
 	// returns the next timestamp.
 	ts_t			get_ts(uint64_t thread_id);
-
-	// For MVCC. To calculate the min active ts in the system
-	ts_t 			get_min_ts(uint64_t tid = 0);
+	// [TS_HLC] moves the clock floor up to a timestamp from another node
+	void 			update_ts(ts_t ts);
 
 	// HACK! the following mutexes are used to model a centralized
 	// lock/timestamp manager. 
@@ -45,9 +56,13 @@ private:
 	pthread_mutex_t mutexes[BUCKET_CNT];
 	uint64_t 		hash(row_t * row);
 	ts_t * volatile all_ts;
+	// [TS_HLC] A timestamp is clock * hlc_id_cnt + (node, thread). The
+	// floor is the highest clock seen from another node; threads only read
+	// it when they renew their lease
+	hlc_lease * 	hlc_leases;
+	uint64_t 		hlc_id_cnt;
+	volatile uint64_t hlc_floor;
 	TxnManager ** 		_all_txns;
-	ts_t			last_min_ts_time;
-	ts_t			min_ts;
 };
 
 #endif
@@ -18,6 +18,17 @@
 #include "helper.h"
 #include "global.h"
 #include "jemalloc/jemalloc.h"
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// mbind(2) memory policy, so that we do not depend on libnuma
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 	1
+#endif
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE 	(1 << 1)
+#endif
+#define MAX_NUMA_NODE 	64
 
 //#define N_MALLOC
 
@@ -44,9 +55,19 @@ void * mem_alloc::alloc(uint64_t size) {
 	return ptr;
 }
 
+// returns a cache-line aligned block whose size is rounded up to whole lines
 void * mem_alloc::align_alloc(uint64_t size) {
-  uint64_t aligned_size = size + CL_SIZE - (size % CL_SIZE);
-  return alloc(aligned_size);
+	void * ptr;
+  uint64_t aligned_size = (size + CL_SIZE - 1) / CL_SIZE * CL_SIZE;
+#ifdef N_MALLOC
+  if (posix_memalign(&ptr, CL_SIZE, aligned_size) != 0)
+    ptr = NULL;
+#else
+  ptr = je_aligned_alloc(CL_SIZE, aligned_size);
+#endif
+  DEBUG_M("align_alloc %ld 0x%lx\n",aligned_size,(uint64_t)ptr);
+  assert(ptr != NULL);
+	return ptr;
 }
 
 
@@ -60,4 +81,110 @@ void * mem_alloc::realloc(void * ptr, uint64_t size) {
 	return _ptr;
 }
 
+// parses a sysfs cpu list such as "0-7,16-23"
+static uint32_t parse_cpulist(const char * path, uint32_t * out, uint32_t max) {
+	FILE * f = fopen(path, "r");
+	if (f == NULL)
+		return 0;
+	uint32_t cnt = 0;
+	unsigned lo, hi;
+	while (fscanf(f, "%u", &lo) == 1) {
+		hi = lo;
+		int c = fgetc(f);
+		if (c == '-') {
+			if (fscanf(f, "%u", &hi) != 1)
+				break;
+			c = fgetc(f);
+		}
+		for (unsigned cpu = lo; cpu <= hi && cnt < max; cpu++)
+			out[cnt++] = cpu;
+		if (c != ',')
+			break;
+	}
+	fclose(f);
+	return cnt;
+}
+
+void mem_alloc::init() {
+	uint32_t max_cpu = sysconf(_SC_NPROCESSORS_CONF);
+	cpus = new uint32_t [max_cpu];
+	cpu_node = new uint32_t [max_cpu];
+	cpu_cnt = 0;
+	node_cnt = 0;
+	char path[128];
+	while (node_cnt < MAX_NUMA_NODE && cpu_cnt < max_cpu) {
+		sprintf(path, "/sys/devices/system/node/node%d/cpulist", node_cnt);
+		uint32_t cnt = parse_cpulist(path, &cpus[cpu_cnt], max_cpu - cpu_cnt);
+		if (cnt == 0)
+			break;
+		for (uint32_t i = cpu_cnt; i < cpu_cnt + cnt; i++)
+			cpu_node[i] = node_cnt;
+		cpu_cnt += cnt;
+		node_cnt ++;
+	}
+	if (node_cnt == 0) {
+		// no NUMA information. treat the machine as one node
+		node_cnt = 1;
+		for (cpu_cnt = 0; cpu_cnt < max_cpu; cpu_cnt++) {
+			cpus[cpu_cnt] = cpu_cnt;
+			cpu_node[cpu_cnt] = 0;
+		}
+	}
+	arenas = NULL;
+	if (g_part_alloc) {
+		arenas = new unsigned [node_cnt];
+		for (uint32_t n = 0; n < node_cnt; n++) {
+#ifdef N_MALLOC
+			arenas[n] = 0;
+#else
+			size_t sz = sizeof(unsigned);
+			int ret __attribute__ ((unused));
+			ret = je_mallctl("arenas.create", &arenas[n], &sz, NULL, 0);
+			assert(ret == 0);
+#endif
+		}
+	}
+	printf("NUMA nodes %d, cpus %d\n", node_cnt, cpu_cnt);
+}
+
+uint32_t mem_alloc::get_thd_cpu(uint64_t thd_id) {
+	return cpus[thd_id % cpu_cnt];
+}
+
+uint32_t mem_alloc::get_part_node(uint64_t part_id) {
+	uint64_t owner = GET_PART_ID_IDX(part_id) % g_thread_cnt;
+	return cpu_node[owner % cpu_cnt];
+}
+
+void * mem_alloc::part_alloc(uint64_t size, uint64_t part_id) {
+	if (!g_part_alloc || arenas == NULL)
+		return align_alloc(size);
+	uint32_t node = get_part_node(part_id);
+	void * ptr;
+  uint64_t aligned_size = (size + CL_SIZE - 1) / CL_SIZE * CL_SIZE;
+#ifdef N_MALLOC
+  if (posix_memalign(&ptr, CL_SIZE, aligned_size) != 0)
+    ptr = NULL;
+#else
+  // the arena only serves this node, so its pages can be bound as a whole
+  ptr = je_mallocx(aligned_size, MALLOCX_ARENA(arenas[node]) 
+      | MALLOCX_ALIGN(CL_SIZE) | MALLOCX_TCACHE_NONE);
+#endif
+  DEBUG_M("part_alloc %ld 0x%lx node %d\n",aligned_size,(uint64_t)ptr,node);
+  assert(ptr != NULL);
+	bind(ptr, aligned_size, node);
+	return ptr;
+}
 
+// prefers node for the pages that lie completely inside the block
+void mem_alloc::bind(void * ptr, uint64_t size, uint32_t node) {
+	if (node_cnt <= 1)
+		return;
+	uint64_t page = sysconf(_SC_PAGESIZE);
+	uint64_t start = ((uint64_t) ptr + page - 1) / page * page;
+	uint64_t end = ((uint64_t) ptr + size) / page * page;
+	if (end <= start)
+		return;
+	unsigned long mask = 1UL << node;
+	syscall(SYS_mbind, start, end - start, MPOL_PREFERRED, &mask, MAX_NUMA_NODE, MPOL_MF_MOVE);
+}
@@ -21,10 +21,29 @@
 
 class mem_alloc {
 public:
+    // reads the NUMA topology. With PART_ALLOC, also creates one arena per node.
+    void init();
     void * alloc(uint64_t size);
     void * align_alloc(uint64_t size);
+    // cache-line aligned block on the NUMA node of the partition. Same as 
+    // align_alloc unless PART_ALLOC is on.
+    void * part_alloc(uint64_t size, uint64_t part_id);
     void * realloc(void * ptr, uint64_t size);
     void free(void * block, uint64_t size);
+
+    // Worker threads are pinned one NUMA node after another, and local 
+    // partition i is owned by worker thread i % g_thread_cnt.
+    uint32_t get_thd_cpu(uint64_t thd_id);
+    uint32_t get_part_node(uint64_t part_id);
+private:
+    void bind(void * ptr, uint64_t size, uint32_t node);
+
+    uint32_t node_cnt;
+    uint32_t cpu_cnt;
+    // cpus in node order, and the node of each of them
+    uint32_t * cpus;
+    uint32_t * cpu_node;
+    unsigned * arenas;
 };
 
 #endif
@@ -65,10 +65,13 @@ void print_usage() {
 	printf("\t-zipfFLOAT     ; ZIPF_THETA\n");
 	printf("\t-sINT       ; SYNTH_TABLE_SIZE\n");
 	printf("\t-rpqINT       ; REQ_PER_QUERY\n");
+	printf("\t-scpFLOAT       ; SCAN_PERC\n");
+	printf("\t-sclINT       ; SCAN_LEN\n");
 	printf("\t-fINT       ; FIELD_PER_TUPLE\n");
 	printf("  [TPCC]:\n");
 	printf("\t-whINT       ; NUM_WH\n");
 	printf("\t-ppFLOAT    ; PERC_PAYMENT\n");
+	printf("\t-pdFLOAT    ; PERC_DELIVERY\n");
 	printf("\t-upINT      ; WH_UPDATE\n");
   
 }
@@ -113,6 +116,10 @@ void parser(int argc, char * argv[]) {
       g_part_per_txn = atoi( &argv[i][4] );
     else if (argv[i][1] == 'r' && argv[i][2] == 'p' && argv[i][3] == 'q')
       g_req_per_query = atoi( &argv[i][4] );
+    else if (argv[i][1] == 's' && argv[i][2] == 'c' && argv[i][3] == 'p')
+      g_scan_perc = atof( &argv[i][4] );
+    else if (argv[i][1] == 's' && argv[i][2] == 'c' && argv[i][3] == 'l')
+      g_scan_len = atoi( &argv[i][4] );
     else if (argv[i][1] == 'c' && argv[i][2] == 'n')
       g_client_node_cnt = atoi( &argv[i][3] );
     else if (argv[i][1] == 't' && argv[i][2] == 'r')
@@ -127,6 +134,8 @@ void parser(int argc, char * argv[]) {
 			txn_file = argv[++i];
     else if (argv[i][1] == 'p' && argv[i][2] == 'p')
       g_perc_payment = atof( &argv[i][3] );
+    else if (argv[i][1] == 'p' && argv[i][2] == 'd')
+      g_perc_delivery = atof( &argv[i][3] );
     else if (argv[i][1] == 'u' && argv[i][2] == 'p')
       g_wh_update = atoi( &argv[i][3] );
     else if (argv[i][1] == 'd' && argv[i][2] == 'p')
@@ -183,7 +192,7 @@ void parser(int argc, char * argv[]) {
   g_total_thread_cnt += g_logger_thread_cnt; // logger thread
 #endif
 #if CC_ALG == CALVIN
-    g_total_thread_cnt += 2; // sequencer + scheduler thread
+    g_total_thread_cnt += g_seq_thread_cnt + g_calvin_lock_thread_cnt; // sequencer + scheduler threads
   // Remove abort thread
   g_abort_thread_cnt = 0;
   g_total_thread_cnt -= 1;
@@ -222,12 +231,15 @@ void parser(int argc, char * argv[]) {
 			printf("g_mpitem %f\n",g_mpitem );
       printf("g_part_per_txn %d\n",g_part_per_txn );
       printf("g_req_per_query %d\n",g_req_per_query );
+      printf("g_scan_perc %f\n",g_scan_perc );
+      printf("g_scan_len %d\n",g_scan_len );
       printf("g_client_node_cnt %d\n",g_client_node_cnt );
       printf("g_rem_thread_cnt %d\n",g_rem_thread_cnt );
       printf("g_send_thread_cnt %d\n",g_send_thread_cnt );
       printf("g_client_thread_cnt %d\n",g_client_thread_cnt );
       printf("g_num_wh %d\n",g_num_wh );
       printf("g_perc_payment %f\n",g_perc_payment );
+      printf("g_perc_delivery %f\n",g_perc_delivery );
       printf("g_wh_update %d\n",g_wh_update );
       printf("g_part_cnt %d\n",g_part_cnt );
       printf("g_node_cnt %d\n",g_node_cnt );
@@ -254,6 +266,8 @@ void parser(int argc, char * argv[]) {
       printf("g_total_client_thread_cnt %d\n",g_total_client_thread_cnt);
       printf("g_total_node_cnt %d\n",g_total_node_cnt);
       printf("g_seq_batch_time_limit %ld\n",g_seq_batch_time_limit);
+      printf("g_seq_batch_min_time %ld\n",g_seq_batch_min_time);
+      printf("g_seq_batch_max_txns %ld\n",g_seq_batch_max_txns);
 
     // Initialize client-specific globals
     if (g_node_id >= g_node_cnt)
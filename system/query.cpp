@@ -97,6 +97,7 @@ void BaseQuery::clear() {
   partitions_touched.clear();
   active_nodes.clear();
   participant_nodes.clear();
+  recon_keys.clear();
 } 
 
 void BaseQuery::release() { 
@@ -104,4 +105,5 @@ void BaseQuery::release() {
   partitions_touched.release();
   active_nodes.release();
   participant_nodes.release();
+  recon_keys.release();
 } 
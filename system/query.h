@@ -35,7 +35,12 @@ public:
     uint64_t waiting_time;
     void clear();
     void release();
+    // [CALVIN] OLLP. A dependent txn derives part of its read/write set
+    // from the rows it reads. Its reconnaissance run fills recon_keys
+    // without locking; the real run locks by them and aborts if a lookup
+    // no longer matches
     virtual bool isReconQuery() {return false;}
+    Array<uint64_t> recon_keys;
 
     // Prevent unnecessary remote messages
     Array<uint64_t> partitions;
@@ -37,11 +37,27 @@ void Sequencer::init(Workload * wl) {
   last_time_batch = 0;
   wl_head = NULL;
   wl_tail = NULL;
-  fill_queue = new boost::lockfree::queue<Message*, boost::lockfree::capacity<65526> > [g_node_cnt];
+  pending = new std::vector<seq_entry> [g_seq_thread_cnt];
+  pending_mtx = new pthread_mutex_t [g_seq_thread_cnt];
+  for (uint64_t i = 0; i < g_seq_thread_cnt; i++) {
+    pthread_mutex_init(&pending_mtx[i], NULL);
+  }
+  pending_cnt = 0;
+  pthread_mutex_init(&wl_mtx, NULL);
+  arrival_rate = 0;
+  // every node's first epoch is one tick; the schedulers start there
+  epoch_ticks = 1;
+  last_epoch_time = 0;
 }
 
-// Assumes 1 thread does sequencer work
-void Sequencer::process_ack(Message * msg, uint64_t thd_id) {
+void Sequencer::process_ack(Message * msg, uint64_t thd_id, uint64_t seq_id) {
+  uint64_t prof_stat = get_sys_clock();
+  uint64_t id = msg->get_txn_id() / g_node_cnt;
+  qlite txn;
+  uint64_t batch_send_time = 0;
+  bool txn_done = false;
+
+  pthread_mutex_lock(&wl_mtx);
   qlite_ll * en = wl_head;
   while(en != NULL && en->epoch != msg->get_batch_id()) {
     en = en->next;
@@ -50,85 +66,108 @@ void Sequencer::process_ack(Message * msg, uint64_t thd_id) {
   qlite * wait_list = en->list;
   assert(wait_list != NULL);
   assert(en->txns_left > 0);
-
-  uint64_t id = msg->get_txn_id() / g_node_cnt;
-  uint64_t prof_stat = get_sys_clock();
   assert(wait_list[id].server_ack_cnt > 0);
 
+  // Gather the keys each participant predicted during reconnaissance. The
+  // msg may still be in use by other participants, so they only go into it
+  // once every ack is in
+  AckMessage * ack = (AckMessage*)msg;
+  if (ack->recon_keys.size() > 0) {
+      Array<uint64_t> keys;
+      keys.init(wait_list[id].recon_keys.size() + ack->recon_keys.size());
+      keys.append(wait_list[id].recon_keys);
+      keys.append(ack->recon_keys);
+      wait_list[id].recon_keys.release();
+      wait_list[id].recon_keys = keys;
+  }
+
   // Decrement the number of acks needed for this txn
-  uint32_t query_acks_left = ATOM_SUB_FETCH(wait_list[id].server_ack_cnt, 1);
+  uint32_t query_acks_left = --wait_list[id].server_ack_cnt;
 
   if (wait_list[id].skew_startts == 0) {
       wait_list[id].skew_startts = get_sys_clock();
   }
 
   if (query_acks_left == 0) {
+      txn_done = true;
+      txn = wait_list[id];
+      batch_send_time = en->batch_send_time;
       en->txns_left--;
-      ATOM_FETCH_ADD(total_txns_finished,1);
-      INC_STATS(thd_id,seq_txn_cnt,1);
-      // free msg, queries
-#if WORKLOAD == YCSB
-      YCSBClientQueryMessage* cl_msg = (YCSBClientQueryMessage*)wait_list[id].msg;
-      for(uint64_t i = 0; i < cl_msg->requests.size(); i++) {
-          DEBUG_M("Sequencer::process_ack() ycsb_request free\n");
-          mem_allocator.free(cl_msg->requests[i],sizeof(ycsb_request));
-      }
-#elif WORKLOAD == TPCC
-      TPCCClientQueryMessage* cl_msg = (TPCCClientQueryMessage*)wait_list[id].msg;
-      if(cl_msg->txn_type == TPCC_NEW_ORDER) {
-          for(uint64_t i = 0; i < cl_msg->items.size(); i++) {
-              DEBUG_M("Sequencer::process_ack() items free\n");
-              mem_allocator.free(cl_msg->items[i],sizeof(Item_no));
-          }
+      // If we have all acks for this batch, the wait list is done
+      if (en->txns_left == 0) {
+          DEBUG("FINISHED BATCH %ld\n",en->epoch);
+          LIST_REMOVE_HT(en,wl_head,wl_tail);
+          mem_allocator.free(en->list,sizeof(qlite) * en->max_size);
+          mem_allocator.free(en,sizeof(qlite_ll));
       }
-#elif WORKLOAD == PPS
-      PPSClientQueryMessage* cl_msg = (PPSClientQueryMessage*)wait_list[id].msg;
+  }
+  pthread_mutex_unlock(&wl_mtx);
 
-#endif
-#if WORKLOAD == PPS
-      if ( WORKLOAD == PPS && CC_ALG == CALVIN && ((cl_msg->txn_type == PPS_GETPARTBYSUPPLIER) ||
-              (cl_msg->txn_type == PPS_GETPARTBYPRODUCT) ||
-              (cl_msg->txn_type == PPS_ORDERPRODUCT))
-              && (cl_msg->recon || ((AckMessage*)msg)->rc == Abort)) {
-          int abort_cnt = wait_list[id].abort_cnt;
+  if (txn_done) {
+      ATOM_FETCH_ADD(total_txns_finished,1);
+      INC_STATS(thd_id,seq_txn_cnt,1);
+      ClientQueryMessage* cl_msg = (ClientQueryMessage*)txn.msg;
+      if (cl_msg->isReconQuery() && (cl_msg->recon || ((AckMessage*)msg)->rc == Abort)) {
+          // OLLP: run the txn for real with the predicted keys, or predict
+          // them again if they turned out wrong
+          int abort_cnt = txn.abort_cnt;
           if (cl_msg->recon) {
-              // Copy over part keys
-              cl_msg->part_keys.copy( ((AckMessage*)msg)->part_keys);
+              cl_msg->recon_keys.release();
+              cl_msg->recon_keys = txn.recon_keys;
+              cl_msg->recon = false;
               DEBUG("Finished RECON (%ld,%ld)\n",msg->get_txn_id(),msg->get_batch_id());
           }
           else {
-              uint64_t timespan = get_sys_clock() - wait_list[id].seq_startts;
+              uint64_t timespan = get_sys_clock() - txn.seq_startts;
               if (warmup_done) {
                 INC_STATS_ARR(0,start_abort_commit_latency, timespan);
               }
-              cl_msg->part_keys.clear();
+              txn.recon_keys.release();
+              cl_msg->recon_keys.clear();
+              cl_msg->recon = true;
               DEBUG("Aborted (%ld,%ld)\n",msg->get_txn_id(),msg->get_batch_id());
               INC_STATS(0,total_txn_abort_cnt,1);
               abort_cnt++;
           }
 
-          cl_msg->return_node_id = wait_list[id].client_id;
-          wait_list[id].total_batch_time += en->batch_send_time - wait_list[id].seq_startts;
+          cl_msg->return_node_id = txn.client_id;
+          txn.total_batch_time += batch_send_time - txn.seq_startts;
           // restart
-          process_txn(cl_msg, thd_id, wait_list[id].seq_first_startts, wait_list[id].seq_startts, wait_list[id].total_batch_time, abort_cnt);
+          process_txn(cl_msg, thd_id, seq_id, txn.seq_first_startts, txn.seq_startts, txn.total_batch_time, abort_cnt);
       }
       else {
+          txn.recon_keys.release();
+          // free msg, queries
+#if WORKLOAD == YCSB
+          YCSBClientQueryMessage* ycsb_msg = (YCSBClientQueryMessage*)cl_msg;
+          for(uint64_t i = 0; i < ycsb_msg->requests.size(); i++) {
+              DEBUG_M("Sequencer::process_ack() ycsb_request free\n");
+              mem_allocator.free(ycsb_msg->requests[i],sizeof(ycsb_request));
+          }
+#elif WORKLOAD == TPCC
+          TPCCClientQueryMessage* tpcc_msg = (TPCCClientQueryMessage*)cl_msg;
+          if(tpcc_msg->txn_type == TPCC_NEW_ORDER) {
+              for(uint64_t i = 0; i < tpcc_msg->items.size(); i++) {
+                  DEBUG_M("Sequencer::process_ack() items free\n");
+                  mem_allocator.free(tpcc_msg->items[i],sizeof(Item_no));
+              }
+          }
 #endif
           uint64_t curr_clock = get_sys_clock();
-          uint64_t timespan = curr_clock - wait_list[id].seq_first_startts;
-          uint64_t timespan2 = curr_clock - wait_list[id].seq_startts;
-          uint64_t skew_timespan = get_sys_clock() - wait_list[id].skew_startts;
-          wait_list[id].total_batch_time += en->batch_send_time - wait_list[id].seq_startts;
+          uint64_t timespan = curr_clock - txn.seq_first_startts;
+          uint64_t timespan2 = curr_clock - txn.seq_startts;
+          uint64_t skew_timespan = get_sys_clock() - txn.skew_startts;
+          txn.total_batch_time += batch_send_time - txn.seq_startts;
           if (warmup_done) {
             INC_STATS_ARR(0,first_start_commit_latency, timespan);
             INC_STATS_ARR(0,last_start_commit_latency, timespan2);
             INC_STATS_ARR(0,start_abort_commit_latency, timespan2);
           }
-          if (wait_list[id].abort_cnt > 0) {
+          if (txn.abort_cnt > 0) {
               INC_STATS(0,unique_txn_abort_cnt,1);
           }
 
-    INC_STATS(0,lat_l_loc_msg_queue_time,wait_list[id].total_batch_time);
+    INC_STATS(0,lat_l_loc_msg_queue_time,txn.total_batch_time);
     INC_STATS(0,lat_l_loc_process_time,skew_timespan);
 
     INC_STATS(0,lat_short_work_queue_time,msg->lat_work_queue_time);
@@ -145,71 +184,40 @@ void Sequencer::process_ack(Message * msg, uint64_t thd_id) {
           */
       INC_STATS(0,lat_short_network_time,msg->lat_network_time);
     }
-    INC_STATS(0,lat_short_batch_time,wait_list[id].total_batch_time);
+    INC_STATS(0,lat_short_batch_time,txn.total_batch_time);
 
           PRINT_LATENCY("lat_l_seq %ld %ld %d %f %f %f\n"
                   , msg->get_txn_id()
                   , msg->get_batch_id()
-                  , wait_list[id].abort_cnt
+                  , txn.abort_cnt
                   , (double) timespan / BILLION
                   , (double) skew_timespan / BILLION
-                  , (double) wait_list[id].total_batch_time / BILLION
+                  , (double) txn.total_batch_time / BILLION
                   );
 
           cl_msg->release();
 
           ClientResponseMessage * rsp_msg = (ClientResponseMessage*)Message::create_message(msg->get_txn_id(),CL_RSP);
-          rsp_msg->client_startts = wait_list[id].client_startts;
-          msg_queue.enqueue(thd_id,rsp_msg,wait_list[id].client_id);
-#if WORKLOAD == PPS
+          rsp_msg->client_startts = txn.client_startts;
+          msg_queue.enqueue(thd_id,rsp_msg,txn.client_id);
       }
-#endif
 
       INC_STATS(thd_id,seq_complete_cnt,1);
 
   }
 
-  // If we have all acks for this batch, send qry responses to all clients
-  if (en->txns_left == 0) {
-      DEBUG("FINISHED BATCH %ld\n",en->epoch);
-      LIST_REMOVE_HT(en,wl_head,wl_tail);
-      mem_allocator.free(en->list,sizeof(qlite) * en->max_size);
-      mem_allocator.free(en,sizeof(qlite_ll));
-
-  }
   INC_STATS(thd_id,seq_ack_time,get_sys_clock() - prof_stat);
 }
 
-// Assumes 1 thread does sequencer work
-void Sequencer::process_txn( Message * msg,uint64_t thd_id, uint64_t early_start, uint64_t last_start, uint64_t wait_time, uint32_t abort_cnt) {
+void Sequencer::process_txn( Message * msg,uint64_t thd_id, uint64_t seq_id, uint64_t early_start, uint64_t last_start, uint64_t wait_time, uint32_t abort_cnt) {
 
     uint64_t starttime = get_sys_clock();
     DEBUG("SEQ Processing msg\n");
-    qlite_ll * en = wl_tail;
-
-    // LL is potentially a bottleneck here
-    if(!en || en->epoch != simulation->get_seq_epoch()+1) {
-      DEBUG("SEQ new wait list for epoch %ld\n",simulation->get_seq_epoch()+1);
-      // First txn of new wait list
-      en = (qlite_ll *) mem_allocator.alloc(sizeof(qlite_ll));
-      en->epoch = simulation->get_seq_epoch()+1;
-      en->max_size = 1000;
-      en->size = 0;
-      en->txns_left = 0;
-      en->list = (qlite *) mem_allocator.alloc(sizeof(qlite) * en->max_size);
-      LIST_PUT_TAIL(wl_head,wl_tail,en)
-    }
-    if(en->size == en->max_size) {
-      en->max_size *= 2;
-      en->list = (qlite *) mem_allocator.realloc(en->list,sizeof(qlite) * en->max_size);
-    }
 
-    txnid_t txn_id = g_node_id + g_node_cnt * next_txn_id;
-    next_txn_id++;
-    uint64_t id = txn_id / g_node_cnt;
-    msg->batch_id = en->epoch;
-    msg->txn_id = txn_id;
-    assert(txn_id != UINT64_MAX);
+    ClientQueryMessage* cl_msg = (ClientQueryMessage*)msg;
+    if (early_start == 0) {
+        cl_msg->recon = cl_msg->isReconQuery();
+    }
 
 #if WORKLOAD == YCSB
     std::set<uint64_t> participants = YCSBQuery::participants(msg,_wl);
@@ -218,59 +226,24 @@ void Sequencer::process_txn( Message * msg,uint64_t thd_id, uint64_t early_start
 #elif WORKLOAD == PPS
     std::set<uint64_t> participants = PPSQuery::participants(msg,_wl);
 #endif
-    uint32_t server_ack_cnt = participants.size();
-    assert(server_ack_cnt > 0);
+    assert(participants.size() > 0);
     assert(ISCLIENTN(msg->get_return_id()));
-    en->list[id].client_id = msg->get_return_id();
-    en->list[id].client_startts = ((ClientQueryMessage*)msg)->client_startts;
-    //en->list[id].seq_startts = get_sys_clock();
-
-    en->list[id].total_batch_time = wait_time;
-    en->list[id].abort_cnt = abort_cnt;
-    en->list[id].skew_startts = 0;
-    en->list[id].server_ack_cnt = server_ack_cnt;
-    en->list[id].msg = msg;
-    en->size++;
-    en->txns_left++;
-    // Note: Modifying msg!
-    msg->return_node_id = g_node_id;
-    msg->lat_network_time = 0;
-    msg->lat_other_time = 0;
-#if CC_ALG == CALVIN && WORKLOAD == PPS
-    PPSClientQueryMessage* cl_msg = (PPSClientQueryMessage*) msg;
-    if (cl_msg->txn_type == PPS_GETPARTBYSUPPLIER ||
-            cl_msg->txn_type == PPS_GETPARTBYPRODUCT ||
-            cl_msg->txn_type == PPS_ORDERPRODUCT) {
-        if (cl_msg->part_keys.size() == 0) {
-            cl_msg->recon = true;
-            en->list[id].seq_startts = get_sys_clock();
-        }
-        else {
-            cl_msg->recon = false;
-            en->list[id].seq_startts = last_time;
-        }
 
-    }
-    else {
-        cl_msg->recon = false;
-        en->list[id].seq_startts = get_sys_clock();
-    }
-#else
-    en->list[id].seq_startts = get_sys_clock();
-#endif
-    if (early_start == 0) {
-        en->list[id].seq_first_startts = en->list[id].seq_startts;
-    } else {
-        en->list[id].seq_first_startts = early_start;
-    }
-    assert(en->size == en->txns_left);
-    assert(en->size <= ((uint64_t)g_inflight_max * g_node_cnt));
-
-    // Add new txn to fill queue
-    for(auto participant = participants.begin(); participant != participants.end(); participant++) {
-      DEBUG("SEQ adding (%ld,%ld) to fill queue (recon: %d)\n",msg->get_txn_id(),msg->get_batch_id(),((PPSClientQueryMessage*)msg)->recon);
-      while(!fill_queue[*participant].push(msg) && !simulation->is_done()) {}
-    }
+    // A dependent txn first runs as reconnaissance; its rerun keeps the
+    // start time of the recon run
+    uint64_t seq_startts = (early_start != 0 && !cl_msg->recon) ? last_start : get_sys_clock();
+
+    pthread_mutex_lock(&pending_mtx[seq_id]);
+    pending[seq_id].push_back(seq_entry());
+    seq_entry & en = pending[seq_id].back();
+    en.msg = msg;
+    en.participants.swap(participants);
+    en.seq_startts = seq_startts;
+    en.seq_first_startts = early_start == 0 ? seq_startts : early_start;
+    en.total_batch_time = wait_time;
+    en.abort_cnt = abort_cnt;
+    pthread_mutex_unlock(&pending_mtx[seq_id]);
+    ATOM_ADD(pending_cnt,1);
 
 	INC_STATS(thd_id,seq_process_cnt,1);
 	INC_STATS(thd_id,seq_process_time,get_sys_clock() - starttime);
@@ -278,33 +251,132 @@ void Sequencer::process_txn( Message * msg,uint64_t thd_id, uint64_t early_start
 
 }
 
+bool Sequencer::is_batch_ready() {
+  return get_wall_clock() - simulation->last_seq_epoch_time >= epoch_ticks * g_seq_batch_min_time;
+}
+
+// The epoch length is the latency target scaled by how full an epoch of
+// that length would be at the current arrival rate. Light load gets short
+// epochs and low latency; near SEQ_BATCH_MAX_TXNS it approaches the target.
+// The length is rounded up to whole ticks of the shared epoch grid, and the
+// RDONE of an epoch announces it, so the other nodes' schedulers skip this
+// node for the epochs in between.
+void Sequencer::update_epoch_len(uint64_t txn_cnt, uint64_t epoch_time) {
+  if (epoch_time == 0)
+    return;
+  double rate = (double) txn_cnt / epoch_time;
+  arrival_rate = arrival_rate == 0 ? rate : (arrival_rate + rate) / 2;
+  double target = (double) g_seq_batch_time_limit;
+  double len = arrival_rate * target * target / g_seq_batch_max_txns;
+  if (len < g_seq_batch_min_time)
+    len = g_seq_batch_min_time;
+  if (len > target)
+    len = target;
+  epoch_ticks = ((uint64_t) len + g_seq_batch_min_time - 1) / g_seq_batch_min_time;
+}
 
-// Assumes 1 thread does sequencer work
+// Closes the current epoch: orders the txns every sequencer thread
+// received since the last one and sends them to their participants
 void Sequencer::send_next_batch(uint64_t thd_id) {
   uint64_t prof_stat = get_sys_clock();
-  qlite_ll * en = wl_tail;
-  bool empty = true;
-  if(en && en->epoch == simulation->get_seq_epoch()) {
-    DEBUG("SEND NEXT BATCH %ld [%ld,%ld] %ld\n",thd_id,simulation->get_seq_epoch(),en->epoch,en->size);
-    empty = false;
+  simulation->advance_seq_epoch(epoch_ticks);
+  uint64_t epoch = simulation->get_seq_epoch();
+  std::vector<seq_entry> * batch = new std::vector<seq_entry> [g_seq_thread_cnt];
+  uint64_t txn_cnt = 0;
+  // An epoch takes at most SEQ_BATCH_MAX_TXNS txns so the schedulers never
+  // get a burst; the rest wait for the next one. The first thread to take
+  // from rotates so none of them is always cut off
+  for (uint64_t k = 0; k < g_seq_thread_cnt; k++) {
+    uint64_t i = (epoch + k) % g_seq_thread_cnt;
+    pthread_mutex_lock(&pending_mtx[i]);
+    uint64_t take = pending[i].size();
+    if (txn_cnt + take > g_seq_batch_max_txns)
+      take = g_seq_batch_max_txns - txn_cnt;
+    if (take == pending[i].size()) {
+      batch[i].swap(pending[i]);
+    } else {
+      batch[i].assign(pending[i].begin(), pending[i].begin() + take);
+      pending[i].erase(pending[i].begin(), pending[i].begin() + take);
+    }
+    pthread_mutex_unlock(&pending_mtx[i]);
+    txn_cnt += take;
+  }
+  ATOM_SUB(pending_cnt,txn_cnt);
 
+  uint64_t now = get_wall_clock();
+  if(last_epoch_time > 0) {
+    update_epoch_len(txn_cnt,now - last_epoch_time);
+  }
+  last_epoch_time = now;
+
+  if(txn_cnt > 0) {
+    DEBUG("SEND NEXT BATCH %ld [%ld] %ld\n",thd_id,epoch,txn_cnt);
+    assert(txn_cnt <= ((uint64_t)g_inflight_max * g_node_cnt));
+    qlite_ll * en = (qlite_ll *) mem_allocator.alloc(sizeof(qlite_ll));
+    en->epoch = epoch;
+    en->max_size = txn_cnt;
+    en->size = 0;
+    en->txns_left = txn_cnt;
     en->batch_send_time = prof_stat;
+    en->list = (qlite *) mem_allocator.alloc(sizeof(qlite) * en->max_size);
+    next_txn_id = 0;
+    for (uint64_t i = 0; i < g_seq_thread_cnt; i++) {
+      for (uint64_t j = 0; j < batch[i].size(); j++) {
+        seq_entry & sen = batch[i][j];
+        Message * msg = sen.msg;
+        txnid_t txn_id = g_node_id + g_node_cnt * next_txn_id;
+        next_txn_id++;
+        uint64_t id = txn_id / g_node_cnt;
+        msg->batch_id = epoch;
+        msg->txn_id = txn_id;
+        assert(txn_id != UINT64_MAX);
+
+        en->list[id].client_id = msg->get_return_id();
+        en->list[id].client_startts = ((ClientQueryMessage*)msg)->client_startts;
+        en->list[id].seq_startts = sen.seq_startts;
+        en->list[id].seq_first_startts = sen.seq_first_startts;
+        en->list[id].total_batch_time = sen.total_batch_time;
+        en->list[id].abort_cnt = sen.abort_cnt;
+        en->list[id].skew_startts = 0;
+        en->list[id].server_ack_cnt = sen.participants.size();
+        en->list[id].msg = msg;
+        en->list[id].recon_keys = Array<uint64_t>();
+        en->size++;
+        // Note: Modifying msg!
+        msg->return_node_id = g_node_id;
+        msg->lat_network_time = 0;
+        msg->lat_other_time = 0;
+      }
+    }
+    assert(en->size == en->txns_left);
+    pthread_mutex_lock(&wl_mtx);
+    LIST_PUT_TAIL(wl_head,wl_tail,en)
+    pthread_mutex_unlock(&wl_mtx);
   }
 
-  Message * msg;
-  for(uint64_t j = 0; j < g_node_cnt; j++) {
-    while(fill_queue[j].pop(msg)) {
-      if(j == g_node_id) {
+  // Every node receives its txns of the epoch in txn id order
+  for (uint64_t i = 0; i < g_seq_thread_cnt; i++) {
+    for (uint64_t j = 0; j < batch[i].size(); j++) {
+      seq_entry & sen = batch[i][j];
+      Message * msg = sen.msg;
+      for(auto participant = sen.participants.begin(); participant != sen.participants.end(); participant++) {
+        if(*participant == g_node_id) {
           work_queue.sched_enqueue(thd_id,msg);
-      } else {
-        msg_queue.enqueue(thd_id,msg,j);
+        } else {
+          msg_queue.enqueue(thd_id,msg,*participant);
+        }
       }
     }
-    if(!empty) {
-      DEBUG("Seq RDONE %ld\n",simulation->get_seq_epoch())
+  }
+  delete [] batch;
+
+  for(uint64_t j = 0; j < g_node_cnt; j++) {
+    if(txn_cnt > 0) {
+      DEBUG("Seq RDONE %ld\n",epoch)
     }
-    msg = Message::create_message(RDONE);
-    msg->batch_id = simulation->get_seq_epoch(); 
+    Message * msg = Message::create_message(RDONE);
+    msg->batch_id = epoch;
+    ((DoneMessage*)msg)->next_epoch = epoch + epoch_ticks;
     if(j == g_node_id) {
       work_queue.sched_enqueue(thd_id,msg);
     } else {
@@ -318,10 +390,8 @@ void Sequencer::send_next_batch(uint64_t thd_id) {
   last_time_batch = get_sys_clock();
 
 	INC_STATS(thd_id,seq_batch_cnt,1);
-  if(!empty) {
+  if(txn_cnt > 0) {
     INC_STATS(thd_id,seq_full_batch_cnt,1);
   }
   INC_STATS(thd_id,seq_prep_time,get_sys_clock() - prof_stat);
-  next_txn_id = 0;
 }
-
@@ -19,7 +19,6 @@
 
 #include "global.h"
 #include "query.h"
-#include <boost/lockfree/queue.hpp>
 
 class Workload;
 class BaseQuery;
@@ -36,6 +35,8 @@ typedef struct qlite_entry {
 	uint32_t server_ack_cnt;
 	uint32_t abort_cnt;
   Message * msg;
+  // [OLLP] the keys the participants' recon runs predicted so far
+  Array<uint64_t> recon_keys;
 } qlite;
 
 typedef struct qlite_ll_entry {
@@ -49,18 +50,43 @@ typedef struct qlite_ll_entry {
   qlite_ll_entry * prev;
 } qlite_ll;
 
+// a txn received by a sequencer thread, not yet ordered into an epoch
+typedef struct seq_entry {
+  Message * msg;
+  std::set<uint64_t> participants;
+	uint64_t seq_startts;
+	uint64_t seq_first_startts;
+	uint64_t total_batch_time;
+	uint32_t abort_cnt;
+} seq_entry;
+
 
 class Sequencer {
  public:
 	void init(Workload * wl);	
-	void process_ack(Message * msg, uint64_t thd_id);
-	void process_txn(Message * msg,uint64_t thd_id, uint64_t early_start, uint64_t last_start, uint64_t wait_time, uint32_t abort_cnt);
+	// seq_id is the index of the calling sequencer thread
+	void process_ack(Message * msg, uint64_t thd_id, uint64_t seq_id);
+	void process_txn(Message * msg,uint64_t thd_id, uint64_t seq_id, uint64_t early_start, uint64_t last_start, uint64_t wait_time, uint32_t abort_cnt);
+	// Called by sequencer thread 0 only
+	bool is_batch_ready();
 	void send_next_batch(uint64_t thd_id);
 
  private:
 	void reset_participating_nodes(bool * part_nodes);
-
-  boost::lockfree::queue<Message*, boost::lockfree::capacity<65526> > * fill_queue;
+	void update_epoch_len(uint64_t txn_cnt, uint64_t epoch_time);
+
+	// txns received since the last epoch closed, one list per sequencer
+	// thread. An epoch orders them by thread, then by arrival
+	std::vector<seq_entry> * pending;
+	pthread_mutex_t * pending_mtx;
+	volatile uint64_t pending_cnt;
+	// guards the wait lists
+	pthread_mutex_t wl_mtx;
+	// smoothed arrival rate in txns per ns, and the length of the next epoch
+	// it implies, in ticks of the epoch grid
+	double arrival_rate;
+	uint64_t epoch_ticks;
+	uint64_t last_epoch_time;
 #if WORKLOAD == YCSB
 	YCSBQuery* node_queries;
 #elif WORKLOAD == TPCC
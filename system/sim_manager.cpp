@@ -123,18 +123,21 @@ uint64_t SimManager::get_seq_epoch() {
   return seq_epoch;
 }
 
-void SimManager::advance_seq_epoch() {
-  ATOM_ADD(seq_epoch,1);
-  last_seq_epoch_time += g_seq_batch_time_limit;
+// Epochs close on a grid of SEQ_BATCH_MIN_TIMER ticks that every node steps
+// by the same amount, so epoch e closes at about the same time everywhere
+void SimManager::advance_seq_epoch(uint64_t ticks) {
+  ATOM_ADD(seq_epoch,ticks);
+  last_seq_epoch_time += ticks * g_seq_batch_min_time;
 }
 
 uint64_t SimManager::get_worker_epoch() {
   return worker_epoch;
 }
 
-void SimManager::next_worker_epoch() {
+void SimManager::next_worker_epoch(uint64_t epoch) {
+  assert(epoch > worker_epoch);
   last_worker_epoch_time = get_sys_clock();
-  ATOM_ADD(worker_epoch,1);
+  worker_epoch = epoch;
 }
 
 double SimManager::seconds_from_start(uint64_t time) {
@@ -50,9 +50,9 @@ public:
   void inc_inflight_cnt(); 
   void dec_inflight_cnt(); 
   uint64_t get_worker_epoch(); 
-  void next_worker_epoch(); 
+  void next_worker_epoch(uint64_t epoch); 
   uint64_t get_seq_epoch(); 
-  void advance_seq_epoch(); 
+  void advance_seq_epoch(uint64_t ticks); 
   void inc_epoch_txn_cnt(); 
   void decr_epoch_txn_cnt(); 
   double seconds_from_start(uint64_t time);
@@ -23,9 +23,16 @@
 #include "mem_alloc.h"
 #include "occ.h"
 #include "row_occ.h"
+#include "silo.h"
+#include "row_silo.h"
+#include "tictoc.h"
+#include "row_tictoc.h"
+#include "plock.h"
+#include "vll.h"
 #include "table.h"
 #include "catalog.h"
 #include "index_btree.h"
+#include "index_art.h"
 #include "index_hash.h"
 #include "msg_queue.h"
 #include "pool.h"
@@ -35,6 +42,7 @@
 #include "pps_query.h"
 #include "array.h"
 #include "maat.h"
+#include "manager.h"
 
 
 void TxnStats::init() {
@@ -262,6 +270,15 @@ void TxnStats::commit_stats(uint64_t thd_id, uint64_t txn_id, uint64_t batch_id,
 }
 
 
+// capacity of the per-txn row arrays. a TPC-C Delivery touches the 
+// new-order row, the order, the order lines and the customer of every district
+static uint64_t max_row_cnt() {
+  uint64_t max_rows = MAX_ROW_PER_TXN;
+  if (WORKLOAD == TPCC)
+    max_rows = max(max_rows, (uint64_t) g_dist_per_wh * (3 + max(g_max_items_per_txn, (UInt32) 15)));
+  return max_rows;
+}
+
 void Transaction::init() {
   timestamp = UINT64_MAX;
   start_timestamp = UINT64_MAX;
@@ -270,8 +287,10 @@ void Transaction::init() {
   batch_id = UINT64_MAX;
   DEBUG_M("Transaction::init array insert_rows\n");
   insert_rows.init(g_max_items_per_txn + 10); 
+  DEBUG_M("Transaction::init array delete_rows\n");
+  delete_rows.init(g_max_items_per_txn + 10); 
   DEBUG_M("Transaction::reset array accesses\n");
-  accesses.init(MAX_ROW_PER_TXN);  
+  accesses.init(max_row_cnt());  
 
   reset(0);
 }
@@ -281,6 +300,7 @@ void Transaction::reset(uint64_t thd_id) {
   accesses.clear();
   //release_inserts(thd_id);
   insert_rows.clear();  
+  delete_rows.clear();
   write_cnt = 0;
   row_cnt = 0;
   twopc_state = START;
@@ -296,13 +316,12 @@ void Transaction::release_accesses(uint64_t thd_id) {
 void Transaction::release_inserts(uint64_t thd_id) {
   for(uint64_t i = 0; i < insert_rows.size(); i++) {
     row_t * row = insert_rows[i];
-#if CC_ALG != MAAT && CC_ALG != OCC
+#if CC_ALG != MAAT && CC_ALG != OCC && CC_ALG != HSTORE && CC_ALG != HSTORE_SPEC
     DEBUG_M("TxnManager::cleanup row->manager free\n");
     mem_allocator.free(row->manager, 0);
 #endif
-    row->free_row();
     DEBUG_M("Transaction::release insert_rows free\n")
-    row_pool.put(thd_id,row);
+    row->get_table()->release_row(row);
   }
 }
 
@@ -314,6 +333,8 @@ void Transaction::release(uint64_t thd_id) {
   release_inserts(thd_id);
   DEBUG_M("Transaction::release array insert_rows free\n")
   insert_rows.release();
+  DEBUG_M("Transaction::release array delete_rows free\n")
+  delete_rows.release();
 }
 
 void TxnManager::init(uint64_t thd_id, Workload * h_wl) {
@@ -335,17 +356,31 @@ void TxnManager::init(uint64_t thd_id, Workload * h_wl) {
   //reset();
   sem_init(&rsp_mutex, 0, 1);
   return_id = UINT64_MAX;
+  mvcc_slot = NULL;
 
 	this->h_wl = h_wl;
 #if CC_ALG == MAAT
-  uncommitted_writes = new std::set<uint64_t>();
-  uncommitted_writes_y = new std::set<uint64_t>();
-  uncommitted_reads = new std::set<uint64_t>();
+  // room for every row's first chunk; the arrays grow past that
+  uncommitted_writes.init(max_row_cnt() * MAAT_ROW_SET_SIZE);
+  uncommitted_writes_y.init(max_row_cnt() * MAAT_ROW_SET_SIZE);
+  uncommitted_reads.init(max_row_cnt() * MAAT_ROW_SET_SIZE);
 #endif
 #if CC_ALG == CALVIN
   phase = CALVIN_RW_ANALYSIS;
   locking_done = false;
+  calvin_part_locked_rows = new Array<row_t*> [g_calvin_lock_thread_cnt];
+  for (uint64_t i = 0; i < g_calvin_lock_thread_cnt; i++)
+    calvin_part_locked_rows[i].init(MAX_ROW_PER_TXN);
+#endif
+#if CC_ALG == VLL
   calvin_locked_rows.init(MAX_ROW_PER_TXN);
+  vll_lock_types.init(MAX_ROW_PER_TXN);
+#endif
+#if CC_ALG == SILO
+  silo_locked_rows.init(max_row_cnt());
+#endif
+#if CC_ALG == TICTOC
+  tictoc_locked_rows.init(max_row_cnt());
 #endif
   
   txn_ready = true;
@@ -358,10 +393,18 @@ void TxnManager::init(uint64_t thd_id, Workload * h_wl) {
 void TxnManager::reset() {
 	lock_ready = false;
   lock_ready_cnt = 0;
+  calvin_parts_left = 0;
   locking_done = true;
 	ready_part = 0;
+  part_locked = false;
+  vll_blocked = false;
+  spec = false;
+  spec_waiting = false;
+  spec_aborted = false;
   rsp_cnt = 0;
   aborted = false;
+  lock_cancelled = false;
+  wounded = false;
   return_id = UINT64_MAX;
   twopl_wait_start = 0;
 
@@ -372,15 +415,25 @@ void TxnManager::reset() {
   greatest_read_timestamp = 0;
   commit_timestamp = 0;
 #if CC_ALG == MAAT
-  uncommitted_writes->clear();
-  uncommitted_writes_y->clear();
-  uncommitted_reads->clear();
+  uncommitted_writes.clear();
+  uncommitted_writes_y.clear();
+  uncommitted_reads.clear();
 #endif
 
 #if CC_ALG == CALVIN
   phase = CALVIN_RW_ANALYSIS;
   locking_done = false;
-  calvin_locked_rows.clear();
+  for (uint64_t i = 0; i < g_calvin_lock_thread_cnt; i++)
+    calvin_part_locked_rows[i].clear();
+#endif
+#if CC_ALG == VLL
+  assert(calvin_locked_rows.size() == 0);
+#endif
+#if CC_ALG == SILO
+  assert(silo_locked_rows.size() == 0);
+#endif
+#if CC_ALG == TICTOC
+  assert(tictoc_locked_rows.size() == 0);
 #endif
 
   assert(txn);
@@ -404,12 +457,24 @@ TxnManager::release() {
   txn = NULL;
 
 #if CC_ALG == MAAT
-  delete uncommitted_writes;
-  delete uncommitted_writes_y;
-  delete uncommitted_reads;
+  uncommitted_writes.release();
+  uncommitted_writes_y.release();
+  uncommitted_reads.release();
 #endif
 #if CC_ALG == CALVIN
+  for (uint64_t i = 0; i < g_calvin_lock_thread_cnt; i++)
+    calvin_part_locked_rows[i].release();
+  delete [] calvin_part_locked_rows;
+#endif
+#if CC_ALG == VLL
   calvin_locked_rows.release();
+  vll_lock_types.release();
+#endif
+#if CC_ALG == SILO
+  silo_locked_rows.release();
+#endif
+#if CC_ALG == TICTOC
+  tictoc_locked_rows.release();
 #endif
   txn_ready = true;
 }
@@ -426,6 +491,15 @@ void TxnManager::reset_query() {
 
 RC TxnManager::commit() {
   DEBUG("Commit %ld\n",get_txn_id());
+  // committed inserts become reachable through their table's indexes
+  for (uint64_t i = 0; i < txn->insert_rows.size(); i++)
+    h_wl->index_insert_row(txn->insert_rows[i]);
+  // deletes still hold their write locks, so waiters find the row dead
+  for (uint64_t i = 0; i < txn->delete_rows.size(); i++) {
+    row_t * row = txn->delete_rows[i];
+    h_wl->index_remove_row(row, get_thd_id());
+    row->get_table()->delete_row(row, get_thd_id());
+  }
   release_locks(RCOK);
 #if CC_ALG == MAAT
   time_table.release(get_thd_id(),get_txn_id());
@@ -499,9 +573,17 @@ RC TxnManager::start_commit() {
   RC rc = RCOK;
   DEBUG("%ld start_commit RO?%d\n",get_txn_id(),query->readonly());
   if(is_multi_part()) {
-    if(!query->readonly() || CC_ALG == OCC || CC_ALG == MAAT) {
+    if(!query->readonly() || CC_ALG == OCC || CC_ALG == MAAT || CC_ALG == SILO
+        || CC_ALG == TICTOC) {
+#if CC_ALG == TICTOC
+      // every participant validates at the same timestamp
+      set_commit_timestamp(max(get_commit_timestamp(),tictoc_man.get_lower_bound(this)));
+#endif
       // send prepare messages
       send_prepare_messages();
+#if CC_ALG == HSTORE_SPEC
+      part_lock_man.prepare(this,get_thd_id());
+#endif
       rc = WAIT_REM;
     } else {
       send_finish_messages();
@@ -509,6 +591,16 @@ RC TxnManager::start_commit() {
       rc = commit();
     }
   } else { // is not multi-part
+#if CC_ALG == HSTORE_SPEC
+    // a speculative txn commits after the txn it speculated on
+    if (spec) {
+      rc = part_lock_man.spec_commit(this);
+      if (rc == WAIT)
+        return rc;
+      if (rc == Abort)
+        return start_abort();
+    }
+#endif
     rc = validate();
     if(rc == RCOK)
       rc = commit();
@@ -607,9 +699,6 @@ void TxnManager::commit_stats() {
 
 void TxnManager::register_thread(Thread * h_thd) {
   this->h_thd = h_thd;
-#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
-  this->active_part = GET_PART_ID_FROM_IDX(get_thd_id());
-#endif
 }
 
 void TxnManager::set_txn_id(txnid_t txn_id) {
@@ -689,12 +778,15 @@ uint64_t TxnManager::decr_rsp(int i) {
   return result;
 }
 
-void TxnManager::release_last_row_lock() {
-  assert(txn->row_cnt > 0);
-  row_t * orig_r = txn->accesses[txn->row_cnt-1]->orig_row;
-  access_t type = txn->accesses[txn->row_cnt-1]->type;
-  orig_r->return_row(RCOK, type, this, NULL);
-  //txn->accesses[txn->row_cnt-1]->orig_row = NULL;
+void TxnManager::release_read_lock(Access * access) {
+  row_t * row = access->orig_row;
+  row_t * copy;
+  DEBUG_M("TxnManager::release_read_lock row_t alloc\n");
+  row_pool.get(get_thd_id(),copy);
+  copy->init(row->get_table(), row->get_part_id(), 0);
+  copy->copy(row);
+  row->return_row(RCOK, access->type, this, NULL);
+  access->data = copy;
 }
 
 void TxnManager::cleanup_row(RC rc, uint64_t rid) {
@@ -705,29 +797,32 @@ void TxnManager::cleanup_row(RC rc, uint64_t rid) {
 
     // Handle calvin elsewhere
 #if CC_ALG != CALVIN
-#if ISOLATION_LEVEL != READ_UNCOMMITTED
     row_t * orig_r = txn->accesses[rid]->orig_row;
-    if (ROLL_BACK && type == XP &&
+    // the private copies of a speculative txn are dropped, not rolled back
+    if (ROLL_BACK && type == XP && !spec &&
                 (CC_ALG == DL_DETECT ||
                 CC_ALG == NO_WAIT ||
                 CC_ALG == WAIT_DIE ||
+                CC_ALG == WOUND_WAIT ||
       CC_ALG == HSTORE ||
-      CC_ALG == HSTORE_SPEC
+      CC_ALG == HSTORE_SPEC ||
+      CC_ALG == VLL
       ))
     {
         orig_r->return_row(rc,type, this, txn->accesses[rid]->orig_data);
     } else {
-#if ISOLATION_LEVEL == READ_COMMITTED
-        if(type == WR) {
-          orig_r->return_row(rc,type, this, txn->accesses[rid]->data);
-        }
-#else
-        orig_r->return_row(rc,type, this, txn->accesses[rid]->data);
+#if ISOLATION_LEVEL == READ_COMMITTED && IS_2PL
+        // the read lock is gone already, only the copy is left
+        if(type == RD || type == SCAN) {
+          txn->accesses[rid]->data->free_row();
+          DEBUG_M("TxnManager::cleanup row_t free\n");
+          row_pool.put(get_thd_id(),txn->accesses[rid]->data);
+        } else
 #endif
+        orig_r->return_row(rc,type, this, txn->accesses[rid]->data);
     }
-#endif
 
-#if ROLL_BACK && (CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC)
+#if ROLL_BACK && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == VLL)
     if (type == WR) {
         //printf("free 10 %ld\n",get_txn_id());
               txn->accesses[rid]->orig_data->free_row();
@@ -759,27 +854,60 @@ void TxnManager::cleanup(RC rc) {
 	for (int rid = row_cnt - 1; rid >= 0; rid --) {
 	    cleanup_row(rc,rid);
 	}
+#if CC_ALG == SILO && MODE == NORMAL_MODE
+    // the writes are installed, so the new TIDs can be published
+    silo_man.finish(rc,this);
+#endif
+#if CC_ALG == TICTOC && MODE == NORMAL_MODE
+    tictoc_man.finish(rc,this);
+#endif
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
+    // the rows are rolled back by now
+    part_lock_man.unlock(this,rc,get_thd_id());
+#endif
+#if CC_ALG == VLL
+    // the rows are rolled back by now
+    vll_man.unlock(this,get_thd_id());
+#endif
 #if CC_ALG == CALVIN
 	// cleanup locked rows
-    for (uint64_t i = 0; i < calvin_locked_rows.size(); i++) {
-        row_t * row = calvin_locked_rows[i];
-        row->return_row(rc,RD,this,row);
+    for (uint64_t p = 0; p < g_calvin_lock_thread_cnt; p++) {
+        for (uint64_t i = 0; i < calvin_part_locked_rows[p].size(); i++) {
+            row_t * row = calvin_part_locked_rows[p][i];
+            row->return_row(rc,RD,this,row);
+        }
     }
 #endif
 
 	if (rc == Abort) {
 	    txn->release_inserts(get_thd_id());
 	    txn->insert_rows.clear();
+	    txn->delete_rows.clear();
 
         INC_STATS(get_thd_id(), abort_time, get_sys_clock() - starttime);
 	} 
 }
 
-RC TxnManager::get_lock(row_t * row, access_t type) {
+RC TxnManager::get_lock(row_t * row, access_t type, uint64_t lock_part) {
+#if CC_ALG == CALVIN
+    // every row belongs to exactly one lock thread, which alone touches
+    // its array
+    if (!calvin_owns_row(row->get_primary_key(), lock_part)) {
+        return RCOK;
+    }
+    if (calvin_part_locked_rows[lock_part].contains(row)) {
+        return RCOK;
+    }
+    calvin_part_locked_rows[lock_part].add(row);
+#else
     if (calvin_locked_rows.contains(row)) {
         return RCOK;
     }
     calvin_locked_rows.add(row);
+#endif
+#if CC_ALG == VLL
+    vll_lock_types.add(type == WR ? WR : RD);
+#endif
     RC rc = row->get_lock(type, this);
     if(rc == WAIT) {
       INC_STATS(get_thd_id(), txn_wait_cnt, 1);
@@ -800,6 +928,15 @@ RC TxnManager::get_row(row_t * row, access_t type, row_t *& row_rtn) {
     this->last_row = row;
     this->last_type = type;
 
+#if CC_ALG == WOUND_WAIT
+    // the wounded txn does not request any more locks
+    if (wounded) {
+        row_rtn = NULL;
+        access_pool.put(get_thd_id(),access);
+        return Abort;
+    }
+#endif
+
     rc = row->get_row(type, this, access->data);
 
     if (rc == Abort || rc == WAIT) {
@@ -817,7 +954,14 @@ RC TxnManager::get_row(row_t * row, access_t type, row_t *& row_rtn) {
     }
 	access->type = type;
 	access->orig_row = row;
-#if ROLL_BACK && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC)
+#if CC_ALG == SILO || CC_ALG == TICTOC
+	access->tid = last_tid;
+#endif
+#if ISOLATION_LEVEL == READ_COMMITTED && IS_2PL
+	if (type == RD || type == SCAN)
+		release_read_lock(access);
+#endif
+#if ROLL_BACK && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == VLL)
 	if (type == WR) {
     //printf("alloc 10 %ld\n",get_txn_id());
     uint64_t part_id = row->get_part_id();
@@ -851,7 +995,7 @@ RC TxnManager::get_row(row_t * row, access_t type, row_t *& row_rtn) {
 	row_rtn  = access->data;
 
 
-  if(CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == CALVIN)
+  if(CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == CALVIN || CC_ALG == VLL)
     assert(rc == RCOK);
   return rc;
 }
@@ -871,7 +1015,11 @@ RC TxnManager::get_row_post_wait(row_t *& row_rtn) {
 
 	access->type = type;
 	access->orig_row = row;
-#if ROLL_BACK && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE)
+#if ISOLATION_LEVEL == READ_COMMITTED && IS_2PL
+	if (type == RD || type == SCAN)
+		release_read_lock(access);
+#endif
+#if ROLL_BACK && (CC_ALG == DL_DETECT || CC_ALG == NO_WAIT || CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT)
 	if (type == WR) {
 	  uint64_t part_id = row->get_part_id();
     //printf("alloc 10 %ld\n",get_txn_id());
@@ -903,6 +1051,13 @@ void TxnManager::insert_row(row_t * row, table_t * table) {
   txn->insert_rows.add(row);
 }
 
+void TxnManager::delete_row(row_t * row) {
+	if (!txn->delete_rows.contains(row)) {
+		assert(!txn->delete_rows.is_full());
+		txn->delete_rows.add(row);
+	}
+}
+
 itemid_t *
 TxnManager::index_read(INDEX * index, idx_key_t key, int part_id) {
 	uint64_t starttime = get_sys_clock();
@@ -931,18 +1086,48 @@ TxnManager::index_read(INDEX * index, idx_key_t key, int part_id, int count) {
 	return item;
 }
 
+uint64_t
+TxnManager::index_read_multiple(INDEX * index, idx_key_t key, int part_id, itemid_t ** items, uint64_t max_cnt) {
+	uint64_t starttime = get_sys_clock();
+
+	uint64_t count = max_cnt;
+	index->index_read_multiple(key, items, count, part_id);
+
+  uint64_t t = get_sys_clock() - starttime;
+  INC_STATS(get_thd_id(), txn_index_time, t);
+
+	return count;
+}
 
 RC TxnManager::validate() {
 #if MODE != NORMAL_MODE
   return RCOK;
 #endif
-  if (CC_ALG != OCC && CC_ALG != MAAT) {
+#if CC_ALG == MVCC && ISOLATION_LEVEL == SNAPSHOT
+  // the writes become visible to the snapshots taken after this point. The
+  // other nodes get the timestamp with the finish message
+  set_commit_timestamp(glob_manager.get_ts(get_thd_id()));
+#endif
+#if CC_ALG == WOUND_WAIT
+  // wounded before the commit is decided
+  if (wounded)
+    return Abort;
+#endif
+  if (CC_ALG != OCC && CC_ALG != MAAT && CC_ALG != SILO && CC_ALG != TICTOC) {
       return RCOK;
   }
   RC rc = RCOK;
   uint64_t starttime = get_sys_clock();
   if(CC_ALG == OCC && rc == RCOK)
     rc = occ_man.validate(this);
+#if CC_ALG == SILO
+  if(rc == RCOK)
+    rc = silo_man.validate(this);
+#endif
+#if CC_ALG == TICTOC
+  if(rc == RCOK)
+    rc = tictoc_man.validate(this);
+#endif
   if(CC_ALG == MAAT && rc == RCOK) {
     rc = maat_man.validate(this);
     // Note: home node must be last to validate
@@ -954,6 +1139,31 @@ RC TxnManager::validate() {
   return rc;
 }
 
+bool TxnManager::write_order_less(row_t * a, row_t * b) {
+  if (a->get_primary_key() != b->get_primary_key())
+    return a->get_primary_key() < b->get_primary_key();
+  return a < b;
+}
+
+RC TxnManager::lock_write_set(Array<row_t*> & locked) {
+#if CC_ALG == SILO || CC_ALG == TICTOC
+  assert(locked.size() == 0);
+  for (uint64_t i = 0; i < get_access_cnt(); i++) {
+    if (get_access_type(i) == WR)
+      locked.add(get_access_original_row(i));
+  }
+  // a row written twice is locked once
+  locked.sort_unique(write_order_less);
+  for (uint64_t i = 0; i < locked.size(); i++) {
+    if (!locked[i]->manager->try_lock()) {
+      locked.truncate(i);
+      return Abort;
+    }
+  }
+#endif
+  return RCOK;
+}
+
 RC
 TxnManager::send_remote_reads() {
   assert(CC_ALG == CALVIN);
@@ -32,6 +32,7 @@ class INDEX;
 class TxnQEntry; 
 class YCSBQuery;
 class TPCCQuery;
+struct ts_slot;
 //class r_query;
 
 enum TxnState {START,INIT,EXEC,PREP,FIN,DONE};
@@ -42,6 +43,8 @@ public:
 	row_t * 	orig_row;
 	row_t * 	data;
 	row_t * 	orig_data;
+	// [SILO, TICTOC] TID or timestamp word the row was read at
+	uint64_t 	tid;
 	void cleanup();
 };
 
@@ -64,6 +67,8 @@ public:
     // Internal state
     TxnState twopc_state;
     Array<row_t*> insert_rows;
+    // rows to take out of their tables at commit
+    Array<row_t*> delete_rows;
     txnid_t         txn_id;
     uint64_t batch_id;
     RC rc;
@@ -133,7 +138,9 @@ public:
     virtual RC      run_txn() = 0;
     virtual RC      run_txn_post_wait() = 0;
     virtual RC      run_calvin_txn() = 0;
-    virtual RC      acquire_locks() = 0;
+    // [CALVIN] locks only the rows owned by lock thread lock_part.
+    // [VLL] lock_part is 0
+    virtual RC      acquire_locks(uint64_t lock_part) = 0;
     void            register_thread(Thread * h_thd);
     uint64_t        get_thd_id();
     Workload *      get_wl();
@@ -165,19 +172,38 @@ public:
     bool recon;
 
     row_t * volatile cur_row;
-    // [DL_DETECT, NO_WAIT, WAIT_DIE]
+    // [SILO, TICTOC] TID or timestamp word of cur_row
+    uint64_t last_tid;
+    // [DL_DETECT, NO_WAIT, WAIT_DIE, WOUND_WAIT]
     int volatile   lock_ready;
+    // [DL_DETECT, WOUND_WAIT] the lock request the txn waited for was
+    // cancelled to break a deadlock, or because the txn was wounded
+    bool lock_cancelled;
+    // [WOUND_WAIT] an older txn wants a lock the txn holds. the txn aborts
+    // at its next lock request, resume or validation
+    bool volatile wounded;
     // [TIMESTAMP, MVCC]
     bool volatile   ts_ready;
-    // [HSTORE, HSTORE_SPEC]
+    // [HSTORE, HSTORE_SPEC, VLL] partitions at this node the txn still waits for
     int volatile    ready_part;
+    // [HSTORE, HSTORE_SPEC, VLL] the txn has requested its partitions at this
+    // node
+    bool part_locked;
+    // [VLL] an earlier request conflicts with one of the rows of the txn
+    bool vll_blocked;
+    // [HSTORE_SPEC] the txn runs speculatively on private copies of its rows,
+    // and waits for, or was aborted with, the txn it speculated on
+    bool spec;
+    bool volatile spec_waiting;
+    bool volatile spec_aborted;
     int volatile    ready_ulk;
     bool aborted;
     uint64_t return_id;
     RC        validate();
     void            cleanup(RC rc);
     void            cleanup_row(RC rc,uint64_t rid);
-    void release_last_row_lock();
+    // [READ_COMMITTED] swap the row of a read for a private copy and release its lock
+    void release_read_lock(Access * access);
     RC send_remote_reads();
     void set_end_timestamp(uint64_t timestamp) {txn->end_timestamp = timestamp;}
     uint64_t get_end_timestamp() {return txn->end_timestamp;}
@@ -191,16 +217,22 @@ public:
     }
     uint64_t get_batch_id() {return txn->batch_id;}
     void set_batch_id(uint64_t batch_id) {txn->batch_id = batch_id;}
+    // reclamation epoch the txn runs in, from get_transaction_manager until release
+    uint64_t epoch;
+    // [MVCC] the active timestamp slot the txn is registered in, see Mvcc
+    ts_slot * mvcc_slot;
+    TxnManager * next;
+    TxnManager * prev;
 
-    // For MaaT
+    // For MaaT and TicToc
     uint64_t commit_timestamp;
     uint64_t get_commit_timestamp() {return commit_timestamp;}
     void set_commit_timestamp(uint64_t timestamp) {commit_timestamp = timestamp;}
     uint64_t greatest_write_timestamp;
     uint64_t greatest_read_timestamp;
-    std::set<uint64_t> * uncommitted_reads;
-    std::set<uint64_t> * uncommitted_writes;
-    std::set<uint64_t> * uncommitted_writes_y;
+    Array<uint64_t> uncommitted_reads;
+    Array<uint64_t> uncommitted_writes;
+    Array<uint64_t> uncommitted_writes_y;
 
     uint64_t twopl_wait_start;
 
@@ -232,21 +264,53 @@ public:
     volatile int txn_ready;
     // Calvin
     uint32_t lock_ready_cnt;
+    // lock threads that have not yet locked their share of the rows
+    volatile uint64_t calvin_parts_left;
     uint32_t calvin_expected_rsp_cnt;
     bool locking_done;
     CALVIN_PHASE phase;
+    // VLL: the rows the txn locked
     Array<row_t*> calvin_locked_rows;
+    // CALVIN: the rows locked by each lock thread. A row has one owning lock
+    // thread, so the threads never share an array
+    Array<row_t*> * calvin_part_locked_rows;
+    // VLL: the access types of calvin_locked_rows
+    Array<access_t> vll_lock_types;
     bool calvin_exec_phase_done();
     bool calvin_collect_phase_done();
+    // Silo: write set rows locked by validate, in locking order
+    Array<row_t*> silo_locked_rows;
+    // TicToc: write set rows locked by validate
+    Array<row_t*> tictoc_locked_rows;
+    // [SILO, TICTOC] try-locks the rows written, once each and in
+    // write_order_less order, and keeps the ones it got in locked. On Abort
+    // the caller releases locked
+    RC lock_write_set(Array<row_t*> & locked);
+    // total order in which write sets are locked, so that two committing
+    // transactions can never wait for each other
+    static bool write_order_less(row_t * a, row_t * b);
+    // whether row is in the write set. only after lock_write_set succeeded
+    static bool write_set_contains(Array<row_t*> & locked, row_t * row) {
+      return locked.contains_sorted(row, write_order_less);
+    }
 
 protected:	
 
     int rsp_cnt;
     void            insert_row(row_t * row, table_t * table);
+    // the caller must hold a write lock on row
+    void            delete_row(row_t * row);
 
     itemid_t *      index_read(INDEX * index, idx_key_t key, int part_id);
     itemid_t *      index_read(INDEX * index, idx_key_t key, int part_id, int count);
-    RC get_lock(row_t * row, access_t type);
+    // all items under key. see index_base::index_read_multiple
+    uint64_t        index_read_multiple(INDEX * index, idx_key_t key, int part_id, itemid_t ** items, uint64_t max_cnt);
+    RC get_lock(row_t * row, access_t type, uint64_t lock_part);
+    // [CALVIN] whether lock thread lock_part locks the rows with this primary
+    // key. acquire_locks skips the index lookup of a row it does not own
+    bool calvin_owns_row(uint64_t key, uint64_t lock_part) {
+      return CC_ALG != CALVIN || key % g_calvin_lock_thread_cnt == lock_part;
+    }
     RC get_row(row_t * row, access_t type, row_t *& row_rtn);
     RC get_row_post_wait(row_t *& row_rtn);
 
@@ -27,6 +27,8 @@
 #include "pool.h"
 #include "work_queue.h"
 #include "message.h"
+#include "epoch.h"
+#include "mvcc.h"
 
 void TxnTable::init() {
   //pool_size = g_inflight_max * g_node_cnt * 2 + 1;
@@ -39,7 +41,6 @@ void TxnTable::init() {
     pool[i]->tail = NULL;
     pool[i]->cnt = 0;
     pool[i]->modify = false;
-    pool[i]->min_ts = UINT64_MAX;
   }
 }
 
@@ -67,15 +68,6 @@ bool TxnTable::is_matching_txn_node(txn_node_t t_node, uint64_t txn_id, uint64_t
 #endif
 }
 
-void TxnTable::update_min_ts(uint64_t thd_id, uint64_t txn_id,uint64_t batch_id,uint64_t ts){
-
-  uint64_t pool_id = txn_id % pool_size;
-  while(!ATOM_CAS(pool[pool_id]->modify,false,true)) { };
-  if(ts < pool[pool_id]->min_ts)
-    pool[pool_id]->min_ts = ts;
-  ATOM_CAS(pool[pool_id]->modify,true,false);
-}
-
 TxnManager * TxnTable::get_transaction_manager(uint64_t thd_id, uint64_t txn_id,uint64_t batch_id){
   DEBUG("TxnTable::get_txn_manager %ld / %ld\n",txn_id,pool_size);
   uint64_t starttime = get_sys_clock();
@@ -115,6 +107,8 @@ TxnManager * TxnTable::get_transaction_manager(uint64_t thd_id, uint64_t txn_id,
 
     txn_man->set_txn_id(txn_id);
     txn_man->set_batch_id(batch_id);
+    // rows and index items the txn reaches stay allocated until it is released
+    txn_man->epoch = epoch_man.enter(thd_id);
     t_node->txn_man = txn_man;
     txn_man->txn_stats.starttime = get_sys_clock();
     txn_man->txn_stats.restart_starttime = txn_man->txn_stats.starttime;
@@ -133,11 +127,6 @@ TxnManager * TxnTable::get_transaction_manager(uint64_t thd_id, uint64_t txn_id,
 
   }
 
-#if CC_ALG == MVCC
-  if(txn_man->get_timestamp() < pool[pool_id]->min_ts)
-    pool[pool_id]->min_ts = txn_man->get_timestamp();
-#endif
-
 
   // unset modify bit for this pool: txn_id % pool_size
   ATOM_CAS(pool[pool_id]->modify,true,false);
@@ -175,6 +164,29 @@ void TxnTable::restart_txn(uint64_t thd_id, uint64_t txn_id,uint64_t batch_id){
 
 }
 
+bool TxnTable::wound_txn(uint64_t thd_id, uint64_t txn_id){
+  bool wounded = false;
+#if CC_ALG == WOUND_WAIT
+  uint64_t pool_id = txn_id % pool_size;
+  // set modify bit for this pool: txn_id % pool_size
+  while(!ATOM_CAS(pool[pool_id]->modify,false,true)) { };
+
+  txn_node_t t_node = pool[pool_id]->head;
+
+  while (t_node != NULL) {
+    if(is_matching_txn_node(t_node,txn_id,0)) {
+      wounded = ATOM_CAS(t_node->txn_man->wounded,false,true);
+      break;
+    }
+    t_node = t_node->next;
+  }
+
+  // unset modify bit for this pool: txn_id % pool_size
+  ATOM_CAS(pool[pool_id]->modify,true,false);
+#endif
+  return wounded;
+}
+
 void TxnTable::release_transaction_manager(uint64_t thd_id, uint64_t txn_id, uint64_t batch_id){
   uint64_t starttime = get_sys_clock();
 
@@ -186,38 +198,18 @@ void TxnTable::release_transaction_manager(uint64_t thd_id, uint64_t txn_id, uin
 
   txn_node_t t_node = pool[pool_id]->head;
 
-#if CC_ALG == MVCC
-  uint64_t min_ts = UINT64_MAX;
-  txn_node_t saved_t_node = NULL;
-#endif
-
   uint64_t prof_starttime = get_sys_clock();
   while (t_node != NULL) {
     if(is_matching_txn_node(t_node,txn_id,batch_id)) {
       LIST_REMOVE_HT(t_node,pool[txn_id % pool_size]->head,pool[txn_id % pool_size]->tail);
       --pool[pool_id]->cnt;
-#if CC_ALG == MVCC
-    saved_t_node = t_node;
-    t_node = t_node->next;
-    continue;
-#else
       break;
-#endif
     }
-#if CC_ALG == MVCC
-    if(t_node->txn_man->get_timestamp() < min_ts)
-      min_ts = t_node->txn_man->get_timestamp();
-#endif
     t_node = t_node->next;
   }
   INC_STATS(thd_id,mtx[25],get_sys_clock()-prof_starttime);
   prof_starttime = get_sys_clock();
 
-#if CC_ALG == MVCC
-  t_node = saved_t_node;
-  pool[pool_id]->min_ts = min_ts;
-#endif
-
   // unset modify bit for this pool: txn_id % pool_size
   ATOM_CAS(pool[pool_id]->modify,true,false);
 
@@ -225,6 +217,10 @@ void TxnTable::release_transaction_manager(uint64_t thd_id, uint64_t txn_id, uin
   assert(t_node);
   assert(t_node->txn_man);
 
+  epoch_man.exit(thd_id,t_node->txn_man->epoch);
+#if CC_ALG == MVCC
+  mvcc_man.finish(t_node->txn_man);
+#endif
   txn_man_pool.put(thd_id,t_node->txn_man);
     
   INC_STATS(thd_id,mtx[26],get_sys_clock()-prof_starttime);
@@ -239,18 +235,3 @@ void TxnTable::release_transaction_manager(uint64_t thd_id, uint64_t txn_id, uin
 
 }
 
-uint64_t TxnTable::get_min_ts(uint64_t thd_id) {
-
-  uint64_t starttime = get_sys_clock();
-  uint64_t min_ts = UINT64_MAX;
-  for(uint64_t i = 0 ; i < pool_size; i++) {
-    uint64_t pool_min_ts = pool[i]->min_ts;
-    if(pool_min_ts < min_ts)
-      min_ts = pool_min_ts;
-  }
-
-  INC_STATS(thd_id,txn_table_min_ts_time,get_sys_clock() - starttime);
-  return min_ts;
-
-}
-
@@ -49,7 +49,6 @@ public:
   txn_node_t tail;
   volatile bool modify;
   uint64_t cnt;
-  uint64_t min_ts;
 
 };
 typedef pool_node * pool_node_t;
@@ -60,9 +59,10 @@ public:
   TxnManager* get_transaction_manager(uint64_t thd_id, uint64_t txn_id,uint64_t batch_id);
   void dump();
   void restart_txn(uint64_t thd_id, uint64_t txn_id,uint64_t batch_id);
+  // [WOUND_WAIT] sets the wounded flag of txn_id. false if the txn does not
+  // run at this node or was wounded already
+  bool wound_txn(uint64_t thd_id, uint64_t txn_id);
   void release_transaction_manager(uint64_t thd_id, uint64_t txn_id, uint64_t batch_id);
-  void update_min_ts(uint64_t thd_id, uint64_t txn_id,uint64_t batch_id,uint64_t ts);
-  uint64_t get_min_ts(uint64_t thd_id); 
 
 private:
   bool is_matching_txn_node(txn_node_t t_node, uint64_t txn_id, uint64_t batch_id);
@@ -21,6 +21,7 @@
 #include "table.h"
 #include "index_hash.h"
 #include "index_btree.h"
+#include "index_art.h"
 #include "catalog.h"
 #include "mem_alloc.h"
 
@@ -38,6 +39,13 @@ RC Workload::init_schema(const char * schema_file) {
     while (getline(fin, line)) {
 		if (line.compare(0, 6, "TABLE=") == 0) {
 			string tname(&line[6]);
+			// TABLE=<name>,PAX stores the table column group wise
+			bool pax = false;
+			size_t sep = tname.find(",");
+			if (sep != string::npos) {
+				pax = (tname.substr(sep + 1).compare(0, 3, "PAX") == 0);
+				tname.erase(sep);
+			}
 			void * tmp = new char[CL_SIZE * 2 + sizeof(Catalog)];
             schema = (Catalog *) ((UInt64)tmp + CL_SIZE);
 			getline(fin, line);
@@ -48,7 +56,7 @@ RC Workload::init_schema(const char * schema_file) {
 				lines.push_back(line);
 				getline(fin, line);
 			}
-			schema->init( tname.c_str(), id++, lines.size() );
+			schema->init( tname.c_str(), id++, lines.size(), pax );
 			for (UInt32 i = 0; i < lines.size(); i++) {
 				string line = lines[i];
 				vector<string> items;
@@ -58,8 +66,10 @@ RC Workload::init_schema(const char * schema_file) {
         int size = atoi(strtok(line_cstr,","));
         char * type = strtok(NULL,",");
         char * name = strtok(NULL,",");
+        // optional column group of a PAX table
+        char * group = strtok(NULL,",");
 
-        schema->add_col(name, size, type);
+        schema->add_col(name, size, type, group);
 				col_count ++;
 			} 
 			tmp = new char[CL_SIZE * 2 + sizeof(table_t)];
@@ -68,6 +78,14 @@ RC Workload::init_schema(const char * schema_file) {
 			tables[tname] = cur_tab;
         } else if (!line.compare(0, 6, "INDEX=")) {
 			string iname(&line[6]);
+			// INDEX=<name>,NONUNIQUE declares a secondary index whose keys 
+			// may map to several rows
+			bool unique = true;
+			size_t sep = iname.find(",");
+			if (sep != string::npos) {
+				unique = (iname.substr(sep + 1).compare(0, 9, "NONUNIQUE") != 0);
+				iname.erase(sep);
+			}
 			getline(fin, line);
 
 			vector<string> items;
@@ -105,6 +123,10 @@ RC Workload::init_schema(const char * schema_file) {
       } else if ( !tname.compare(1, 7, "HISTORY") ) {
         table_size = g_num_wh / g_part_cnt * g_dist_per_wh * g_cust_per_dist;
         printf("HISTORY size %ld\n",table_size);
+      } else if ( !tname.compare(1, 9, "NEW-ORDER") ) {
+        // the loader enqueues the orders after the first 2100 of each district
+        table_size = g_num_wh / g_part_cnt * g_dist_per_wh * (g_cust_per_dist - min(g_cust_per_dist, (UInt32) 2100));
+        printf("NEW-ORDER size %ld\n",table_size);
       } else if ( !tname.compare(1, 5, "ORDER") ) {
         table_size = g_num_wh / g_part_cnt * g_dist_per_wh * g_cust_per_dist;
         printf("ORDER size %ld\n",table_size);
@@ -135,12 +157,12 @@ RC Workload::init_schema(const char * schema_file) {
       table_size = g_synth_table_size / g_part_cnt;
 #endif
 
-#if INDEX_STRUCT == IDX_HASH
-			index->init(1024, tables[tname], table_size);
-			//index->init(part_cnt*1024, tables[tname], table_size);
-#else
-			index->init(part_cnt, tables[tname]);
-#endif
+			// the table name is indented in the schema file
+			table_t * table = tables[tname.substr(tname.find_first_not_of(" \t"))];
+			assert(table != NULL);
+			index->init(part_cnt, table, table_size);
+			index->unique = unique;
+			table->add_index(index);
 			indexes[iname] = index;
 		}
     }
@@ -175,7 +197,7 @@ void Workload::index_insert(INDEX * index, uint64_t key, row_t * row, int64_t pa
 	m_item->location = row;
 	m_item->valid = true;
 
-  assert(index);
+  assert(index && index->unique);
   assert( index->index_insert(key, m_item, pid) == RCOK );
 }
 
@@ -190,9 +212,39 @@ void Workload::index_insert_nonunique(INDEX * index, uint64_t key, row_t * row,
 	m_item->location = row;
 	m_item->valid = true;
 
-  assert(index);
+  assert(index && !index->unique);
   assert( index->index_insert_nonunique(key, m_item, pid) == RCOK );
 }
 
+idx_key_t Workload::index_key(INDEX * index, row_t * row) {
+	return row->get_primary_key();
+}
 
+void Workload::index_insert_row(row_t * row) {
+	table_t * table = row->get_table();
+	for (uint32_t i = 0; i < table->get_index_cnt(); i++) {
+		INDEX * index = (INDEX *) table->get_index(i);
+		if (index->unique)
+			index_insert(index, index_key(index, row), row, row->get_part_id());
+		else
+			index_insert_nonunique(index, index_key(index, row), row, row->get_part_id());
+	}
+}
+
+void Workload::index_remove_row(row_t * row, uint64_t thd_id) {
+	table_t * table = row->get_table();
+	for (uint32_t i = 0; i < table->get_index_cnt(); i++) {
+		INDEX * index = (INDEX *) table->get_index(i);
+		RC rc = index->index_remove(index_key(index, row), row, row->get_part_id(), thd_id);
+		M_ASSERT_V(rc == RCOK, "Row %ld is missing from index of %s\n", row->get_primary_key(), table->get_table_name());
+	}
+}
 
+void Workload::check_schema(const static_column * cols, uint64_t cnt) {
+	for (uint64_t i = 0; i < cnt; i++) {
+		map<string, table_t *>::iterator it = tables.find(cols[i].table_name);
+		M_ASSERT_V(it != tables.end() && it->second->get_schema()->check_column(cols[i]),
+			"Column %d of %s does not match the compiled schema layout. Run scripts/gen_schema.py\n",
+			cols[i].id, cols[i].table_name);
+	}
+}
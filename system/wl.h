@@ -23,6 +23,7 @@ class row_t;
 class table_t;
 class IndexHash;
 class index_btree;
+class IndexArt;
 class Catalog;
 class lock_man;
 class TxnManager;
@@ -30,6 +31,7 @@ class Thread;
 class index_base;
 class Timestamp;
 class Mvcc;
+struct static_column;
 
 class Workload
 {
@@ -53,10 +55,19 @@ public:
 	//uint64_t cur_txn_id;
   uint64_t done_cnt;
   uint64_t txn_cnt;
+	// adds a committed insert to every index declared on its table
+	void index_insert_row(row_t * row);
+	// removes a committed delete from every index declared on its table
+	virtual void index_remove_row(row_t * row, uint64_t thd_id);
 protected:
+	// key of row in index. defaults to the row's primary key
+	virtual idx_key_t index_key(INDEX * index, row_t * row);
 	void index_insert(string index_name, uint64_t key, row_t * row);
 	void index_insert(INDEX * index, uint64_t key, row_t * row, int64_t part_id = -1);
 	void index_insert_nonunique(INDEX * index, uint64_t key, row_t * row, int64_t part_id = -1);
+	// asserts that the parsed schema has the layout the typed row accessors
+	// were compiled with
+	void check_schema(const static_column * cols, uint64_t cnt);
 };
 
 #endif
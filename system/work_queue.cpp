@@ -29,8 +29,14 @@ void QWorkQueue::init() {
   work_queue = new boost::lockfree::queue<work_queue_entry* > (0);
   new_txn_queue = new boost::lockfree::queue<work_queue_entry* >(0);
   sched_queue = new boost::lockfree::queue<work_queue_entry* > * [g_node_cnt];
+  sched_next_epoch = new uint64_t [g_node_cnt];
   for ( uint64_t i = 0; i < g_node_cnt; i++) {
     sched_queue[i] = new boost::lockfree::queue<work_queue_entry* > (0);
+    sched_next_epoch[i] = simulation->get_worker_epoch();
+  }
+  lock_queue = new boost::lockfree::queue<work_queue_entry* > * [g_calvin_lock_thread_cnt];
+  for ( uint64_t i = 0; i < g_calvin_lock_thread_cnt; i++) {
+    lock_queue[i] = new boost::lockfree::queue<work_queue_entry* > (0);
   }
 
 }
@@ -102,6 +108,22 @@ void QWorkQueue::sched_enqueue(uint64_t thd_id, Message * msg) {
   INC_STATS(thd_id,sched_queue_enq_cnt,1);
 }
 
+// Advance to the next node's queue, or to the next epoch that any node
+// closes once every node is done with this one
+void QWorkQueue::sched_next_node(uint64_t thd_id) {
+  if(sched_ptr == g_node_cnt - 1) {
+    uint64_t epoch = UINT64_MAX;
+    for(uint64_t i = 0; i < g_node_cnt; i++) {
+      if(sched_next_epoch[i] < epoch)
+        epoch = sched_next_epoch[i];
+    }
+    INC_STATS(thd_id,sched_epoch_cnt,1);
+    INC_STATS(thd_id,sched_epoch_diff,get_sys_clock()-simulation->last_worker_epoch_time);
+    simulation->next_worker_epoch(epoch);
+  }
+  sched_ptr = (sched_ptr + 1) % g_node_cnt;
+}
+
 Message * QWorkQueue::sched_dequeue(uint64_t thd_id) {
   uint64_t starttime = get_sys_clock();
 
@@ -109,6 +131,10 @@ Message * QWorkQueue::sched_dequeue(uint64_t thd_id) {
   Message * msg = NULL;
   work_queue_entry * entry = NULL;
 
+  // a node sends nothing for the epochs it skips
+  while(sched_next_epoch[sched_ptr] > simulation->get_worker_epoch())
+    sched_next_node(thd_id);
+
   bool valid = sched_queue[sched_ptr]->pop(entry);
 
   if(valid) {
@@ -127,12 +153,9 @@ Message * QWorkQueue::sched_dequeue(uint64_t thd_id) {
       // Advance to next queue or next epoch
       DEBUG("Sched RDONE %ld %ld\n",sched_ptr,simulation->get_worker_epoch());
       assert(msg->get_batch_id() == simulation->get_worker_epoch());
-      if(sched_ptr == g_node_cnt - 1) {
-        INC_STATS(thd_id,sched_epoch_cnt,1);
-        INC_STATS(thd_id,sched_epoch_diff,get_sys_clock()-simulation->last_worker_epoch_time);
-        simulation->next_worker_epoch();
-      }
-      sched_ptr = (sched_ptr + 1) % g_node_cnt;
+      sched_next_epoch[sched_ptr] = ((DoneMessage*)msg)->next_epoch;
+      assert(sched_next_epoch[sched_ptr] > simulation->get_worker_epoch());
+      sched_next_node(thd_id);
       msg->release();
       msg = NULL;
 
@@ -150,6 +173,40 @@ Message * QWorkQueue::sched_dequeue(uint64_t thd_id) {
 
 }
 
+void QWorkQueue::lock_enqueue(uint64_t thd_id, uint64_t lock_part, Message * msg) {
+  assert(CC_ALG == CALVIN);
+  assert(msg);
+  assert(lock_part < g_calvin_lock_thread_cnt);
+
+  DEBUG_M("QWorkQueue::lock_enqueue work_queue_entry alloc\n");
+  work_queue_entry * entry = (work_queue_entry*)mem_allocator.alloc(sizeof(work_queue_entry));
+  entry->msg = msg;
+  entry->rtype = msg->rtype;
+  entry->txn_id = msg->txn_id;
+  entry->batch_id = msg->batch_id;
+  entry->starttime = get_sys_clock();
+
+  DEBUG("Lock Enqueue %ld (%ld,%ld)\n",lock_part,entry->txn_id,entry->batch_id);
+  while(!lock_queue[lock_part]->push(entry) && !simulation->is_done()) {}
+}
+
+Message * QWorkQueue::lock_dequeue(uint64_t thd_id, uint64_t lock_part) {
+  assert(CC_ALG == CALVIN);
+  Message * msg = NULL;
+  work_queue_entry * entry = NULL;
+
+  bool valid = lock_queue[lock_part]->pop(entry);
+
+  if(valid) {
+    msg = entry->msg;
+    DEBUG("Lock Dequeue %ld (%ld,%ld)\n",lock_part,entry->txn_id,entry->batch_id);
+    DEBUG_M("QWorkQueue::lock_dequeue work_queue_entry free\n");
+    mem_allocator.free(entry,sizeof(work_queue_entry));
+  }
+
+  return msg;
+}
+
 
 void QWorkQueue::enqueue(uint64_t thd_id, Message * msg,bool busy) {
   uint64_t starttime = get_sys_clock();
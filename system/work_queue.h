@@ -77,6 +77,8 @@ public:
   Message * dequeue(uint64_t thd_id);
   void sched_enqueue(uint64_t thd_id, Message * msg); 
   Message * sched_dequeue(uint64_t thd_id); 
+  void lock_enqueue(uint64_t thd_id, uint64_t lock_part, Message * msg);
+  Message * lock_dequeue(uint64_t thd_id, uint64_t lock_part);
   void sequencer_enqueue(uint64_t thd_id, Message * msg); 
   Message * sequencer_dequeue(uint64_t thd_id); 
 
@@ -94,7 +96,12 @@ private:
   boost::lockfree::queue<work_queue_entry* > * new_txn_queue;
   boost::lockfree::queue<work_queue_entry* > * seq_queue;
   boost::lockfree::queue<work_queue_entry* > ** sched_queue;
+  // [CALVIN] scheduled txns handed to lock thread i > 0, in schedule order
+  boost::lockfree::queue<work_queue_entry* > ** lock_queue;
+  void sched_next_node(uint64_t thd_id);
   uint64_t sched_ptr;
+  // [CALVIN] the next epoch each node closes, from its last RDONE
+  uint64_t * sched_next_epoch;
   BaseQuery * last_sched_dq;
   uint64_t curr_epoch;
 
@@ -32,6 +32,10 @@
 #include "message.h"
 #include "abort_queue.h"
 #include "maat.h"
+#include "dl_detect.h"
+#include "plock.h"
+#include "vll.h"
+#include "mvcc.h"
 
 void WorkerThread::setup() {
 
@@ -192,6 +196,14 @@ RC WorkerThread::run() {
     heartbeat();
 
     progress_stats();
+#if CC_ALG == DL_DETECT
+    if(get_thd_id() == 0)
+      dl_detector.run(get_thd_id());
+#endif
+#if CC_ALG == MVCC
+    if(get_thd_id() == 0)
+      mvcc_man.run(get_thd_id());
+#endif
 
     Message * msg = work_queue.dequeue(get_thd_id());
 
@@ -279,7 +291,7 @@ RC WorkerThread::process_rfin(Message * msg) {
   assert(CC_ALG != CALVIN);
 
   M_ASSERT_V(!IS_LOCAL(msg->get_txn_id()),"RFIN local: %ld %ld/%d\n",msg->get_txn_id(),msg->get_txn_id()%g_node_cnt,g_node_id);
-#if CC_ALG == MAAT
+#if CC_ALG == MAAT || (CC_ALG == MVCC && ISOLATION_LEVEL == SNAPSHOT)
   txn_man->set_commit_timestamp(((FinishMessage*)msg)->commit_timestamp);
 #endif
 
@@ -292,7 +304,8 @@ RC WorkerThread::process_rfin(Message * msg) {
   } 
   txn_man->commit();
   //if(!txn_man->query->readonly() || CC_ALG == OCC)
-  if(!((FinishMessage*)msg)->readonly || CC_ALG == MAAT || CC_ALG == OCC)
+  if(!((FinishMessage*)msg)->readonly || CC_ALG == MAAT || CC_ALG == OCC || CC_ALG == SILO
+      || CC_ALG == TICTOC)
     msg_queue.enqueue(get_thd_id(),Message::create_message(txn_man,RACK_FIN),GET_NODE_ID(msg->get_txn_id()));
   release_txn_man();
 
@@ -310,12 +323,8 @@ RC WorkerThread::process_rack_prep(Message * msg) {
   // Integrate bounds
   uint64_t lower = ((AckMessage*)msg)->lower;
   uint64_t upper = ((AckMessage*)msg)->upper;
-  if(lower > time_table.get_lower(get_thd_id(),msg->get_txn_id())) {
-    time_table.set_lower(get_thd_id(),msg->get_txn_id(),lower);
-  }
-  if(upper < time_table.get_upper(get_thd_id(),msg->get_txn_id())) {
-    time_table.set_upper(get_thd_id(),msg->get_txn_id(),upper);
-  }
+  time_table.raise_lower(get_thd_id(),msg->get_txn_id(),lower);
+  time_table.cap_upper(get_thd_id(),msg->get_txn_id(),upper);
   DEBUG("%ld bound set: [%ld,%ld] -> [%ld,%ld]\n",msg->get_txn_id(),lower,upper,time_table.get_lower(get_thd_id(),msg->get_txn_id()),time_table.get_upper(get_thd_id(),msg->get_txn_id()));
   if(((AckMessage*)msg)->rc != RCOK) {
     time_table.set_state(get_thd_id(),msg->get_txn_id(),MAAT_ABORTED);
@@ -375,6 +384,11 @@ RC WorkerThread::process_rqry_rsp(Message * msg) {
     txn_man->start_abort();
     return Abort;
   }
+#if CC_ALG == TICTOC
+  uint64_t bound = ((QueryResponseMessage*)msg)->commit_timestamp;
+  if(bound > txn_man->get_commit_timestamp())
+    txn_man->set_commit_timestamp(bound);
+#endif
 
   RC rc = txn_man->run_txn();
   check_if_done(rc);
@@ -390,8 +404,38 @@ RC WorkerThread::process_rqry(Message * msg) {
 
   msg->copy_to_txn(txn_man);
 
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
+  // the first request locks the partitions of the txn at this node
+  if(!txn_man->part_locked) {
+    rc = part_lock_man.lock(txn_man,get_thd_id());
+    if(rc == WAIT)
+      return rc;
+    if(rc == Abort) {
+      txn_man->abort();
+      msg_queue.enqueue(get_thd_id(),Message::create_message(txn_man,RQRY_RSP),txn_man->return_id);
+      return rc;
+    }
+  }
+#endif
+#if CC_ALG == VLL
+  // every request locks its rows, which are only known once it arrives. A
+  // participant does not wait
+  rc = vll_man.lock(txn_man,get_thd_id());
+  assert(rc != WAIT);
+  if(rc == Abort) {
+    txn_man->abort();
+    msg_queue.enqueue(get_thd_id(),Message::create_message(txn_man,RQRY_RSP),txn_man->return_id);
+    return rc;
+  }
+#endif
 #if CC_ALG == MVCC
-  txn_table.update_min_ts(get_thd_id(),txn_man->get_txn_id(),0,txn_man->get_timestamp());
+  // the home node drew the timestamp before this node registered it, so
+  // versions the txn needs may be gone already
+  if(!mvcc_man.start(get_thd_id(),txn_man,false)) {
+    txn_man->abort();
+    msg_queue.enqueue(get_thd_id(),Message::create_message(txn_man,RQRY_RSP),txn_man->return_id);
+    return Abort;
+  }
 #endif
 #if CC_ALG == MAAT
           time_table.init(get_thd_id(),txn_man->get_txn_id());
@@ -411,7 +455,18 @@ RC WorkerThread::process_rqry_cont(Message * msg) {
   assert(!IS_LOCAL(msg->get_txn_id()));
   RC rc = RCOK;
 
+#if CC_ALG == DL_DETECT || CC_ALG == WOUND_WAIT
+  dl_detector.clear_dep(txn_man->get_txn_id());
+  if(txn_man->lock_cancelled) {
+    rc = txn_man->abort();
+    msg_queue.enqueue(get_thd_id(),Message::create_message(txn_man,RQRY_RSP),txn_man->return_id);
+    return rc;
+  }
+#endif
+#if CC_ALG != HSTORE && CC_ALG != HSTORE_SPEC && CC_ALG != VLL
+  // with partition locks or VLL the txn only waits before it runs
   txn_man->run_txn_post_wait();
+#endif
   rc = txn_man->run_txn();
 
   // Send response
@@ -428,7 +483,18 @@ RC WorkerThread::process_rtxn_cont(Message * msg) {
 
   txn_man->txn_stats.local_wait_time += get_sys_clock() - txn_man->txn_stats.wait_starttime;
 
+#if CC_ALG == DL_DETECT || CC_ALG == WOUND_WAIT
+  dl_detector.clear_dep(txn_man->get_txn_id());
+  if(txn_man->lock_cancelled) {
+    check_if_done(txn_man->start_abort());
+    return RCOK;
+  }
+#endif
+#if CC_ALG != HSTORE && CC_ALG != HSTORE_SPEC && CC_ALG != VLL
+  // with partition locks or VLL the txn waits before it runs, or, if it is
+  // speculative, before it commits
   txn_man->run_txn_post_wait();
+#endif
   RC rc = txn_man->run_txn();
   check_if_done(rc);
   return RCOK;
@@ -437,11 +503,18 @@ RC WorkerThread::process_rtxn_cont(Message * msg) {
 RC WorkerThread::process_rprepare(Message * msg) {
   DEBUG("RPREP %ld\n",msg->get_txn_id());
     RC rc = RCOK;
+#if CC_ALG == TICTOC
+    txn_man->set_commit_timestamp(((PrepareMessage*)msg)->commit_timestamp);
+#endif
 
     // Validate transaction
     rc  = txn_man->validate();
     txn_man->set_rc(rc);
     msg_queue.enqueue(get_thd_id(),Message::create_message(txn_man,RACK_PREP),msg->return_node_id);
+#if CC_ALG == HSTORE_SPEC
+    if(rc == RCOK)
+      part_lock_man.prepare(txn_man,get_thd_id());
+#endif
     // Clean up as soon as abort is possible
     if(rc == Abort) {
       txn_man->abort();
@@ -475,7 +548,7 @@ RC WorkerThread::process_rtxn(Message * msg) {
           bool ready = txn_man->unset_ready();
           INC_STATS(get_thd_id(),worker_activate_txn_time,get_sys_clock() - ready_starttime);
           assert(ready);
-					if (CC_ALG == WAIT_DIE) {
+					if (CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT) {
             txn_man->set_timestamp(get_next_ts());
           }
           txn_man->txn_stats.starttime = get_sys_clock();
@@ -489,13 +562,15 @@ RC WorkerThread::process_rtxn(Message * msg) {
           DEBUG("RESTART %ld %f %lu\n",txn_man->get_txn_id(),simulation->seconds_from_start(get_sys_clock()),txn_man->txn_stats.starttime);
         }
 
+#if CC_ALG == MVCC
+          // registered before the timestamp is drawn, so the mark cannot
+          // pass it in between
+          mvcc_man.start(get_thd_id(),txn_man,true);
+#endif
           // Get new timestamps
           if(is_cc_new_timestamp()) {
             txn_man->set_timestamp(get_next_ts());
 					}
-#if CC_ALG == MVCC
-          txn_table.update_min_ts(get_thd_id(),txn_id,0,txn_man->get_timestamp());
-#endif
 
 #if CC_ALG == OCC
           txn_man->set_start_timestamp(get_next_ts());
@@ -511,6 +586,27 @@ RC WorkerThread::process_rtxn(Message * msg) {
     if(rc != RCOK)
       return rc;
 
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
+    // runs once it holds its partitions at this node
+    rc = part_lock_man.lock(txn_man,get_thd_id());
+    if(rc == WAIT)
+      return rc;
+    if(rc == Abort) {
+      check_if_done(txn_man->start_abort());
+      return rc;
+    }
+#endif
+#if CC_ALG == VLL
+    // runs once no earlier txn conflicts with its rows at this node
+    rc = vll_man.lock(txn_man,get_thd_id());
+    if(rc == WAIT)
+      return rc;
+    if(rc == Abort) {
+      check_if_done(txn_man->start_abort());
+      return rc;
+    }
+#endif
+
     // Execute transaction
     rc = txn_man->run_txn();
   check_if_done(rc);
@@ -588,7 +684,7 @@ RC WorkerThread::process_calvin_rtxn(Message * msg) {
 
 
 bool WorkerThread::is_cc_new_timestamp() {
-  return (CC_ALG == MVCC || CC_ALG == TIMESTAMP);
+  return (CC_ALG == MVCC || CC_ALG == TIMESTAMP || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC);
 }
 
 ts_t WorkerThread::get_next_ts() {
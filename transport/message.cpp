@@ -25,6 +25,8 @@
 #include "global.h"
 #include "message.h"
 #include "maat.h"
+#include "tictoc.h"
+#include "manager.h"
 
 std::vector<Message*> * Message::create_messages(char * buf) {
   std::vector<Message*> * all_msgs = new std::vector<Message*>;
@@ -170,6 +172,12 @@ Message * Message::create_message(RemReqType rtype) {
     case CL_RSP:
       msg = new ClientResponseMessage;
       break;
+    case DL_GRAPH:
+    case DL_ABORT:
+    case RWOUND:
+      msg = new DLDetectMessage;
+      ((DLDetectMessage*)msg)->first = true;
+      break;
     default: assert(false);
   }
   assert(msg);
@@ -360,6 +368,14 @@ void Message::release_message(Message * msg) {
       delete m_msg;
       break;
                 }
+    case DL_GRAPH:
+    case DL_ABORT:
+    case RWOUND: {
+      DLDetectMessage * m_msg = (DLDetectMessage*)msg;
+      m_msg->release();
+      delete m_msg;
+      break;
+                }
     case CL_RSP: {
       ClientResponseMessage * m_msg = (ClientResponseMessage*)msg;
       m_msg->release();
@@ -373,35 +389,49 @@ void Message::release_message(Message * msg) {
 
 uint64_t QueryMessage::get_size() {
   uint64_t size = Message::mget_size();
-#if CC_ALG == WAIT_DIE || CC_ALG == TIMESTAMP || CC_ALG == MVCC
+#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == TIMESTAMP || CC_ALG == MVCC \
+  || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
   size += sizeof(ts);
 #endif
 #if CC_ALG == OCC 
   size += sizeof(start_ts);
 #endif  
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == VLL
+  size += sizeof(size_t);
+  size += sizeof(uint64_t) * partitions.size();
+#endif
   return size;
 }
 
 void QueryMessage::copy_from_txn(TxnManager * txn) {
   Message::mcopy_from_txn(txn);
-#if CC_ALG == WAIT_DIE || CC_ALG == TIMESTAMP || CC_ALG == MVCC
+#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == TIMESTAMP || CC_ALG == MVCC \
+  || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
   ts = txn->get_timestamp();
   assert(ts != 0);
 #endif
 #if CC_ALG == OCC 
   start_ts = txn->get_start_timestamp();
 #endif
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == VLL
+  partitions.copy(txn->query->partitions);
+#endif
 }
 
 void QueryMessage::copy_to_txn(TxnManager * txn) {
   Message::mcopy_to_txn(txn);
-#if CC_ALG == WAIT_DIE || CC_ALG == TIMESTAMP || CC_ALG == MVCC
+#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == TIMESTAMP || CC_ALG == MVCC \
+  || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
   assert(ts != 0);
   txn->set_timestamp(ts);
 #endif
 #if CC_ALG == OCC 
   txn->set_start_timestamp(start_ts);
 #endif
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == VLL
+  if(txn->query->partitions.size() == 0)
+    txn->query->partitions.append(partitions);
+#endif
 
 }
 
@@ -409,26 +439,49 @@ void QueryMessage::copy_from_buf(char * buf) {
   Message::mcopy_from_buf(buf);
   uint64_t ptr __attribute__ ((unused));
   ptr = Message::mget_size();
-#if CC_ALG == WAIT_DIE || CC_ALG == TIMESTAMP || CC_ALG == MVCC
+#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == TIMESTAMP || CC_ALG == MVCC \
+  || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
  COPY_VAL(ts,buf,ptr);
   assert(ts != 0);
+  // skew correction: the clock of a remote txn bounds ours from below
+  if (g_ts_alloc == TS_HLC)
+    glob_manager.update_ts(ts);
 #endif
 #if CC_ALG == OCC 
  COPY_VAL(start_ts,buf,ptr);
 #endif
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == VLL
+  size_t size;
+  COPY_VAL(size,buf,ptr);
+  partitions.init(size);
+  for(uint64_t i = 0 ; i < size;i++) {
+    uint64_t item;
+    COPY_VAL(item,buf,ptr);
+    partitions.add(item);
+  }
+#endif
 }
 
 void QueryMessage::copy_to_buf(char * buf) {
   Message::mcopy_to_buf(buf);
   uint64_t ptr __attribute__ ((unused));
   ptr = Message::mget_size();
-#if CC_ALG == WAIT_DIE || CC_ALG == TIMESTAMP || CC_ALG == MVCC
+#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == TIMESTAMP || CC_ALG == MVCC \
+  || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
  COPY_BUF(buf,ts,ptr);
   assert(ts != 0);
 #endif
 #if CC_ALG == OCC 
  COPY_BUF(buf,start_ts,ptr);
 #endif
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == VLL
+  size_t size = partitions.size();
+  COPY_BUF(buf,size,ptr);
+  for(uint64_t i = 0; i < partitions.size(); i++) {
+    uint64_t item = partitions[i];
+    COPY_BUF(buf,item,ptr);
+  }
+#endif
 }
 
 /************************/
@@ -529,6 +582,11 @@ void YCSBClientQueryMessage::copy_to_buf(char * buf) {
 void TPCCClientQueryMessage::init() {
 }
 
+// a payment by last name picks its customer through a secondary lookup
+bool TPCCClientQueryMessage::isReconQuery() {
+  return txn_type == TPCC_PAYMENT && by_last_name;
+}
+
 void TPCCClientQueryMessage::release() {
   ClientQueryMessage::release();
   // Freeing requests is the responsibility of txn
@@ -543,7 +601,7 @@ void TPCCClientQueryMessage::release() {
 
 uint64_t TPCCClientQueryMessage::get_size() {
   uint64_t size = ClientQueryMessage::get_size();
-  size += sizeof(uint64_t) * 10; 
+  size += sizeof(uint64_t) * 12; 
   size += sizeof(char) * LASTNAME_LEN; 
   size += sizeof(bool) * 3;
   size += sizeof(size_t);
@@ -575,6 +633,10 @@ void TPCCClientQueryMessage::copy_from_query(BaseQuery * query) {
   remote = tpcc_query->remote;
   ol_cnt = tpcc_query->ol_cnt;
   o_entry_d = tpcc_query->o_entry_d;
+
+  // delivery
+  o_carrier_id = tpcc_query->o_carrier_id;
+  ol_delivery_d = tpcc_query->ol_delivery_d;
 }
 
 
@@ -595,6 +657,8 @@ void TPCCClientQueryMessage::copy_to_txn(TxnManager * txn) {
     ((TPCCTxnManager*)txn)->state = TPCC_PAYMENT0;
   else if (tpcc_query->txn_type == TPCC_NEW_ORDER) 
     ((TPCCTxnManager*)txn)->state = TPCC_NEWORDER0;
+  else if (tpcc_query->txn_type == TPCC_DELIVERY) 
+    ((TPCCTxnManager*)txn)->state = TPCC_DELIVERY0;
 	// common txn input for both payment & new-order
   tpcc_query->w_id = w_id;
   tpcc_query->d_id = d_id;
@@ -615,6 +679,10 @@ void TPCCClientQueryMessage::copy_to_txn(TxnManager * txn) {
   tpcc_query->ol_cnt = ol_cnt;
   tpcc_query->o_entry_d = o_entry_d;
 
+  // delivery
+  tpcc_query->o_carrier_id = o_carrier_id;
+  tpcc_query->ol_delivery_d = ol_delivery_d;
+
 }
 
 void TPCCClientQueryMessage::copy_from_buf(char * buf) {
@@ -651,6 +719,10 @@ void TPCCClientQueryMessage::copy_from_buf(char * buf) {
   COPY_VAL(ol_cnt,buf,ptr);
   COPY_VAL(o_entry_d,buf,ptr);
 
+  // delivery
+  COPY_VAL(o_carrier_id,buf,ptr);
+  COPY_VAL(ol_delivery_d,buf,ptr);
+
  assert(ptr == get_size());
 }
 
@@ -683,6 +755,9 @@ void TPCCClientQueryMessage::copy_to_buf(char * buf) {
   COPY_BUF(buf,remote,ptr);
   COPY_BUF(buf,ol_cnt,ptr);
   COPY_BUF(buf,o_entry_d,ptr);
+
+  COPY_BUF(buf,o_carrier_id,ptr);
+  COPY_BUF(buf,ol_delivery_d,ptr);
  assert(ptr == get_size());
 }
 
@@ -695,6 +770,13 @@ void TPCCClientQueryMessage::copy_to_buf(char * buf) {
 void PPSClientQueryMessage::init() {
 }
 
+// the parts of a supplier or product are found through a secondary lookup
+bool PPSClientQueryMessage::isReconQuery() {
+  return txn_type == PPS_GETPARTBYSUPPLIER ||
+          txn_type == PPS_GETPARTBYPRODUCT ||
+          txn_type == PPS_ORDERPRODUCT;
+}
+
 void PPSClientQueryMessage::release() {
   ClientQueryMessage::release();
 }
@@ -703,11 +785,6 @@ uint64_t PPSClientQueryMessage::get_size() {
   uint64_t size = ClientQueryMessage::get_size();
   size += sizeof(uint64_t);
   size += sizeof(uint64_t)*3; 
-  size += sizeof(size_t);
-  size += sizeof(uint64_t) * part_keys.size();
-#if CC_ALG == CALVIN
-  size += sizeof(bool);
-#endif
   return size;
 }
 
@@ -721,17 +798,12 @@ void PPSClientQueryMessage::copy_from_query(BaseQuery * query) {
   product_key = pps_query->product_key;
   supplier_key = pps_query->supplier_key;
 
-  part_keys.copy(pps_query->part_keys);
-
 }
 
 
 void PPSClientQueryMessage::copy_from_txn(TxnManager * txn) {
   ClientQueryMessage::mcopy_from_txn(txn);
   copy_from_query(txn->query);
-#if CC_ALG == CALVIN
-  recon = txn->isRecon();
-#endif
 }
 
 void PPSClientQueryMessage::copy_to_txn(TxnManager * txn) {
@@ -759,11 +831,7 @@ void PPSClientQueryMessage::copy_to_txn(TxnManager * txn) {
   pps_query->part_key = part_key;
   pps_query->product_key = product_key;
   pps_query->supplier_key = supplier_key;
-  pps_query->part_keys.append(part_keys);
 
-#if CC_ALG == CALVIN
-  txn->recon = recon;
-#endif
 #if DEBUG_DISTR
   std::cout << "PPSClient::copy_to_txn "
     << "type " << (PPSTxnType)txn_type
@@ -785,19 +853,6 @@ void PPSClientQueryMessage::copy_from_buf(char * buf) {
   COPY_VAL(product_key,buf,ptr);
   COPY_VAL(supplier_key,buf,ptr);
 
-  size_t size;
-  COPY_VAL(size,buf,ptr);
-  part_keys.init(size);
-  for(uint64_t i = 0 ; i < size;i++) {
-    uint64_t item;
-    COPY_VAL(item,buf,ptr);
-    part_keys.add(item);
-  }
-
-#if CC_ALG == CALVIN
-  COPY_VAL(recon,buf,ptr);
-#endif
-
  assert(ptr == get_size());
 #if DEBUG_DISTR
   std::cout << "PPSClient::copy_from_buf "
@@ -819,17 +874,6 @@ void PPSClientQueryMessage::copy_to_buf(char * buf) {
   COPY_BUF(buf,product_key,ptr);
   COPY_BUF(buf,supplier_key,ptr);
 
-  size_t size = part_keys.size();
-  COPY_BUF(buf,size,ptr);
-  for(uint64_t i = 0; i < part_keys.size(); i++) {
-    uint64_t item = part_keys[i];
-    COPY_BUF(buf,item,ptr);
-  }
-
-#if CC_ALG == CALVIN
-  COPY_BUF(buf,recon,ptr);
-#endif
-
  assert(ptr == get_size());
 #if DEBUG_DISTR
   std::cout << "PPSClient::copy_to_buf "
@@ -850,6 +894,7 @@ void ClientQueryMessage::init() {
 
 void ClientQueryMessage::release() {
   partitions.release();
+  recon_keys.release();
   first_startts = 0;
 }
 
@@ -861,12 +906,21 @@ uint64_t ClientQueryMessage::get_size() {
   */
   size += sizeof(size_t);
   size += sizeof(uint64_t) * partitions.size();
+#if CC_ALG == CALVIN
+  size += sizeof(size_t);
+  size += sizeof(uint64_t) * recon_keys.size();
+  size += sizeof(bool);
+#endif
   return size;
 }
 
 void ClientQueryMessage::copy_from_query(BaseQuery * query) {
   partitions.clear();
   partitions.copy(query->partitions);
+#if CC_ALG == CALVIN
+  recon_keys.copy(query->recon_keys);
+  recon = false;
+#endif
 }
 
 void ClientQueryMessage::copy_from_txn(TxnManager * txn) {
@@ -884,6 +938,10 @@ void ClientQueryMessage::copy_to_txn(TxnManager * txn) {
   txn->query->partitions.append(partitions);
   txn->client_startts = client_startts;
   txn->client_id = return_node_id;
+#if CC_ALG == CALVIN
+  txn->query->recon_keys.append(recon_keys);
+  txn->recon = recon;
+#endif
 }
 
 void ClientQueryMessage::copy_from_buf(char * buf) {
@@ -900,6 +958,16 @@ void ClientQueryMessage::copy_from_buf(char * buf) {
     COPY_VAL(part,buf,ptr);
     partitions.add(part);
   }
+#if CC_ALG == CALVIN
+  COPY_VAL(size,buf,ptr);
+  recon_keys.init(size);
+  for(uint64_t i = 0; i < size; i++) {
+    uint64_t key;
+    COPY_VAL(key,buf,ptr);
+    recon_keys.add(key);
+  }
+  COPY_VAL(recon,buf,ptr);
+#endif
 }
 
 void ClientQueryMessage::copy_to_buf(char * buf) {
@@ -913,6 +981,15 @@ void ClientQueryMessage::copy_to_buf(char * buf) {
     uint64_t part = partitions[i];
     COPY_BUF(buf,part,ptr);
   }
+#if CC_ALG == CALVIN
+  size = recon_keys.size();
+  COPY_BUF(buf,size,ptr);
+  for(uint64_t i = 0; i < size; i++) {
+    uint64_t key = recon_keys[i];
+    COPY_BUF(buf,key,ptr);
+  }
+  COPY_BUF(buf,recon,ptr);
+#endif
 }
 
 /************************/
@@ -953,6 +1030,7 @@ void ClientResponseMessage::copy_to_buf(char * buf) {
 
 uint64_t DoneMessage::get_size() {
   uint64_t size = Message::mget_size();
+  size += sizeof(uint64_t);
   return size;
 }
 
@@ -967,12 +1045,52 @@ void DoneMessage::copy_to_txn(TxnManager * txn) {
 void DoneMessage::copy_from_buf(char * buf) {
   Message::mcopy_from_buf(buf);
   uint64_t ptr = Message::mget_size();
+  COPY_VAL(next_epoch,buf,ptr);
  assert(ptr == get_size());
 }
 
 void DoneMessage::copy_to_buf(char * buf) {
   Message::mcopy_to_buf(buf);
   uint64_t ptr = Message::mget_size();
+  COPY_BUF(buf,next_epoch,ptr);
+ assert(ptr == get_size());
+}
+
+/************************/
+
+uint64_t DLDetectMessage::get_size() {
+  uint64_t size = Message::mget_size();
+  size += sizeof(bool);
+  size += sizeof(size_t);
+  size += sizeof(uint64_t) * edges.size();
+  return size;
+}
+
+void DLDetectMessage::copy_from_buf(char * buf) {
+  Message::mcopy_from_buf(buf);
+  uint64_t ptr = Message::mget_size();
+  COPY_VAL(first,buf,ptr);
+  size_t size;
+  COPY_VAL(size,buf,ptr);
+  edges.init(size);
+  for(uint64_t i = 0 ; i < size;i++) {
+    uint64_t item;
+    COPY_VAL(item,buf,ptr);
+    edges.add(item);
+  }
+ assert(ptr == get_size());
+}
+
+void DLDetectMessage::copy_to_buf(char * buf) {
+  Message::mcopy_to_buf(buf);
+  uint64_t ptr = Message::mget_size();
+  COPY_BUF(buf,first,ptr);
+  size_t size = edges.size();
+  COPY_BUF(buf,size,ptr);
+  for(uint64_t i = 0; i < edges.size(); i++) {
+    uint64_t item = edges[i];
+    COPY_BUF(buf,item,ptr);
+  }
  assert(ptr == get_size());
 }
 
@@ -1029,26 +1147,41 @@ void ForwardMessage::copy_to_buf(char * buf) {
 uint64_t PrepareMessage::get_size() {
   uint64_t size = Message::mget_size();
   //size += sizeof(uint64_t);
+#if CC_ALG == TICTOC
+  size += sizeof(uint64_t);
+#endif
   return size;
 }
 
 void PrepareMessage::copy_from_txn(TxnManager * txn) {
   Message::mcopy_from_txn(txn);
+#if CC_ALG == TICTOC
+  commit_timestamp = txn->get_commit_timestamp();
+#endif
 }
 
 void PrepareMessage::copy_to_txn(TxnManager * txn) {
   Message::mcopy_to_txn(txn);
+#if CC_ALG == TICTOC
+  txn->commit_timestamp = commit_timestamp;
+#endif
 }
 
 void PrepareMessage::copy_from_buf(char * buf) {
   Message::mcopy_from_buf(buf);
   uint64_t ptr = Message::mget_size();
+#if CC_ALG == TICTOC
+  COPY_VAL(commit_timestamp,buf,ptr);
+#endif
  assert(ptr == get_size());
 }
 
 void PrepareMessage::copy_to_buf(char * buf) {
   Message::mcopy_to_buf(buf);
   uint64_t ptr = Message::mget_size();
+#if CC_ALG == TICTOC
+  COPY_BUF(buf,commit_timestamp,ptr);
+#endif
  assert(ptr == get_size());
 }
 
@@ -1060,9 +1193,9 @@ uint64_t AckMessage::get_size() {
 #if CC_ALG == MAAT
   size += sizeof(uint64_t) * 2;
 #endif
-#if WORKLOAD == PPS && CC_ALG == CALVIN
+#if CC_ALG == CALVIN
   size += sizeof(size_t);
-  size += sizeof(uint64_t) * part_keys.size();
+  size += sizeof(uint64_t) * recon_keys.size();
 #endif
   return size;
 }
@@ -1075,19 +1208,17 @@ void AckMessage::copy_from_txn(TxnManager * txn) {
   lower = time_table.get_lower(txn->get_thd_id(),txn->get_txn_id());
   upper = time_table.get_upper(txn->get_thd_id(),txn->get_txn_id());
 #endif
-#if WORKLOAD == PPS && CC_ALG == CALVIN
-  PPSQuery* pps_query = (PPSQuery*)(txn->query);
-  part_keys.copy(pps_query->part_keys);
+#if CC_ALG == CALVIN
+  if(txn->isRecon())
+    recon_keys.copy(txn->query->recon_keys);
 #endif
 }
 
 void AckMessage::copy_to_txn(TxnManager * txn) {
   Message::mcopy_to_txn(txn);
   //query->rc = rc;
-#if WORKLOAD == PPS && CC_ALG == CALVIN
-
-  PPSQuery* pps_query = (PPSQuery*)(txn->query);
-  pps_query->part_keys.append(part_keys);
+#if CC_ALG == CALVIN
+  txn->query->recon_keys.append(recon_keys);
 #endif
 }
 
@@ -1099,15 +1230,14 @@ void AckMessage::copy_from_buf(char * buf) {
   COPY_VAL(lower,buf,ptr);
   COPY_VAL(upper,buf,ptr);
 #endif
-#if WORKLOAD == PPS && CC_ALG == CALVIN
-
+#if CC_ALG == CALVIN
   size_t size;
   COPY_VAL(size,buf,ptr);
-  part_keys.init(size);
+  recon_keys.init(size);
   for(uint64_t i = 0 ; i < size;i++) {
     uint64_t item;
     COPY_VAL(item,buf,ptr);
-    part_keys.add(item);
+    recon_keys.add(item);
   }
 #endif
  assert(ptr == get_size());
@@ -1121,12 +1251,11 @@ void AckMessage::copy_to_buf(char * buf) {
   COPY_BUF(buf,lower,ptr);
   COPY_BUF(buf,upper,ptr);
 #endif
-#if WORKLOAD == PPS && CC_ALG == CALVIN
-
-  size_t size = part_keys.size();
+#if CC_ALG == CALVIN
+  size_t size = recon_keys.size();
   COPY_BUF(buf,size,ptr);
-  for(uint64_t i = 0; i < part_keys.size(); i++) {
-    uint64_t item = part_keys[i];
+  for(uint64_t i = 0; i < recon_keys.size(); i++) {
+    uint64_t item = recon_keys[i];
     COPY_BUF(buf,item,ptr);
   }
 #endif
@@ -1139,18 +1268,28 @@ uint64_t QueryResponseMessage::get_size() {
   uint64_t size = Message::mget_size(); 
   size += sizeof(RC);
   //size += sizeof(uint64_t);
+#if CC_ALG == TICTOC
+  size += sizeof(uint64_t);
+#endif
   return size;
 }
 
 void QueryResponseMessage::copy_from_txn(TxnManager * txn) {
   Message::mcopy_from_txn(txn);
   rc = txn->get_rc();
+#if CC_ALG == TICTOC
+  commit_timestamp = tictoc_man.get_lower_bound(txn);
+#endif
 
 }
 
 void QueryResponseMessage::copy_to_txn(TxnManager * txn) {
   Message::mcopy_to_txn(txn);
   //query->rc = rc;
+#if CC_ALG == TICTOC
+  if(commit_timestamp > txn->get_commit_timestamp())
+    txn->set_commit_timestamp(commit_timestamp);
+#endif
 
 }
 
@@ -1158,6 +1297,9 @@ void QueryResponseMessage::copy_from_buf(char * buf) {
   Message::mcopy_from_buf(buf);
   uint64_t ptr = Message::mget_size();
   COPY_VAL(rc,buf,ptr);
+#if CC_ALG == TICTOC
+  COPY_VAL(commit_timestamp,buf,ptr);
+#endif
 
  assert(ptr == get_size());
 }
@@ -1166,6 +1308,9 @@ void QueryResponseMessage::copy_to_buf(char * buf) {
   Message::mcopy_to_buf(buf);
   uint64_t ptr = Message::mget_size();
   COPY_BUF(buf,rc,ptr);
+#if CC_ALG == TICTOC
+  COPY_BUF(buf,commit_timestamp,ptr);
+#endif
  assert(ptr == get_size());
 }
 
@@ -1178,7 +1323,7 @@ uint64_t FinishMessage::get_size() {
   size += sizeof(uint64_t); 
   size += sizeof(RC); 
   size += sizeof(bool); 
-#if CC_ALG == MAAT
+#if CC_ALG == MAAT || (CC_ALG == MVCC && ISOLATION_LEVEL == SNAPSHOT)
   size += sizeof(uint64_t); 
 #endif
   return size;
@@ -1188,14 +1333,14 @@ void FinishMessage::copy_from_txn(TxnManager * txn) {
   Message::mcopy_from_txn(txn);
   rc = txn->get_rc();
   readonly = txn->query->readonly();
-#if CC_ALG == MAAT
+#if CC_ALG == MAAT || (CC_ALG == MVCC && ISOLATION_LEVEL == SNAPSHOT)
   commit_timestamp = txn->get_commit_timestamp();
 #endif
 }
 
 void FinishMessage::copy_to_txn(TxnManager * txn) {
   Message::mcopy_to_txn(txn);
-#if CC_ALG == MAAT
+#if CC_ALG == MAAT || (CC_ALG == MVCC && ISOLATION_LEVEL == SNAPSHOT)
   txn->commit_timestamp = commit_timestamp;
 #endif
 }
@@ -1206,7 +1351,7 @@ void FinishMessage::copy_from_buf(char * buf) {
   COPY_VAL(pid,buf,ptr);
   COPY_VAL(rc,buf,ptr);
   COPY_VAL(readonly,buf,ptr);
-#if CC_ALG == MAAT
+#if CC_ALG == MAAT || (CC_ALG == MVCC && ISOLATION_LEVEL == SNAPSHOT)
   COPY_VAL(commit_timestamp,buf,ptr);
 #endif
  assert(ptr == get_size());
@@ -1218,7 +1363,7 @@ void FinishMessage::copy_to_buf(char * buf) {
   COPY_BUF(buf,pid,ptr);
   COPY_BUF(buf,rc,ptr);
   COPY_BUF(buf,readonly,ptr);
-#if CC_ALG == MAAT
+#if CC_ALG == MAAT || (CC_ALG == MVCC && ISOLATION_LEVEL == SNAPSHOT)
   COPY_BUF(buf,commit_timestamp,ptr);
 #endif
  assert(ptr == get_size());
@@ -1627,7 +1772,7 @@ void PPSQueryMessage::copy_from_txn(TxnManager * txn) {
       part_key = pps_query->part_key;
   }
 
-  part_keys.copy(pps_query->part_keys);
+  part_keys.copy(pps_query->recon_keys);
 
 }
 
@@ -1666,7 +1811,7 @@ void PPSQueryMessage::copy_to_txn(TxnManager * txn) {
   if (txn_type == PPS_UPDATEPART) {
       pps_query->part_key = part_key;
   }
-  pps_query->part_keys.append(part_keys);
+  pps_query->recon_keys.append(part_keys);
 
 }
 
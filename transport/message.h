@@ -103,7 +103,7 @@ public:
   //uint64_t txn_id;
   //uint64_t batch_id;
   bool readonly;
-#if CC_ALG == MAAT
+#if CC_ALG == MAAT || (CC_ALG == MVCC && ISOLATION_LEVEL == SNAPSHOT)
   uint64_t commit_timestamp;
 #endif
 };
@@ -159,6 +159,10 @@ public:
 
   RC rc;
   uint64_t pid;
+#if CC_ALG == TICTOC
+  // lower bound of the commit timestamp from the accesses at this node
+  uint64_t commit_timestamp;
+#endif
 
 };
 
@@ -178,8 +182,8 @@ public:
   uint64_t upper;
 #endif
 
-  // For Calvin PPS: part keys from secondary lookup for sequencer response
-  Array<uint64_t> part_keys;
+  // [CALVIN] the keys a reconnaissance run predicted
+  Array<uint64_t> recon_keys;
 };
 
 class PrepareMessage : public Message {
@@ -195,6 +199,9 @@ public:
   uint64_t pid;
   RC rc;
   uint64_t txn_id;
+#if CC_ALG == TICTOC
+  uint64_t commit_timestamp;
+#endif
 };
 
 class ForwardMessage : public Message {
@@ -224,6 +231,30 @@ public:
   void init() {}
   void release() {}
   uint64_t batch_id;
+  // [CALVIN] the next epoch the sender closes; it sends no txns for the
+  // epochs in between
+  uint64_t next_epoch;
+};
+
+// [DL_DETECT] DL_GRAPH carries the waits-for edges of a node to node 0 as
+// (txn_id, ts, waits-for txn_id) triples. A report that does not fit into
+// one message is split. DL_ABORT asks the node where txn_id is blocked to
+// abort it, and carries no edges.
+// [WOUND_WAIT] RWOUND tells every node that txn_id was wounded, and carries
+// no edges either.
+class DLDetectMessage : public Message {
+public:
+  void copy_from_buf(char * buf);
+  void copy_to_buf(char * buf);
+  void copy_from_txn(TxnManager * txn) {}
+  void copy_to_txn(TxnManager * txn) {}
+  uint64_t get_size();
+  void init() {}
+  void release() { edges.release(); }
+
+  // the first message of a report replaces the previous report of the node
+  bool first;
+  Array<uint64_t> edges;
 };
 
 class ClientResponseMessage : public Message {
@@ -260,6 +291,12 @@ public:
   uint64_t client_startts;
   uint64_t first_startts;
   Array<uint64_t> partitions;
+
+  // [CALVIN] OLLP, see BaseQuery::isReconQuery. The sequencer runs a
+  // dependent txn as reconnaissance until it has its recon_keys
+  virtual bool isReconQuery() {return false;}
+  Array<uint64_t> recon_keys;
+  bool recon;
 };
 
 class YCSBClientQueryMessage : public ClientQueryMessage {
@@ -309,6 +346,11 @@ public:
   uint64_t ol_cnt;
   uint64_t o_entry_d;
 
+  // delivery
+  uint64_t o_carrier_id;
+  uint64_t ol_delivery_d;
+
+  bool isReconQuery();
 };
 
 class PPSClientQueryMessage : public ClientQueryMessage {
@@ -331,11 +373,7 @@ public:
   // getsuppliers / getpartbysupplier
   uint64_t supplier_key;
 
-  // part keys from secondary lookup
-  Array<uint64_t> part_keys;
-
-  bool recon;
-
+  bool isReconQuery();
 };
 
 class QueryMessage : public Message {
@@ -346,12 +384,22 @@ public:
   void copy_to_txn(TxnManager * txn);
   uint64_t get_size();
   void init() {}
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == VLL
+  void release() { partitions.release(); }
+#else
   void release() {}
+#endif
 
   uint64_t pid;
-#if CC_ALG == WAIT_DIE || CC_ALG == TIMESTAMP || CC_ALG == MVCC
+#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || CC_ALG == DL_DETECT || CC_ALG == TIMESTAMP || CC_ALG == MVCC \
+  || CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC
   uint64_t ts;
 #endif
+#if CC_ALG == HSTORE || CC_ALG == HSTORE_SPEC || CC_ALG == VLL
+  // every partition of the txn, so that a participant locks its own ones
+  // with the first request
+  Array<uint64_t> partitions;
+#endif
 #if CC_ALG == MVCC 
   uint64_t thd_id;
 #elif CC_ALG == OCC 